@@ -456,8 +456,17 @@ extern SDL_DECLSPEC void SDLCALL MIX_DestroyMixer(MIX_Mixer *mixer);
 /**
  * Get the properties associated with a mixer.
  *
- * Currently SDL_mixer assigns no properties of its own to a mixer, but this
- * can be a convenient place to store app-specific data.
+ * The app can set these properties to change how the mixer behaves. They
+ * are read each time the mixer generates more audio, so changes take effect
+ * within one audio buffer:
+ *
+ * - `MIX_PROP_MIXER_SPEED_OF_SOUND_FLOAT`: the speed of sound, in units per
+ *   second, used to calculate the Doppler shift of 3D tracks (see
+ *   MIX_SetTrack3DVelocity()). Defaults to 343.3, so a unit is a meter in dry
+ *   air at 20 degrees Celsius. Values that aren't larger than zero are
+ *   ignored.
+ *
+ * This is also a convenient place to store app-specific data.
  *
  * A SDL_PropertiesID is created the first time this function is called for a
  * given mixer.
@@ -472,6 +481,8 @@ extern SDL_DECLSPEC void SDLCALL MIX_DestroyMixer(MIX_Mixer *mixer);
  */
 extern SDL_DECLSPEC SDL_PropertiesID SDLCALL MIX_GetMixerProperties(MIX_Mixer *mixer);
 
+#define MIX_PROP_MIXER_SPEED_OF_SOUND_FLOAT "SDL_mixer.mixer.speed_of_sound"
+
 /**
  * Get the audio format a mixer is generating.
  *
@@ -503,6 +514,36 @@ extern SDL_DECLSPEC SDL_PropertiesID SDLCALL MIX_GetMixerProperties(MIX_Mixer *m
  */
 extern SDL_DECLSPEC bool SDLCALL MIX_GetMixerFormat(MIX_Mixer *mixer, SDL_AudioSpec *spec);
 
+/**
+ * Get the mixer's sample clock.
+ *
+ * This is the total number of sample frames the mixer has produced since it
+ * was created, at the mixer's sample rate (see MIX_GetMixerFormat()). It
+ * only moves forward, in chunks of whatever size the audio device (or
+ * MIX_Generate()) asks for. It doesn't move while the device is paused.
+ *
+ * This is meant for scheduling things to happen at an exact point in the
+ * future: read the clock, add some number of frames, and pass the result to
+ * MIX_PROP_PLAY_START_AT_MIXER_FRAME_NUMBER or MIX_StopTrackAtMixerFrame().
+ * Be sure to schedule far enough ahead that the mixer hasn't already mixed
+ * that point by the time your request is made; a device buffer or two is
+ * usually plenty.
+ *
+ * This does not lock the mixer, so it's cheap to call often.
+ *
+ * \param mixer the mixer to query.
+ * \returns the number of sample frames mixed so far, or 0 on error; call
+ *          SDL_GetError() for details.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_PlayTrack
+ * \sa MIX_StopTrackAtMixerFrame
+ */
+extern SDL_DECLSPEC Uint64 SDLCALL MIX_GetMixerClock(MIX_Mixer *mixer);
+
 /**
  * Load audio for playback from an SDL_IOStream.
  *
@@ -614,13 +655,40 @@ extern SDL_DECLSPEC MIX_Audio * SDLCALL MIX_LoadAudio(MIX_Mixer *mixer, const ch
  *   metadata tags, like ID3 and APE tags. This can be used to speed up
  *   loading _if the data definitely doesn't have these tags_. Some decoders
  *   will fail if these tags are present when this property is true.
+ * - `MIX_PROP_AUDIO_LOAD_ANALYZE_LOUDNESS_BOOLEAN`: true to measure the
+ *   audio's loudness (as EBU R128 describes it) while loading, so the
+ *   `MIX_PROP_METADATA_LOUDNESS_*` properties are available. If ReplayGain or
+ *   R128 tags in the data already provide the loudness, this uses them and
+ *   skips the measurement. If predecoding, the measurement happens during
+ *   that decode; otherwise it costs an extra decoding pass over the data,
+ *   which can make loading much slower. If the measurement fails, the audio
+ *   still loads, but without these properties. Default false.
+ * - `MIX_PROP_AUDIO_LOAD_SEEK_INTERVAL_MS_NUMBER`: for formats that need a
+ *   seek table to seek quickly (like MP3 and Ogg Vorbis), roughly how many
+ *   milliseconds apart its entries should be. The table is built on a
+ *   background thread after loading (one thread works through all loaded
+ *   audio, in the order it loaded), and all tracks share it; seeks before
+ *   it's ready take the format's slower path. Smaller values make seeks land
+ *   faster, but use more memory. Zero means no table, so seeks always take
+ *   the slower path. Default 1000.
+ * - `MIX_PROP_AUDIO_LOAD_BUILD_SEEK_TABLE_BOOLEAN`: true to build the seek
+ *   table described above while loading, instead of in the background. This
+ *   makes loading slower, but seeks are fast right away. Audio that keeps
+ *   reading from its SDL_IOStream instead of holding the data in memory only
+ *   gets a table if this is true. Default false.
  * - `MIX_PROP_AUDIO_DECODER_STRING`: the name of the decoder to use for this
  *   data. Optional. If not specified, SDL_mixer will examine the data and
  *   choose the best decoder. These names are the same returned from
  *   MIX_GetAudioDecoder().
  *
  * Specific decoders might accept additional custom properties, such as where
- * to find soundfonts for MIDI playback, etc.
+ * to find soundfonts for MIDI playback, etc. These are documented here:
+ *
+ * - `MIX_PROP_DECODER_GME_TRACK_NUMBER`: for game music formats that hold
+ *   several songs in one file (NSF, GBS, SPC sets, etc), which song to play,
+ *   starting from zero. Tracks play this song unless their own properties
+ *   (see MIX_GetTrackProperties) pick another. Loading fails if the file
+ *   doesn't have this song. Default zero.
  *
  * \param props a set of properties on how to load audio.
  * \returns an audio object that can be used to make sound on a mixer, or NULL
@@ -642,7 +710,11 @@ extern SDL_DECLSPEC MIX_Audio * SDLCALL MIX_LoadAudioWithProperties(SDL_Properti
 #define MIX_PROP_AUDIO_LOAD_PREDECODE_BOOLEAN "SDL_mixer.audio.load.predecode"
 #define MIX_PROP_AUDIO_LOAD_PREFERRED_MIXER_POINTER "SDL_mixer.audio.load.preferred_mixer"
 #define MIX_PROP_AUDIO_LOAD_SKIP_METADATA_TAGS_BOOLEAN "SDL_mixer.audio.load.skip_metadata_tags"
+#define MIX_PROP_AUDIO_LOAD_ANALYZE_LOUDNESS_BOOLEAN "SDL_mixer.audio.load.analyze_loudness"
+#define MIX_PROP_AUDIO_LOAD_SEEK_INTERVAL_MS_NUMBER "SDL_mixer.audio.load.seek_interval_ms"
+#define MIX_PROP_AUDIO_LOAD_BUILD_SEEK_TABLE_BOOLEAN "SDL_mixer.audio.load.build_seek_table"
 #define MIX_PROP_AUDIO_DECODER_STRING "SDL_mixer.audio.decoder"
+#define MIX_PROP_DECODER_GME_TRACK_NUMBER "SDL_mixer.decoder.gme.track"
 
 /**
  * Load raw PCM data from an SDL_IOStream.
@@ -820,6 +892,17 @@ extern SDL_DECLSPEC MIX_Audio * SDLCALL MIX_CreateSineWaveAudio(MIX_Mixer *mixer
  * - `MIX_PROP_METADATA_DURATION_INFINITE_BOOLEAN`: if true, audio never runs
  *   out of sound to generate. This isn't necessarily always known to
  *   SDL_mixer, though.
+ * - `MIX_PROP_METADATA_LOUDNESS_INTEGRATED_FLOAT`: the audio's integrated
+ *   loudness, in LUFS (-23.0f is the EBU R128 broadcast target). This comes
+ *   from ReplayGain or R128 tags if present, or from measuring the audio if
+ *   MIX_PROP_AUDIO_LOAD_ANALYZE_LOUDNESS_BOOLEAN was used. Audio shorter than
+ *   400 milliseconds can't be measured.
+ * - `MIX_PROP_METADATA_LOUDNESS_TRUE_PEAK_FLOAT`: the audio's largest
+ *   (oversampled) peak, in dBTP. If this came from ReplayGain tags, it's the
+ *   largest sample instead.
+ * - `MIX_PROP_METADATA_LOUDNESS_RANGE_FLOAT`: the audio's loudness range, in
+ *   LU. This is only available if the audio was measured, and is at least 3
+ *   seconds long.
  *
  * Other properties, documented with MIX_LoadAudioWithProperties(), may also
  * be present.
@@ -848,6 +931,9 @@ extern SDL_DECLSPEC SDL_PropertiesID SDLCALL MIX_GetAudioProperties(MIX_Audio *a
 #define MIX_PROP_METADATA_YEAR_NUMBER "SDL_mixer.metadata.year"
 #define MIX_PROP_METADATA_DURATION_FRAMES_NUMBER "SDL_mixer.metadata.duration_frames"
 #define MIX_PROP_METADATA_DURATION_INFINITE_BOOLEAN "SDL_mixer.metadata.duration_infinite"
+#define MIX_PROP_METADATA_LOUDNESS_INTEGRATED_FLOAT "SDL_mixer.metadata.loudness.integrated"
+#define MIX_PROP_METADATA_LOUDNESS_TRUE_PEAK_FLOAT "SDL_mixer.metadata.loudness.true_peak"
+#define MIX_PROP_METADATA_LOUDNESS_RANGE_FLOAT "SDL_mixer.metadata.loudness.range"
 
 
 /**
@@ -979,7 +1065,16 @@ extern SDL_DECLSPEC void SDLCALL MIX_DestroyTrack(MIX_Track *track);
  * Get the properties associated with a track.
  *
  * Currently SDL_mixer assigns no properties of its own to a track, but this
- * can be a convenient place to store app-specific data.
+ * can be a convenient place to store app-specific data. Some decoders also
+ * check these when audio is assigned to the track (with MIX_SetTrackAudio,
+ * MIX_QueueTrackAudio, etc), for settings that can differ between tracks
+ * playing the same MIX_Audio, like which song to play from a file that holds
+ * several:
+ *
+ * - `MIX_PROP_DECODER_GME_TRACK_NUMBER`: which song (starting from zero) to
+ *   play from a game music file that holds several. If not set, the track
+ *   plays the song the MIX_Audio was loaded with. Assigning the audio to the
+ *   track fails if the file doesn't have this song.
  *
  * A SDL_PropertiesID is created the first time this function is called for a
  * given track.
@@ -1132,6 +1227,131 @@ extern SDL_DECLSPEC bool SDLCALL MIX_SetTrackAudioStream(MIX_Track *track, SDL_A
  */
 extern SDL_DECLSPEC bool SDLCALL MIX_SetTrackIOStream(MIX_Track *track, SDL_IOStream *io, bool closeio);
 
+/**
+ * Queue up a MIX_Audio to play on a track after its current input finishes.
+ *
+ * When the track's current input reaches its end (after any loops and
+ * appended silence), the track switches to the first item in its queue at
+ * exactly that sample frame, without a gap, instead of stopping. The
+ * MIX_TrackStoppedCallback is not called for the switch; the track keeps
+ * playing until it runs out of input with nothing left in the queue.
+ *
+ * The decoder for `audio` is set up, and the first bit of audio decoded,
+ * during this call, so the mixer doesn't have to do that work (or clean up
+ * the previous input) on the audio thread when it switches. As such, it's
+ * better to call this well before the current input ends, and it's better
+ * not to call this from a MIX_TrackStoppedCallback.
+ *
+ * Queued audio plays once, from the start, at full volume; the options given
+ * to MIX_PlayTrack() apply only to the input that was playing at the time.
+ * Stopping the track (including with a fade-out) leaves the queue alone, so
+ * it will continue on to the queue the next time the track plays and
+ * finishes its current input.
+ *
+ * The track holds a reference to `audio` while it's queued, so it's safe to
+ * call MIX_DestroyAudio() on it right after queueing.
+ *
+ * \param track the track to queue audio on.
+ * \param audio the audio to play after the track's current input.
+ * \returns true on success, false on error; call SDL_GetError() for details.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_ClearTrackQueue
+ * \sa MIX_GetTrackQueueLength
+ */
+extern SDL_DECLSPEC bool SDLCALL MIX_QueueTrackAudio(MIX_Track *track, MIX_Audio *audio);
+
+/**
+ * Remove everything from a track's queue.
+ *
+ * The track's current input is not affected.
+ *
+ * \param track the track to clear.
+ * \returns true on success, false on error; call SDL_GetError() for details.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_QueueTrackAudio
+ */
+extern SDL_DECLSPEC bool SDLCALL MIX_ClearTrackQueue(MIX_Track *track);
+
+/**
+ * Get the number of MIX_Audio items waiting in a track's queue.
+ *
+ * This does not count the track's current input. An app building a playlist
+ * can check this periodically and queue more audio when it gets low.
+ *
+ * \param track the track to query.
+ * \returns the number of queued items, or -1 on error; call SDL_GetError()
+ *          for details.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_QueueTrackAudio
+ */
+extern SDL_DECLSPEC int SDLCALL MIX_GetTrackQueueLength(MIX_Track *track);
+
+/**
+ * The shapes of volume curve available to MIX_CrossfadeTrackAudio().
+ *
+ * \since This enum is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_CrossfadeTrackAudio
+ */
+typedef enum MIX_CrossfadeCurve
+{
+    MIX_CROSSFADE_EQUAL_POWER,  /**< Sine/cosine curves; keeps the overall loudness steady between unrelated audio, like two different songs. */
+    MIX_CROSSFADE_LINEAR        /**< Straight lines; keeps the level steady between closely-related audio, like two takes of the same loop. */
+} MIX_CrossfadeCurve;
+
+/**
+ * Change a track's input to a MIX_Audio, crossfading from what it was playing.
+ *
+ * Over the next `frames` sample frames (of `audio`), the track's old input
+ * fades out while `audio` fades in, both mixed on this same track, so the
+ * track's gain, spatialization, filters, tags, etc, apply to both. When the
+ * fade is done, the old input is cleaned up.
+ *
+ * The decoder for `audio` is set up, and the first bit of audio decoded,
+ * during this call, and the old input's decoder is cleaned up later, off the
+ * audio thread, so the mixer doesn't have to do any of this work itself.
+ *
+ * The new audio plays once, from the start, at full volume; call
+ * MIX_PlayTrack() afterwards if it should loop, etc (this will end the
+ * crossfade, though, so it's usually better to queue the next piece with
+ * MIX_QueueTrackAudio() instead). If the track was stopped, or its input
+ * wasn't a MIX_Audio, the new audio just fades in from silence, and the
+ * track starts playing if it wasn't already.
+ *
+ * If the track is already in the middle of a crossfade, the audio that was
+ * fading in starts fading out from whatever volume it had reached, and the
+ * audio that was already fading out finishes its own fade, so nothing jumps
+ * in volume. If `frames` is 0, everything that was fading out stops
+ * immediately.
+ *
+ * \param track the track to change.
+ * \param audio the new audio to play on the track.
+ * \param frames the length of the crossfade, in sample frames of `audio`. 0
+ *               to switch immediately.
+ * \param curve the shape of the crossfade.
+ * \returns true on success, false on error; call SDL_GetError() for details.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_SetTrackAudio
+ * \sa MIX_QueueTrackAudio
+ */
+extern SDL_DECLSPEC bool SDLCALL MIX_CrossfadeTrackAudio(MIX_Track *track, MIX_Audio *audio, Sint64 frames, MIX_CrossfadeCurve curve);
+
 /**
  * Assign an arbitrary tag to a track.
  *
@@ -1221,6 +1441,40 @@ extern SDL_DECLSPEC void SDLCALL MIX_UntagTrack(MIX_Track *track, const char *ta
  */
 extern SDL_DECLSPEC bool SDLCALL MIX_SetTrackPlaybackPosition(MIX_Track *track, Uint64 frames);
 
+/**
+ * Seek all tracks with a specific tag to the same position, in lockstep.
+ *
+ * This is meant for music that's split into stems (drums, bass, strings...),
+ * each on its own tagged track, that must stay sample-locked to each other.
+ * Every tagged track is seeked, and has some audio decoded at the new
+ * position, before any of them continue mixing, and then they all continue on
+ * the exact same sample frame. Any audio that was already converted for
+ * mixing is thrown away, so no track plays a little bit of audio from before
+ * the seek that the others don't.
+ *
+ * `frames` is in sample frames of each track's input, so it's best if all the
+ * tagged tracks' audio have the same sample rate. Tracks that can't seek (see
+ * MIX_SetTrackPlaybackPosition()) are skipped, and this function will report
+ * failure, but all the other tracks will still seek.
+ *
+ * Tracks that are paused will resume from the new position; stopped tracks
+ * are not affected.
+ *
+ * \param mixer the mixer on which to look for tagged tracks.
+ * \param tag the tag to use when searching for tracks.
+ * \param frames the sample frame position to seek to.
+ * \returns true on success, false on error; call SDL_GetError() for details.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_SetTrackPlaybackPosition
+ * \sa MIX_PlayTag
+ * \sa MIX_TagTrack
+ */
+extern SDL_DECLSPEC bool SDLCALL MIX_SetTagPlaybackPosition(MIX_Mixer *mixer, const char *tag, Uint64 frames);
+
 /**
  * Get the current input position of a playing track.
  *
@@ -1545,6 +1799,21 @@ extern SDL_DECLSPEC Uint64 SDLCALL MIX_FramesToMS(int sample_rate, Uint64 frames
  *   MIX_PROP_PLAY_APPEND_SILENCE_FRAMES_NUMBER property, but the value is
  *   specified in milliseconds instead of sample frames. If both properties
  *   are specified, the sample frames value is favored. Default 0.
+ * - `MIX_PROP_PLAY_LOUDNESS_TARGET_FLOAT`: If the track's MIX_Audio has a
+ *   MIX_PROP_METADATA_LOUDNESS_INTEGRATED_FLOAT property, adjust the track's
+ *   volume so it plays at this loudness, in LUFS (-23.0f for EBU R128, around
+ *   -14.0f to -16.0f for most music streaming services). This won't boost
+ *   the audio so much that its true peak goes over -1 dBTP. This is applied
+ *   in addition to the track's gain, and doesn't change what
+ *   MIX_GetTrackGain() reports. If not specified, or the loudness isn't
+ *   known, no adjustment is made.
+ * - `MIX_PROP_PLAY_START_AT_MIXER_FRAME_NUMBER`: Don't start mixing the track
+ *   until the mixer's sample clock (see MIX_GetMixerClock()) reaches this
+ *   value, and then start at exactly that sample frame, even if it lands in
+ *   the middle of a device buffer. Tracks started with the same value (for
+ *   example, with MIX_PlayTag()) will be perfectly in sync. The track counts
+ *   as playing while it waits. If this is zero, or the mixer has already
+ *   passed this point, the track starts as soon as possible. Default 0.
  *
  * If this function fails, mixing of this track will not start (or restart, if
  * it was already started).
@@ -1576,6 +1845,8 @@ extern SDL_DECLSPEC bool SDLCALL MIX_PlayTrack(MIX_Track *track, SDL_PropertiesI
 #define MIX_PROP_PLAY_FADE_IN_MILLISECONDS_NUMBER "SDL_mixer.play.fade_in_milliseconds"
 #define MIX_PROP_PLAY_APPEND_SILENCE_FRAMES_NUMBER "SDL_mixer.play.append_silence_frames"
 #define MIX_PROP_PLAY_APPEND_SILENCE_MILLISECONDS_NUMBER "SDL_mixer.play.append_silence_milliseconds"
+#define MIX_PROP_PLAY_LOUDNESS_TARGET_FLOAT "SDL_mixer.play.loudness_target"
+#define MIX_PROP_PLAY_START_AT_MIXER_FRAME_NUMBER "SDL_mixer.play.start_at_mixer_frame"
 
 
 /**
@@ -1596,7 +1867,13 @@ extern SDL_DECLSPEC bool SDLCALL MIX_PlayTrack(MIX_Track *track, SDL_PropertiesI
  * start will still be started even when this function reports failure.
  *
  * From the point of view of the mixing process, all tracks that successfully
- * (re)start will do so at the exact same moment.
+ * (re)start will do so at the exact same moment. Each track seeks to its
+ * start position and decodes a little audio before any of them start, so
+ * nothing has to catch up on the audio thread. This makes tags a good way to
+ * keep music stems sample-locked; MIX_PauseTag(), MIX_ResumeTag(),
+ * MIX_StopTag() and MIX_SetTagPlaybackPosition() also act on all the tracks
+ * at the same moment. Use MIX_PROP_PLAY_START_AT_MIXER_FRAME_NUMBER to pick
+ * that moment exactly.
  *
  * \param mixer the mixer on which to look for tagged tracks.
  * \param tag the tag to use when searching for tracks.
@@ -1681,6 +1958,35 @@ extern SDL_DECLSPEC bool SDLCALL MIX_PlayAudio(MIX_Mixer *mixer, MIX_Audio *audi
  */
 extern SDL_DECLSPEC bool SDLCALL MIX_StopTrack(MIX_Track *track, Sint64 fade_out_frames);
 
+/**
+ * Halt a track at a specific point on the mixer's sample clock.
+ *
+ * This works like MIX_StopTrack(), but instead of stopping when the mixer
+ * next runs, it stops at exactly `mixer_frame` (see MIX_GetMixerClock()),
+ * even if that lands in the middle of a device buffer. If
+ * `fade_out_frames` is > 0, the fade-out starts at that point.
+ *
+ * If the mixer has already passed `mixer_frame` (including a `mixer_frame`
+ * of zero), the track stops the next time the mixer runs. Restarting the
+ * track with MIX_PlayTrack() cancels a pending stop, as does calling this
+ * function again with a `mixer_frame` of SDL_MAX_UINT64.
+ *
+ * \param track the track to halt.
+ * \param mixer_frame the mixer clock value where the track should stop, or
+ *                    SDL_MAX_UINT64 to cancel a pending stop.
+ * \param fade_out_frames the number of sample frames to spend fading out to
+ *                        silence before halting. 0 to stop immediately.
+ * \returns true on success, false on error; call SDL_GetError() for details.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_GetMixerClock
+ * \sa MIX_StopTrack
+ */
+extern SDL_DECLSPEC bool SDLCALL MIX_StopTrackAtMixerFrame(MIX_Track *track, Uint64 mixer_frame, Sint64 fade_out_frames);
+
 /**
  * Halt all currently-playing tracks, possibly fading out over time.
  *
@@ -2132,6 +2438,143 @@ extern SDL_DECLSPEC bool SDLCALL MIX_SetTrackFrequencyRatio(MIX_Track *track, fl
  */
 extern SDL_DECLSPEC float SDLCALL MIX_GetTrackFrequencyRatio(MIX_Track *track);
 
+/**
+ * The resampling algorithms available to MIX_SetTrackResampler() and
+ * MIX_SetGroupResampler().
+ *
+ * When a track's audio isn't at the mixer's sample rate, or the track has a
+ * frequency ratio other than 1.0f, its audio has to be resampled. Better
+ * quality costs more CPU time. A music track might want the best quality
+ * available, while hundreds of footstep sounds might be fine with something
+ * cheap.
+ *
+ * \since This enum is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_SetTrackResampler
+ * \sa MIX_SetGroupResampler
+ */
+typedef enum MIX_ResamplerQuality
+{
+    MIX_RESAMPLER_DEFAULT,  /**< For tracks, use the group's setting. For groups, use SDL's built-in resampler. */
+    MIX_RESAMPLER_NEAREST,  /**< Repeat or skip samples. Very cheap, sounds harsh. */
+    MIX_RESAMPLER_LINEAR,   /**< Linear interpolation. Cheap, dulls high frequencies a little. */
+    MIX_RESAMPLER_CUBIC,    /**< Cubic (Catmull-Rom) interpolation. A good compromise. */
+    MIX_RESAMPLER_SINC      /**< Windowed-sinc interpolation with a configurable number of taps. Best quality, most expensive. */
+} MIX_ResamplerQuality;
+
+/**
+ * Choose how a track resamples its audio.
+ *
+ * By default, tracks use their group's setting (see
+ * MIX_SetGroupResampler()), and tracks that aren't in a group, or are in a
+ * group that hasn't chosen, use SDL's built-in resampler.
+ *
+ * `sinc_taps` is only used for MIX_RESAMPLER_SINC. It's the number of input
+ * sample frames that go into each output sample frame; more taps cost more
+ * CPU time but filter more accurately. It must be an even number between 4
+ * and 64. 16 is a reasonable value.
+ *
+ * This can be changed at any time, even while the track is playing.
+ *
+ * \param track the track to change.
+ * \param quality the resampler to use, or MIX_RESAMPLER_DEFAULT to use the
+ *                group's setting.
+ * \param sinc_taps the number of taps for MIX_RESAMPLER_SINC. Ignored
+ *                  otherwise.
+ * \returns true on success or false on failure; call SDL_GetError() for more
+ *          information.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_SetGroupResampler
+ * \sa MIX_SetTrackFrequencyRatio
+ */
+extern SDL_DECLSPEC bool SDLCALL MIX_SetTrackResampler(MIX_Track *track, MIX_ResamplerQuality quality, int sinc_taps);
+
+/**
+ * Choose how tracks in a group resample their audio.
+ *
+ * This applies to all tracks in the group that are using
+ * MIX_RESAMPLER_DEFAULT (which is all tracks, unless they called
+ * MIX_SetTrackResampler()), including tracks added to the group later.
+ * Setting MIX_RESAMPLER_DEFAULT here makes those tracks use SDL's built-in
+ * resampler.
+ *
+ * See MIX_SetTrackResampler() for details on `sinc_taps`.
+ *
+ * \param group the group to change.
+ * \param quality the resampler to use.
+ * \param sinc_taps the number of taps for MIX_RESAMPLER_SINC. Ignored
+ *                  otherwise.
+ * \returns true on success or false on failure; call SDL_GetError() for more
+ *          information.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_SetTrackResampler
+ */
+extern SDL_DECLSPEC bool SDLCALL MIX_SetGroupResampler(MIX_Group *group, MIX_ResamplerQuality quality, int sinc_taps);
+
+/**
+ * Change the tempo of a track without changing its pitch.
+ *
+ * Unlike MIX_SetTrackFrequencyRatio(), which speeds up or slows down audio
+ * like a record player would, this time-stretches the audio so it plays
+ * faster or slower at the same pitch. A value greater than 1.0f will play
+ * the audio faster, a value less than 1.0f will play it slower. 1.0f is
+ * normal speed, and costs nothing extra.
+ *
+ * This is meant for things like music that speeds up as a timer runs low, or
+ * slowed-down dialogue. It works best on music and speech; extreme values
+ * will produce audible artifacts. The stretched audio lags the input by a
+ * few tens of milliseconds.
+ *
+ * This can be combined with MIX_SetTrackFrequencyRatio(); the two multiply
+ * together for the speed, but only the frequency ratio changes pitch.
+ *
+ * The default value is 1.0f.
+ *
+ * This value can be changed at any time to adjust the future mix.
+ *
+ * \param track the track on which to change the tempo.
+ * \param tempo the tempo. Must be between 0.25f and 4.0f.
+ * \returns true on success or false on failure; call SDL_GetError() for more
+ *          information.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_GetTrackTempo
+ * \sa MIX_SetTrackFrequencyRatio
+ */
+extern SDL_DECLSPEC bool SDLCALL MIX_SetTrackTempo(MIX_Track *track, float tempo);
+
+/**
+ * Query the tempo of a track.
+ *
+ * See MIX_SetTrackTempo() for details.
+ *
+ * On various errors (MIX_Init() was not called, the track is NULL), this
+ * returns 0.0f. Since this is not a valid value to set, this can be seen as
+ * an error state.
+ *
+ * \param track the track on which to query the tempo.
+ * \returns the current tempo, or 0.0f on failure; call SDL_GetError() for
+ *          more information.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_SetTrackTempo
+ */
+extern SDL_DECLSPEC float SDLCALL MIX_GetTrackTempo(MIX_Track *track);
+
 
 /* channel maps... */
 
@@ -2254,10 +2697,10 @@ typedef struct MIX_Point3D
  * Set a track's position in 3D space.
  *
  * (Please note that SDL_mixer is not intended to be a extremely powerful 3D
- * API. It lacks 3D features that other APIs like OpenAL offer: there's no
- * doppler effect, distance models, rolloff, etc. This is meant to be Good
- * Enough for games that can use some positional sounds and can even take
- * advantage of surround-sound configurations.)
+ * API. It lacks 3D features that other APIs like OpenAL offer: there are no
+ * configurable distance models, rolloff, etc. This is meant to be Good Enough
+ * for games that can use some positional sounds and can even take advantage
+ * of surround-sound configurations.)
  *
  * If `position` is not NULL, this track will be switched into 3D positional
  * mode. If `position` is NULL, this will disable positional mixing (both the
@@ -2315,6 +2758,141 @@ extern SDL_DECLSPEC bool SDLCALL MIX_SetTrack3DPosition(MIX_Track *track, const
  */
 extern SDL_DECLSPEC bool SDLCALL MIX_GetTrack3DPosition(MIX_Track *track, MIX_Point3D *position);
 
+/**
+ * Set a track's velocity in 3D space, for the Doppler effect.
+ *
+ * If a track is in 3D positional mode (see MIX_SetTrack3DPosition()), its
+ * velocity, along with the listener's velocity (see
+ * MIX_SetListener3DVelocity()), is used to shift the track's pitch as it
+ * moves toward or away from the listener.
+ *
+ * Velocity is in units per second, in the same coordinate system as
+ * MIX_Point3D. The speed of sound is 343.3 units per second by default, so
+ * it's reasonable to think of a unit as a meter; apps using a different scale
+ * can change it with the `MIX_PROP_MIXER_SPEED_OF_SOUND_FLOAT` property (see
+ * MIX_GetMixerProperties()).
+ *
+ * The velocity doesn't move the track; the app is still responsible for
+ * updating the track's position. The Doppler shift is recalculated each time
+ * the mixer needs more audio, and changes are ramped smoothly across the mixed
+ * audio, so the app does not need to update this at any specific rate.
+ *
+ * The Doppler shift is limited to between 0.5 and 2.0 times the track's
+ * frequency (one octave down or up), no matter how fast things are moving.
+ * It is applied in addition to any frequency ratio set with
+ * MIX_SetTrackFrequencyRatio(), and MIX_GetTrackFrequencyRatio() does not
+ * report it. The combined ratio is limited to the same 0.01f to 100.0f range
+ * that MIX_SetTrackFrequencyRatio() allows.
+ *
+ * If `velocity` is NULL, the track's velocity is set to (0,0,0). Tracks
+ * default to a velocity of (0,0,0).
+ *
+ * \param track the track for which to set 3D velocity.
+ * \param velocity the new 3D velocity for the track. May be NULL.
+ * \returns true on success or false on failure; call SDL_GetError() for more
+ *          information.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_GetMixerProperties
+ * \sa MIX_GetTrack3DVelocity
+ * \sa MIX_SetListener3DVelocity
+ * \sa MIX_SetTrack3DPosition
+ */
+extern SDL_DECLSPEC bool SDLCALL MIX_SetTrack3DVelocity(MIX_Track *track, const MIX_Point3D *velocity);
+
+/**
+ * Get a track's current velocity in 3D space.
+ *
+ * \param track the track to query.
+ * \param velocity on successful return, will contain the track's velocity.
+ * \returns true on success or false on failure; call SDL_GetError() for more
+ *          information.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_SetTrack3DVelocity
+ */
+extern SDL_DECLSPEC bool SDLCALL MIX_GetTrack3DVelocity(MIX_Track *track, MIX_Point3D *velocity);
+
+/**
+ * Set the listener's velocity in 3D space, for the Doppler effect.
+ *
+ * The listener is always at coordinate (0,0,0), but it can still be moving,
+ * which affects the Doppler shift of every 3D track on this mixer. See
+ * MIX_SetTrack3DVelocity() for details.
+ *
+ * If `velocity` is NULL, the listener's velocity is set to (0,0,0), which is
+ * the default.
+ *
+ * \param mixer the mixer whose listener should change.
+ * \param velocity the new 3D velocity for the listener. May be NULL.
+ * \returns true on success or false on failure; call SDL_GetError() for more
+ *          information.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_SetTrack3DVelocity
+ */
+extern SDL_DECLSPEC bool SDLCALL MIX_SetListener3DVelocity(MIX_Mixer *mixer, const MIX_Point3D *velocity);
+
+/**
+ * Set the order of a mixer's ambisonic bus.
+ *
+ * By default (order 0), tracks positioned with MIX_SetTrack3DPosition() are
+ * panned directly to the nearest speakers. With an ambisonic bus, 3D tracks
+ * are instead encoded into an Ambisonic sound field, which is decoded to the
+ * output speakers once per mixing group.
+ *
+ * This gives smoother movement as sounds travel between speakers, and makes
+ * the cost of spatialization less dependent on the number of tracks and
+ * speakers, as the decode happens once per group instead of once per track.
+ *
+ * Higher orders are more precise about direction, at a higher CPU cost. The
+ * order can be 0 (disabled), 1, 2, or 3. Orders beyond what the output's
+ * speaker layout can resolve are accepted, but don't improve the results.
+ * Mono and stereo outputs only benefit from first order.
+ *
+ * Group postmix callbacks see the decoded audio, not the ambisonic data.
+ *
+ * Tracks in forced-stereo mode (MIX_SetTrackStereo()) and tracks without any
+ * positioning are not affected by this setting.
+ *
+ * \param mixer the mixer to change.
+ * \param order the ambisonic order to use, from 0 to 3.
+ * \returns true on success or false on failure; call SDL_GetError() for more
+ *          information.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_GetAmbisonicOrder
+ * \sa MIX_SetTrack3DPosition
+ */
+extern SDL_DECLSPEC bool SDLCALL MIX_SetAmbisonicOrder(MIX_Mixer *mixer, int order);
+
+/**
+ * Get the order of a mixer's ambisonic bus.
+ *
+ * \param mixer the mixer to query.
+ * \returns the current ambisonic order, or 0 if the ambisonic bus is
+ *          disabled (or if `mixer` is invalid).
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_SetAmbisonicOrder
+ */
+extern SDL_DECLSPEC int SDLCALL MIX_GetAmbisonicOrder(MIX_Mixer *mixer);
+
 
 /* Mix groups... */
 
@@ -2427,6 +3005,374 @@ extern SDL_DECLSPEC MIX_Mixer * SDLCALL MIX_GetGroupMixer(MIX_Group *group);
 extern SDL_DECLSPEC bool SDLCALL MIX_SetTrackGroup(MIX_Track *track, MIX_Group *group);
 
 
+/* Filters... */
+
+/**
+ * The types of filters available to MIX_SetTrackFilters() and
+ * MIX_SetGroupFilters().
+ *
+ * These are the classic "biquad" filters, as described in Robert
+ * Bristow-Johnson's "Audio EQ Cookbook".
+ *
+ * \since This enum is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_Filter
+ */
+typedef enum MIX_FilterType
+{
+    MIX_FILTER_LOWPASS,    /**< Remove frequencies above `frequency`. Good for muffled sounds: occlusion, underwater, etc. */
+    MIX_FILTER_HIGHPASS,   /**< Remove frequencies below `frequency`. Good for tinny sounds: radios, telephones, etc. */
+    MIX_FILTER_BANDPASS,   /**< Keep only frequencies around `frequency`. */
+    MIX_FILTER_NOTCH,      /**< Remove only frequencies around `frequency`. */
+    MIX_FILTER_PEAKING,    /**< Boost or cut frequencies around `frequency` by `gain_db`. */
+    MIX_FILTER_LOWSHELF,   /**< Boost or cut frequencies below `frequency` by `gain_db`. */
+    MIX_FILTER_HIGHSHELF   /**< Boost or cut frequencies above `frequency` by `gain_db`. */
+} MIX_FilterType;
+
+/**
+ * A description of a single filter, for MIX_SetTrackFilters() and
+ * MIX_SetGroupFilters().
+ *
+ * `q` controls how wide the filter's effect is; smaller values affect a wider
+ * range of frequencies. 0.7071f is a good default for low-pass and high-pass
+ * filters (it's the flattest response without a resonant peak). Larger
+ * values make low-pass and high-pass filters resonate at `frequency`.
+ *
+ * `gain_db` is only used for MIX_FILTER_PEAKING, MIX_FILTER_LOWSHELF, and
+ * MIX_FILTER_HIGHSHELF, and is ignored by other filter types.
+ *
+ * \since This struct is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_SetTrackFilters
+ * \sa MIX_SetGroupFilters
+ */
+typedef struct MIX_Filter
+{
+    MIX_FilterType type;  /**< the type of filter. */
+    float frequency;  /**< the filter's cutoff/center frequency, in Hz. */
+    float q;   /**< the filter's Q factor (resonance/bandwidth). Must be > 0.0f. */
+    float gain_db;  /**< boost (positive) or cut (negative), in decibels, for peaking and shelving filters. */
+} MIX_Filter;
+
+/**
+ * Set a chain of filters to apply to a track.
+ *
+ * Filters are applied in order, each one processing the output of the
+ * previous one. Up to 4 filters can be chained on a track. They are applied
+ * after the track has been converted to the mixer's sample rate and had its
+ * own gain (see MIX_SetTrackGain()) applied, right before the track's cooked
+ * callback (see MIX_SetTrackCookedCallback()) would run. The master gain,
+ * loudness normalization, and any stereo or 3D positioning are applied after
+ * the filters, as the track is mixed, so 3D tracks are filtered while they
+ * are still mono.
+ *
+ * This is much cheaper than implementing filters in a cooked callback, and
+ * it's safe to use on a large number of tracks at once.
+ *
+ * It's safe to call this frequently, for example to adjust the cutoff of an
+ * occlusion filter as a sound moves behind a wall. Changes to existing
+ * filters are smoothed over the next block of mixed audio, so they don't
+ * produce clicks. Changing a filter's type, or adding new filters, resets
+ * that filter.
+ *
+ * The array of filters is copied; the app does not need to keep it around
+ * after this call.
+ *
+ * Setting `count` to zero (and `filters` to NULL) removes all filters.
+ *
+ * \param track the track to filter.
+ * \param filters an array of `count` filters to apply. May be NULL if
+ *                `count` is zero.
+ * \param count the number of filters in the array, between 0 and 4.
+ * \returns true on success or false on failure; call SDL_GetError() for more
+ *          information.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_SetGroupFilters
+ */
+extern SDL_DECLSPEC bool SDLCALL MIX_SetTrackFilters(MIX_Track *track, const MIX_Filter *filters, int count);
+
+/**
+ * Set a chain of filters to apply to a mixing group.
+ *
+ * This works like MIX_SetTrackFilters(), but is applied to the mixed output
+ * of all tracks in a group, right before the group's postmix callback (see
+ * MIX_SetGroupPostMixCallback()) would run. This is useful for applying the
+ * same effect to many tracks at once for the cost of one filter chain.
+ *
+ * \param group the group to filter.
+ * \param filters an array of `count` filters to apply. May be NULL if
+ *                `count` is zero.
+ * \param count the number of filters in the array, between 0 and 4.
+ * \returns true on success or false on failure; call SDL_GetError() for more
+ *          information.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_SetTrackFilters
+ */
+extern SDL_DECLSPEC bool SDLCALL MIX_SetGroupFilters(MIX_Group *group, const MIX_Filter *filters, int count);
+
+
+/* Dynamics... */
+
+/**
+ * Set up a compressor and look-ahead limiter on a mixer's final output.
+ *
+ * Summing lots of loud tracks can push the mix past full volume, which
+ * clips. A limiter smoothly turns the volume down just before a peak would
+ * go over a ceiling, and back up afterwards, so the output never clips. A
+ * compressor evens out the overall level by turning down audio that gets
+ * louder than a threshold.
+ *
+ * The limiter delays the mixer's output by its look-ahead time, so it can
+ * see peaks coming.
+ *
+ * When dynamics processing is enabled, tracks and groups are summed without
+ * clamping, so the limiter sees the real peaks instead of audio that was
+ * already clipped along the way.
+ *
+ * Dynamics processing runs after all groups are mixed together, before the
+ * mixer's postmix callback (see MIX_SetPostMixCallback()).
+ *
+ * These are the supported properties:
+ *
+ * - `MIX_PROP_DYNAMICS_LIMITER_ENABLED_BOOLEAN`: true to use the limiter.
+ *   Default true.
+ * - `MIX_PROP_DYNAMICS_LIMITER_CEILING_FLOAT`: the maximum output level, in
+ *   decibels relative to full scale. Must be <= 0.0f. Default -1.0f.
+ * - `MIX_PROP_DYNAMICS_LIMITER_LOOKAHEAD_FLOAT`: how far ahead the limiter
+ *   looks for peaks, in milliseconds. This is also how long the limiter takes
+ *   to turn the volume down, and how much latency it adds. Between 0.1f and
+ *   100.0f. Default 5.0f.
+ * - `MIX_PROP_DYNAMICS_LIMITER_RELEASE_FLOAT`: how quickly the limiter turns
+ *   the volume back up after a peak, in milliseconds. Default 50.0f.
+ * - `MIX_PROP_DYNAMICS_COMPRESSOR_ENABLED_BOOLEAN`: true to use the
+ *   compressor. It runs before the limiter. Default false.
+ * - `MIX_PROP_DYNAMICS_COMPRESSOR_THRESHOLD_FLOAT`: the level, in decibels
+ *   relative to full scale, above which the compressor turns the volume
+ *   down. Must be <= 0.0f. Default -18.0f.
+ * - `MIX_PROP_DYNAMICS_COMPRESSOR_RATIO_FLOAT`: how much the compressor turns
+ *   the volume down. For a ratio of 4.0f, audio that is 4 decibels over the
+ *   threshold is reduced to 1 decibel over. Must be >= 1.0f. Default 4.0f.
+ * - `MIX_PROP_DYNAMICS_COMPRESSOR_ATTACK_FLOAT`: how quickly the compressor
+ *   turns the volume down, in milliseconds. Default 10.0f.
+ * - `MIX_PROP_DYNAMICS_COMPRESSOR_RELEASE_FLOAT`: how quickly the compressor
+ *   turns the volume back up, in milliseconds. Default 100.0f.
+ * - `MIX_PROP_DYNAMICS_COMPRESSOR_WINDOW_FLOAT`: the time, in milliseconds,
+ *   over which the compressor measures the audio's (RMS) level. Default
+ *   10.0f.
+ * - `MIX_PROP_DYNAMICS_COMPRESSOR_MAKEUP_GAIN_FLOAT`: gain, in decibels, to
+ *   apply after compression, to make up for the lost volume. Default 0.0f.
+ *
+ * The properties are read during this call; changing them later has no
+ * effect until this function is called again. Each call replaces the
+ * previous settings and resets the processing state.
+ *
+ * If `props` is zero, dynamics processing is disabled.
+ *
+ * \param mixer the mixer to change.
+ * \param props a set of properties that configure the dynamics processing.
+ *              May be zero.
+ * \returns true on success or false on failure; call SDL_GetError() for more
+ *          information.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_SetGroupDynamics
+ * \sa MIX_GetMixerGainReduction
+ */
+extern SDL_DECLSPEC bool SDLCALL MIX_SetMixerDynamics(MIX_Mixer *mixer, SDL_PropertiesID props);
+
+#define MIX_PROP_DYNAMICS_LIMITER_ENABLED_BOOLEAN "SDL_mixer.dynamics.limiter.enabled"
+#define MIX_PROP_DYNAMICS_LIMITER_CEILING_FLOAT "SDL_mixer.dynamics.limiter.ceiling"
+#define MIX_PROP_DYNAMICS_LIMITER_LOOKAHEAD_FLOAT "SDL_mixer.dynamics.limiter.lookahead"
+#define MIX_PROP_DYNAMICS_LIMITER_RELEASE_FLOAT "SDL_mixer.dynamics.limiter.release"
+#define MIX_PROP_DYNAMICS_COMPRESSOR_ENABLED_BOOLEAN "SDL_mixer.dynamics.compressor.enabled"
+#define MIX_PROP_DYNAMICS_COMPRESSOR_THRESHOLD_FLOAT "SDL_mixer.dynamics.compressor.threshold"
+#define MIX_PROP_DYNAMICS_COMPRESSOR_RATIO_FLOAT "SDL_mixer.dynamics.compressor.ratio"
+#define MIX_PROP_DYNAMICS_COMPRESSOR_ATTACK_FLOAT "SDL_mixer.dynamics.compressor.attack"
+#define MIX_PROP_DYNAMICS_COMPRESSOR_RELEASE_FLOAT "SDL_mixer.dynamics.compressor.release"
+#define MIX_PROP_DYNAMICS_COMPRESSOR_WINDOW_FLOAT "SDL_mixer.dynamics.compressor.window"
+#define MIX_PROP_DYNAMICS_COMPRESSOR_MAKEUP_GAIN_FLOAT "SDL_mixer.dynamics.compressor.makeup_gain"
+
+/**
+ * Set up a compressor and look-ahead limiter on a mixing group.
+ *
+ * This works just like MIX_SetMixerDynamics(), but processes the mixed
+ * output of a single group, before the group's postmix callback (see
+ * MIX_SetGroupPostMixCallback()). This is useful for keeping one category of
+ * sounds (a music group, or a pile of explosions) in check without affecting
+ * the rest of the mix.
+ *
+ * Note that a limiter delays the group's audio by its look-ahead time,
+ * relative to other groups.
+ *
+ * \param group the group to change.
+ * \param props a set of properties that configure the dynamics processing.
+ *              May be zero.
+ * \returns true on success or false on failure; call SDL_GetError() for more
+ *          information.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_SetMixerDynamics
+ * \sa MIX_GetGroupGainReduction
+ */
+extern SDL_DECLSPEC bool SDLCALL MIX_SetGroupDynamics(MIX_Group *group, SDL_PropertiesID props);
+
+/**
+ * Query how much a mixer's dynamics processing is reducing the volume.
+ *
+ * This reports the most gain reduction (compressor and limiter combined)
+ * applied during the most-recently mixed buffer, in decibels. Zero means no
+ * reduction. This is useful for metering in a UI.
+ *
+ * This does not block, so it's cheap to call every frame.
+ *
+ * \param mixer the mixer to query.
+ * \returns the current gain reduction in decibels, zero if none or if
+ *          dynamics processing is disabled.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_SetMixerDynamics
+ */
+extern SDL_DECLSPEC float SDLCALL MIX_GetMixerGainReduction(MIX_Mixer *mixer);
+
+/**
+ * Query how much a group's dynamics processing is reducing the volume.
+ *
+ * This works like MIX_GetMixerGainReduction(), but for a group's dynamics
+ * processing (see MIX_SetGroupDynamics()).
+ *
+ * \param group the group to query.
+ * \returns the current gain reduction in decibels, zero if none or if
+ *          dynamics processing is disabled.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_SetGroupDynamics
+ */
+extern SDL_DECLSPEC float SDLCALL MIX_GetGroupGainReduction(MIX_Group *group);
+
+
+
+/* Metering... */
+
+/**
+ * Enable or disable peak/RMS metering on a mixer.
+ *
+ * When metering is enabled, SDL_mixer measures the peak and RMS levels of
+ * each track, each group, and the final mix as it mixes them. Most of this
+ * happens inside the loops that are mixing the audio anyhow, so it's much
+ * cheaper than measuring the data in a MIX_TrackMixCallback or
+ * MIX_GroupMixCallback.
+ *
+ * To lower the cost further, `interval` lets the mixer measure only one of
+ * every `interval` buffers it mixes; a UI that redraws 30 times a second
+ * probably doesn't need every buffer measured. Note that peaks in the
+ * buffers that aren't measured will be missed!
+ *
+ * An `interval` of zero disables metering (the default), which resets all
+ * the mixer's meters to zero.
+ *
+ * \param mixer the mixer to meter.
+ * \param interval measure one of every `interval` buffers. 1 to measure
+ *                 every buffer, 0 to disable metering.
+ * \returns true on success, false on error; call SDL_GetError() for details.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_GetMixerMeter
+ * \sa MIX_GetGroupMeter
+ * \sa MIX_GetTrackMeter
+ */
+extern SDL_DECLSPEC bool SDLCALL MIX_SetMixerMetering(MIX_Mixer *mixer, int interval);
+
+/**
+ * Query the levels of a mixer's final mix.
+ *
+ * This reports the levels of the most-recently measured buffer, after
+ * dynamics processing but before the mixer's postmix callback (see
+ * MIX_SetPostMixCallback()), so it can be measured as part of the mixing
+ * itself. Values are linear amplitudes, where 1.0f is full scale. The peak
+ * is the largest absolute sample and the RMS is across all channels.
+ *
+ * Metering must be enabled with MIX_SetMixerMetering(), or these will be
+ * zero.
+ *
+ * This does not block, so it's cheap to call every frame.
+ *
+ * \param mixer the mixer to query.
+ * \param peak on return, filled with the peak level. Can be NULL.
+ * \param rms on return, filled with the RMS level. Can be NULL.
+ * \returns true on success, false on error; call SDL_GetError() for details.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_SetMixerMetering
+ */
+extern SDL_DECLSPEC bool SDLCALL MIX_GetMixerMeter(MIX_Mixer *mixer, float *peak, float *rms);
+
+/**
+ * Query the levels of a group's mix.
+ *
+ * This works like MIX_GetMixerMeter(), but measures a group's output after
+ * its filters, dynamics processing and postmix callback, before it's added
+ * to the final mix.
+ *
+ * \param group the group to query.
+ * \param peak on return, filled with the peak level. Can be NULL.
+ * \param rms on return, filled with the RMS level. Can be NULL.
+ * \returns true on success, false on error; call SDL_GetError() for details.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_SetMixerMetering
+ */
+extern SDL_DECLSPEC bool SDLCALL MIX_GetGroupMeter(MIX_Group *group, float *peak, float *rms);
+
+/**
+ * Query the levels of a track.
+ *
+ * This works like MIX_GetMixerMeter(), but measures a track's output, with
+ * the mixer's gain applied, before it's positioned or panned. Tracks that
+ * aren't playing report zero.
+ *
+ * \param track the track to query.
+ * \param peak on return, filled with the peak level. Can be NULL.
+ * \param rms on return, filled with the RMS level. Can be NULL.
+ * \returns true on success, false on error; call SDL_GetError() for details.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_SetMixerMetering
+ */
+extern SDL_DECLSPEC bool SDLCALL MIX_GetTrackMeter(MIX_Track *track, float *peak, float *rms);
+
+
 
 /* Hooks... */
 
@@ -93,6 +93,14 @@ static MIX_Audio *all_audios = NULL;
 static MIX_AudioDecoder *all_audiodecoders = NULL;
 static SDL_Mutex *global_lock = NULL;
 
+// precached audio builds its seek table on a single background thread, one MIX_Audio at a time, in the order they loaded.
+static SDL_Mutex *seek_index_lock = NULL;
+static SDL_Condition *seek_index_cond = NULL;
+static SDL_Thread *seek_index_thread = NULL;
+static MIX_Audio *seek_index_queue = NULL;
+static MIX_Audio *seek_index_busy = NULL;  // the MIX_Audio the thread is working on right now.
+static bool seek_index_quit = false;
+
 #if defined(SDL_NEON_INTRINSICS) && SDL_MIXER_NEED_SCALAR_FALLBACK
 bool MIX_HasNEON = false;
 #endif
@@ -185,11 +193,118 @@ static bool SetTrackOutputStreamFormat(MIX_Track *track, const SDL_AudioSpec *sp
         track->output_spec.channels = 2;
     }
 
+    if (spec) {
+        SDL_copyp(&track->input_spec, spec);
+        if (track->resampler) {
+            MIX_ResetResampler(track->resampler);  // new input, don't mix in the old one's history.
+        }
+        if (track->timestretch) {
+            MIX_ResetTimeStretch(track->timestretch);
+        }
+    }
+
+    // if we're doing our own resampling, SDL_AudioStream gets data that's already at the mixer's sample rate.
+    SDL_AudioSpec resampled_spec;
+    if (track->resampler && spec) {
+        SDL_copyp(&resampled_spec, spec);
+        resampled_spec.freq = track->output_spec.freq;
+        spec = &resampled_spec;
+    } else if (track->resampler && track->input_spec.freq) {
+        SDL_copyp(&resampled_spec, &track->input_spec);
+        resampled_spec.freq = track->output_spec.freq;
+        spec = &resampled_spec;
+    }
+
     const bool retval = SDL_SetAudioStreamFormat(track->output_stream, spec, &track->output_spec);   // input is `spec`, output is to mixer->output_stream (or, if spatializing, to mixer->output_stream but mono...if force_stereo, output_stream but stereo).
     SDL_assert(retval != false);
     return retval;
 }
 
+// size the time-stretcher (if any) for the current input and everything queued behind it, at `tempo`, so the audio thread
+//  never has to allocate for it. Call this off the audio thread whenever the tempo or the input changes.
+// this assumes LockTrack(track) was called before this.
+static bool ReserveTrackTimeStretch(MIX_Track *track, float tempo)
+{
+    MIX_TimeStretch *timestretch = track->timestretch;
+    if (!timestretch) {
+        return true;  // nothing to do.
+    } else if (track->input_spec.freq && !MIX_ReserveTimeStretch(timestretch, track->input_spec.channels, track->input_spec.freq, tempo)) {
+        return false;
+    }
+
+    for (const MIX_TrackQueueItem *item = track->queue; item; item = item->next) {
+        if (!MIX_ReserveTimeStretch(timestretch, item->audio->spec.channels, item->audio->spec.freq, tempo)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// this assumes LockTrack(track) was called before this. `ratio` is the frequency ratio with Doppler shift already applied.
+static bool SetTrackOutputRatio(MIX_Track *track, float ratio)
+{
+    ratio = SDL_clamp(ratio, 0.01f, 100.0f);
+    if (ratio == track->output_ratio) {
+        return true;  // don't touch the stream if nothing changed.
+    }
+    track->output_ratio = ratio;
+    if (track->resampler) {
+        return true;  // TrackGetCallback will use this when it resamples.
+    }
+    return SDL_SetAudioStreamFrequencyRatio(track->output_stream, track->output_ratio);
+}
+
+// this assumes LockTrack(track) was called before this, and the track's group can't change under us.
+static bool UpdateTrackResampler(MIX_Track *track)
+{
+    MIX_ResamplerQuality quality = track->resampler_quality;
+    int taps = track->resampler_taps;
+    if ((quality == MIX_RESAMPLER_DEFAULT) && track->group) {
+        quality = track->group->resampler_quality;
+        taps = track->group->resampler_taps;
+    }
+
+    MIX_Resampler *resampler = track->resampler;
+    if (quality == MIX_RESAMPLER_DEFAULT) {
+        if (!resampler) {
+            return true;  // nothing to do.
+        }
+        track->resampler = NULL;
+        SetTrackOutputStreamFormat(track, NULL);  // let SDL_AudioStream resample from the input's real sample rate again.
+        bool retval = SDL_SetAudioStreamFrequencyRatio(track->output_stream, track->output_ratio);
+
+        // hand SDL_AudioStream the input our resampler hadn't gotten to yet, so playback carries on from the same spot.
+        const float *pending = NULL;
+        const int pending_frames = MIX_GetResamplerInput(resampler, &pending);
+        if (pending_frames > 0) {
+            retval = SDL_PutAudioStreamData(track->output_stream, pending, pending_frames * resampler->channels * sizeof (float)) && retval;
+        }
+        MIX_DestroyResampler(resampler);
+        return retval;
+    }
+
+    if (resampler && (resampler->quality == quality) && ((quality != MIX_RESAMPLER_SINC) || (resampler->taps == taps))) {
+        return true;  // already set up like this.
+    }
+
+    resampler = MIX_CreateResampler(quality, taps);  // this builds any tables now, so the audio thread doesn't have to.
+    if (!resampler) {
+        return false;
+    } else if (track->resampler && !MIX_TransferResamplerHistory(resampler, track->resampler)) {  // pick up right where the old one left off.
+        MIX_DestroyResampler(resampler);
+        return false;
+    }
+
+    const bool had_resampler = (track->resampler != NULL);
+    MIX_DestroyResampler(track->resampler);
+    track->resampler = resampler;
+    if (!had_resampler) {
+        SetTrackOutputStreamFormat(track, NULL);  // SDL_AudioStream now gets data at the mixer's sample rate.
+        SDL_SetAudioStreamFrequencyRatio(track->output_stream, 1.0f);
+    }
+    return true;
+}
+
 // catch events to see if output device format has changed. This can let us move to/from surround sound support on the fly, not to mention spend less time doing unnecessary conversions.
 static bool SDLCALL AudioDeviceChangeEventWatcher(void *userdata, SDL_Event *event)
 {
@@ -211,6 +326,18 @@ static bool SDLCALL AudioDeviceChangeEventWatcher(void *userdata, SDL_Event *eve
         mixer->spec.format = SDL_AUDIO_F32;
         if (SDL_SetAudioStreamFormat(mixer->output_stream, &mixer->spec, NULL)) {
             MIX_VBAP2D_Init(&mixer->vbap2d, mixer->spec.channels);  // deal with channel count changing.
+            if (mixer->ambisonic_order) {
+                MIX_AmbisonicDecoder_Init(&mixer->ambisonic_decoder, mixer->ambisonic_order, mixer->spec.channels);  // tracks encode independent of speaker layout, so only the decoder cares.
+            }
+            // reallocate dynamics processing here, instead of making MixerCallback do it.
+            if (mixer->dynamics) {
+                MIX_SetDynamicsFormat(mixer->dynamics, mixer->spec.channels, mixer->spec.freq);
+            }
+            for (MIX_Group *group = mixer->all_groups; group; group = group->next) {
+                if (group->dynamics) {
+                    MIX_SetDynamicsFormat(group->dynamics, mixer->spec.channels, mixer->spec.freq);
+                }
+            }
             for (MIX_Track *track = mixer->all_tracks; track; track = track->next) {
                 LockTrack(track);
                 SetTrackOutputStreamFormat(track, NULL);   // input is from internal_stream, output is to mixer->output_stream (or, if spatializing, to mixer->output_stream but mono).
@@ -226,11 +353,33 @@ static bool SDLCALL AudioDeviceChangeEventWatcher(void *userdata, SDL_Event *eve
     return true;
 }
 
+// this assumes LockTrack(track) was called before this.
+static void RetireTrackInput(MIX_Track *track, MIX_TrackQueueItem *item)
+{
+    item->next = track->retired;
+    track->retired = item;
+}
+
+// this assumes LockTrack(track) was called before this.
+static void EndTrackCrossfade(MIX_Track *track)
+{
+    MIX_TrackQueueItem *next = NULL;
+    for (MIX_TrackQueueItem *from = track->crossfade_from; from; from = next) {
+        next = from->next;
+        RetireTrackInput(track, from);
+    }
+    track->crossfade_from = NULL;
+    track->crossfade_frames = 0;
+}
+
 // this assumes LockTrack(track) was called before this.
 static void TrackStopped(MIX_Track *track)
 {
     SDL_assert(track->state != MIX_STATE_STOPPED);  // shouldn't be already stopped at this point.
     track->state = MIX_STATE_STOPPED;
+    track->start_mixer_frame = 0;
+    track->stop_mixer_frame = MIX_UNSCHEDULED_MIXER_FRAME;
+    EndTrackCrossfade(track);
     if (track->stopped_callback) {
         track->stopped_callback(track->stopped_callback_userdata, track);
     }
@@ -247,6 +396,25 @@ static void TrackStopped(MIX_Track *track)
     }
 }
 
+static void StopTrack(MIX_Track *track, Sint64 fadeOut)
+{
+    LockTrack(track);
+    if (track->state != MIX_STATE_STOPPED) {
+        if (fadeOut <= 0) {  // stop immediately.
+            if (track->internal_stream) {
+                SDL_ClearAudioStream(track->internal_stream);  // make sure we don't leave old data hanging around.
+            }
+            TrackStopped(track);
+        } else {
+            track->total_fade_frames = fadeOut;
+            track->fade_frames = track->total_fade_frames;
+            track->fade_frames = fadeOut;
+            track->fade_direction = -1;
+        }
+    }
+    UnlockTrack(track);
+}
+
 static void ApplyFade(MIX_Track *track, int channels, float *pcm, int frames)
 {
     // !!! FIXME: this is probably pretty naive.
@@ -315,6 +483,38 @@ static bool DecodeMore(MIX_Track *track, int bytes_needed)
     return retval;
 }
 
+// Decoders with decode_into can write straight to our buffer, skipping the trip through input_stream. We only do this when
+//  input_stream has nothing buffered (queued inputs arrive prebuffered, for example), since it would otherwise come first.
+// Returns bytes written (zero at the end of the data), or -1 if the caller should go through input_stream instead.
+static int DecodeDirectly(MIX_Track *track, float *pcm, int bytes_needed)
+{
+    const MIX_Audio *audio = track->input_audio;
+    const MIX_Decoder *decoder = audio->decoder;
+    if (!decoder->decode_into || (audio->spec.format != SDL_AUDIO_F32) || (track->input_stream != track->internal_stream)) {
+        return -1;
+    } else if (SDL_GetAudioStreamAvailable(track->input_stream) != 0) {
+        return -1;
+    }
+
+    const int channels = audio->spec.channels;
+    const int framesize = SDL_AUDIO_FRAMESIZE(audio->spec);
+    const int frames_needed = bytes_needed / framesize;
+    if (frames_needed == 0) {
+        return -1;  // less than a frame? Let the stream sort it out.
+    }
+
+    int frames = 0;
+    while (frames < frames_needed) {
+        const int rc = decoder->decode_into(track->decoder_userdata, pcm + (frames * channels), frames_needed - frames);
+        if (rc <= 0) {
+            break;  // end of data (or failure), or the decoder is stalled; hand back what we got instead of spinning here.
+        }
+        frames += rc;
+    }
+
+    return frames * framesize;
+}
+
 static int FillSilenceFrames(MIX_Track *track, void *buffer, int channels, int buflen)
 {
     SDL_assert(track->silence_frames > 0);
@@ -328,6 +528,174 @@ static int FillSilenceFrames(MIX_Track *track, void *buffer, int channels, int b
     return br;
 }
 
+// Switch a track to an input that's already set up (from PrepareTrackQueueItem), without doing any decoder setup or
+//  teardown here, since this might be on the audio thread. `item` is reused to hold the old input, and returned, so
+//  the caller can put it on track->retired, to be cleaned up later by something that isn't the audio thread.
+// this assumes LockTrack(track) was called before this.
+static MIX_TrackQueueItem *SwapTrackInput(MIX_Track *track, MIX_TrackQueueItem *item)
+{
+    MIX_Audio *audio = item->audio;
+    void *decoder_userdata = item->decoder_userdata;
+    SDL_IOStream *io = item->io;
+    SDL_AudioStream *stream = item->stream;
+
+    // reuse the queue item to hold on to the old input.
+    item->audio = track->input_audio;
+    item->decoder_userdata = track->decoder_userdata;
+    item->io = track->io;
+    item->clamped_io = track->clamped_io;  // the IoClamp (if any) belongs to item->io, so the old decoder can keep reading through it while it fades out.
+    item->closeio = track->closeio;
+    item->stream = track->internal_stream;
+    item->next = NULL;
+
+    track->clamped_io = NULL;
+    track->input_audio = audio;
+    track->decoder_userdata = decoder_userdata;
+    track->io = io;
+    track->closeio = true;
+    track->internal_stream = stream;
+    track->input_stream = stream;
+
+    SDL_AudioSpec spec;
+    SDL_GetAudioStreamFormat(stream, NULL, &spec);
+    SetTrackOutputStreamFormat(track, &spec);   // input is from internal_stream, output is to mixer->output_stream (or, if spatializing, to mixer->output_stream but mono).
+
+    // new input plays once, from the start, with default options.
+    track->position = 0;
+    track->max_frame = -1;
+    track->loops_remaining = 0;
+    track->loop_start = 0;
+    track->total_fade_frames = 0;
+    track->fade_frames = 0;
+    track->fade_direction = 0;
+    track->silence_frames = 0;
+    track->normalization_gain = 1.0f;
+
+    return item;
+}
+
+// Switch a track to the first input from MIX_QueueTrackAudio. Returns false if nothing was queued.
+// this assumes LockTrack(track) was called before this.
+static bool StartQueuedTrackAudio(MIX_Track *track)
+{
+    MIX_TrackQueueItem *item = track->queue;
+    if (!item) {
+        return false;
+    }
+
+    track->queue = item->next;
+    EndTrackCrossfade(track);  // the outgoing audio is in the wrong format for the new input now.
+    RetireTrackInput(track, SwapTrackInput(track, item));
+    return true;
+}
+
+// gain for audio fading in during a crossfade, where `t` goes from 0.0f to 1.0f. Fading out is the same curve, backwards.
+static float CrossfadeGain(MIX_CrossfadeCurve curve, float t)
+{
+    if (curve == MIX_CROSSFADE_EQUAL_POWER) {   // keeps the total power constant, so uncorrelated audio doesn't dip in the middle.
+        return SDL_sinf(t * (SDL_PI_F / 2.0f));
+    }
+    return t;
+}
+
+// Mix one outgoing input of a MIX_CrossfadeTrackAudio into `pcm`, which is the incoming input, in the same format.
+//  Returns false if `from` is done, because it finished fading out or ran out of audio.
+// this assumes LockTrack(track) was called before this.
+static bool MixCrossfadeOutput(MIX_Track *track, MIX_TrackQueueItem *from, int channels, float *pcm, int frames)
+{
+    const int framesize = channels * (int) sizeof (float);
+    const int chunk_frames = MIX_CROSSFADE_BUFFER_BYTES / framesize;
+    const int to_be_faded = (int) SDL_min(from->crossfade_frames, frames);
+    const float total = (float) from->crossfade_total_frames;
+    const float position = (float) (from->crossfade_total_frames - from->crossfade_frames);
+
+    int done = 0;
+    while (done < to_be_faded) {
+        const int needed = SDL_min(chunk_frames, to_be_faded - done) * framesize;
+        while (SDL_GetAudioStreamAvailable(from->stream) < needed) {
+            if (!from->audio->decoder->decode(from->decoder_userdata, from->stream)) {
+                SDL_FlushAudioStream(from->stream);  // make sure we read _everything_ now.
+                break;
+            }
+        }
+
+        const int br = SDL_GetAudioStreamData(from->stream, track->crossfade_buffer, needed);
+        const int old_frames = (br > 0) ? (br / framesize) : 0;
+        const float *old = track->crossfade_buffer;
+        float *dst = pcm + (done * channels);
+        for (int i = 0; i < old_frames; i++) {
+            const float t = (position + done + i) / total;
+            const float gain = from->crossfade_gain * CrossfadeGain(from->crossfade_curve, 1.0f - t);
+            for (int j = 0; j < channels; j++) {
+                *(dst++) += *(old++) * gain;
+            }
+        }
+
+        done += old_frames;
+        if (old_frames < (needed / framesize)) {
+            return false;  // the old input ran out early.
+        }
+    }
+
+    from->crossfade_frames -= to_be_faded;
+    return (from->crossfade_frames > 0);
+}
+
+// Fade in the current input, and mix in anything MIX_CrossfadeTrackAudio is fading out, in the same format as `pcm`.
+// this assumes LockTrack(track) was called before this.
+static void ApplyCrossfade(MIX_Track *track, int channels, float *pcm, int frames)
+{
+    if ((track->crossfade_frames <= 0) && !track->crossfade_from) {
+        return;  // no crossfade is happening, early exit.
+    }
+
+    if (track->crossfade_frames > 0) {
+        const int to_be_faded = (int) SDL_min(track->crossfade_frames, frames);
+        const float total = (float) track->crossfade_total_frames;
+        const float position = (float) (track->crossfade_total_frames - track->crossfade_frames);
+        float *ptr = pcm;
+        for (int i = 0; i < to_be_faded; i++) {
+            const float gain = CrossfadeGain(track->crossfade_curve, (position + i) / total);
+            for (int j = 0; j < channels; j++) {
+                *(ptr++) *= gain;
+            }
+        }
+        track->crossfade_frames -= to_be_faded;
+    }
+
+    MIX_TrackQueueItem *prev = NULL;
+    MIX_TrackQueueItem *next = NULL;
+    for (MIX_TrackQueueItem *from = track->crossfade_from; from; from = next) {
+        next = from->next;
+        if (MixCrossfadeOutput(track, from, channels, pcm, frames)) {
+            prev = from;
+        } else {  // done, or the old input ran out early (keep fading in the new one, though).
+            if (prev) {
+                prev->next = next;
+            } else {
+                track->crossfade_from = next;
+            }
+            RetireTrackInput(track, from);
+        }
+    }
+}
+
+// send processed audio on to the track's output_stream, through our own resampler if there is one.
+static void PutTrackOutput(SDL_AudioStream *stream, MIX_Resampler *resampler, double step, int channels, const float *pcm, int frames)
+{
+    if (frames <= 0) {
+        return;
+    } else if (!resampler) {
+        SDL_PutAudioStreamData(stream, pcm, frames * channels * sizeof (float));
+    } else {
+        const float *resampled = NULL;
+        const int resampled_frames = MIX_Resample(resampler, pcm, frames, step, &resampled);
+        if (resampled_frames > 0) {
+            SDL_PutAudioStreamData(stream, resampled, resampled_frames * channels * sizeof (float));
+        }
+    }
+}
+
 // This is called every time we try to pull more from a track's output_stream.
 // We generate more audio here on-demand, either from a decoder, or pulling
 // from another audio stream.
@@ -351,24 +719,62 @@ static void SDLCALL TrackGetCallback(void *userdata, SDL_AudioStream *stream, in
         SDL_GetAudioStreamFormat(track->input_stream, NULL, &raw_spec);
     }
 
+    // if we're resampling or time-stretching ourselves, `additional_amount` is what comes out the other end, so we need more or less input than that.
+    MIX_Resampler *resampler = track->input_stream ? track->resampler : NULL;
+    MIX_TimeStretch *timestretch = NULL;  // only set if we're actually changing the tempo right now.
+    const float tempo = track->tempo;
+    double step = 1.0;
+    int input_amount = additional_amount;
+    if (track->input_stream) {
+        double input_scale = 1.0;
+        if (resampler) {
+            if (!MIX_SetResamplerFormat(resampler, raw_spec.channels, raw_spec.freq, track->output_spec.freq)) {
+                TrackStopped(track);
+                return;
+            }
+            step = (((double) raw_spec.freq) / ((double) track->output_spec.freq)) * ((double) track->output_ratio);
+            input_scale = SDL_max(step, resampler->step);  // it might still be gliding down from a faster step.
+        }
+
+        if (track->timestretch) {
+            if (!MIX_SetTimeStretchFormat(track->timestretch, raw_spec.channels, raw_spec.freq)) {
+                // not sized for this format (the app changed its stream's format on us?), and we can't allocate here. Play at normal speed until it is.
+            } else if (tempo != 1.0f) {
+                timestretch = track->timestretch;
+                input_scale *= tempo;
+            } else {  // back to normal speed; push out whatever the time-stretcher was holding, and pass audio straight through from here on.
+                const float *stretched = NULL;
+                const int stretched_frames = MIX_FlushTimeStretch(track->timestretch, &stretched);
+                PutTrackOutput(stream, resampler, step, raw_spec.channels, stretched, stretched_frames);
+            }
+        }
+
+        if (input_scale != 1.0) {
+            const int raw_framesize = SDL_AUDIO_FRAMESIZE(raw_spec);
+            const int output_frames = SDL_max(1, additional_amount / raw_framesize);
+            input_amount = ((int) SDL_ceil(output_frames * input_scale) + 1) * raw_framesize;
+        }
+    }
+
     // do we need to grow our buffer?
-    if (additional_amount > track->input_buffer_len) {
-        void *ptr = SDL_realloc(track->input_buffer, additional_amount);
+    if (input_amount > track->input_buffer_len) {
+        void *ptr = SDL_realloc(track->input_buffer, input_amount);
         if (!ptr) {   // uhoh.
             TrackStopped(track);
             return;  // not much to be done, we're out of memory!
         }
         track->input_buffer = (float *) ptr;
-        track->input_buffer_len = additional_amount;
+        track->input_buffer_len = input_amount;
     }
 
     float *pcm = track->input_buffer;  // we always work in float32 format.
     const int output_framesize = SDL_AUDIO_FRAMESIZE(track->output_spec);
-    int bytes_remaining = additional_amount;
+    int bytes_remaining = input_amount;
 
     // Calling TrackStopped() might have a stopped_callback that restarts the track, so don't break the loop
     //  for simply being stopped, so we can generate audio without gaps. If not restarted, track->state will no longer be PLAYING.
     while ((track->state == MIX_STATE_PLAYING) && (bytes_remaining > 0)) {
+        const bool fading_out = (track->fade_direction < 0);  // if this ends the audio, the app wanted it stopped, so don't move on to the queue.
         bool end_of_audio = false;
         int br = 0;   // bytes read.
 
@@ -379,10 +785,13 @@ static void SDLCALL TrackGetCallback(void *userdata, SDL_AudioStream *stream, in
             SDL_assert(track->input_stream != NULL);  // should have data bound if you landed here (we need raw_spec to be initialized).
             br = FillSilenceFrames(track, pcm, raw_spec.channels, bytes_remaining);
         } else if (track->input_stream) {
-            if (track->input_audio) {
-                DecodeMore(track, bytes_remaining);
+            br = track->input_audio ? DecodeDirectly(track, pcm, bytes_remaining) : -1;
+            if (br < 0) {
+                if (track->input_audio) {
+                    DecodeMore(track, bytes_remaining);
+                }
+                br = SDL_GetAudioStreamData(track->input_stream, pcm, bytes_remaining);
             }
-            br = SDL_GetAudioStreamData(track->input_stream, pcm, bytes_remaining);
         }
 
         // if input_audio and input_stream are both NULL, there's nothing to play (maybe they changed out the input on us?), br will be zero and we'll go to end_of_audio=true.
@@ -429,12 +838,32 @@ static void SDLCALL TrackGetCallback(void *userdata, SDL_AudioStream *stream, in
             }
 
             ApplyFade(track, raw_channels, pcm, frames_read);
+            ApplyCrossfade(track, raw_channels, pcm, frames_read);
 
-            const int put_bytes = samples * sizeof (float);
-            SDL_PutAudioStreamData(stream, pcm, put_bytes);
+            if (!timestretch) {
+                PutTrackOutput(stream, resampler, step, raw_channels, pcm, frames_read);
+                bytes_remaining -= samples * sizeof (float);  // we asked for enough input to cover the output, so count what we consumed.
+            } else {
+                // the time-stretcher holds on to some input before it produces anything, so count what actually came out (in input terms), or we'd fall short at startup.
+                //  It only takes as much as fits in its buffers, so feed it in pieces.
+                const float *input = pcm;
+                int input_frames = frames_read;
+                while (input_frames > 0) {
+                    const float *stretched = NULL;
+                    int consumed = 0;
+                    const int stretched_frames = MIX_ApplyTimeStretch(timestretch, input, input_frames, tempo, &consumed, &stretched);
+                    if (stretched_frames < 0) {
+                        bytes_remaining = 0;  // no room for this tempo; give up on this callback rather than spin.
+                        break;
+                    }
+                    PutTrackOutput(stream, resampler, step, raw_channels, stretched, stretched_frames);
+                    bytes_remaining -= ((int) SDL_ceil(stretched_frames * tempo)) * raw_channels * sizeof (float);
+                    input += consumed * raw_channels;
+                    input_frames -= consumed;
+                }
+            }
 
             track->position += frames_read;
-            bytes_remaining -= put_bytes;
         }
 
         // remember that the callback in TrackStopped() might restart this track,
@@ -465,6 +894,35 @@ static void SDLCALL TrackGetCallback(void *userdata, SDL_AudioStream *stream, in
                 }
             }
 
+            if (track_stopped && timestretch) {  // push out the last bit the time-stretcher is holding (through the resampler, if there is one).
+                const float *stretched = NULL;
+                const int stretched_frames = MIX_FlushTimeStretch(timestretch, &stretched);
+                PutTrackOutput(stream, resampler, step, raw_spec.channels, stretched, stretched_frames);
+            }
+
+            if (track_stopped && resampler) {  // push out the last few frames the resampler is holding.
+                const float *resampled = NULL;
+                const int resampled_frames = MIX_FlushResampler(resampler, step, &resampled);
+                if (resampled_frames > 0) {
+                    SDL_PutAudioStreamData(stream, resampled, resampled_frames * raw_spec.channels * sizeof (float));
+                }
+                MIX_ResetResampler(resampler);
+            }
+
+            if (track_stopped && !fading_out && StartQueuedTrackAudio(track)) {
+                track_stopped = false;  // carry right on with the next input, no gap.
+                SDL_GetAudioStreamFormat(track->input_stream, NULL, &raw_spec);
+                if (resampler) {
+                    if (!MIX_SetResamplerFormat(resampler, raw_spec.channels, raw_spec.freq, track->output_spec.freq)) {
+                        track_stopped = true;
+                    }
+                    step = (((double) raw_spec.freq) / ((double) track->output_spec.freq)) * ((double) track->output_ratio);
+                }
+                if (timestretch && !MIX_SetTimeStretchFormat(timestretch, raw_spec.channels, raw_spec.freq)) {
+                    timestretch = NULL;  // MIX_QueueTrackAudio should have made room for this, but if not, play at normal speed rather than allocate here.
+                }
+            }
+
             if (track_stopped) {
                 TrackStopped(track);
             }
@@ -472,7 +930,7 @@ static void SDLCALL TrackGetCallback(void *userdata, SDL_AudioStream *stream, in
     }
 }
 
-static void MixSpatializedFloat32Audio(float *dst, const float *src, const int samples, const int output_channels, const float *panning, const int *speakers, const float gain)
+static void MixSpatializedFloat32Audio(float *dst, const float *src, const int samples, const int output_channels, const float *panning, const int *speakers, const float gain, MIX_MeterAccumulator *meter)
 {
     const float panning0 = panning[0] * gain;
     const float panning1 = panning[1] * gain;
@@ -481,7 +939,21 @@ static void MixSpatializedFloat32Audio(float *dst, const float *src, const int s
 
     // !!! FIXME: a common case (output_channels==2, speaker0=0, speaker1=1) can be easily SIMD'd.
     // !!! FIXME: unroll this loop?
-    if ((panning0 == 0.0f) && (panning1 == 0.0f)) {
+    if (meter) {  // meter the track before it's panned, so this measures the same thing for every spatialization mode.
+        float peak = meter->peak;
+        float sum_squares = 0.0f;
+        for (int i = 0; i < samples; i++, dst += output_channels, src++) {
+            const float sample = *src * gain;
+            const float a = SDL_fabsf(sample);
+            peak = SDL_max(peak, a);
+            sum_squares += sample * sample;
+            dst[speaker0] += sample * panning[0];
+            dst[speaker1] += sample * panning[1];
+        }
+        meter->peak = peak;
+        meter->sum_squares += sum_squares;
+        meter->samples += samples;
+    } else if ((panning0 == 0.0f) && (panning1 == 0.0f)) {
         return;  // don't mix silence.
     } else if ((panning0 == 1.0f) && (panning1 == 1.0f)) {  // no modulation.
         for (int i = 0; i < samples; i++, dst += output_channels, src++) {
@@ -498,14 +970,29 @@ static void MixSpatializedFloat32Audio(float *dst, const float *src, const int s
     }
 }
 
-static void MixForcedStereoFloat32Audio(float *dst, const float *src, const int sample_frames, const int output_channels, const float *panning, const float gain)
+static void MixForcedStereoFloat32Audio(float *dst, const float *src, const int sample_frames, const int output_channels, const float *panning, const float gain, MIX_MeterAccumulator *meter)
 {
     const float panning0 = panning[0] * gain;
     const float panning1 = panning[1] * gain;
 
     // !!! FIXME: a common case (output_channels==2) can be easily SIMD'd.
     // !!! FIXME: unroll this loop?
-    if ((panning0 == 0.0f) && (panning1 == 0.0f)) {
+    if (meter) {  // meter the track before it's panned, so this measures the same thing for every spatialization mode.
+        float peak = meter->peak;
+        float sum_squares = 0.0f;
+        for (int i = 0; i < sample_frames; i++, dst += output_channels, src += 2) {
+            const float left = src[0] * gain;
+            const float right = src[1] * gain;
+            const float a = SDL_max(SDL_fabsf(left), SDL_fabsf(right));
+            peak = SDL_max(peak, a);
+            sum_squares += (left * left) + (right * right);
+            dst[0] += left * panning[0];
+            dst[1] += right * panning[1];
+        }
+        meter->peak = peak;
+        meter->sum_squares += sum_squares;
+        meter->samples += sample_frames * 2;
+    } else if ((panning0 == 0.0f) && (panning1 == 0.0f)) {
         return;  // don't mix silence.
     } else if ((panning0 == 1.0f) && (panning1 == 1.0f)) {  // no modulation.
         for (int i = 0; i < sample_frames; i++, dst += output_channels, src += 2) {
@@ -520,13 +1007,475 @@ static void MixForcedStereoFloat32Audio(float *dst, const float *src, const int
     }
 }
 
-static void MixFloat32Audio(float *dst, const float *src, const int buffer_size, const float gain)
+// SDL_MixAudio clamps float data to -1.0f/1.0f; when there's dynamics processing downstream, we want the real peaks, so we use this instead.
+#if SDL_MIXER_NEED_SCALAR_FALLBACK
+static void MixFloat32AudioUnclamped_scalar(float *dst, const float *src, const int samples, const float gain)
+{
+    for (int i = 0; i < samples; i++) {
+        dst[i] += src[i] * gain;
+    }
+}
+
+// When metering, we do our own mixing (clamped or not), so we can measure the source as we add it to the destination.
+//  `meter` measures the source, `mixed_meter` the result. Either can be NULL.
+static void MixFloat32AudioMetered_scalar(float *dst, const float *src, const int samples, const float gain, const bool clamp, MIX_MeterAccumulator *meter, MIX_MeterAccumulator *mixed_meter)
+{
+    float peak = 0.0f;
+    float sum_squares = 0.0f;
+    float mixed_peak = 0.0f;
+    float mixed_sum_squares = 0.0f;
+    for (int i = 0; i < samples; i++) {
+        const float sample = src[i] * gain;
+        const float a = SDL_fabsf(sample);
+        float mixed = dst[i] + sample;
+        if (clamp) {
+            mixed = SDL_clamp(mixed, -1.0f, 1.0f);
+        }
+        dst[i] = mixed;
+        peak = SDL_max(peak, a);
+        sum_squares += sample * sample;
+        mixed_peak = SDL_max(mixed_peak, SDL_fabsf(mixed));
+        mixed_sum_squares += mixed * mixed;
+    }
+    if (meter) {
+        meter->peak = SDL_max(meter->peak, peak);
+        meter->sum_squares += sum_squares;
+    }
+    if (mixed_meter) {
+        mixed_meter->peak = SDL_max(mixed_meter->peak, mixed_peak);
+        mixed_meter->sum_squares += mixed_sum_squares;
+    }
+}
+
+static void MeterFloat32Audio_scalar(const float *src, const int samples, MIX_MeterAccumulator *meter)
+{
+    float peak = meter->peak;
+    float sum_squares = 0.0f;
+    for (int i = 0; i < samples; i++) {
+        const float sample = src[i];
+        const float a = SDL_fabsf(sample);
+        peak = SDL_max(peak, a);
+        sum_squares += sample * sample;
+    }
+    meter->peak = peak;
+    meter->sum_squares += sum_squares;
+}
+#endif
+
+#if defined(SDL_SSE_INTRINSICS)
+static void SDL_TARGETING("sse") MixFloat32AudioUnclamped_sse(float *dst, const float *src, const int samples, const float gain)
+{
+    const __m128 gain_sse = _mm_set1_ps(gain);
+    int i;
+    for (i = 0; i <= (samples - 4); i += 4) {
+        _mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), _mm_mul_ps(_mm_loadu_ps(src + i), gain_sse)));
+    }
+    for (; i < samples; i++) {
+        dst[i] += src[i] * gain;
+    }
+}
+
+static void SDL_TARGETING("sse") FinishMeter_sse(MIX_MeterAccumulator *meter, __m128 peak_sse, __m128 sum_squares_sse, float peak, float sum_squares)
+{
+    if (!meter) {
+        return;
+    }
+    float SDL_ALIGNED(16) lanes[4];
+    _mm_store_ps(lanes, _mm_max_ps(peak_sse, _mm_movehl_ps(peak_sse, peak_sse)));
+    peak = SDL_max(peak, SDL_max(lanes[0], lanes[1]));
+    _mm_store_ps(lanes, sum_squares_sse);
+    meter->peak = SDL_max(meter->peak, peak);
+    meter->sum_squares += sum_squares + ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3]));
+}
+
+static void SDL_TARGETING("sse") MixFloat32AudioMetered_sse(float *dst, const float *src, const int samples, const float gain, const bool clamp, MIX_MeterAccumulator *meter, MIX_MeterAccumulator *mixed_meter)
+{
+    const __m128 gain_sse = _mm_set1_ps(gain);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 minus_one = _mm_set1_ps(-1.0f);
+    __m128 peak_sse = zero;
+    __m128 sum_squares_sse = zero;
+    __m128 mixed_peak_sse = zero;
+    __m128 mixed_sum_squares_sse = zero;
+    int i;
+    for (i = 0; i <= (samples - 4); i += 4) {
+        const __m128 sample = _mm_mul_ps(_mm_loadu_ps(src + i), gain_sse);
+        __m128 mixed = _mm_add_ps(_mm_loadu_ps(dst + i), sample);
+        if (clamp) {
+            mixed = _mm_min_ps(_mm_max_ps(mixed, minus_one), one);
+        }
+        _mm_storeu_ps(dst + i, mixed);
+        peak_sse = _mm_max_ps(peak_sse, _mm_max_ps(sample, _mm_sub_ps(zero, sample)));  // no SSE1 abs, but max(x, -x) works.
+        sum_squares_sse = _mm_add_ps(sum_squares_sse, _mm_mul_ps(sample, sample));
+        mixed_peak_sse = _mm_max_ps(mixed_peak_sse, _mm_max_ps(mixed, _mm_sub_ps(zero, mixed)));
+        mixed_sum_squares_sse = _mm_add_ps(mixed_sum_squares_sse, _mm_mul_ps(mixed, mixed));
+    }
+
+    float peak = 0.0f;
+    float sum_squares = 0.0f;
+    float mixed_peak = 0.0f;
+    float mixed_sum_squares = 0.0f;
+    for (; i < samples; i++) {
+        const float sample = src[i] * gain;
+        const float a = SDL_fabsf(sample);
+        float mixed = dst[i] + sample;
+        if (clamp) {
+            mixed = SDL_clamp(mixed, -1.0f, 1.0f);
+        }
+        dst[i] = mixed;
+        peak = SDL_max(peak, a);
+        sum_squares += sample * sample;
+        mixed_peak = SDL_max(mixed_peak, SDL_fabsf(mixed));
+        mixed_sum_squares += mixed * mixed;
+    }
+
+    FinishMeter_sse(meter, peak_sse, sum_squares_sse, peak, sum_squares);
+    FinishMeter_sse(mixed_meter, mixed_peak_sse, mixed_sum_squares_sse, mixed_peak, mixed_sum_squares);
+}
+
+static void SDL_TARGETING("sse") MeterFloat32Audio_sse(const float *src, const int samples, MIX_MeterAccumulator *meter)
+{
+    const __m128 zero = _mm_setzero_ps();
+    __m128 peak_sse = zero;
+    __m128 sum_squares_sse = zero;
+    int i;
+    for (i = 0; i <= (samples - 4); i += 4) {
+        const __m128 sample = _mm_loadu_ps(src + i);
+        peak_sse = _mm_max_ps(peak_sse, _mm_max_ps(sample, _mm_sub_ps(zero, sample)));
+        sum_squares_sse = _mm_add_ps(sum_squares_sse, _mm_mul_ps(sample, sample));
+    }
+
+    float peak = 0.0f;
+    float sum_squares = 0.0f;
+    for (; i < samples; i++) {
+        const float sample = src[i];
+        const float a = SDL_fabsf(sample);
+        peak = SDL_max(peak, a);
+        sum_squares += sample * sample;
+    }
+
+    FinishMeter_sse(meter, peak_sse, sum_squares_sse, peak, sum_squares);
+}
+#endif
+
+#if defined(SDL_NEON_INTRINSICS)
+static void MixFloat32AudioUnclamped_neon(float *dst, const float *src, const int samples, const float gain)
+{
+    int i;
+    for (i = 0; i <= (samples - 4); i += 4) {
+        vst1q_f32(dst + i, vmlaq_n_f32(vld1q_f32(dst + i), vld1q_f32(src + i), gain));
+    }
+    for (; i < samples; i++) {
+        dst[i] += src[i] * gain;
+    }
+}
+
+static void FinishMeter_neon(MIX_MeterAccumulator *meter, float32x4_t peak_neon, float32x4_t sum_squares_neon, float peak, float sum_squares)
+{
+    if (!meter) {
+        return;
+    }
+    const float32x2_t peak2 = vpmax_f32(vget_low_f32(peak_neon), vget_high_f32(peak_neon));
+    const float32x2_t sum2 = vpadd_f32(vget_low_f32(sum_squares_neon), vget_high_f32(sum_squares_neon));
+    peak = SDL_max(peak, SDL_max(vget_lane_f32(peak2, 0), vget_lane_f32(peak2, 1)));
+    meter->peak = SDL_max(meter->peak, peak);
+    meter->sum_squares += sum_squares + vget_lane_f32(sum2, 0) + vget_lane_f32(sum2, 1);
+}
+
+static void MixFloat32AudioMetered_neon(float *dst, const float *src, const int samples, const float gain, const bool clamp, MIX_MeterAccumulator *meter, MIX_MeterAccumulator *mixed_meter)
+{
+    const float32x4_t one = vdupq_n_f32(1.0f);
+    const float32x4_t minus_one = vdupq_n_f32(-1.0f);
+    float32x4_t peak_neon = vdupq_n_f32(0.0f);
+    float32x4_t sum_squares_neon = vdupq_n_f32(0.0f);
+    float32x4_t mixed_peak_neon = vdupq_n_f32(0.0f);
+    float32x4_t mixed_sum_squares_neon = vdupq_n_f32(0.0f);
+    int i;
+    for (i = 0; i <= (samples - 4); i += 4) {
+        const float32x4_t sample = vmulq_n_f32(vld1q_f32(src + i), gain);
+        float32x4_t mixed = vaddq_f32(vld1q_f32(dst + i), sample);
+        if (clamp) {
+            mixed = vminq_f32(vmaxq_f32(mixed, minus_one), one);
+        }
+        vst1q_f32(dst + i, mixed);
+        peak_neon = vmaxq_f32(peak_neon, vabsq_f32(sample));
+        sum_squares_neon = vmlaq_f32(sum_squares_neon, sample, sample);
+        mixed_peak_neon = vmaxq_f32(mixed_peak_neon, vabsq_f32(mixed));
+        mixed_sum_squares_neon = vmlaq_f32(mixed_sum_squares_neon, mixed, mixed);
+    }
+
+    float peak = 0.0f;
+    float sum_squares = 0.0f;
+    float mixed_peak = 0.0f;
+    float mixed_sum_squares = 0.0f;
+    for (; i < samples; i++) {
+        const float sample = src[i] * gain;
+        const float a = SDL_fabsf(sample);
+        float mixed = dst[i] + sample;
+        if (clamp) {
+            mixed = SDL_clamp(mixed, -1.0f, 1.0f);
+        }
+        dst[i] = mixed;
+        peak = SDL_max(peak, a);
+        sum_squares += sample * sample;
+        mixed_peak = SDL_max(mixed_peak, SDL_fabsf(mixed));
+        mixed_sum_squares += mixed * mixed;
+    }
+
+    FinishMeter_neon(meter, peak_neon, sum_squares_neon, peak, sum_squares);
+    FinishMeter_neon(mixed_meter, mixed_peak_neon, mixed_sum_squares_neon, mixed_peak, mixed_sum_squares);
+}
+
+static void MeterFloat32Audio_neon(const float *src, const int samples, MIX_MeterAccumulator *meter)
+{
+    float32x4_t peak_neon = vdupq_n_f32(0.0f);
+    float32x4_t sum_squares_neon = vdupq_n_f32(0.0f);
+    int i;
+    for (i = 0; i <= (samples - 4); i += 4) {
+        const float32x4_t sample = vld1q_f32(src + i);
+        peak_neon = vmaxq_f32(peak_neon, vabsq_f32(sample));
+        sum_squares_neon = vmlaq_f32(sum_squares_neon, sample, sample);
+    }
+
+    float peak = 0.0f;
+    float sum_squares = 0.0f;
+    for (; i < samples; i++) {
+        const float sample = src[i];
+        const float a = SDL_fabsf(sample);
+        peak = SDL_max(peak, a);
+        sum_squares += sample * sample;
+    }
+
+    FinishMeter_neon(meter, peak_neon, sum_squares_neon, peak, sum_squares);
+}
+#endif
+
+// `meter` measures `src` (with `gain` applied) as it's added, and `mixed_meter` measures what ends up in `dst`. Either can be NULL.
+static void MixFloat32Audio(float *dst, const float *src, const int buffer_size, const float gain, const bool clamp, MIX_MeterAccumulator *meter, MIX_MeterAccumulator *mixed_meter)
 {
+    const int samples = buffer_size / sizeof (float);
+
+    if (meter || mixed_meter) {
+        if (meter) {
+            meter->samples += samples;
+        }
+        if (mixed_meter) {
+            mixed_meter->samples += samples;
+        }
+        if ((gain != 0.0f) || mixed_meter) {   // if gain is zero, this contributes silence to the meter, so there's nothing to do unless we're measuring the result.
+            #if defined(SDL_SSE_INTRINSICS)
+            if (MIX_HasSSE) {
+                MixFloat32AudioMetered_sse(dst, src, samples, gain, clamp, meter, mixed_meter);
+            } else
+            #elif defined(SDL_NEON_INTRINSICS)
+            if (MIX_HasNEON) {
+                MixFloat32AudioMetered_neon(dst, src, samples, gain, clamp, meter, mixed_meter);
+            } else
+            #endif
+
+            {
+            #if SDL_MIXER_NEED_SCALAR_FALLBACK
+                MixFloat32AudioMetered_scalar(dst, src, samples, gain, clamp, meter, mixed_meter);
+            #endif
+            }
+        }
+        return;
+    }
+
     if (gain == 0.0f) {
         return;  // don't mix silence.
-    } else if (!SDL_MixAudio((Uint8 *) dst, (const Uint8 *) src, SDL_AUDIO_F32, buffer_size, gain)) {
-        SDL_assert(!"This shouldn't happen.");
+    } else if (clamp) {
+        if (!SDL_MixAudio((Uint8 *) dst, (const Uint8 *) src, SDL_AUDIO_F32, buffer_size, gain)) {
+            SDL_assert(!"This shouldn't happen.");
+        }
+        return;
+    }
+
+    #if defined(SDL_SSE_INTRINSICS)
+    if (MIX_HasSSE) {
+        MixFloat32AudioUnclamped_sse(dst, src, samples, gain);
+    } else
+    #elif defined(SDL_NEON_INTRINSICS)
+    if (MIX_HasNEON) {
+        MixFloat32AudioUnclamped_neon(dst, src, samples, gain);
+    } else
+    #endif
+
+    {
+    #if SDL_MIXER_NEED_SCALAR_FALLBACK
+        MixFloat32AudioUnclamped_scalar(dst, src, samples, gain);
+    #endif
+    }
+}
+
+// for buffers that don't get mixed into anything else (the final mix, etc), just measure them.
+static void MeterFloat32Audio(const float *src, const int buffer_size, MIX_MeterAccumulator *meter)
+{
+    const int samples = buffer_size / sizeof (float);
+    meter->samples += samples;
+
+    #if defined(SDL_SSE_INTRINSICS)
+    if (MIX_HasSSE) {
+        MeterFloat32Audio_sse(src, samples, meter);
+    } else
+    #elif defined(SDL_NEON_INTRINSICS)
+    if (MIX_HasNEON) {
+        MeterFloat32Audio_neon(src, samples, meter);
+    } else
+    #endif
+
+    {
+    #if SDL_MIXER_NEED_SCALAR_FALLBACK
+        MeterFloat32Audio_scalar(src, samples, meter);
+    #endif
+    }
+}
+
+static void PublishMeter(MIX_Meter *meter, const MIX_MeterAccumulator *accumulator)
+{
+    const float rms = (accumulator->samples > 0) ? SDL_sqrtf(accumulator->sum_squares / (float) accumulator->samples) : 0.0f;
+    MIX_SetAtomicFloat(&meter->peak, accumulator->peak);
+    MIX_SetAtomicFloat(&meter->rms, rms);
+}
+
+static void ResetMeter(MIX_Meter *meter)
+{
+    MIX_SetAtomicFloat(&meter->peak, 0.0f);
+    MIX_SetAtomicFloat(&meter->rms, 0.0f);
+}
+
+// Pull a track's output for the mixer. If the track is moving in 3D space, this also handles the Doppler
+// shift, ramping the resampling ratio across the buffer instead of jumping straight to the new value,
+// which would make an audible step when the velocity changes.
+//
+// If the track has our own resampler, it glides the ratio a little every output frame. SDL_AudioStream
+// can only change the ratio between calls, so otherwise we pull the buffer in slices, each at the
+// ratio halfway through it. Each slice moves the ratio by about MIX_DOPPLER_RATIO_STEP (a couple
+// cents, too small to hear as a step), so small changes are one ratio update instead of one per
+// slice, but a slice is never smaller than MIX_DOPPLER_SLICE_FRAMES.
+#define MIX_DOPPLER_SLICE_FRAMES 16
+#define MIX_DOPPLER_RATIO_STEP 0.001f
+static int GetTrackOutputData(MIX_Mixer *mixer, MIX_Track *track, float *buffer, int buflen)
+{
+    if (track->spatialization_mode != MIX_SPATIALIZATION_3D) {
+        return SDL_GetAudioStreamData(track->output_stream, buffer, buflen);
+    }
+
+    LockTrack(track);
+
+    const float target_doppler = MIX_CalculateDopplerRatio(track->position3d, track->velocity3d, mixer->listener_velocity3d, mixer->speed_of_sound);
+    const float start_doppler = track->doppler_ratio;
+    const int framesize = SDL_AUDIO_FRAMESIZE(track->output_spec);
+    const int frames = buflen / framesize;
+    int retval = 0;
+
+    if (start_doppler == target_doppler) {   // steady state, just grab it all at once.
+        retval = SDL_GetAudioStreamData(track->output_stream, buffer, buflen);
+    } else if (track->resampler) {
+        MIX_SetResamplerGlide(track->resampler, frames);
+        SetTrackOutputRatio(track, track->frequency_ratio * target_doppler);
+        retval = SDL_GetAudioStreamData(track->output_stream, buffer, buflen);
+    } else {
+        const int max_slices = SDL_max(1, (frames + MIX_DOPPLER_SLICE_FRAMES - 1) / MIX_DOPPLER_SLICE_FRAMES);
+        const int wanted_slices = (int) SDL_ceilf(SDL_fabsf(target_doppler - start_doppler) / MIX_DOPPLER_RATIO_STEP);
+        const int total_slices = SDL_clamp(wanted_slices, 1, max_slices);
+        const int slice_size = ((frames + total_slices - 1) / total_slices) * framesize;
+        Uint8 *ptr = (Uint8 *) buffer;
+        for (int i = 0; (i < total_slices) && (retval < buflen); i++) {
+            const float doppler = start_doppler + ((target_doppler - start_doppler) * ((((float) i) + 0.5f) / ((float) total_slices)));
+            SetTrackOutputRatio(track, track->frequency_ratio * doppler);
+            const int want = SDL_min(slice_size, buflen - retval);
+            const int br = SDL_GetAudioStreamData(track->output_stream, ptr + retval, want);
+            if (br < 0) {
+                if (retval == 0) {
+                    retval = br;
+                }
+                break;
+            }
+            retval += br;
+            if (br < want) {
+                break;  // ran out of data.
+            }
+        }
+
+        // leave it on the target ratio, so the next buffer picks up from there.
+        SetTrackOutputRatio(track, track->frequency_ratio * target_doppler);
+    }
+
+    track->doppler_ratio = target_doppler;
+
+    UnlockTrack(track);
+
+    return retval;
+}
+
+// Pull a track's output for the mixer, dealing with anything scheduled on the mixer clock during this buffer.
+//  `*offset_frames` is set to where in the buffer the track's output begins, if it was scheduled to start partway through.
+static int GetScheduledTrackOutputData(MIX_Mixer *mixer, MIX_Track *track, float *buffer, int mixer_frames, int *offset_frames)
+{
+    const Uint64 clock = mixer->clock;
+    const Uint64 end_of_buffer = clock + mixer_frames;
+    const int framesize = SDL_AUDIO_FRAMESIZE(track->output_spec);
+
+    *offset_frames = 0;
+
+    // a tag operation is decoding ahead for this track while holding its lock. The track is about to be held silent
+    //  anyway, so skip it instead of stalling the audio device until the decoder is done.
+    if (SDL_GetAtomicInt(&track->prebuffering)) {
+        return 0;
+    }
+
+    LockTrack(track);
+
+    if (track->start_mixer_frame > clock) {  // not time to start yet?
+        if (track->start_mixer_frame >= end_of_buffer) {
+            UnlockTrack(track);
+            return 0;  // not during this buffer.
+        }
+        *offset_frames = (int) (track->start_mixer_frame - clock);
+    }
+    track->start_mixer_frame = 0;  // we're starting (or already started), so this is done.
+
+    const int frames = mixer_frames - *offset_frames;
+    int frames_before_stop = frames;
+    const bool stopping = (track->stop_mixer_frame < end_of_buffer);  // MIX_UNSCHEDULED_MIXER_FRAME is never less than this.
+    if (stopping) {
+        const Uint64 stop_frame = SDL_max(track->stop_mixer_frame, clock + *offset_frames);
+        frames_before_stop = (int) (stop_frame - (clock + *offset_frames));
+    }
+
+    int retval = 0;
+    if (frames_before_stop > 0) {
+        retval = GetTrackOutputData(mixer, track, buffer, frames_before_stop * framesize);
+    }
+
+    if (stopping && (retval >= 0)) {
+        const Sint64 fade_out_frames = track->stop_fade_frames;
+        track->stop_mixer_frame = MIX_UNSCHEDULED_MIXER_FRAME;
+        StopTrack(track, fade_out_frames);
+        // if we're fading out, the rest of this buffer is the start of the fade.
+        if ((retval == (frames_before_stop * framesize)) && (track->state == MIX_STATE_PLAYING) && (frames_before_stop < frames)) {
+            const int br = GetTrackOutputData(mixer, track, (float *) (((Uint8 *) buffer) + retval), (frames - frames_before_stop) * framesize);
+            if (br > 0) {
+                retval += br;
+            }
+        }
     }
+
+    UnlockTrack(track);
+
+    return retval;
+}
+
+// this is only called from MixerCallback, with the mixer locked. See MIX_GetMixerClock for the other half of this.
+static void AdvanceMixerClock(MIX_Mixer *mixer, int frames)
+{
+    SDL_AddAtomicInt(&mixer->clock_sequence, 1);  // now it's odd, readers will wait.
+    SDL_MemoryBarrierRelease();
+    mixer->clock += frames;
+    SDL_MemoryBarrierRelease();
+    SDL_AddAtomicInt(&mixer->clock_sequence, 1);  // even again, readers can proceed.
 }
 
 // SDL calls this function from the audio device thread as more data is needed the mixer.
@@ -547,7 +1496,10 @@ static void SDLCALL MixerCallback(void *userdata, SDL_AudioStream *stream, int a
     // do we need to grow our buffer?
     const bool skip_group_mixing = !mixer->all_groups || !mixer->all_groups->next;
     const int alloc_multiplier = skip_group_mixing ? 2 : 3;
-    const int alloc_size = additional_amount * alloc_multiplier;
+    const int mixer_frames = additional_amount / SDL_AUDIO_FRAMESIZE(mixer->spec);
+    const int ambisonic_stride = mixer->ambisonic_order ? MIX_AMBISONIC_STRIDE(mixer->ambisonic_order) : 0;
+    const int ambisonic_bytes = mixer_frames * ambisonic_stride * (int) sizeof (float);
+    const int alloc_size = (additional_amount * alloc_multiplier) + ambisonic_bytes;
     if (alloc_size > mixer->mix_buffer_allocation) {
         void *ptr = SDL_realloc(mixer->mix_buffer, alloc_size);
         if (!ptr) {   // uhoh.
@@ -560,9 +1512,32 @@ static void SDLCALL MixerCallback(void *userdata, SDL_AudioStream *stream, int a
     float *getbuf = mixer->mix_buffer;
     float *final_mixbuf = getbuf + (additional_amount / sizeof (float));
     float *group_mixbuf = skip_group_mixing ? final_mixbuf : (final_mixbuf + (additional_amount / sizeof (float)));
+    float *ambisonic_mixbuf = mixer->mix_buffer + ((additional_amount / sizeof (float)) * alloc_multiplier);  // only valid if mixer->ambisonic_order > 0.
 
     SDL_memset(final_mixbuf, '\0', additional_amount);
 
+    // pick up the speed of sound once per buffer, instead of once per 3D track.
+    mixer->speed_of_sound = MIX_DEFAULT_SPEED_OF_SOUND;
+    if (mixer->props) {
+        const float speed_of_sound = SDL_GetFloatProperty(mixer->props, MIX_PROP_MIXER_SPEED_OF_SOUND_FLOAT, MIX_DEFAULT_SPEED_OF_SOUND);
+        if (speed_of_sound > 0.0f) {
+            mixer->speed_of_sound = speed_of_sound;
+        }
+    }
+
+    // when metering, the accumulators get filled in by the mixing loops, so it doesn't cost an extra pass over most buffers.
+    bool metering = false;
+    if (mixer->meter_interval > 0) {
+        if (--mixer->meter_countdown <= 0) {
+            mixer->meter_countdown = mixer->meter_interval;
+            metering = true;
+        }
+    }
+
+    bool mixer_dynamics_done = false;  // set once the mixer's dynamics have run, folded into the last group's mix.
+    bool mixer_metered = false;  // set once `mixer_meter` covers the whole final mix, measured along the way.
+    MIX_MeterAccumulator mixer_meter;
+    SDL_zero(mixer_meter);
     MIX_Group *next_group = NULL;
     for (MIX_Group *group = mixer->all_groups; group; group = next_group) {
         next_group = group->next;  // this won't save you from a callback going totally rogue, but it'll deal with the current group changing.
@@ -570,13 +1545,31 @@ static void SDLCALL MixerCallback(void *userdata, SDL_AudioStream *stream, int a
             SDL_memset(group_mixbuf, '\0', additional_amount);  // if skip_group_mixing, this is final_mixbuf, which we just zero'd out.
         }
 
+        const bool unclamped_group = (group->dynamics != NULL) || (mixer->dynamics != NULL);  // let dynamics processing see the real peaks.
         int group_bytes = 0;
+        int ambisonic_frames = 0;  // non-zero if any 3D tracks in this group were encoded to the ambisonic bus.
+        MIX_MeterAccumulator group_meter;
+        SDL_zero(group_meter);
         MIX_Track *next_track = NULL;
         for (MIX_Track *track = group->tracks; track; track = next_track) {
             next_track = track->group_next;  // this won't save you from a callback going totally rogue, but it'll deal with the current track leaving the group.
-            const int to_be_read = (additional_amount / SDL_AUDIO_FRAMESIZE(mixer->spec)) * SDL_AUDIO_FRAMESIZE(track->output_spec);
-            const int br = SDL_GetAudioStreamData(track->output_stream, getbuf, to_be_read);
-            if (br > 0) {
+            int offset_frames = 0;  // if the track is scheduled to start partway through this buffer.
+            const int br = GetScheduledTrackOutputData(mixer, track, getbuf, mixer_frames, &offset_frames);
+            if ((br <= 0) && metering) {
+                ResetMeter(&track->meter);  // stopped, paused, or starved; either way, it's silent.
+            } else if (br > 0) {
+                const float gain = mixer->gain * track->normalization_gain;
+                float *dst = group_mixbuf + (offset_frames * mixer->spec.channels);
+                const int offset_bytes = offset_frames * SDL_AUDIO_FRAMESIZE(mixer->spec);
+                MIX_MeterAccumulator track_meter;
+                SDL_zero(track_meter);
+                MIX_MeterAccumulator *meter = metering ? &track_meter : NULL;
+
+                // filters run in place, before the mixing below, because the cooked callback needs to see their output.
+                if (track->filters) {
+                    MIX_ApplyFilterChain(track->filters, getbuf, track->output_spec.channels, mixer->spec.freq, br / SDL_AUDIO_FRAMESIZE(track->output_spec));
+                }
+
                 if (track->cooked_callback) {
                     track->cooked_callback(track->cooked_callback_userdata, track, &track->output_spec, getbuf, br / sizeof (float));
                 }
@@ -584,26 +1577,54 @@ static void SDLCALL MixerCallback(void *userdata, SDL_AudioStream *stream, int a
                 switch (track->spatialization_mode) {
                     case MIX_SPATIALIZATION_NONE:
                         SDL_assert(track->output_spec.channels == mixer->spec.channels);
-                        MixFloat32Audio(group_mixbuf, getbuf, br, mixer->gain);
-                        group_bytes = SDL_max(group_bytes, br);
+                        MixFloat32Audio(dst, getbuf, br, gain, !unclamped_group, meter, NULL);
+                        group_bytes = SDL_max(group_bytes, offset_bytes + br);
                         break;
 
                     case MIX_SPATIALIZATION_3D:
                         SDL_assert(track->output_spec.channels == 1);
-                        MixSpatializedFloat32Audio(group_mixbuf, getbuf, br / sizeof (float), mixer->spec.channels, track->spatialization_panning, track->spatialization_speakers, mixer->gain);
-                        group_bytes = SDL_max(group_bytes, br * mixer->spec.channels);
+                        if (ambisonic_stride) {
+                            if (!ambisonic_frames) {
+                                SDL_memset(ambisonic_mixbuf, '\0', ambisonic_bytes);  // first 3D track in this group, clear the bus.
+                            }
+                            MIX_AmbisonicEncodeMix(ambisonic_mixbuf + (offset_frames * ambisonic_stride), getbuf, br / sizeof (float), mixer->ambisonic_order, track->ambisonic_gains, gain, meter);
+                            ambisonic_frames = SDL_max(ambisonic_frames, offset_frames + (br / (int) sizeof (float)));
+                            break;  // the bus gets decoded to group_mixbuf once all the group's tracks are mixed.
+                        }
+                        MixSpatializedFloat32Audio(dst, getbuf, br / sizeof (float), mixer->spec.channels, track->spatialization_panning, track->spatialization_speakers, gain, meter);
+                        group_bytes = SDL_max(group_bytes, offset_bytes + (br * mixer->spec.channels));
                         break;
 
                     case MIX_SPATIALIZATION_STEREO:
                         SDL_assert(track->output_spec.channels == 2);
-                        MixForcedStereoFloat32Audio(group_mixbuf, getbuf, br / (sizeof (float) * 2), mixer->spec.channels, track->spatialization_panning, mixer->gain);
-                        group_bytes = SDL_max(group_bytes, (br / 2) * mixer->spec.channels);
+                        MixForcedStereoFloat32Audio(dst, getbuf, br / (sizeof (float) * 2), mixer->spec.channels, track->spatialization_panning, gain, meter);
+                        group_bytes = SDL_max(group_bytes, offset_bytes + ((br / 2) * mixer->spec.channels));
                         break;
 
                     default:
                         SDL_assert(!"Unexpected spatialization mode");
                         break;
                 }
+
+                if (meter) {
+                    PublishMeter(&track->meter, meter);
+                }
+            }
+        }
+
+        if (ambisonic_frames > 0) {
+            MIX_AmbisonicDecode(&mixer->ambisonic_decoder, group_mixbuf, ambisonic_mixbuf, ambisonic_frames);
+            group_bytes = SDL_max(group_bytes, ambisonic_frames * SDL_AUDIO_FRAMESIZE(mixer->spec));
+        }
+
+        if (group->filters && group->filters->num_filters) {
+            MIX_ApplyFilterChain(group->filters, group_mixbuf, mixer->spec.channels, mixer->spec.freq, mixer_frames);
+            group_bytes = additional_amount;  // filters can ring past the end of the tracks' audio, so keep all of it.
+        }
+
+        if (group->dynamics) {
+            if (MIX_ApplyDynamics(group->dynamics, &group->gain_reduction, group_mixbuf, NULL, 0, NULL, NULL, mixer->spec.channels, mixer->spec.freq, mixer_frames)) {
+                group_bytes = additional_amount;  // the limiter's delay line is still holding audio.
             }
         }
 
@@ -611,9 +1632,55 @@ static void SDLCALL MixerCallback(void *userdata, SDL_AudioStream *stream, int a
             group->postmix_callback(group->postmix_callback_userdata, group, &mixer->spec, group_mixbuf, additional_amount / sizeof (float));
         }
 
+        // the last group's sum into the final mix is also the mixer's dynamics pass (if there is one), and measures the final mix.
+        const bool last_group = !group->next;
+        MIX_MeterAccumulator *meter = metering ? &group_meter : NULL;
+        MIX_MeterAccumulator *final_meter = (metering && last_group) ? &mixer_meter : NULL;
+        const bool apply_mixer_dynamics = mixer->dynamics && last_group && !mixer_dynamics_done;
         if (!skip_group_mixing) {
-            MixFloat32Audio(final_mixbuf, group_mixbuf, group_bytes, 1.0f);  // we adjusted for mixer->gain for each track, don't adjust gain here, too.
+            if (apply_mixer_dynamics) {
+                const int framesize = SDL_AUDIO_FRAMESIZE(mixer->spec);
+                mixer_dynamics_done = MIX_ApplyDynamics(mixer->dynamics, &mixer->gain_reduction, final_mixbuf, group_mixbuf, group_bytes / framesize, meter, final_meter, mixer->spec.channels, mixer->spec.freq, mixer_frames);
+                mixer_metered = mixer_dynamics_done && (final_meter != NULL);
+            }
+            if (!mixer_dynamics_done) {
+                MixFloat32Audio(final_mixbuf, group_mixbuf, group_bytes, 1.0f, !mixer->dynamics, meter, mixer->dynamics ? NULL : final_meter);  // we adjusted for mixer->gain for each track, don't adjust gain here, too.
+                if (final_meter && !mixer->dynamics) {
+                    MeterFloat32Audio(final_mixbuf + (group_bytes / sizeof (float)), additional_amount - group_bytes, final_meter);  // the part of the final mix this group didn't add to.
+                    mixer_metered = true;
+                }
+            }
+        } else if (apply_mixer_dynamics) {  // group_mixbuf _is_ final_mixbuf, so the dynamics pass measures the group on the way in and the final mix on the way out.
+            mixer_dynamics_done = MIX_ApplyDynamics(mixer->dynamics, &mixer->gain_reduction, final_mixbuf, NULL, 0, meter, final_meter, mixer->spec.channels, mixer->spec.freq, mixer_frames);
+            mixer_metered = mixer_dynamics_done && (final_meter != NULL);
         }
+
+        if (skip_group_mixing && meter && !mixer_dynamics_done) {
+            // no mixing pass to piggyback on, but with no dynamics after this, one measurement covers the group and the final mix.
+            MeterFloat32Audio(group_mixbuf, additional_amount, meter);
+            if (final_meter && !mixer->dynamics) {
+                *final_meter = group_meter;
+                mixer_metered = true;
+            }
+        }
+
+        if (metering) {
+            group_meter.samples = additional_amount / sizeof (float);  // anything past group_bytes was silence.
+            PublishMeter(&group->meter, &group_meter);
+        }
+    }
+
+    if (mixer->dynamics && !mixer_dynamics_done) {  // the groups changed under us, or the format didn't match; give it one more shot by itself.
+        MIX_ApplyDynamics(mixer->dynamics, &mixer->gain_reduction, final_mixbuf, NULL, 0, NULL, NULL, mixer->spec.channels, mixer->spec.freq, mixer_frames);
+    }
+
+    if (metering) {
+        if (!mixer_metered) {
+            SDL_zero(mixer_meter);
+            MeterFloat32Audio(final_mixbuf, additional_amount, &mixer_meter);
+        }
+        mixer_meter.samples = additional_amount / sizeof (float);
+        PublishMeter(&mixer->meter, &mixer_meter);
     }
 
     if (mixer->postmix_callback) {
@@ -621,6 +1688,8 @@ static void SDLCALL MixerCallback(void *userdata, SDL_AudioStream *stream, int a
     }
 
     SDL_PutAudioStreamData(stream, final_mixbuf, additional_amount);
+
+    AdvanceMixerClock(mixer, mixer_frames);
 }
 
 bool MIX_Generate(MIX_Mixer *mixer, void *buffer, int buflen)
@@ -680,6 +1749,17 @@ bool MIX_Init(void)
         if (!global_lock) {
             return false;
         }
+        seek_index_lock = SDL_CreateMutex();
+        seek_index_cond = SDL_CreateCondition();
+        if (!seek_index_lock || !seek_index_cond) {
+            SDL_DestroyCondition(seek_index_cond);
+            SDL_DestroyMutex(seek_index_lock);
+            SDL_DestroyMutex(global_lock);
+            seek_index_cond = NULL;
+            seek_index_lock = NULL;
+            global_lock = NULL;
+            return false;
+        }
         InitDecoders();
     }
     mixer_initialized++;
@@ -712,6 +1792,20 @@ void MIX_Quit(void)
         MIX_DestroyAudio(all_audios);
     }
 
+    if (seek_index_thread) {  // every MIX_Audio is gone, so the queue is empty; tell the thread to finish up.
+        SDL_LockMutex(seek_index_lock);
+        seek_index_quit = true;
+        SDL_BroadcastCondition(seek_index_cond);
+        SDL_UnlockMutex(seek_index_lock);
+        SDL_WaitThread(seek_index_thread, NULL);
+        seek_index_thread = NULL;
+        seek_index_quit = false;
+    }
+    SDL_DestroyCondition(seek_index_cond);
+    SDL_DestroyMutex(seek_index_lock);
+    seek_index_cond = NULL;
+    seek_index_lock = NULL;
+
     QuitDecoders();
 
     SDL_DestroyMutex(global_lock);
@@ -773,6 +1867,7 @@ static MIX_Mixer *CreateMixer(SDL_AudioStream *stream)
     }
 
     mixer->gain = 1.0f;
+    mixer->speed_of_sound = MIX_DEFAULT_SPEED_OF_SOUND;
     mixer->output_stream = stream;
 
     SDL_SetAudioStreamGetCallback(stream, MixerCallback, mixer);
@@ -870,100 +1965,535 @@ void MIX_DestroyMixer(MIX_Mixer *mixer)
         SDL_RemoveEventWatch(AudioDeviceChangeEventWatcher, mixer);
     }
 
-    SDL_DestroyAudioStream(mixer->output_stream);
-    SDL_DestroyProperties(mixer->track_tags);
-    SDL_DestroyProperties(mixer->props);
-    SDL_free(mixer->mix_buffer);
+    SDL_DestroyAudioStream(mixer->output_stream);
+    SDL_DestroyProperties(mixer->track_tags);
+    SDL_DestroyProperties(mixer->props);
+    SDL_free(mixer->mix_buffer);
+    MIX_DestroyDynamics(mixer->dynamics);
+
+    if (mixer->device_id) {
+        SDL_QuitSubSystem(SDL_INIT_AUDIO);
+    }
+
+    SDL_free(mixer);
+}
+
+SDL_PropertiesID MIX_GetMixerProperties(MIX_Mixer *mixer)
+{
+    if (!CheckMixerParam(mixer)) {
+        return 0;
+    }
+
+    if (mixer->props == 0) {
+        mixer->props = SDL_CreateProperties();
+    }
+    return mixer->props;
+}
+
+bool MIX_GetMixerFormat(MIX_Mixer *mixer, SDL_AudioSpec *spec)
+{
+    if (!CheckMixerParam(mixer)) {
+        return false;
+    } else if (!spec) {
+        return SDL_InvalidParamError("spec");
+    }
+    return SDL_GetAudioStreamFormat(mixer->output_stream, NULL, spec);
+}
+
+Uint64 MIX_GetMixerClock(MIX_Mixer *mixer)
+{
+    if (!CheckMixerParam(mixer)) {
+        return 0;
+    }
+
+    // MixerCallback bumps clock_sequence before and after changing the clock, so if it's odd, or changed while we
+    //  were reading, we might have gotten half an update; try again. Updates are tiny and rare, so this won't spin long.
+    while (true) {
+        const int sequence = SDL_GetAtomicInt(&mixer->clock_sequence);
+        if ((sequence & 1) == 0) {
+            SDL_MemoryBarrierAcquire();
+            const Uint64 retval = mixer->clock;
+            SDL_MemoryBarrierAcquire();
+            if (SDL_GetAtomicInt(&mixer->clock_sequence) == sequence) {
+                return retval;
+            }
+        }
+        SDL_CPUPauseInstruction();
+    }
+}
+
+static const MIX_Decoder *PrepareDecoder(SDL_IOStream *io, MIX_Audio *audio)
+{
+    const char *decoder_name = SDL_GetStringProperty(audio->props, MIX_PROP_AUDIO_DECODER_STRING, NULL);
+
+    SDL_AudioSpec original_spec;
+    SDL_copyp(&original_spec, &audio->spec);
+
+    for (int i = 0; i < num_available_decoders; i++) {
+        const MIX_Decoder *decoder = available_decoders[i];
+        if (!decoder_name || (SDL_strcasecmp(decoder->name, decoder_name) == 0)) {
+            if (decoder->init_audio(io, &audio->spec, audio->props, &audio->duration_frames, &audio->decoder_userdata)) {
+                audio->decoder = decoder;
+                return decoder;
+            } else if (SDL_SeekIO(io, 0, SDL_IO_SEEK_SET) == -1) {   // note this seeks to offset 0, because we're using an IoClamp.
+                SDL_SetError("Can't seek in stream to find proper decoder");
+                return NULL;
+            }
+            SDL_copyp(&audio->spec, &original_spec);  // reset this, in case init_audio changed it and then failed.
+        }
+    }
+
+    SDL_SetError("Audio data is in unknown/unsupported/corrupt format");
+    return NULL;
+}
+
+// predecoded audio gets mixed with SIMD, so keep it aligned. There's no SDL_aligned_realloc, so this copies the first `used` bytes over.
+static Uint8 *ReallocDecodedAudio(Uint8 *ptr, size_t used, size_t newlen)
+{
+    Uint8 *newptr = (Uint8 *) SDL_aligned_alloc(SDL_GetSIMDAlignment(), newlen);
+    if (newptr && ptr) {
+        SDL_memcpy(newptr, ptr, SDL_min(used, newlen));
+        SDL_aligned_free(ptr);
+    }
+    return newptr;
+}
+
+// move whatever is available in `stream` to the end of `*decoded`, growing it as needed, and let the loudness analyzer see it, too.
+static bool DrainDecodedAudio(SDL_AudioStream *stream, Uint8 **decoded, size_t *bytes_decoded, size_t *allocated, MIX_LoudnessAnalyzer *loudness)
+{
+    const int available = SDL_GetAudioStreamAvailable(stream);
+    if (available <= 0) {
+        return true;
+    }
+
+    const size_t needed = *bytes_decoded + (size_t) available;
+    if (needed > *allocated) {
+        const size_t newlen = SDL_max(*allocated * 2, needed);
+        Uint8 *ptr = ReallocDecodedAudio(*decoded, *bytes_decoded, newlen);
+        if (!ptr) {
+            return false;
+        }
+        *decoded = ptr;
+        *allocated = newlen;
+    }
+
+    Uint8 *dst = *decoded + *bytes_decoded;
+    const int rc = SDL_GetAudioStreamData(stream, dst, available);
+    SDL_assert((rc < 0) || (rc == available));
+    if (rc < 0) {
+        return false;
+    }
+    *bytes_decoded += (size_t) rc;
+
+    if (loudness && !MIX_FeedLoudnessAnalyzer(loudness, dst, rc)) {
+        return false;
+    }
+
+    return true;
+}
+
+// for decoders with decode_into: decode in whatever size chunks the decoder likes, straight into the final buffer.
+//  If the decoder knows the duration up front, we allocate that (plus room for one chunk) once, instead of growing as we go.
+static bool DecodeWholeFileDirectly(const MIX_Decoder *decoder, void *track_userdata, const SDL_AudioSpec *spec, Sint64 duration_frames, Uint8 **decoded, size_t *bytes_decoded, size_t *allocated, MIX_LoudnessAnalyzer *loudness)
+{
+    SDL_assert(decoder->decode_into != NULL);
+    SDL_assert(spec->format == SDL_AUDIO_F32);
+
+    const int framesize = SDL_AUDIO_FRAMESIZE(*spec);
+    const int chunk_frames = (decoder->preferred_frames > 0) ? decoder->preferred_frames : 4096;
+    const size_t chunk_bytes = (size_t) chunk_frames * framesize;
+
+    if ((duration_frames > 0) && (*allocated == 0) && (((Uint64) duration_frames) < ((SDL_SIZE_MAX - chunk_bytes) / framesize))) {
+        const size_t len = (((size_t) duration_frames) * framesize) + chunk_bytes;
+        *decoded = ReallocDecodedAudio(NULL, 0, len);
+        if (!*decoded) {
+            return false;
+        }
+        *allocated = len;
+    }
+
+    while (true) {
+        const size_t needed = *bytes_decoded + chunk_bytes;
+        if (needed > *allocated) {
+            const size_t newlen = SDL_max(*allocated * 2, needed);
+            Uint8 *ptr = ReallocDecodedAudio(*decoded, *bytes_decoded, newlen);
+            if (!ptr) {
+                return false;
+            }
+            *decoded = ptr;
+            *allocated = newlen;
+        }
 
-    if (mixer->device_id) {
-        SDL_QuitSubSystem(SDL_INIT_AUDIO);
+        Uint8 *dst = *decoded + *bytes_decoded;
+        const int rc = decoder->decode_into(track_userdata, (float *) dst, chunk_frames);
+        if (rc < 0) {
+            break;  // all done.
+        }
+
+        const int br = rc * framesize;
+        *bytes_decoded += (size_t) br;
+        if (loudness && (br > 0) && !MIX_FeedLoudnessAnalyzer(loudness, dst, br)) {
+            return false;
+        }
     }
 
-    SDL_free(mixer);
+    return true;
 }
 
-SDL_PropertiesID MIX_GetMixerProperties(MIX_Mixer *mixer)
+// Predecoding can split the audio into ranges and decode them on separate threads, each with its own decoder instance,
+//  if the decoder's seeks are exact and cheap (so the ranges stitch together without seams, and each job can get to its
+//  range without decoding everything before it) and it knows the duration up front. Every job gets at least
+//  MIX_PREDECODE_MIN_SECONDS_PER_THREAD of audio, so starting a thread per job is noise next to the decoding, and
+//  there's no persistent worker pool to manage across MIX_Init/MIX_Quit.
+#define MIX_MAX_PREDECODE_THREADS 8
+#define MIX_PREDECODE_MIN_SECONDS_PER_THREAD 10
+
+typedef struct MIX_PredecodeJob
 {
-    if (!CheckMixerParam(mixer)) {
+    const MIX_Decoder *decoder;
+    SDL_IOStream *io;
+    void *track_userdata;
+    SDL_Thread *thread;
+    Uint64 start_frame;
+    Uint64 frames;
+    float *dst;
+    int channels;
+    int chunk_frames;
+    bool okay;
+} MIX_PredecodeJob;
+
+static int SDLCALL PredecodeJobThread(void *data)
+{
+    MIX_PredecodeJob *job = (MIX_PredecodeJob *) data;
+    const MIX_Decoder *decoder = job->decoder;
+
+    if ((job->start_frame > 0) && !decoder->seek(job->track_userdata, job->start_frame)) {
         return 0;
     }
 
-    if (mixer->props == 0) {
-        mixer->props = SDL_CreateProperties();
+    float *dst = job->dst;
+    Uint64 remaining = job->frames;
+    while (remaining > 0) {
+        const int rc = decoder->decode_into(job->track_userdata, dst, (int) SDL_min(remaining, (Uint64) job->chunk_frames));
+        if (rc < 0) {
+            return 0;  // ran out early, so the duration was wrong and the ranges won't line up.
+        }
+        dst += ((size_t) rc) * job->channels;
+        remaining -= (Uint64) rc;
     }
-    return mixer->props;
+
+    job->okay = true;
+    return 0;
 }
 
-bool MIX_GetMixerFormat(MIX_Mixer *mixer, SDL_AudioSpec *spec)
+// Returns false if the work can't (or shouldn't) be split up, or if splitting it failed; the caller should decode serially, as usual, in that case.
+//  If `loudness` isn't NULL, it sees each job's range as it's stitched in, in order, while later jobs are still decoding. If this
+//  fails, `loudness` is reset, so the serial decode can start over with it.
+static bool DecodeWholeFileInParallel(MIX_Audio *audio, SDL_IOStream *io, Uint8 **decoded, size_t *bytes_decoded, size_t *allocated, MIX_LoudnessAnalyzer *loudness)
 {
-    if (!CheckMixerParam(mixer)) {
+    const MIX_Decoder *decoder = audio->decoder;
+    const SDL_AudioSpec *spec = &audio->spec;
+    const Sint64 duration_frames = audio->duration_frames;
+
+    if (!decoder->exact_seek || !decoder->decode_into || (spec->format != SDL_AUDIO_F32) || (duration_frames <= 0)) {
         return false;
-    } else if (!spec) {
-        return SDL_InvalidParamError("spec");
     }
-    return SDL_GetAudioStreamFormat(mixer->output_stream, NULL, spec);
-}
 
-static const MIX_Decoder *PrepareDecoder(SDL_IOStream *io, MIX_Audio *audio)
-{
-    const char *decoder_name = SDL_GetStringProperty(audio->props, MIX_PROP_AUDIO_DECODER_STRING, NULL);
+    const Uint64 min_frames_per_job = ((Uint64) spec->freq) * MIX_PREDECODE_MIN_SECONDS_PER_THREAD;
+    const int max_jobs = SDL_min(SDL_GetNumLogicalCPUCores(), MIX_MAX_PREDECODE_THREADS);
+    const int num_jobs = (int) SDL_min((Uint64) SDL_max(max_jobs, 1), ((Uint64) duration_frames) / min_frames_per_job);
+    const int framesize = SDL_AUDIO_FRAMESIZE(*spec);
+    const int chunk_frames = (decoder->preferred_frames > 0) ? decoder->preferred_frames : 4096;
+    const size_t chunk_bytes = (size_t) chunk_frames * framesize;
+    if ((num_jobs < 2) || (((Uint64) duration_frames) >= ((SDL_SIZE_MAX - chunk_bytes) / framesize))) {
+        return false;
+    }
 
-    SDL_AudioSpec original_spec;
-    SDL_copyp(&original_spec, &audio->spec);
+    // every job needs its own SDL_IOStream, so give each one a view of the (compressed) data in memory. `io` is the
+    //  precache (the ID3 tags, etc, are already gone from it); if we're streaming from the app's stream instead, decode serially.
+    size_t datalen = 0;
+    const Uint8 *data = (const Uint8 *) MIX_GetConstIOBuffer(io, &datalen);
+    if (!data) {
+        return false;
+    }
 
-    for (int i = 0; i < num_available_decoders; i++) {
-        const MIX_Decoder *decoder = available_decoders[i];
-        if (!decoder_name || (SDL_strcasecmp(decoder->name, decoder_name) == 0)) {
-            if (decoder->init_audio(io, &audio->spec, audio->props, &audio->duration_frames, &audio->decoder_userdata)) {
-                audio->decoder = decoder;
-                return decoder;
-            } else if (SDL_SeekIO(io, 0, SDL_IO_SEEK_SET) == -1) {   // note this seeks to offset 0, because we're using an IoClamp.
-                SDL_SetError("Can't seek in stream to find proper decoder");
-                return NULL;
+    // every job but the first seeks to its range before decoding. If the decoder needs a seek table for that to be
+    //  cheap, build it once here (it's shared by all the jobs), and if that doesn't work, decoding serially is faster.
+    bool okay = true;
+    if (decoder->build_seek_index) {
+        SDL_IOStream *indexio = SDL_IOFromConstMem(data, datalen);
+        okay = indexio && decoder->build_seek_index(audio->decoder_userdata, indexio);
+        if (indexio) {
+            SDL_CloseIO(indexio);
+        }
+    }
+
+    const size_t buflen = (((size_t) duration_frames) * framesize) + chunk_bytes;
+    Uint8 *buffer = okay ? ReallocDecodedAudio(NULL, 0, buflen) : NULL;
+    okay = okay && (buffer != NULL);
+
+    MIX_PredecodeJob jobs[MIX_MAX_PREDECODE_THREADS];
+    SDL_zeroa(jobs);
+
+    const Uint64 frames_per_job = ((Uint64) duration_frames) / num_jobs;
+    for (int i = 0; okay && (i < num_jobs); i++) {
+        MIX_PredecodeJob *job = &jobs[i];
+        job->decoder = decoder;
+        job->start_frame = frames_per_job * i;
+        job->frames = (i == (num_jobs - 1)) ? (((Uint64) duration_frames) - job->start_frame) : frames_per_job;
+        job->dst = (float *) (buffer + (job->start_frame * framesize));
+        job->channels = spec->channels;
+        job->chunk_frames = chunk_frames;
+        job->io = SDL_IOFromConstMem(data, datalen);
+        okay = job->io && decoder->init_track(audio->decoder_userdata, job->io, spec, audio->props, &job->track_userdata);
+    }
+
+    if (okay) {
+        // the first job runs on this thread. If a thread won't start, we run that job here, too, when its turn comes.
+        for (int i = 1; i < num_jobs; i++) {
+            jobs[i].thread = SDL_CreateThread(PredecodeJobThread, "SDL_mixer predecode", &jobs[i]);
+        }
+
+        // collect the jobs in order, so the loudness analyzer can look at each range while the later ones are still decoding.
+        //  Keep waiting on all of them even if one fails, since they're all writing into `buffer`.
+        for (int i = 0; i < num_jobs; i++) {
+            if (jobs[i].thread) {
+                SDL_WaitThread(jobs[i].thread, NULL);
+            } else {
+                PredecodeJobThread(&jobs[i]);
+            }
+
+            okay = okay && jobs[i].okay;
+            if (okay && loudness) {
+                const Uint8 *ptr = (const Uint8 *) jobs[i].dst;
+                const size_t feed_bytes = chunk_bytes * 64;
+                for (size_t remaining = (size_t) (jobs[i].frames * framesize); okay && remaining; ) {
+                    const size_t cpy = SDL_min(remaining, feed_bytes);
+                    okay = MIX_FeedLoudnessAnalyzer(loudness, ptr, (int) cpy);
+                    ptr += cpy;
+                    remaining -= cpy;
+                }
             }
-            SDL_copyp(&audio->spec, &original_spec);  // reset this, in case init_audio changed it and then failed.
         }
     }
 
-    SDL_SetError("Audio data is in unknown/unsupported/corrupt format");
-    return NULL;
+    // the duration might have been an estimate that came up short, so let the last job's decoder carry on to the real end.
+    //  (nothing else is writing to the buffer now, so it's safe for this to grow it.)
+    if (okay) {
+        *decoded = buffer;
+        *bytes_decoded = ((size_t) duration_frames) * framesize;
+        *allocated = buflen;
+        buffer = NULL;  // *decoded owns this now.
+        okay = DecodeWholeFileDirectly(decoder, jobs[num_jobs - 1].track_userdata, spec, duration_frames, decoded, bytes_decoded, allocated, loudness);
+    }
+
+    for (int i = 0; i < num_jobs; i++) {
+        if (jobs[i].track_userdata) {
+            decoder->quit_track(jobs[i].track_userdata);
+        }
+        if (jobs[i].io) {
+            SDL_CloseIO(jobs[i].io);
+        }
+    }
+    SDL_aligned_free(buffer);
+
+    if (!okay) {
+        SDL_aligned_free(*decoded);
+        *decoded = NULL;
+        *bytes_decoded = 0;
+        *allocated = 0;
+        if (loudness) {
+            MIX_ResetLoudnessAnalyzer(loudness);  // it might have seen some of this already.
+        }
+    }
+
+    return okay;
 }
 
-static void *DecodeWholeFile(MIX_Audio *audio, SDL_IOStream *io, size_t *decoded_len)
+// if `loudness` isn't NULL, it sees the decoded audio as it goes by, so we don't have to decode twice to analyze it.
+//  The result is from SDL_aligned_alloc.
+static void *DecodeWholeFile(MIX_Audio *audio, SDL_IOStream *io, size_t *decoded_len, MIX_LoudnessAnalyzer *loudness)
 {
     size_t bytes_decoded = 0;
+    size_t allocated = 0;
     Uint8 *decoded = NULL;
+    bool okay = false;
     SDL_AudioStream *stream = SDL_CreateAudioStream(&audio->spec, &audio->spec);   // !!! FIXME: if we're decoding up front, we might as well convert to float here too, right?
     if (stream) {
         const MIX_Decoder *decoder = audio->decoder;
         void *track_userdata = NULL;
-        if (decoder->init_track(audio->decoder_userdata, io, &audio->spec, audio->props, &track_userdata)) {
-            while (decoder->decode(track_userdata, stream)) {
-                // spin.
+        if (DecodeWholeFileInParallel(audio, io, &decoded, &bytes_decoded, &allocated, loudness)) {
+            okay = true;
+        } else if (decoder->init_track(audio->decoder_userdata, io, &audio->spec, audio->props, &track_userdata)) {
+            okay = true;
+            if (decoder->decode_into && (audio->spec.format == SDL_AUDIO_F32)) {  // skip the stream entirely.
+                okay = DecodeWholeFileDirectly(decoder, track_userdata, &audio->spec, audio->duration_frames, &decoded, &bytes_decoded, &allocated, loudness);
+            } else {
+                while (decoder->decode(track_userdata, stream)) {
+                    if (loudness) {  // otherwise, just let it pile up in the stream, and we'll allocate exactly once at the end.
+                        okay = DrainDecodedAudio(stream, &decoded, &bytes_decoded, &allocated, loudness);
+                        if (!okay) {
+                            break;
+                        }
+                    }
+                }
             }
             decoder->quit_track(track_userdata);
 
-            SDL_FlushAudioStream(stream);
-            const int available = SDL_GetAudioStreamAvailable(stream);
-            decoded = (Uint8 *) SDL_malloc(available);   // !!! FIXME: SIMD align?
-            if (decoded) {
-                const int rc = SDL_GetAudioStreamData(stream, decoded, available);
-                SDL_assert((rc < 0) || (rc == available));
-                if (rc < 0) {
-                    SDL_free(decoded);
-                    decoded = NULL;
-                } else {
-                    bytes_decoded = (size_t) available;
-                }
+            okay = okay && SDL_FlushAudioStream(stream) && DrainDecodedAudio(stream, &decoded, &bytes_decoded, &allocated, loudness);
+            if (okay && !decoded) {
+                decoded = ReallocDecodedAudio(NULL, 0, 1);  // no audio at all, but that's still a successful decode.
+                okay = (decoded != NULL);
+            }
+        }
+
+        // give back what the buffer growth overallocated. This is a copy now, so don't bother if it's just the last chunk or so.
+        if (okay && bytes_decoded && ((allocated - bytes_decoded) > (bytes_decoded / 4))) {
+            Uint8 *ptr = ReallocDecodedAudio(NULL, 0, bytes_decoded);
+            if (ptr) {
+                SDL_memcpy(ptr, decoded, bytes_decoded);
+                SDL_aligned_free(decoded);
+                decoded = ptr;
             }
         }
         SDL_DestroyAudioStream(stream);
     }
 
+    if (!okay) {
+        SDL_aligned_free(decoded);
+        decoded = NULL;
+        bytes_decoded = 0;
+    }
+
     *decoded_len = bytes_decoded;
     return decoded;
 }
 
+// Run a decoder over the audio just to measure its loudness. This is for audio we aren't predecoding.
+static bool AnalyzeAudioLoudness(MIX_Audio *audio, SDL_IOStream *io)
+{
+    MIX_LoudnessAnalyzer *loudness = MIX_CreateLoudnessAnalyzer(&audio->spec);
+    if (!loudness) {
+        return false;
+    }
+
+    bool okay = true;
+    if ((audio->decoder == &MIX_Decoder_RAW) && audio->precache) {   // it's already PCM in RAM, just look at it.
+        const Uint8 *ptr = (const Uint8 *) audio->precache;
+        size_t remaining = audio->precachelen;
+        while (okay && remaining) {
+            const int cpy = (int) SDL_min(remaining, 1024 * 1024);
+            okay = MIX_FeedLoudnessAnalyzer(loudness, ptr, cpy);
+            ptr += cpy;
+            remaining -= cpy;
+        }
+    } else {
+        SDL_IOStream *dataio = audio->precache ? SDL_IOFromConstMem(audio->precache, audio->precachelen) : io;
+        SDL_AudioStream *stream = SDL_CreateAudioStream(&audio->spec, &audio->spec);
+        void *track_userdata = NULL;
+        okay = dataio && stream && (SDL_SeekIO(dataio, 0, SDL_IO_SEEK_SET) == 0) && audio->decoder->init_track(audio->decoder_userdata, dataio, &audio->spec, audio->props, &track_userdata);
+        if (okay) {
+            Uint8 buffer[16 * 1024];
+            bool decoding = true;
+            while (okay && decoding) {
+                decoding = audio->decoder->decode(track_userdata, stream);
+                if (!decoding) {
+                    okay = SDL_FlushAudioStream(stream);
+                }
+                int br;
+                while (okay && ((br = SDL_GetAudioStreamData(stream, buffer, sizeof (buffer))) > 0)) {
+                    okay = MIX_FeedLoudnessAnalyzer(loudness, buffer, br);
+                }
+            }
+            audio->decoder->quit_track(track_userdata);
+        }
+
+        SDL_DestroyAudioStream(stream);
+        if (dataio && (dataio != io)) {
+            SDL_CloseIO(dataio);
+        } else if (dataio && (SDL_SeekIO(dataio, 0, SDL_IO_SEEK_SET) == -1)) {   // put this back for the tracks that will read from it.
+            okay = false;
+        }
+    }
+
+    okay = okay && MIX_FinishLoudnessAnalyzer(loudness, audio->props);
+    MIX_DestroyLoudnessAnalyzer(loudness);
+    return okay;
+}
+
+// Have the decoder build its seek table from the precached data, so seek() doesn't have to scan the file.
+static bool BuildAudioSeekIndex(MIX_Audio *audio)
+{
+    // the table's offsets have to match what tracks will see, which is the whole precache (ID3 tags, etc, were cut off when it loaded).
+    SDL_IOStream *io = SDL_IOFromConstMem(audio->precache, audio->precachelen);
+    if (!io) {
+        return false;
+    }
+    const bool retval = audio->decoder->build_seek_index(audio->decoder_userdata, io);
+    SDL_CloseIO(io);
+    return retval;
+}
+
+static int SDLCALL SeekIndexThread(void *data)
+{
+    SDL_LockMutex(seek_index_lock);
+    while (!seek_index_quit) {
+        MIX_Audio *audio = seek_index_queue;
+        if (!audio) {
+            SDL_WaitCondition(seek_index_cond, seek_index_lock);
+            continue;
+        }
+
+        seek_index_queue = audio->seek_index_next;
+        audio->seek_index_next = NULL;
+        seek_index_busy = audio;
+        SDL_UnlockMutex(seek_index_lock);
+
+        BuildAudioSeekIndex(audio);  // if this fails, seeks just take the decoder's slower path.
+
+        SDL_LockMutex(seek_index_lock);
+        seek_index_busy = NULL;
+        SDL_BroadcastCondition(seek_index_cond);  // UnrefAudio might be waiting for this one.
+    }
+    SDL_UnlockMutex(seek_index_lock);
+    return 0;
+}
+
+// hand `audio` to the seek index thread, starting it if this is the first time. If that fails, seeks take the slower path.
+static void QueueAudioSeekIndex(MIX_Audio *audio)
+{
+    SDL_LockMutex(seek_index_lock);
+    if (!seek_index_thread) {
+        seek_index_thread = SDL_CreateThread(SeekIndexThread, "SDL_mixer seek index", NULL);
+    }
+    if (seek_index_thread) {
+        MIX_Audio **tail = &seek_index_queue;
+        while (*tail) {
+            tail = &(*tail)->seek_index_next;
+        }
+        *tail = audio;
+        SDL_BroadcastCondition(seek_index_cond);
+    }
+    SDL_UnlockMutex(seek_index_lock);
+}
+
+// make sure the seek index thread is done with `audio`, since it's about to go away.
+static void CancelAudioSeekIndex(MIX_Audio *audio)
+{
+    SDL_LockMutex(seek_index_lock);
+    for (MIX_Audio **prev = &seek_index_queue; *prev; prev = &(*prev)->seek_index_next) {
+        if (*prev == audio) {
+            *prev = audio->seek_index_next;
+            audio->seek_index_next = NULL;
+            break;
+        }
+    }
+    while (seek_index_busy == audio) {
+        SDL_WaitCondition(seek_index_cond, seek_index_lock);
+    }
+    SDL_UnlockMutex(seek_index_lock);
+}
+
 MIX_Audio *MIX_LoadAudioWithProperties(SDL_PropertiesID props)  // lets you specify things like "here's a path to MIDI instrument data outside of this file", etc.
 {
     if (!CheckInitialized()) {
@@ -976,10 +2506,14 @@ MIX_Audio *MIX_LoadAudioWithProperties(SDL_PropertiesID props)  // lets you spec
     const bool closeio = SDL_GetBooleanProperty(props, MIX_PROP_AUDIO_LOAD_CLOSEIO_BOOLEAN, false);
     const bool ondemand = SDL_GetBooleanProperty(props, MIX_PROP_AUDIO_LOAD_ONDEMAND_BOOLEAN, false);
     const bool skip_metadata_tags = SDL_GetBooleanProperty(props, MIX_PROP_AUDIO_LOAD_SKIP_METADATA_TAGS_BOOLEAN, false);
+    const bool analyze_loudness = SDL_GetBooleanProperty(props, MIX_PROP_AUDIO_LOAD_ANALYZE_LOUDNESS_BOOLEAN, false);
+    const bool build_seek_table = SDL_GetBooleanProperty(props, MIX_PROP_AUDIO_LOAD_BUILD_SEEK_TABLE_BOOLEAN, false);
+    bool need_loudness = false;
     void *audio_userdata = NULL;
     const MIX_Decoder *decoder = NULL;
     SDL_IOStream *io = NULL;
     SDL_IOStream *ioclamp = NULL;
+    SDL_IOStream *precacheio = NULL;
     MIX_IoClamp clamp;
     SDL_AudioSpec recommended_spec = { SDL_AUDIO_F32, 2, 48000 };  // a reasonable default if no mixer specified.
     if (mixer) {
@@ -1027,6 +2561,26 @@ MIX_Audio *MIX_LoadAudioWithProperties(SDL_PropertiesID props)  // lets you spec
         }
     }
 
+    // unless we're streaming from `io` on demand, pull the whole thing into RAM now, and let the decoder look at it there. This is the
+    //  precache tracks will share (or the source data for predecoding), so decoders that need the whole file (GME, etc) can use it in
+    //  place instead of making their own copy. This reads through the IoClamp, so the ID3 tags, etc, are already gone from it.
+    if (!ondemand) {
+        if ((audio->precache = SDL_LoadFile_IO(io, &audio->precachelen, false)) == NULL) {
+            goto failed;
+        }
+        audio->free_precache = true;
+
+        if (ioclamp) {
+            SDL_CloseIO(ioclamp);  // IoClamp's close doesn't close the original stream, but we still need to free its resources here.
+            ioclamp = NULL;
+        }
+
+        io = precacheio = SDL_IOFromConstMem(audio->precache, audio->precachelen);
+        if (!io) {
+            goto failed;
+        }
+    }
+
     // the decoder sets audio->spec to whatever it's actually providing, but we pass the current hardware setting in, in case that's useful for
     // things that generate audio in whatever format (for example, a MIDI decoder is going to generate PCM from "notes", so it can do it at any
     // sample rate, so it might as well do it at device format to avoid an unnecessary resample later).
@@ -1047,21 +2601,60 @@ MIX_Audio *MIX_LoadAudioWithProperties(SDL_PropertiesID props)  // lets you spec
     // set this before predecoding might change `decoder` to the RAW implementation.
     SDL_SetStringProperty(audio->props, MIX_PROP_AUDIO_DECODER_STRING, decoder->name);
 
+    // decoders have added any Ogg comments by now, so see if ReplayGain/R128 tags already told us the loudness, so we don't have to measure it.
+    if (!MIX_ResolveLoudnessTags(audio->props)) {
+        need_loudness = analyze_loudness && (audio->duration_frames != MIX_DURATION_INFINITE);
+    }
+
     // if this is already raw data, predecoding is just going to make a copy of it, so skip it.
     if (predecode && (decoder != &MIX_Decoder_RAW) && (audio->duration_frames != MIX_DURATION_INFINITE)) {
-        audio->precache = DecodeWholeFile(audio, io, &audio->precachelen);
-        if (!audio->precache) {
+        MIX_LoudnessAnalyzer *loudness = need_loudness ? MIX_CreateLoudnessAnalyzer(&audio->spec) : NULL;   // if this fails, we just won't report loudness.
+        size_t decodedlen = 0;
+        void *decoded = DecodeWholeFile(audio, io, &decodedlen, loudness);
+        if (loudness) {
+            if (decoded) {
+                MIX_FinishLoudnessAnalyzer(loudness, audio->props);
+            }
+            MIX_DestroyLoudnessAnalyzer(loudness);
+            need_loudness = false;
+        }
+        if (!decoded) {
             goto failed;
         }
-        audio->free_precache = true;
 
+        // the decoder might be using the original data in place, so shut it down before the decoded data replaces it.
         decoder->quit_audio(audio_userdata);
         decoder = audio->decoder = &MIX_Decoder_RAW;
         audio_userdata = audio->decoder_userdata = NULL;  // no audio_userdata state in the RAW decoder (so we can cheat here and not do a full init_audio().)
+
+        if (precacheio) {
+            SDL_CloseIO(precacheio);
+            io = precacheio = NULL;
+        }
+        SDL_free((void *) audio->precache);
+        audio->precache = decoded;
+        audio->precachelen = decodedlen;
+        audio->aligned_precache = true;
         audio->duration_frames = audio->precachelen / SDL_AUDIO_FRAMESIZE(audio->spec);
-    } else if (!ondemand) {  // precache the audio data, so all decoding happens from a single buffer in RAM shared between tracks.
-        if ((audio->precache = SDL_LoadFile_IO(io, &audio->precachelen, false)) == NULL) {
-            goto failed;
+    }
+
+    // loudness analysis is optional metadata, so if it fails, we still load the audio; the properties just won't be set.
+    if (need_loudness) {
+        AnalyzeAudioLoudness(audio, io);
+    }
+
+    // seek tables take a scan of the whole file, so do it here or in the background, and never in a seek() on the mixer thread.
+    //  If the app wants it now, or we aren't holding the data in RAM for a background thread to read, build it right here.
+    //  Otherwise, it's queued for the background thread once loading has succeeded, below.
+    const bool queue_seek_index = (decoder->build_seek_index && audio->precache && !build_seek_table);
+    if (decoder->build_seek_index && !queue_seek_index) {
+        if (audio->precache) {
+            BuildAudioSeekIndex(audio);
+        } else if (build_seek_table) {
+            decoder->build_seek_index(audio_userdata, io);
+            if (SDL_SeekIO(io, 0, SDL_IO_SEEK_SET) == -1) {  // put this back for the tracks that will read from it.
+                goto failed;
+            }
         }
     }
 
@@ -1070,6 +2663,11 @@ MIX_Audio *MIX_LoadAudioWithProperties(SDL_PropertiesID props)  // lets you spec
         io = ioclamp = NULL;
     }
 
+    if (precacheio) {
+        SDL_CloseIO(precacheio);  // this doesn't free the precache, it just stops reading from it.
+        io = precacheio = NULL;
+    }
+
     if (closeio) {
         SDL_CloseIO(origio);
         origio = NULL;
@@ -1092,6 +2690,10 @@ MIX_Audio *MIX_LoadAudioWithProperties(SDL_PropertiesID props)  // lets you spec
     all_audios = audio;
     UnlockGlobal();
 
+    if (queue_seek_index) {
+        QueueAudioSeekIndex(audio);
+    }
+
     return audio;
 
 failed:
@@ -1100,7 +2702,9 @@ failed:
     }
 
     if (audio) {
-        if (audio->precache) {
+        if (audio->aligned_precache) {
+            SDL_aligned_free((void *) audio->precache);
+        } else if (audio->precache) {
             SDL_free((void *) audio->precache);
         }
         if (audio->props) {
@@ -1113,6 +2717,10 @@ failed:
         SDL_CloseIO(ioclamp);  // IoClamp's close doesn't close the original stream, but we still need to free its resources here.
     }
 
+    if (precacheio) {
+        SDL_CloseIO(precacheio);
+    }
+
     if (origio && closeio) {
         SDL_CloseIO(origio);
     }
@@ -1311,19 +2919,45 @@ static void UnrefAudio(MIX_Audio *audio)
         }
         UnlockGlobal();
 
+        if (audio->decoder && audio->decoder->build_seek_index && audio->precache) {
+            CancelAudioSeekIndex(audio);  // the seek index thread might be using decoder_userdata and the precache.
+        }
         if (audio->decoder) {
             audio->decoder->quit_audio(audio->decoder_userdata);
         }
         if (audio->props) {
             SDL_DestroyProperties(audio->props);
         }
-        if (audio->free_precache) {
+        if (audio->aligned_precache) {
+            SDL_aligned_free((void *) audio->precache);
+        } else if (audio->free_precache) {
             SDL_free((void *) audio->precache);
         }
         SDL_free(audio);
     }
 }
 
+static void DestroyTrackQueueItems(MIX_TrackQueueItem *item)
+{
+    while (item) {
+        MIX_TrackQueueItem *next = item->next;
+        if (item->audio) {
+            item->audio->decoder->quit_track(item->decoder_userdata);
+            UnrefAudio(item->audio);
+        }
+        if (item->clamped_io) {
+            SDL_CloseIO(item->io);  // this is the clamp, not the actual stream.
+            item->io = item->clamped_io;  // this is the actual stream.
+        }
+        if (item->io && item->closeio) {
+            SDL_CloseIO(item->io);
+        }
+        SDL_DestroyAudioStream(item->stream);
+        SDL_free(item);
+        item = next;
+    }
+}
+
 void MIX_DestroyAudio(MIX_Audio *audio)
 {
     if (CheckAudioParam(audio)) {
@@ -1344,6 +2978,13 @@ MIX_Track *MIX_CreateTrack(MIX_Mixer *mixer)
     }
     SDL_zerop(track);
 
+    track->frequency_ratio = 1.0f;
+    track->doppler_ratio = 1.0f;
+    track->stop_mixer_frame = MIX_UNSCHEDULED_MIXER_FRAME;
+    track->normalization_gain = 1.0f;
+    track->output_ratio = 1.0f;
+    track->tempo = 1.0f;
+
     track->tags = SDL_CreateProperties();
     if (!track->tags) {
         SDL_free(track);
@@ -1425,21 +3066,28 @@ void MIX_DestroyTrack(MIX_Track *track)
     UnlockMixer(mixer);
 
     SDL_DestroyAudioStream(track->output_stream);
+    MIX_DestroyResampler(track->resampler);
+    MIX_DestroyTimeStretch(track->timestretch);
 
     if (track->input_audio) {
         track->input_audio->decoder->quit_track(track->decoder_userdata);
     }
 
     SDL_DestroyAudioStream(track->internal_stream);
+    DestroyTrackQueueItems(track->queue);
+    DestroyTrackQueueItems(track->retired);
+    DestroyTrackQueueItems(track->crossfade_from);
+    SDL_free(track->crossfade_buffer);
 
     UnrefAudio(track->input_audio);
     SDL_EnumerateProperties(track->tags, UntagWholeTrack, track);
     SDL_DestroyProperties(track->props);
     SDL_DestroyProperties(track->tags);
+    MIX_DestroyFilterChain(track->filters);
     SDL_free(track->input_buffer);
-    if (track->ioclamp.io) {  // if we applied an i/o clamp to the stream, close that unconditionally.
+    if (track->clamped_io) {  // if we applied an i/o clamp to the stream, close that unconditionally.
         SDL_CloseIO(track->io);   // this is the clamp, not the actual stream.
-        track->io = track->ioclamp.io;  // this is the actual stream.
+        track->io = track->clamped_io;  // this is the actual stream.
     }
     if (track->io && track->closeio) {
         SDL_CloseIO(track->io);
@@ -1479,6 +3127,10 @@ static bool MIX_SetTrackAudio_internal(MIX_Track *track, MIX_Audio *audio, SDL_I
 
     LockTrack(track);
 
+    EndTrackCrossfade(track);
+    DestroyTrackQueueItems(track->retired);  // clean these up now, since they might be holding decoder state for the input we're replacing.
+    track->retired = NULL;
+
     if (audio && (track->internal_stream == NULL)) {
         track->internal_stream = SDL_CreateAudioStream(&audio->spec, &spec);
         if (!track->internal_stream) {
@@ -1496,14 +3148,14 @@ static bool MIX_SetTrackAudio_internal(MIX_Track *track, MIX_Audio *audio, SDL_I
     if (track->input_audio) {
         track->input_audio->decoder->quit_track(track->decoder_userdata);
         UnrefAudio(track->input_audio);
-        if (track->ioclamp.io) {  // if we applied an i/o clamp to the stream, close that unconditionally.
+        if (track->clamped_io) {  // if we applied an i/o clamp to the stream, close that unconditionally.
             SDL_CloseIO(track->io);   // this is the clamp, not the actual stream.
-            track->io = track->ioclamp.io;  // this is the actual stream.
+            track->io = track->clamped_io;  // this is the actual stream.
         }
         if (track->io && track->closeio) {
             SDL_CloseIO(track->io);
         }
-        SDL_zero(track->ioclamp);
+        track->clamped_io = NULL;
         track->io = NULL;
         track->closeio = false;
     }
@@ -1513,21 +3165,20 @@ static bool MIX_SetTrackAudio_internal(MIX_Track *track, MIX_Audio *audio, SDL_I
 
     bool retval = true;
     if (audio) {
-        if (audio->clamp_offset >= 0) {   // clamp i/o so decoders don't see ID3 tags, etc.
-            SDL_IOStream *clampio = MIX_OpenIoClamp(&track->ioclamp, io);
+        // clamp i/o so decoders don't see ID3 tags, etc. The precache was loaded through a clamp, so they're already gone from it.
+        if ((audio->clamp_offset >= 0) && !audio->precache) {
+            SDL_IOStream *clampio = MIX_OpenIoClampRange(io, audio->clamp_offset, audio->clamp_length);
             if (!clampio) {
                 retval = false;
             } else {
                 io = clampio;
-                track->ioclamp.start = audio->clamp_offset;
-                track->ioclamp.length = audio->clamp_length;
             }
         }
 
         if (retval) {
-            retval = audio->decoder->init_track(audio->decoder_userdata, io, &audio->spec, audio->props, &track->decoder_userdata);
+            retval = audio->decoder->init_track(audio->decoder_userdata, io, &audio->spec, track->props, &track->decoder_userdata);
             if (!retval) {
-                if (track->ioclamp.io) {
+                if (io != origio) {
                     SDL_CloseIO(io);  // this was the IoClamp, not the real data stream.
                     io = origio;
                 }
@@ -1535,11 +3186,13 @@ static bool MIX_SetTrackAudio_internal(MIX_Track *track, MIX_Audio *audio, SDL_I
                 RefAudio(audio);
                 SDL_SetAudioStreamFormat(track->internal_stream, &audio->spec, &spec);   // input is from decoded audio, output is to output_stream
                 SetTrackOutputStreamFormat(track, &spec);   // input is from internal_stream, output is to mixer->output_stream (or, if spatializing, to mixer->output_stream but mono).
+                ReserveTrackTimeStretch(track, track->tempo);  // if this fails, the audio thread plays at normal speed instead of allocating.
                 track->input_audio = audio;
                 track->input_stream = track->internal_stream;
                 SDL_ClearAudioStream(track->input_stream);   // make sure that any extra buffered input from before is removed.
                 track->position = 0;
                 track->io = io;
+                track->clamped_io = (io != origio) ? origio : NULL;
                 track->closeio = closeio;
             }
         }
@@ -1580,18 +3233,22 @@ bool MIX_SetTrackAudioStream(MIX_Track *track, SDL_AudioStream *stream)
 
     LockTrack(track);
 
+    EndTrackCrossfade(track);
+    DestroyTrackQueueItems(track->retired);
+    track->retired = NULL;
+
     if (track->input_audio) {
         track->input_audio->decoder->quit_track(track->decoder_userdata);
         UnrefAudio(track->input_audio);
         track->input_audio = NULL;
-        if (track->ioclamp.io) {  // if we applied an i/o clamp to the stream, close that unconditionally.
+        if (track->clamped_io) {  // if we applied an i/o clamp to the stream, close that unconditionally.
             SDL_CloseIO(track->io);   // this is the clamp, not the actual stream.
-            track->io = track->ioclamp.io;  // this is the actual stream.
+            track->io = track->clamped_io;  // this is the actual stream.
         }
         if (track->io && track->closeio) {
             SDL_CloseIO(track->io);
         }
-        SDL_zero(track->ioclamp);
+        track->clamped_io = NULL;
         track->io = NULL;
         track->closeio = false;
         if (track->internal_stream) {
@@ -1605,41 +3262,225 @@ bool MIX_SetTrackAudioStream(MIX_Track *track, SDL_AudioStream *stream)
         spec.format = SDL_AUDIO_F32;  // we always work in float32.
         SDL_SetAudioStreamFormat(stream, NULL, &spec);                 // input is whatever, output is whatever in float format.
         SetTrackOutputStreamFormat(track, &spec);   // input is whatever in float format, output is to mixer->output_stream (or, if spatializing, to mixer->output_stream but mono).
+        ReserveTrackTimeStretch(track, track->tempo);  // if this fails, the audio thread plays at normal speed instead of allocating.
+    }
+
+    track->input_stream = stream;
+    track->position = 0;
+    UnlockTrack(track);
+
+    return true;
+}
+
+bool MIX_SetTrackIOStream(MIX_Track *track, SDL_IOStream *io, bool closeio)
+{
+    if (!CheckTrackParam(track)) {
+        return false;
+    } else if (!io) {
+        return MIX_SetTrackAudio(track, NULL);  // just drop the current input.
+    }
+
+    const SDL_PropertiesID props = SDL_CreateProperties();
+    SDL_SetPointerProperty(props, MIX_PROP_AUDIO_LOAD_PREFERRED_MIXER_POINTER, track->mixer);
+    SDL_SetPointerProperty(props, MIX_PROP_AUDIO_LOAD_IOSTREAM_POINTER, io);
+    SDL_SetBooleanProperty(props, MIX_PROP_AUDIO_LOAD_ONDEMAND_BOOLEAN, true);
+    MIX_Audio *audio = MIX_LoadAudioWithProperties(props);
+    SDL_DestroyProperties(props);
+    if (!audio) {
+        return false;
+    }
+
+    const bool retval = MIX_SetTrackAudio_internal(track, audio, io, closeio);
+
+    // Drop our reference to `audio` after the track accepts it, so when the track is
+    //  done with it, it'll unref it, and `audio` will be cleaned up. If the track failed
+    //  to accept the audio, this will clean it up right now.
+    UnrefAudio(audio);
+
+    return retval;
+}
+
+// how much to decode ahead when getting audio ready to play, so the mixer has something ready to go immediately.
+#define MIX_PREBUFFER_FRAMES 4096
+
+static MIX_TrackQueueItem *PrepareTrackQueueItem(MIX_Track *track, MIX_Audio *audio)
+{
+    MIX_TrackQueueItem *item = (MIX_TrackQueueItem *) SDL_calloc(1, sizeof (*item));
+    if (!item) {
+        return NULL;
+    }
+
+    // MIX_Audios given to the app are always precached, and the precache was loaded through an IoClamp, so ID3 tags, etc, are already gone.
+    SDL_assert(audio->precache != NULL);
+
+    SDL_AudioSpec spec;
+    SDL_copyp(&spec, &audio->spec);
+    spec.format = SDL_AUDIO_F32;  // we always work in float32.
+
+    item->io = SDL_IOFromConstMem(audio->precache, audio->precachelen);
+    item->closeio = true;
+    if (item->io) {
+        item->stream = SDL_CreateAudioStream(&audio->spec, &spec);
+    }
+
+    if (!item->stream || !audio->decoder->init_track(audio->decoder_userdata, item->io, &audio->spec, track->props, &item->decoder_userdata)) {
+        DestroyTrackQueueItems(item);  // item->audio is still NULL, so this won't call quit_track.
+        return NULL;
+    }
+
+    // we want this stream to survive SDL_Quit(), since it's not attached to an audio device.
+    SDL_SetBooleanProperty(SDL_GetAudioStreamProperties(item->stream), SDL_PROP_AUDIOSTREAM_AUTO_CLEANUP_BOOLEAN, false);
+
+    RefAudio(audio);
+    item->audio = audio;
+
+    // decode the first few blocks now, so the mixer doesn't have to right when it switches over.
+    const int prebuffer_bytes = MIX_PREBUFFER_FRAMES * SDL_AUDIO_FRAMESIZE(spec);
+    while (SDL_GetAudioStreamAvailable(item->stream) < prebuffer_bytes) {
+        if (!audio->decoder->decode(item->decoder_userdata, item->stream)) {
+            SDL_FlushAudioStream(item->stream);  // make sure we read _everything_ now.
+            break;
+        }
+    }
+
+    return item;
+}
+
+bool MIX_QueueTrackAudio(MIX_Track *track, MIX_Audio *audio)
+{
+    if (!CheckTrackParam(track)) {
+        return false;
+    } else if (!CheckAudioParam(audio)) {
+        return false;
+    }
+
+    MIX_TrackQueueItem *item = PrepareTrackQueueItem(track, audio);
+    if (!item) {
+        return false;
+    }
+
+    LockTrack(track);
+    MIX_TrackQueueItem **tail = &track->queue;
+    while (*tail) {
+        tail = &(*tail)->next;
+    }
+    *tail = item;
+    ReserveTrackTimeStretch(track, track->tempo);  // so switching to this on the audio thread doesn't allocate. If it fails, it'll play at normal speed.
+    MIX_TrackQueueItem *retired = track->retired;  // might as well clean these up while we're here.
+    track->retired = NULL;
+    UnlockTrack(track);
+
+    DestroyTrackQueueItems(retired);  // don't hold the track lock while tearing down decoders.
+
+    return true;
+}
+
+bool MIX_ClearTrackQueue(MIX_Track *track)
+{
+    if (!CheckTrackParam(track)) {
+        return false;
     }
 
-    track->input_stream = stream;
-    track->position = 0;
+    LockTrack(track);
+    MIX_TrackQueueItem *queue = track->queue;
+    MIX_TrackQueueItem *retired = track->retired;
+    track->queue = NULL;
+    track->retired = NULL;
     UnlockTrack(track);
 
+    DestroyTrackQueueItems(queue);
+    DestroyTrackQueueItems(retired);
+
     return true;
 }
 
-bool MIX_SetTrackIOStream(MIX_Track *track, SDL_IOStream *io, bool closeio)
+int MIX_GetTrackQueueLength(MIX_Track *track)
+{
+    if (!CheckTrackParam(track)) {
+        return -1;
+    }
+
+    int retval = 0;
+    LockTrack(track);
+    for (const MIX_TrackQueueItem *item = track->queue; item; item = item->next) {
+        retval++;
+    }
+    UnlockTrack(track);
+
+    return retval;
+}
+
+bool MIX_CrossfadeTrackAudio(MIX_Track *track, MIX_Audio *audio, Sint64 frames, MIX_CrossfadeCurve curve)
 {
     if (!CheckTrackParam(track)) {
         return false;
-    } else if (!io) {
-        return MIX_SetTrackAudio(track, NULL);  // just drop the current input.
+    } else if (!CheckAudioParam(audio)) {
+        return false;
+    } else if ((curve != MIX_CROSSFADE_EQUAL_POWER) && (curve != MIX_CROSSFADE_LINEAR)) {
+        return SDL_InvalidParamError("curve");
     }
 
-    const SDL_PropertiesID props = SDL_CreateProperties();
-    SDL_SetPointerProperty(props, MIX_PROP_AUDIO_LOAD_PREFERRED_MIXER_POINTER, track->mixer);
-    SDL_SetPointerProperty(props, MIX_PROP_AUDIO_LOAD_IOSTREAM_POINTER, io);
-    SDL_SetBooleanProperty(props, MIX_PROP_AUDIO_LOAD_ONDEMAND_BOOLEAN, true);
-    MIX_Audio *audio = MIX_LoadAudioWithProperties(props);
-    SDL_DestroyProperties(props);
-    if (!audio) {
+    MIX_TrackQueueItem *item = PrepareTrackQueueItem(track, audio);
+    if (!item) {
         return false;
     }
 
-    const bool retval = MIX_SetTrackAudio_internal(track, audio, io, closeio);
+    // allocate this here, so the audio thread never has to. If the track already has one, we free this again below.
+    float *crossfade_buffer = (frames > 0) ? (float *) SDL_malloc(MIX_CROSSFADE_BUFFER_BYTES) : NULL;
 
-    // Drop our reference to `audio` after the track accepts it, so when the track is
-    //  done with it, it'll unref it, and `audio` will be cleaned up. If the track failed
-    //  to accept the audio, this will clean it up right now.
-    UnrefAudio(audio);
+    LockTrack(track);
 
-    return retval;
+    if (!track->crossfade_buffer) {
+        track->crossfade_buffer = crossfade_buffer;
+        crossfade_buffer = NULL;
+    }
+
+    // if we're already crossfading, the current input is only partway faded in, so it fades out from that level instead of jumping to full volume.
+    float current_gain = 1.0f;
+    if (track->crossfade_frames > 0) {
+        current_gain = CrossfadeGain(track->crossfade_curve, ((float) (track->crossfade_total_frames - track->crossfade_frames)) / ((float) track->crossfade_total_frames));
+    }
+
+    const bool was_stopped = (track->state == MIX_STATE_STOPPED);
+    MIX_TrackQueueItem *old = SwapTrackInput(track, item);
+    ReserveTrackTimeStretch(track, track->tempo);  // if this fails, the audio thread plays at normal speed instead of allocating.
+    if ((frames > 0) && !was_stopped && old->audio && track->crossfade_buffer) {
+        old->crossfade_gain = current_gain;
+        old->crossfade_total_frames = frames;
+        old->crossfade_frames = frames;
+        old->crossfade_curve = curve;
+        old->next = track->crossfade_from;  // anything that was already fading out keeps going on its own schedule.
+        track->crossfade_from = old;
+
+        // convert everything fading out to match the new audio, so ApplyCrossfade can just add them.
+        SDL_AudioSpec spec;
+        SDL_GetAudioStreamFormat(track->input_stream, NULL, &spec);
+        for (MIX_TrackQueueItem *from = track->crossfade_from; from; from = from->next) {
+            SDL_SetAudioStreamFormat(from->stream, NULL, &spec);
+        }
+    } else {
+        EndTrackCrossfade(track);  // switching immediately, so anything still fading out stops, too.
+        RetireTrackInput(track, old);
+    }
+
+    track->crossfade_total_frames = SDL_max(frames, 0);
+    track->crossfade_frames = track->crossfade_total_frames;
+    track->crossfade_curve = curve;
+
+    if (was_stopped) {
+        track->start_mixer_frame = 0;
+        track->stop_mixer_frame = MIX_UNSCHEDULED_MIXER_FRAME;
+        track->state = MIX_STATE_PLAYING;
+    }
+
+    MIX_TrackQueueItem *retired = track->retired;
+    track->retired = NULL;
+    UnlockTrack(track);
+
+    DestroyTrackQueueItems(retired);  // don't hold the track lock while tearing down decoders.
+    SDL_free(crossfade_buffer);  // if the track already had one.
+
+    return true;
 }
 
 static void SDLCALL CleanupTagList(void *userdata, void *value)
@@ -1768,12 +3609,34 @@ void MIX_UntagTrack(MIX_Track *track, const char *tag)
     SDL_UnlockProperties(tags);
 }
 
-bool MIX_SetTrackPlaybackPosition(MIX_Track *track, Uint64 frames)
+// a start_mixer_frame that never arrives, so a track waits until a whole group of them is ready; see ReleaseHeldTrack.
+#define MIX_HELD_MIXER_FRAME (~((Uint64) 0))
+
+// Decode a little ahead, so a track that's about to start doesn't have to do it in the mixer callback. Callers set
+//  track->prebuffering first, so the mixer callback skips this track instead of waiting on the lock while we decode.
+// this assumes LockTrack(track) was called before this.
+static void PrebufferTrack(MIX_Track *track)
 {
-    if (!CheckTrackParam(track)) {
-        return false;
+    if (track->input_audio) {
+        SDL_AudioSpec spec;
+        SDL_GetAudioStreamFormat(track->input_stream, NULL, &spec);
+        DecodeMore(track, MIX_PREBUFFER_FRAMES * SDL_AUDIO_FRAMESIZE(spec));
+    }
+}
+
+// let a track that was held by PlayTrack or SeekTrack mix again. Do this for a group of tracks with the mixer locked, so they all go at once.
+static void ReleaseHeldTrack(MIX_Track *track, Uint64 start_mixer_frame)
+{
+    LockTrack(track);
+    if (track->start_mixer_frame == MIX_HELD_MIXER_FRAME) {
+        track->start_mixer_frame = start_mixer_frame;
     }
+    UnlockTrack(track);
+}
 
+// if `hold` is true, the track won't mix again until ReleaseHeldTrack is called, and anything already converted for mixing is dropped.
+static bool SeekTrack(MIX_Track *track, Uint64 frames, bool hold)
+{
     bool retval = true;
 
     // !!! FIXME: should it be legal to seek past the end of an track (so it just stops immediately, or maybe stops on next callback)?
@@ -1788,7 +3651,18 @@ bool MIX_SetTrackPlaybackPosition(MIX_Track *track, Uint64 frames)
         retval = track->input_audio->decoder->seek(track->decoder_userdata, frames);
         if (retval) {
             SDL_ClearAudioStream(track->input_stream);   // make sure that any extra buffered input from before the seek is removed.
+            if (track->resampler) {
+                MIX_ResetResampler(track->resampler);
+            }
+            if (track->timestretch) {
+                MIX_ResetTimeStretch(track->timestretch);  // don't splice audio from before the seek into what comes after it.
+            }
             track->position = frames;
+            if (hold && (track->state != MIX_STATE_STOPPED)) {
+                SDL_ClearAudioStream(track->output_stream);  // other tracks in the group might have more or less of this buffered, so dump it.
+                track->start_mixer_frame = MIX_HELD_MIXER_FRAME;
+                PrebufferTrack(track);
+            }
         }
     }
     UnlockTrack(track);
@@ -1796,6 +3670,50 @@ bool MIX_SetTrackPlaybackPosition(MIX_Track *track, Uint64 frames)
     return retval;
 }
 
+bool MIX_SetTrackPlaybackPosition(MIX_Track *track, Uint64 frames)
+{
+    if (!CheckTrackParam(track)) {
+        return false;
+    }
+    return SeekTrack(track, frames, false);
+}
+
+bool MIX_SetTagPlaybackPosition(MIX_Mixer *mixer, const char *tag, Uint64 frames)
+{
+    if (!CheckMixerTagParam(mixer, tag)) {
+        return false;
+    }
+
+    MIX_TagList *list = (MIX_TagList *) SDL_GetPointerProperty(mixer->track_tags, tag, NULL);
+    if (!list) {
+        return true;  // nothing is using this tag, do nothing (but not an error).
+    }
+
+    bool retval = true;
+    SDL_LockRWLockForReading(list->rwlock);
+    const size_t total = list->num_tracks;
+
+    // seek and decode without the mixer locked, so we don't stall the audio device; the tracks are held silent until everything is ready.
+    for (size_t i = 0; i < total; i++) {
+        MIX_Track *track = list->tracks[i];
+        SDL_SetAtomicInt(&track->prebuffering, 1);
+        if (!SeekTrack(track, frames, true)) {
+            retval = false;
+        }
+        SDL_SetAtomicInt(&track->prebuffering, 0);
+    }
+
+    LockMixer(mixer);  // so all tracks continue at the same time.
+    for (size_t i = 0; i < total; i++) {
+        ReleaseHeldTrack(list->tracks[i], 0);
+    }
+    UnlockMixer(mixer);
+
+    SDL_UnlockRWLock(list->rwlock);
+
+    return retval;
+}
+
 Sint64 MIX_GetTrackPlaybackPosition(MIX_Track *track)
 {
     Sint64 retval = -1;
@@ -1939,11 +3857,29 @@ static Sint64 GetTrackOptionFramesOrTicks(MIX_Track *track, SDL_PropertiesID opt
     return defval;
 }
 
-bool MIX_PlayTrack(MIX_Track *track, SDL_PropertiesID options)
+static float GetTrackOptionNormalizationGain(MIX_Track *track, SDL_PropertiesID options)
 {
-    if (!CheckTrackParam(track)) {
-        return false;
-    } else if (!track->input_audio && !track->input_stream) {
+    if (!track->input_audio || !SDL_HasProperty(options, MIX_PROP_PLAY_LOUDNESS_TARGET_FLOAT)) {
+        return 1.0f;
+    }
+
+    const SDL_PropertiesID props = track->input_audio->props;
+    if (!SDL_HasProperty(props, MIX_PROP_METADATA_LOUDNESS_INTEGRATED_FLOAT)) {
+        return 1.0f;  // we don't know how loud it is, so leave it alone.
+    }
+
+    const float target = SDL_GetFloatProperty(options, MIX_PROP_PLAY_LOUDNESS_TARGET_FLOAT, -23.0f);
+    float gain_db = target - SDL_GetFloatProperty(props, MIX_PROP_METADATA_LOUDNESS_INTEGRATED_FLOAT, target);
+    if (SDL_HasProperty(props, MIX_PROP_METADATA_LOUDNESS_TRUE_PEAK_FLOAT)) {   // don't push peaks past -1dBTP.
+        gain_db = SDL_min(gain_db, -1.0f - SDL_GetFloatProperty(props, MIX_PROP_METADATA_LOUDNESS_TRUE_PEAK_FLOAT, 0.0f));
+    }
+    return SDL_powf(10.0f, gain_db / 20.0f);
+}
+
+// if `hold` is true, the track won't start mixing until ReleaseHeldTrack is called.
+static bool PlayTrack(MIX_Track *track, SDL_PropertiesID options, bool hold)
+{
+    if (!track->input_audio && !track->input_stream) {
         return SDL_SetError("No audio currently assigned to this track");
     }
 
@@ -1953,6 +3889,8 @@ bool MIX_PlayTrack(MIX_Track *track, SDL_PropertiesID options)
     Sint64 loop_start = 0;
     Sint64 fade_in = 0;
     Sint64 append_silence_frames = 0;
+    float normalization_gain = 1.0f;
+    Uint64 start_mixer_frame = 0;
     LockTrack(track);
     if (options) {
         loops = (int) SDL_GetNumberProperty(options, MIX_PROP_PLAY_LOOPS_NUMBER, loops);
@@ -1961,6 +3899,8 @@ bool MIX_PlayTrack(MIX_Track *track, SDL_PropertiesID options)
         loop_start = GetTrackOptionFramesOrTicks(track, options, MIX_PROP_PLAY_LOOP_START_FRAME_NUMBER, MIX_PROP_PLAY_LOOP_START_MILLISECOND_NUMBER, loop_start);
         fade_in = GetTrackOptionFramesOrTicks(track, options, MIX_PROP_PLAY_FADE_IN_FRAMES_NUMBER, MIX_PROP_PLAY_FADE_IN_MILLISECONDS_NUMBER, fade_in);
         append_silence_frames = GetTrackOptionFramesOrTicks(track, options, MIX_PROP_PLAY_APPEND_SILENCE_FRAMES_NUMBER, MIX_PROP_PLAY_APPEND_SILENCE_MILLISECONDS_NUMBER, append_silence_frames);
+        normalization_gain = GetTrackOptionNormalizationGain(track, options);
+        start_mixer_frame = (Uint64) SDL_GetNumberProperty(options, MIX_PROP_PLAY_START_AT_MIXER_FRAME_NUMBER, 0);
     }
 
     if (start_pos < 0) {
@@ -1975,7 +3915,12 @@ bool MIX_PlayTrack(MIX_Track *track, SDL_PropertiesID options)
         append_silence_frames = 0;
     }
 
-    if (track->input_audio && (!track->input_audio->decoder->seek(track->decoder_userdata, start_pos))) {
+    // looping seeks from the mixer thread, so give the decoder a chance to get ready for that here, instead of there.
+    const MIX_Decoder *decoder = track->input_audio ? track->input_audio->decoder : NULL;
+    if (decoder && (loops != 0) && decoder->prepare_seek && !decoder->prepare_seek(track->decoder_userdata)) {
+        UnlockTrack(track);
+        return false;
+    } else if (decoder && !decoder->seek(track->decoder_userdata, start_pos)) {
         UnlockTrack(track);
         return false;
     } else if (!track->input_audio && (start_pos != 0)) {
@@ -1992,11 +3937,35 @@ bool MIX_PlayTrack(MIX_Track *track, SDL_PropertiesID options)
     track->silence_frames = (append_silence_frames > 0) ? -append_silence_frames : 0;  // negative means "there is still actual audio data to play", positive means "we're done with actual data, feed silence now." Zero means no silence (left) to feed.
     track->state = MIX_STATE_PLAYING;
     track->position = start_pos;
+    track->normalization_gain = normalization_gain;
+    track->start_mixer_frame = start_mixer_frame;
+    track->stop_mixer_frame = MIX_UNSCHEDULED_MIXER_FRAME;
+    EndTrackCrossfade(track);
+    if (track->resampler) {
+        MIX_ResetResampler(track->resampler);  // don't let the end of the last playback bleed into this one.
+    }
+    if (track->timestretch) {
+        MIX_ResetTimeStretch(track->timestretch);
+    }
+
+    if (hold) {
+        SDL_ClearAudioStream(track->output_stream);  // if restarting, drop what was buffered, so everything in the group starts fresh.
+        track->start_mixer_frame = MIX_HELD_MIXER_FRAME;
+        PrebufferTrack(track);
+    }
 
     UnlockTrack(track);
     return true;
 }
 
+bool MIX_PlayTrack(MIX_Track *track, SDL_PropertiesID options)
+{
+    if (!CheckTrackParam(track)) {
+        return false;
+    }
+    return PlayTrack(track, options, false);
+}
+
 bool MIX_PlayTag(MIX_Mixer *mixer, const char *tag, SDL_PropertiesID options)
 {
     if (!CheckMixerTagParam(mixer, tag)) {
@@ -2011,18 +3980,27 @@ bool MIX_PlayTag(MIX_Mixer *mixer, const char *tag, SDL_PropertiesID options)
     bool retval = true;
     SDL_LockRWLockForReading(list->rwlock);
     const size_t total = list->num_tracks;
-    LockMixer(mixer);  // so all tracks start at the same time.
 
+    // get every track seeked and decoding without the mixer locked, so we don't stall the audio device; the tracks
+    //  are held silent until everything is ready.
     for (size_t i = 0; i < total; i++) {
         MIX_Track *track = list->tracks[i];
         if (track->input_audio || track->input_stream) {  // don't treat it as an error if no audio is available, just don't play it.
-            if (!MIX_PlayTrack(track, options)) {
+            SDL_SetAtomicInt(&track->prebuffering, 1);
+            if (!PlayTrack(track, options, true)) {
                 retval = false;
             }
+            SDL_SetAtomicInt(&track->prebuffering, 0);
         }
     }
 
+    const Uint64 start_mixer_frame = options ? (Uint64) SDL_GetNumberProperty(options, MIX_PROP_PLAY_START_AT_MIXER_FRAME_NUMBER, 0) : 0;
+    LockMixer(mixer);  // so all tracks start at the same time.
+    for (size_t i = 0; i < total; i++) {
+        ReleaseHeldTrack(list->tracks[i], start_mixer_frame);
+    }
     UnlockMixer(mixer);
+
     SDL_UnlockRWLock(list->rwlock);
 
     return retval;
@@ -2064,32 +4042,34 @@ bool MIX_PlayAudio(MIX_Mixer *mixer, MIX_Audio *audio)
     return retval;
 }
 
-static void StopTrack(MIX_Track *track, Sint64 fadeOut)
+bool MIX_StopTrack(MIX_Track *track, Sint64 fade_out_frames)
 {
-    LockTrack(track);
-    if (track->state != MIX_STATE_STOPPED) {
-        if (fadeOut <= 0) {  // stop immediately.
-            if (track->internal_stream) {
-                SDL_ClearAudioStream(track->internal_stream);  // make sure we don't leave old data hanging around.
-            }
-            TrackStopped(track);
-        } else {
-            track->total_fade_frames = fadeOut;
-            track->fade_frames = track->total_fade_frames;
-            track->fade_frames = fadeOut;
-            track->fade_direction = -1;
-        }
+    if (!CheckTrackParam(track)) {
+        return false;
     }
-    UnlockTrack(track);
+
+    StopTrack(track, fade_out_frames);
+    return true;
 }
 
-bool MIX_StopTrack(MIX_Track *track, Sint64 fade_out_frames)
+bool MIX_StopTrackAtMixerFrame(MIX_Track *track, Uint64 mixer_frame, Sint64 fade_out_frames)
 {
     if (!CheckTrackParam(track)) {
         return false;
     }
 
-    StopTrack(track, fade_out_frames);
+    // a frame the mixer already passed means "right now"; clamp it so it can't be mistaken for anything else.
+    if (mixer_frame != MIX_UNSCHEDULED_MIXER_FRAME) {
+        mixer_frame = SDL_max(mixer_frame, MIX_GetMixerClock(track->mixer));
+    }
+
+    LockTrack(track);
+    if (track->state != MIX_STATE_STOPPED) {
+        track->stop_mixer_frame = mixer_frame;
+        track->stop_fade_frames = fade_out_frames;
+    }
+    UnlockTrack(track);
+
     return true;
 }
 
@@ -2121,6 +4101,7 @@ bool MIX_StopTag(MIX_Mixer *mixer, const char *tag, Sint64 fade_out_ms)
         return true;  // nothing is using this tag, do nothing (but not an error).
     }
 
+    LockMixer(mixer);  // lock the mixer so all tracks stop at the same time.
     SDL_LockRWLockForReading(list->rwlock);
 
     const size_t total = list->num_tracks;
@@ -2129,6 +4110,7 @@ bool MIX_StopTag(MIX_Mixer *mixer, const char *tag, Sint64 fade_out_ms)
     }
 
     SDL_UnlockRWLock(list->rwlock);
+    UnlockMixer(mixer);
 
     return true;
 }
@@ -2315,6 +4297,37 @@ float MIX_GetMasterGain(MIX_Mixer *mixer)
     return retval;
 }
 
+bool MIX_SetAmbisonicOrder(MIX_Mixer *mixer, int order)
+{
+    if (!CheckMixerParam(mixer)) {
+        return false;
+    } else if ((order < 0) || (order > MIX_AMBISONIC_MAX_ORDER)) {
+        return SDL_InvalidParamError("order");
+    }
+
+    LockMixer(mixer);
+    if (mixer->ambisonic_order != order) {
+        mixer->ambisonic_order = order;
+        if (order) {
+            MIX_AmbisonicDecoder_Init(&mixer->ambisonic_decoder, order, mixer->spec.channels);
+        }
+    }
+    UnlockMixer(mixer);
+    return true;
+}
+
+int MIX_GetAmbisonicOrder(MIX_Mixer *mixer)
+{
+    if (!CheckMixerParam(mixer)) {
+        return 0;
+    }
+
+    LockMixer(mixer);
+    const int retval = mixer->ambisonic_order;
+    UnlockMixer(mixer);
+    return retval;
+}
+
 static bool SetTrackGain(MIX_Track *track, float gain)
 {
     // don't have to LockTrack, as SDL_SetAudioStreamGain will do that.
@@ -2343,73 +4356,158 @@ float MIX_GetTrackGain(MIX_Track *track)
         return 1.0f;
     }
 
-    // don't have to LockTrack, as SDL_GetAudioStreamGain will do that.
-    //LockTrack(track);
-    const float retval = SDL_GetAudioStreamGain(track->output_stream);
-    //UnlockTrack(track);
+    // don't have to LockTrack, as SDL_GetAudioStreamGain will do that.
+    //LockTrack(track);
+    const float retval = SDL_GetAudioStreamGain(track->output_stream);
+    //UnlockTrack(track);
+
+    return retval;
+}
+
+bool MIX_SetTagGain(MIX_Mixer *mixer, const char *tag, float gain)
+{
+    if (!CheckMixerTagParam(mixer, tag)) {
+        return false;
+    }
+
+    if (gain < 0.0f) {
+        gain = 0.0f;  // !!! FIXME: this clamps, but should it fail instead?
+    }
+
+    MIX_TagList *list = (MIX_TagList *) SDL_GetPointerProperty(mixer->track_tags, tag, NULL);
+    if (!list) {
+        return true;  // nothing is using this tag, do nothing (but not an error).
+    }
+
+    LockMixer(mixer);  // lock the mixer so all tracks adust gain at the same time.
+    SDL_LockRWLockForReading(list->rwlock);
+
+    const size_t total = list->num_tracks;
+    for (size_t i = 0; i < total; i++) {
+        SetTrackGain(list->tracks[i], gain);
+    }
+
+    SDL_UnlockRWLock(list->rwlock);
+    UnlockMixer(mixer);
+
+    return true;
+}
+
+static bool SetTrackFrequencyRatio(MIX_Track *track, float ratio)
+{
+    LockTrack(track);  // need the lock so the Doppler shift doesn't change under us.
+    track->frequency_ratio = ratio;
+    const bool retval = SetTrackOutputRatio(track, ratio * track->doppler_ratio);
+    UnlockTrack(track);
+    return retval;
+}
+
+// this assumes LockTrack(track) was called before this.
+static void ResetTrackDoppler(MIX_Track *track)
+{
+    if (track->doppler_ratio != 1.0f) {
+        track->doppler_ratio = 1.0f;
+        SetTrackOutputRatio(track, track->frequency_ratio);
+    }
+}
+
+bool MIX_SetTrackFrequencyRatio(MIX_Track *track, float ratio)
+{
+    if (!CheckTrackParam(track)) {
+        return false;
+    }
+
+    ratio = SDL_clamp(ratio, 0.01f, 100.0f);   // !!! FIXME: this clamps, but should it fail instead?
+
+    return SetTrackFrequencyRatio(track, ratio);
+}
+
+float MIX_GetTrackFrequencyRatio(MIX_Track *track)
+{
+    if (!CheckTrackParam(track)) {
+        return 0.0f;
+    }
+
+    LockTrack(track);
+    const float retval = track->frequency_ratio;  // don't report the Doppler shift, just what the app asked for.
+    UnlockTrack(track);
 
     return retval;
 }
 
-bool MIX_SetTagGain(MIX_Mixer *mixer, const char *tag, float gain)
+static bool CheckResamplerParams(MIX_ResamplerQuality quality, int sinc_taps)
 {
-    if (!CheckMixerTagParam(mixer, tag)) {
-        return false;
-    }
-
-    if (gain < 0.0f) {
-        gain = 0.0f;  // !!! FIXME: this clamps, but should it fail instead?
+    if ((quality < MIX_RESAMPLER_DEFAULT) || (quality > MIX_RESAMPLER_SINC)) {
+        return SDL_InvalidParamError("quality");
+    } else if ((quality == MIX_RESAMPLER_SINC) && ((sinc_taps < 4) || (sinc_taps > MIX_RESAMPLER_MAX_TAPS) || (sinc_taps & 1))) {
+        return SDL_InvalidParamError("sinc_taps");
     }
+    return true;
+}
 
-    MIX_TagList *list = (MIX_TagList *) SDL_GetPointerProperty(mixer->track_tags, tag, NULL);
-    if (!list) {
-        return true;  // nothing is using this tag, do nothing (but not an error).
+bool MIX_SetTrackResampler(MIX_Track *track, MIX_ResamplerQuality quality, int sinc_taps)
+{
+    if (!CheckTrackParam(track)) {
+        return false;
+    } else if (!CheckResamplerParams(quality, sinc_taps)) {
+        return false;
     }
 
-    LockMixer(mixer);  // lock the mixer so all tracks adust gain at the same time.
-    SDL_LockRWLockForReading(list->rwlock);
-
-    const size_t total = list->num_tracks;
-    for (size_t i = 0; i < total; i++) {
-        SetTrackGain(list->tracks[i], gain);
+    LockMixer(track->mixer);  // so the group can't change under us.
+    LockTrack(track);
+    const MIX_ResamplerQuality old_quality = track->resampler_quality;
+    const int old_taps = track->resampler_taps;
+    track->resampler_quality = quality;
+    track->resampler_taps = sinc_taps;
+    const bool retval = UpdateTrackResampler(track);
+    if (!retval) {
+        track->resampler_quality = old_quality;
+        track->resampler_taps = old_taps;
     }
+    UnlockTrack(track);
+    UnlockMixer(track->mixer);
 
-    SDL_UnlockRWLock(list->rwlock);
-    UnlockMixer(mixer);
-
-    return true;
-}
-
-static bool SetTrackFrequencyRatio(MIX_Track *track, float ratio)
-{
-    // don't have to LockTrack, as SDL_SetAudioStreamFrequencyRatio will do that.
-    //LockTrack(track);
-    const bool retval = SDL_SetAudioStreamFrequencyRatio(track->output_stream, ratio);
-    //UnlockTrack(track);
     return retval;
 }
 
-bool MIX_SetTrackFrequencyRatio(MIX_Track *track, float ratio)
+bool MIX_SetTrackTempo(MIX_Track *track, float tempo)
 {
     if (!CheckTrackParam(track)) {
         return false;
+    } else if ((tempo < 0.25f) || (tempo > 4.0f)) {
+        return SDL_InvalidParamError("tempo");
     }
 
-    ratio = SDL_clamp(ratio, 0.01f, 100.0f);   // !!! FIXME: this clamps, but should it fail instead?
+    bool retval = true;
+    LockTrack(track);
+    if ((tempo != 1.0f) && !track->timestretch) {  // set this up here, so the audio thread doesn't have to allocate it.
+        track->timestretch = MIX_CreateTimeStretch();
+        if (!track->timestretch) {
+            retval = false;
+        }
+    }
+    if (retval && !ReserveTrackTimeStretch(track, tempo)) {  // faster and slower tempos need bigger buffers; get them here, not on the audio thread.
+        retval = false;
+    } else if (retval && track->timestretch && track->input_spec.freq && !MIX_SetTimeStretchFormat(track->timestretch, track->input_spec.channels, track->input_spec.freq)) {
+        retval = false;
+    }
+    if (retval) {
+        track->tempo = tempo;
+    }
+    UnlockTrack(track);
 
-    return SetTrackFrequencyRatio(track, ratio);
+    return retval;
 }
 
-float MIX_GetTrackFrequencyRatio(MIX_Track *track)
+float MIX_GetTrackTempo(MIX_Track *track)
 {
     if (!CheckTrackParam(track)) {
         return 0.0f;
     }
 
-    // don't have to LockTrack, as SDL_GetAudioStreamFrequencyRatio will do that.
-    //LockTrack(track);
-    const float retval = SDL_GetAudioStreamFrequencyRatio(track->output_stream);
-    //UnlockTrack(track);
+    LockTrack(track);
+    const float retval = track->tempo;
+    UnlockTrack(track);
 
     return retval;
 }
@@ -2445,6 +4543,7 @@ bool MIX_SetTrackStereo(MIX_Track *track, const MIX_StereoGains *gains)
     }
 
     track->position3d[0] = track->position3d[1] = track->position3d[2] = 0.0f;
+    ResetTrackDoppler(track);
 
     if (wants_stereo) {
         const float left = SDL_max(0.0f, gains->left);
@@ -2486,13 +4585,15 @@ bool MIX_SetTrack3DPosition(MIX_Track *track, const MIX_Point3D *position)
 
     if (!wants_spatialization) {
         track->position3d[0] = track->position3d[1] = track->position3d[2] = 0.0f;
+        ResetTrackDoppler(track);
     } else {
         float *tposition3d = track->position3d;
-        if (toggling || ((tposition3d[0] != position->x) || (tposition3d[2] != position->y) || (tposition3d[2] != position->z))) {
+        if (toggling || ((tposition3d[0] != position->x) || (tposition3d[1] != position->y) || (tposition3d[2] != position->z))) {
             tposition3d[0] = position->x;
             tposition3d[1] = position->y;
             tposition3d[2] = position->z;
             MIX_Spatialize(&track->mixer->vbap2d, tposition3d, track->spatialization_panning, track->spatialization_speakers);
+            MIX_AmbisonicEncode(tposition3d, track->ambisonic_gains);  // always keep this current, in case the app turns on the ambisonic bus later.
         }
     }
 
@@ -2520,6 +4621,234 @@ bool MIX_GetTrack3DPosition(MIX_Track *track, MIX_Point3D *position)
 
 }
 
+bool MIX_SetTrack3DVelocity(MIX_Track *track, const MIX_Point3D *velocity)
+{
+    if (!CheckTrackParam(track)) {
+        return false;
+    }
+
+    LockTrack(track);
+    float *tvelocity3d = track->velocity3d;
+    if (!velocity) {
+        tvelocity3d[0] = tvelocity3d[1] = tvelocity3d[2] = 0.0f;
+    } else {
+        tvelocity3d[0] = velocity->x;
+        tvelocity3d[1] = velocity->y;
+        tvelocity3d[2] = velocity->z;
+    }
+    UnlockTrack(track);
+
+    return true;
+}
+
+bool MIX_GetTrack3DVelocity(MIX_Track *track, MIX_Point3D *velocity)
+{
+    if (!CheckTrackParam(track)) {
+        return false;
+    } else if (!velocity) {
+        return SDL_InvalidParamError("velocity");
+    }
+
+    LockTrack(track);
+    const float *tvelocity3d = track->velocity3d;
+    velocity->x = tvelocity3d[0];
+    velocity->y = tvelocity3d[1];
+    velocity->z = tvelocity3d[2];
+    UnlockTrack(track);
+
+    return true;
+}
+
+bool MIX_SetListener3DVelocity(MIX_Mixer *mixer, const MIX_Point3D *velocity)
+{
+    if (!CheckMixerParam(mixer)) {
+        return false;
+    }
+
+    LockMixer(mixer);
+    float *lvelocity3d = mixer->listener_velocity3d;
+    if (!velocity) {
+        lvelocity3d[0] = lvelocity3d[1] = lvelocity3d[2] = 0.0f;
+    } else {
+        lvelocity3d[0] = velocity->x;
+        lvelocity3d[1] = velocity->y;
+        lvelocity3d[2] = velocity->z;
+    }
+    UnlockMixer(mixer);
+
+    return true;
+}
+
+bool MIX_SetTrackFilters(MIX_Track *track, const MIX_Filter *filters, int count)
+{
+    if (!CheckTrackParam(track)) {
+        return false;
+    } else if ((count < 0) || (count > MIX_MAX_FILTERS)) {
+        return SDL_InvalidParamError("count");
+    } else if (!filters && (count > 0)) {
+        return SDL_InvalidParamError("filters");
+    }
+
+    MIX_Mixer *mixer = track->mixer;
+    LockMixer(mixer);  // the filters are only used in MixerCallback, so this is the lock that matters.
+    const bool retval = MIX_SetFilterChain(&track->filters, filters, count);
+    UnlockMixer(mixer);
+    return retval;
+}
+
+bool MIX_SetGroupFilters(MIX_Group *group, const MIX_Filter *filters, int count)
+{
+    if (!CheckGroupParam(group)) {
+        return false;
+    } else if ((count < 0) || (count > MIX_MAX_FILTERS)) {
+        return SDL_InvalidParamError("count");
+    } else if (!filters && (count > 0)) {
+        return SDL_InvalidParamError("filters");
+    }
+
+    MIX_Mixer *mixer = group->mixer;
+    LockMixer(mixer);
+    const bool retval = MIX_SetFilterChain(&group->filters, filters, count);
+    UnlockMixer(mixer);
+    return retval;
+}
+
+bool MIX_SetMixerDynamics(MIX_Mixer *mixer, SDL_PropertiesID props)
+{
+    if (!CheckMixerParam(mixer)) {
+        return false;
+    }
+
+    // allocate everything now, so the audio thread only ever sees a finished state. This has to be under the lock,
+    //  so the device format can't change between reading mixer->spec and handing this to MixerCallback.
+    LockMixer(mixer);
+    MIX_Dynamics *dynamics = NULL;
+    if (props) {
+        dynamics = MIX_CreateDynamics(props, mixer->spec.channels, mixer->spec.freq);
+        if (!dynamics) {
+            UnlockMixer(mixer);
+            return false;
+        }
+    }
+    MIX_Dynamics *old_dynamics = mixer->dynamics;
+    mixer->dynamics = dynamics;
+    UnlockMixer(mixer);
+
+    if (!dynamics) {
+        MIX_SetAtomicFloat(&mixer->gain_reduction, 0.0f);
+    }
+
+    MIX_DestroyDynamics(old_dynamics);
+    return true;
+}
+
+bool MIX_SetGroupDynamics(MIX_Group *group, SDL_PropertiesID props)
+{
+    if (!CheckGroupParam(group)) {
+        return false;
+    }
+
+    MIX_Mixer *mixer = group->mixer;
+    LockMixer(mixer);  // see notes in MIX_SetMixerDynamics.
+    MIX_Dynamics *dynamics = NULL;
+    if (props) {
+        dynamics = MIX_CreateDynamics(props, mixer->spec.channels, mixer->spec.freq);
+        if (!dynamics) {
+            UnlockMixer(mixer);
+            return false;
+        }
+    }
+    MIX_Dynamics *old_dynamics = group->dynamics;
+    group->dynamics = dynamics;
+    UnlockMixer(mixer);
+
+    if (!dynamics) {
+        MIX_SetAtomicFloat(&group->gain_reduction, 0.0f);
+    }
+
+    MIX_DestroyDynamics(old_dynamics);
+    return true;
+}
+
+float MIX_GetMixerGainReduction(MIX_Mixer *mixer)
+{
+    if (!CheckMixerParam(mixer)) {
+        return 0.0f;
+    }
+    return MIX_GetAtomicFloat(&mixer->gain_reduction);   // atomic, so we don't have to wait on the mixer lock.
+}
+
+float MIX_GetGroupGainReduction(MIX_Group *group)
+{
+    if (!CheckGroupParam(group)) {
+        return 0.0f;
+    }
+    return MIX_GetAtomicFloat(&group->gain_reduction);
+}
+
+bool MIX_SetMixerMetering(MIX_Mixer *mixer, int interval)
+{
+    if (!CheckMixerParam(mixer)) {
+        return false;
+    } else if (interval < 0) {
+        return SDL_InvalidParamError("interval");
+    }
+
+    LockMixer(mixer);
+    if (!interval || !mixer->meter_interval) {  // turning metering on or off? Clear out old values.
+        ResetMeter(&mixer->meter);
+        for (MIX_Group *group = mixer->all_groups; group; group = group->next) {
+            ResetMeter(&group->meter);
+        }
+        for (MIX_Track *track = mixer->all_tracks; track; track = track->next) {
+            ResetMeter(&track->meter);
+        }
+    }
+    mixer->meter_interval = interval;
+    mixer->meter_countdown = 0;  // measure the next buffer.
+    UnlockMixer(mixer);
+
+    return true;
+}
+
+static void GetMeter(MIX_Meter *meter, float *peak, float *rms)
+{
+    // atomic, so we don't have to wait on the mixer lock.
+    if (peak) {
+        *peak = MIX_GetAtomicFloat(&meter->peak);
+    }
+    if (rms) {
+        *rms = MIX_GetAtomicFloat(&meter->rms);
+    }
+}
+
+bool MIX_GetMixerMeter(MIX_Mixer *mixer, float *peak, float *rms)
+{
+    if (!CheckMixerParam(mixer)) {
+        return false;
+    }
+    GetMeter(&mixer->meter, peak, rms);
+    return true;
+}
+
+bool MIX_GetGroupMeter(MIX_Group *group, float *peak, float *rms)
+{
+    if (!CheckGroupParam(group)) {
+        return false;
+    }
+    GetMeter(&group->meter, peak, rms);
+    return true;
+}
+
+bool MIX_GetTrackMeter(MIX_Track *track, float *peak, float *rms)
+{
+    if (!CheckTrackParam(track)) {
+        return false;
+    }
+    GetMeter(&track->meter, peak, rms);
+    return true;
+}
+
 bool MIX_SetPostMixCallback(MIX_Mixer *mixer, MIX_PostMixCallback cb, void *userdata)
 {
     if (!CheckMixerParam(mixer)) {
@@ -2610,6 +4939,8 @@ void MIX_DestroyGroup(MIX_Group *group)
     UnlockMixer(mixer);
 
     SDL_DestroyProperties(group->props);
+    MIX_DestroyFilterChain(group->filters);
+    MIX_DestroyDynamics(group->dynamics);
     SDL_free(group);
 }
 
@@ -2630,6 +4961,30 @@ MIX_Mixer *MIX_GetGroupMixer(MIX_Group *group)
     return CheckGroupParam(group) ? group->mixer : NULL;
 }
 
+bool MIX_SetGroupResampler(MIX_Group *group, MIX_ResamplerQuality quality, int sinc_taps)
+{
+    if (!CheckGroupParam(group)) {
+        return false;
+    } else if (!CheckResamplerParams(quality, sinc_taps)) {
+        return false;
+    }
+
+    bool retval = true;
+    LockMixer(group->mixer);
+    group->resampler_quality = quality;
+    group->resampler_taps = sinc_taps;
+    for (MIX_Track *track = group->tracks; track; track = track->group_next) {
+        LockTrack(track);
+        if (!UpdateTrackResampler(track)) {
+            retval = false;  // keep going, so the other tracks get the new setting.
+        }
+        UnlockTrack(track);
+    }
+    UnlockMixer(group->mixer);
+
+    return retval;
+}
+
 bool MIX_SetTrackGroup(MIX_Track *track, MIX_Group *group)
 {
     if (!CheckTrackParam(track)) {
@@ -2663,6 +5018,7 @@ bool MIX_SetTrackGroup(MIX_Track *track, MIX_Group *group)
         }
         group->tracks = track;
         track->group = group;
+        UpdateTrackResampler(track);  // might be using the group's resampler settings.
     }
     UnlockTrack(track);
     UnlockMixer(track->mixer);
@@ -2875,6 +5231,12 @@ static size_t MIX_IoClamp_read(void *userdata, void *ptr, size_t size, SDL_IOSta
     return ret;
 }
 
+static bool MIX_IoClamp_close(void *userdata)
+{
+    SDL_free(userdata);  // this is only used by MIX_OpenIoClampRange; it doesn't close the original stream.
+    return true;
+}
+
 SDL_IOStream *MIX_OpenIoClamp(MIX_IoClamp *clamp, SDL_IOStream *io)
 {
     /* Don't use SDL_GetIOSize() here -- see SDL bug #4026 */
@@ -2896,6 +5258,35 @@ SDL_IOStream *MIX_OpenIoClamp(MIX_IoClamp *clamp, SDL_IOStream *io)
     return SDL_OpenIO(&iface, clamp);
 }
 
+SDL_IOStream *MIX_OpenIoClampRange(SDL_IOStream *io, Sint64 start, Sint64 length)
+{
+    if (SDL_SeekIO(io, start, SDL_IO_SEEK_SET) < 0) {
+        return NULL;
+    }
+
+    MIX_IoClamp *clamp = (MIX_IoClamp *) SDL_calloc(1, sizeof (*clamp));
+    if (!clamp) {
+        return NULL;
+    }
+
+    clamp->io = io;
+    clamp->start = start;
+    clamp->length = length;
+    clamp->pos = 0;
+
+    SDL_IOStreamInterface iface;
+    SDL_INIT_INTERFACE(&iface);
+    iface.size = MIX_IoClamp_size;
+    iface.seek = MIX_IoClamp_seek;
+    iface.read = MIX_IoClamp_read;
+    iface.close = MIX_IoClamp_close;
+    SDL_IOStream *retval = SDL_OpenIO(&iface, clamp);
+    if (!retval) {
+        SDL_free(clamp);
+    }
+    return retval;
+}
+
 void *MIX_GetConstIOBuffer(SDL_IOStream *io, size_t *datalen)
 {
     void *buffer = NULL;
@@ -2989,3 +5380,49 @@ const float MIX_alawToFloat[256] = {
 };
 
 #undef S2F
+
+static const Sint8 IMA_ADPCM_index_table_4b[16] = {
+    -1, -1, -1, -1,
+    2, 4, 6, 8,
+    -1, -1, -1, -1,
+    2, 4, 6, 8
+};
+
+static const Uint16 IMA_ADPCM_step_table[89] = {
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31,
+    34, 37, 41, 45, 50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130,
+    143, 157, 173, 190, 209, 230, 253, 279, 307, 337, 371, 408,
+    449, 494, 544, 598, 658, 724, 796, 876, 963, 1060, 1166, 1282,
+    1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327,
+    3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630,
+    9493, 10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350,
+    22385, 24623, 27086, 29794, 32767
+};
+
+MIX_IMAADPCMTables MIX_IMAADPCM_tables;
+
+void MIX_BuildIMAADPCMTables(MIX_IMAADPCMTables *tables)
+{
+    for (int index = 0; index < 89; index++) {
+        const Sint32 step = (Sint32) IMA_ADPCM_step_table[index];
+        for (int nybble = 0; nybble < 16; nybble++) {
+            // This uses shifts and additions because multiplications were much slower back then. Sadly, this can't
+            //  just be replaced with an actual multiplication now, as the old algorithm drops some bits.
+            Sint32 delta = step >> 3;
+            if (nybble & 0x04) {
+                delta += step;
+            }
+            if (nybble & 0x02) {
+                delta += step >> 1;
+            }
+            if (nybble & 0x01) {
+                delta += step >> 2;
+            }
+            if (nybble & 0x08) {
+                delta = -delta;
+            }
+            tables->delta[index][nybble] = delta;
+            tables->next_index[index][nybble] = (Uint8) SDL_clamp(index + IMA_ADPCM_index_table_4b[nybble], 0, 88);
+        }
+    }
+}
@@ -0,0 +1,528 @@
+/*
+  SDL_mixer:  An audio mixer library based on the SDL library
+  Copyright (C) 1997-2025 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "SDL_mixer_internal.h"
+
+// Dynamics processing (compressor and look-ahead limiter) for the master mix and mixing groups.
+//
+// The compressor and limiter share a single in-place pass over the buffer: each sample frame is
+// compressed, fed to the limiter's detector, and swapped with the frame coming out of the look-ahead
+// delay line, which gets the final gain applied on its way out. For the master mix, that pass is also
+// the last sum into the buffer (the final group's mix is added to each frame just before it goes to
+// the detector), so the dynamics don't cost an extra trip through the buffer. A group's dynamics run
+// over its own buffer, since the group's postmix callback needs to see the result before it's mixed.
+//
+// The compressor is a feed-forward RMS compressor. The mean square is tracked every frame, but the
+// (expensive) dB conversions only happen every MIX_DYNAMICS_CONTROL_FRAMES frames, and the gain is
+// ramped linearly between those points.
+//
+// The limiter needs to guarantee that no sample exceeds the ceiling, without any sudden gain
+// changes. For each frame we work out the gain that frame would need, take the minimum of that
+// over the look-ahead window (so the gain is already down when a peak comes out of the delay
+// line), then smooth that with a moving average of the same length, which ramps the gain down
+// over the look-ahead period instead of stepping it. Release is a simple one-pole filter.
+
+#define MIX_DYNAMICS_CONTROL_FRAMES 32
+
+static float MillisecondsToCoefficient(float ms, int freq, int frames_per_step)
+{
+    if (ms <= 0.0f) {
+        return 0.0f;  // instant.
+    }
+    return SDL_expf(-((float) frames_per_step) / (ms * 0.001f * ((float) freq)));
+}
+
+static float DecibelsToLinear(float db)
+{
+    return SDL_powf(10.0f, db / 20.0f);
+}
+
+static float LinearToDecibels(float linear)
+{
+    return 20.0f * SDL_log10f(SDL_max(linear, 1e-9f));
+}
+
+// (re)allocate and reset everything for a new output format.
+static bool ConfigureDynamics(MIX_Dynamics *dynamics, int channels, int freq)
+{
+    const int lookahead = dynamics->limiter_enabled ? SDL_max(1, (int) (dynamics->limiter_lookahead_ms * 0.001f * ((float) freq))) : 0;
+
+    if (lookahead != dynamics->lookahead_frames) {
+        SDL_aligned_free(dynamics->delay);
+        dynamics->delay = NULL;
+        dynamics->lookahead_frames = 0;
+        if (lookahead > 0) {
+            // one allocation for everything. The delay line goes first, so it's aligned for SIMD access.
+            const size_t delay_len = sizeof (float) * MIX_DYNAMICS_DELAY_STRIDE * lookahead;
+            const size_t len = delay_len + (sizeof (float) * lookahead * 2) + ((sizeof (float) + sizeof (Uint32)) * (lookahead + 2));
+            Uint8 *ptr = (Uint8 *) SDL_aligned_alloc(SDL_GetSIMDAlignment(), len);
+            if (!ptr) {
+                return false;
+            }
+            dynamics->delay = (float *) ptr;
+            dynamics->delayed_gains = (float *) (ptr + delay_len);
+            dynamics->moving_average = dynamics->delayed_gains + lookahead;
+            dynamics->min_values = dynamics->moving_average + lookahead;
+            dynamics->min_frames = (Uint32 *) (dynamics->min_values + (lookahead + 2));
+            dynamics->lookahead_frames = lookahead;
+        }
+    }
+
+    const int L = dynamics->lookahead_frames;
+    if (L > 0) {
+        SDL_memset(dynamics->delay, '\0', sizeof (float) * MIX_DYNAMICS_DELAY_STRIDE * L);
+        for (int i = 0; i < L; i++) {
+            dynamics->delayed_gains[i] = 1.0f;
+            dynamics->moving_average[i] = 1.0f;
+        }
+    }
+
+    dynamics->channels = channels;
+    dynamics->freq = freq;
+    dynamics->delay_position = 0;
+    dynamics->frame_counter = 0;
+    dynamics->min_head = dynamics->min_tail = 0;
+    dynamics->moving_average_sum = (double) L;
+    dynamics->limiter_ceiling = DecibelsToLinear(dynamics->limiter_ceiling_db);
+    dynamics->limiter_gain = 1.0f;
+    dynamics->limiter_release_coefficient = MillisecondsToCoefficient(dynamics->limiter_release_ms, freq, 1);
+
+    dynamics->compressor_mean_square = 0.0f;
+    dynamics->compressor_gain_reduction_db = 0.0f;
+    dynamics->compressor_makeup = DecibelsToLinear(dynamics->compressor_makeup_db);
+    dynamics->compressor_gain = dynamics->compressor_enabled ? dynamics->compressor_makeup : 1.0f;
+    dynamics->compressor_gain_step = 0.0f;
+    dynamics->compressor_countdown = 0;
+    dynamics->compressor_window_coefficient = 1.0f - MillisecondsToCoefficient(dynamics->compressor_window_ms, freq, 1);
+    dynamics->compressor_attack_coefficient = MillisecondsToCoefficient(dynamics->compressor_attack_ms, freq, MIX_DYNAMICS_CONTROL_FRAMES);
+    dynamics->compressor_release_coefficient = MillisecondsToCoefficient(dynamics->compressor_release_ms, freq, MIX_DYNAMICS_CONTROL_FRAMES);
+
+    return true;
+}
+
+MIX_Dynamics *MIX_CreateDynamics(SDL_PropertiesID props, int channels, int freq)
+{
+    MIX_Dynamics *dynamics = (MIX_Dynamics *) SDL_calloc(1, sizeof (*dynamics));
+    if (!dynamics) {
+        return NULL;
+    }
+
+    dynamics->limiter_enabled = SDL_GetBooleanProperty(props, MIX_PROP_DYNAMICS_LIMITER_ENABLED_BOOLEAN, true);
+    dynamics->limiter_ceiling_db = SDL_min(SDL_GetFloatProperty(props, MIX_PROP_DYNAMICS_LIMITER_CEILING_FLOAT, -1.0f), 0.0f);
+    dynamics->limiter_lookahead_ms = SDL_clamp(SDL_GetFloatProperty(props, MIX_PROP_DYNAMICS_LIMITER_LOOKAHEAD_FLOAT, 5.0f), 0.1f, 100.0f);
+    dynamics->limiter_release_ms = SDL_max(SDL_GetFloatProperty(props, MIX_PROP_DYNAMICS_LIMITER_RELEASE_FLOAT, 50.0f), 0.0f);
+
+    dynamics->compressor_enabled = SDL_GetBooleanProperty(props, MIX_PROP_DYNAMICS_COMPRESSOR_ENABLED_BOOLEAN, false);
+    dynamics->compressor_threshold_db = SDL_min(SDL_GetFloatProperty(props, MIX_PROP_DYNAMICS_COMPRESSOR_THRESHOLD_FLOAT, -18.0f), 0.0f);
+    dynamics->compressor_ratio = SDL_max(SDL_GetFloatProperty(props, MIX_PROP_DYNAMICS_COMPRESSOR_RATIO_FLOAT, 4.0f), 1.0f);
+    dynamics->compressor_attack_ms = SDL_max(SDL_GetFloatProperty(props, MIX_PROP_DYNAMICS_COMPRESSOR_ATTACK_FLOAT, 10.0f), 0.0f);
+    dynamics->compressor_release_ms = SDL_max(SDL_GetFloatProperty(props, MIX_PROP_DYNAMICS_COMPRESSOR_RELEASE_FLOAT, 100.0f), 0.0f);
+    dynamics->compressor_window_ms = SDL_max(SDL_GetFloatProperty(props, MIX_PROP_DYNAMICS_COMPRESSOR_WINDOW_FLOAT, 10.0f), 0.1f);
+    dynamics->compressor_makeup_db = SDL_GetFloatProperty(props, MIX_PROP_DYNAMICS_COMPRESSOR_MAKEUP_GAIN_FLOAT, 0.0f);
+
+    if (!MIX_SetDynamicsFormat(dynamics, channels, freq)) {
+        MIX_DestroyDynamics(dynamics);
+        return NULL;
+    }
+
+    return dynamics;
+}
+
+bool MIX_SetDynamicsFormat(MIX_Dynamics *dynamics, int channels, int freq)
+{
+    if ((channels <= 0) || (channels > MIX_DYNAMICS_DELAY_STRIDE)) {
+        return true;  // MIX_ApplyDynamics will leave this alone, so don't bother.
+    }
+    return ConfigureDynamics(dynamics, channels, freq);
+}
+
+void MIX_DestroyDynamics(MIX_Dynamics *dynamics)
+{
+    if (dynamics) {
+        SDL_aligned_free(dynamics->delay);
+        SDL_free(dynamics);
+    }
+}
+
+// this is the part that can't be vectorized: given a frame's peak and mean square, update the
+// compressor and limiter, and return the gain for the frame coming out of the delay line.
+// `*compressor_gain` gets the gain to apply to the incoming frame before it goes into the delay line.
+static SDL_INLINE float UpdateDynamicsGain(MIX_Dynamics *dynamics, float peak, float mean_square, float *compressor_gain)
+{
+    float cgain = 1.0f;
+    if (dynamics->compressor_enabled) {
+        dynamics->compressor_mean_square += (mean_square - dynamics->compressor_mean_square) * dynamics->compressor_window_coefficient;
+        if (--dynamics->compressor_countdown <= 0) {
+            const float level_db = 10.0f * SDL_log10f(SDL_max(dynamics->compressor_mean_square, 1e-12f));
+            const float over_db = level_db - dynamics->compressor_threshold_db;
+            const float target_db = (over_db > 0.0f) ? (over_db * (1.0f - (1.0f / dynamics->compressor_ratio))) : 0.0f;
+            const float current_db = dynamics->compressor_gain_reduction_db;
+            const float coefficient = (target_db > current_db) ? dynamics->compressor_attack_coefficient : dynamics->compressor_release_coefficient;
+            dynamics->compressor_gain_reduction_db = target_db + ((current_db - target_db) * coefficient);
+            const float next_gain = dynamics->compressor_makeup * DecibelsToLinear(-dynamics->compressor_gain_reduction_db);
+            dynamics->compressor_gain_step = (next_gain - dynamics->compressor_gain) / ((float) MIX_DYNAMICS_CONTROL_FRAMES);
+            dynamics->compressor_countdown = MIX_DYNAMICS_CONTROL_FRAMES;
+            dynamics->max_compressor_reduction_db = SDL_max(dynamics->max_compressor_reduction_db, dynamics->compressor_gain_reduction_db);
+        }
+        dynamics->compressor_gain += dynamics->compressor_gain_step;
+        cgain = dynamics->compressor_gain;
+    }
+
+    *compressor_gain = cgain;
+
+    const int L = dynamics->lookahead_frames;
+    if (L == 0) {
+        return 1.0f;   // no limiter; the compressor gain was applied on the way in.
+    }
+
+    // the gain this frame needs to stay under the ceiling.
+    const float compressed_peak = peak * cgain;
+    const float required = (compressed_peak > dynamics->limiter_ceiling) ? (dynamics->limiter_ceiling / compressed_peak) : 1.0f;
+
+    // sliding minimum over the last L+1 frames (a monotonic queue: each value goes in and out once).
+    const int capacity = L + 2;
+    const Uint32 now = dynamics->frame_counter++;
+    float *min_values = dynamics->min_values;
+    Uint32 *min_frames = dynamics->min_frames;
+    int head = dynamics->min_head;
+    int tail = dynamics->min_tail;
+    while (head != tail) {
+        const int last = (tail == 0) ? (capacity - 1) : (tail - 1);
+        if (min_values[last] < required) {
+            break;
+        }
+        tail = last;
+    }
+    min_values[tail] = required;
+    min_frames[tail] = now;
+    tail = (tail + 1) % capacity;
+    while ((now - min_frames[head]) > (Uint32) L) {
+        head = (head + 1) % capacity;
+    }
+    dynamics->min_head = head;
+    dynamics->min_tail = tail;
+    const float held = min_values[head];
+
+    // moving average of the held minimum, which ramps down to each peak over the look-ahead window.
+    const int position = dynamics->delay_position;
+    dynamics->moving_average_sum += (double) (held - dynamics->moving_average[position]);
+    dynamics->moving_average[position] = held;
+    const float target = (float) (dynamics->moving_average_sum / (double) L);
+
+    float gain = dynamics->limiter_gain;
+    if (target < gain) {
+        gain = target;  // the moving average already ramped it, so this is safe.
+    } else {
+        gain = target + ((gain - target) * dynamics->limiter_release_coefficient);
+    }
+    dynamics->limiter_gain = gain;
+    dynamics->min_limiter_gain = SDL_min(dynamics->min_limiter_gain, gain);
+
+    // the frame coming out of the delay line was compressed with the gain from L frames ago.
+    const float delayed_cgain = dynamics->delayed_gains[position];
+    dynamics->delayed_gains[position] = cgain;
+
+    return delayed_cgain * gain;
+}
+
+static void FinishDynamicsMeter(MIX_MeterAccumulator *meter, float peak, float sum_squares, int samples)
+{
+    if (meter) {
+        meter->peak = SDL_max(meter->peak, peak);
+        meter->sum_squares += sum_squares;
+        meter->samples += samples;
+    }
+}
+
+#if SDL_MIXER_NEED_SCALAR_FALLBACK
+static void MIX_ApplyDynamics_scalar(MIX_Dynamics *dynamics, float *pcm, const float *src, int src_frames, MIX_MeterAccumulator *in_meter, MIX_MeterAccumulator *out_meter, int frames)
+{
+    const int channels = dynamics->channels;
+    const int L = dynamics->lookahead_frames;
+    float in_peak = 0.0f;
+    float in_sum_squares = 0.0f;
+    float out_peak = 0.0f;
+    float out_sum_squares = 0.0f;
+
+    for (int i = 0; i < frames; i++, pcm += channels) {
+        if (i < src_frames) {
+            for (int ch = 0; ch < channels; ch++) {
+                const float sample = src[ch];
+                in_peak = SDL_max(in_peak, SDL_fabsf(sample));
+                in_sum_squares += sample * sample;
+                pcm[ch] += sample;
+            }
+            src += channels;
+        }
+
+        float peak = 0.0f;
+        float sum_squares = 0.0f;
+        for (int ch = 0; ch < channels; ch++) {
+            const float sample = pcm[ch];
+            peak = SDL_max(peak, SDL_fabsf(sample));
+            sum_squares += sample * sample;
+        }
+
+        if (!src) {  // the detector already measured the input for us.
+            in_peak = SDL_max(in_peak, peak);
+            in_sum_squares += sum_squares;
+        }
+
+        float cgain;
+        const float gain = UpdateDynamicsGain(dynamics, peak, sum_squares / ((float) channels), &cgain);
+
+        if (L == 0) {
+            for (int ch = 0; ch < channels; ch++) {
+                pcm[ch] *= cgain;
+            }
+        } else {
+            float *delayed = dynamics->delay + (dynamics->delay_position * MIX_DYNAMICS_DELAY_STRIDE);
+            for (int ch = 0; ch < channels; ch++) {
+                const float sample = pcm[ch];
+                pcm[ch] = delayed[ch] * gain;
+                delayed[ch] = sample;  // the compressor gain for this frame is applied when it comes back out.
+            }
+            if (++dynamics->delay_position >= L) {
+                dynamics->delay_position = 0;
+            }
+        }
+
+        if (out_meter) {
+            for (int ch = 0; ch < channels; ch++) {
+                const float sample = pcm[ch];
+                out_peak = SDL_max(out_peak, SDL_fabsf(sample));
+                out_sum_squares += sample * sample;
+            }
+        }
+    }
+
+    FinishDynamicsMeter(in_meter, in_peak, in_sum_squares, frames * channels);
+    FinishDynamicsMeter(out_meter, out_peak, out_sum_squares, frames * channels);
+}
+#endif
+
+#if defined(SDL_SSE_INTRINSICS)
+static SDL_INLINE float SDL_TARGETING("sse") HorizontalMax_sse(__m128 v)
+{
+    v = _mm_max_ps(v, _mm_movehl_ps(v, v));
+    v = _mm_max_ss(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1)));
+    return _mm_cvtss_f32(v);
+}
+
+static SDL_INLINE float SDL_TARGETING("sse") HorizontalSum_sse(__m128 v)
+{
+    v = _mm_add_ps(v, _mm_movehl_ps(v, v));
+    v = _mm_add_ss(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1)));
+    return _mm_cvtss_f32(v);
+}
+
+static void SDL_TARGETING("sse") MIX_ApplyDynamics_sse(MIX_Dynamics *dynamics, float *pcm, const float *src, int src_frames, MIX_MeterAccumulator *in_meter, MIX_MeterAccumulator *out_meter, int frames)
+{
+    const int channels = dynamics->channels;
+    const int lo_channels = SDL_min(channels, 4);
+    const int hi_channels = channels - lo_channels;
+    const int L = dynamics->lookahead_frames;
+    const float inv_channels = 1.0f / ((float) channels);
+    const __m128 zero = _mm_setzero_ps();
+    __m128 in_peak = zero;
+    __m128 in_sum_squares = zero;
+    __m128 out_peak = zero;
+    __m128 out_sum_squares = zero;
+
+    for (int i = 0; i < frames; i++, pcm += channels) {
+        __m128 xlo = MIX_LoadPartial_sse(pcm, lo_channels);
+        __m128 xhi = hi_channels ? MIX_LoadPartial_sse(pcm + 4, hi_channels) : zero;
+        if (i < src_frames) {
+            const __m128 slo = MIX_LoadPartial_sse(src, lo_channels);
+            const __m128 shi = hi_channels ? MIX_LoadPartial_sse(src + 4, hi_channels) : zero;
+            in_peak = _mm_max_ps(in_peak, _mm_max_ps(_mm_max_ps(slo, _mm_sub_ps(zero, slo)), _mm_max_ps(shi, _mm_sub_ps(zero, shi))));
+            in_sum_squares = _mm_add_ps(in_sum_squares, _mm_add_ps(_mm_mul_ps(slo, slo), _mm_mul_ps(shi, shi)));
+            xlo = _mm_add_ps(xlo, slo);
+            xhi = _mm_add_ps(xhi, shi);
+            src += channels;
+        }
+
+        const __m128 abs_sse = _mm_max_ps(_mm_max_ps(xlo, _mm_sub_ps(zero, xlo)), _mm_max_ps(xhi, _mm_sub_ps(zero, xhi)));  // SSE1 has no abs, but max(x, -x) does the job.
+        const __m128 squares_sse = _mm_add_ps(_mm_mul_ps(xlo, xlo), _mm_mul_ps(xhi, xhi));
+        const float peak = HorizontalMax_sse(abs_sse);
+        const float sum_squares = HorizontalSum_sse(squares_sse);
+        if (!src) {  // the detector already measured the input for us.
+            in_peak = _mm_max_ps(in_peak, abs_sse);
+            in_sum_squares = _mm_add_ps(in_sum_squares, squares_sse);
+        }
+
+        float cgain;
+        const float gain = UpdateDynamicsGain(dynamics, peak, sum_squares * inv_channels, &cgain);
+        __m128 ylo, yhi;
+        if (L == 0) {
+            const __m128 cgain_sse = _mm_set1_ps(cgain);
+            ylo = _mm_mul_ps(xlo, cgain_sse);
+            yhi = _mm_mul_ps(xhi, cgain_sse);
+        } else {
+            float *delayed = dynamics->delay + (dynamics->delay_position * MIX_DYNAMICS_DELAY_STRIDE);
+            const __m128 gain_sse = _mm_set1_ps(gain);
+            ylo = _mm_mul_ps(_mm_load_ps(delayed), gain_sse);
+            yhi = _mm_mul_ps(_mm_load_ps(delayed + 4), gain_sse);  // the padding lanes are zero, and there's always room for 8.
+            _mm_store_ps(delayed, xlo);  // the compressor gain for this frame is applied when it comes back out.
+            if (hi_channels) {
+                _mm_store_ps(delayed + 4, xhi);
+            }
+            if (++dynamics->delay_position >= L) {
+                dynamics->delay_position = 0;
+            }
+        }
+
+        MIX_StorePartial_sse(pcm, ylo, lo_channels);
+        if (hi_channels) {
+            MIX_StorePartial_sse(pcm + 4, yhi, hi_channels);
+        }
+
+        if (out_meter) {
+            out_peak = _mm_max_ps(out_peak, _mm_max_ps(_mm_max_ps(ylo, _mm_sub_ps(zero, ylo)), _mm_max_ps(yhi, _mm_sub_ps(zero, yhi))));
+            out_sum_squares = _mm_add_ps(out_sum_squares, _mm_add_ps(_mm_mul_ps(ylo, ylo), _mm_mul_ps(yhi, yhi)));
+        }
+    }
+
+    FinishDynamicsMeter(in_meter, HorizontalMax_sse(in_peak), HorizontalSum_sse(in_sum_squares), frames * channels);
+    FinishDynamicsMeter(out_meter, HorizontalMax_sse(out_peak), HorizontalSum_sse(out_sum_squares), frames * channels);
+}
+#endif
+
+#if defined(SDL_NEON_INTRINSICS)
+static SDL_INLINE float HorizontalMax_neon(float32x4_t v)
+{
+    const float32x2_t v2 = vpmax_f32(vget_low_f32(v), vget_high_f32(v));
+    return vget_lane_f32(vpmax_f32(v2, v2), 0);
+}
+
+static SDL_INLINE float HorizontalSum_neon(float32x4_t v)
+{
+    const float32x2_t v2 = vadd_f32(vget_low_f32(v), vget_high_f32(v));
+    return vget_lane_f32(vpadd_f32(v2, v2), 0);
+}
+
+static void MIX_ApplyDynamics_neon(MIX_Dynamics *dynamics, float *pcm, const float *src, int src_frames, MIX_MeterAccumulator *in_meter, MIX_MeterAccumulator *out_meter, int frames)
+{
+    const int channels = dynamics->channels;
+    const int lo_channels = SDL_min(channels, 4);
+    const int hi_channels = channels - lo_channels;
+    const int L = dynamics->lookahead_frames;
+    const float inv_channels = 1.0f / ((float) channels);
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    float32x4_t in_peak = zero;
+    float32x4_t in_sum_squares = zero;
+    float32x4_t out_peak = zero;
+    float32x4_t out_sum_squares = zero;
+
+    for (int i = 0; i < frames; i++, pcm += channels) {
+        float32x4_t xlo = MIX_LoadPartial_neon(pcm, lo_channels);
+        float32x4_t xhi = hi_channels ? MIX_LoadPartial_neon(pcm + 4, hi_channels) : zero;
+        if (i < src_frames) {
+            const float32x4_t slo = MIX_LoadPartial_neon(src, lo_channels);
+            const float32x4_t shi = hi_channels ? MIX_LoadPartial_neon(src + 4, hi_channels) : zero;
+            in_peak = vmaxq_f32(in_peak, vmaxq_f32(vabsq_f32(slo), vabsq_f32(shi)));
+            in_sum_squares = vmlaq_f32(vmlaq_f32(in_sum_squares, slo, slo), shi, shi);
+            xlo = vaddq_f32(xlo, slo);
+            xhi = vaddq_f32(xhi, shi);
+            src += channels;
+        }
+
+        const float32x4_t abs_neon = vmaxq_f32(vabsq_f32(xlo), vabsq_f32(xhi));
+        const float32x4_t squares_neon = vmlaq_f32(vmulq_f32(xlo, xlo), xhi, xhi);
+        const float peak = HorizontalMax_neon(abs_neon);
+        const float sum_squares = HorizontalSum_neon(squares_neon);
+        if (!src) {  // the detector already measured the input for us.
+            in_peak = vmaxq_f32(in_peak, abs_neon);
+            in_sum_squares = vaddq_f32(in_sum_squares, squares_neon);
+        }
+
+        float cgain;
+        const float gain = UpdateDynamicsGain(dynamics, peak, sum_squares * inv_channels, &cgain);
+
+        float32x4_t ylo, yhi;
+        if (L == 0) {
+            ylo = vmulq_n_f32(xlo, cgain);
+            yhi = vmulq_n_f32(xhi, cgain);
+        } else {
+            float *delayed = dynamics->delay + (dynamics->delay_position * MIX_DYNAMICS_DELAY_STRIDE);
+            ylo = vmulq_n_f32(vld1q_f32(delayed), gain);
+            yhi = vmulq_n_f32(vld1q_f32(delayed + 4), gain);  // the padding lanes are zero, and there's always room for 8.
+            vst1q_f32(delayed, xlo);  // the compressor gain for this frame is applied when it comes back out.
+            if (hi_channels) {
+                vst1q_f32(delayed + 4, xhi);
+            }
+            if (++dynamics->delay_position >= L) {
+                dynamics->delay_position = 0;
+            }
+        }
+
+        MIX_StorePartial_neon(pcm, ylo, lo_channels);
+        if (hi_channels) {
+            MIX_StorePartial_neon(pcm + 4, yhi, hi_channels);
+        }
+
+        if (out_meter) {
+            out_peak = vmaxq_f32(out_peak, vmaxq_f32(vabsq_f32(ylo), vabsq_f32(yhi)));
+            out_sum_squares = vmlaq_f32(vmlaq_f32(out_sum_squares, ylo, ylo), yhi, yhi);
+        }
+    }
+
+    FinishDynamicsMeter(in_meter, HorizontalMax_neon(in_peak), HorizontalSum_neon(in_sum_squares), frames * channels);
+    FinishDynamicsMeter(out_meter, HorizontalMax_neon(out_peak), HorizontalSum_neon(out_sum_squares), frames * channels);
+}
+#endif
+
+bool MIX_ApplyDynamics(MIX_Dynamics *dynamics, SDL_AtomicU32 *gain_reduction, float *pcm, const float *src, int src_frames, MIX_MeterAccumulator *in_meter, MIX_MeterAccumulator *out_meter, int channels, int freq, int frames)
+{
+    // MIX_SetDynamicsFormat runs under the mixer lock when the device format changes, so this only
+    // mismatches if that failed (or there are more channels than the delay line has room for).
+    if ((dynamics->channels != channels) || (dynamics->freq != freq)) {
+        return false;
+    }
+
+    if (!src) {
+        src_frames = 0;
+    }
+
+    dynamics->min_limiter_gain = 1.0f;
+    dynamics->max_compressor_reduction_db = dynamics->compressor_gain_reduction_db;
+
+    #if defined(SDL_SSE_INTRINSICS)
+    if (MIX_HasSSE) {
+        MIX_ApplyDynamics_sse(dynamics, pcm, src, src_frames, in_meter, out_meter, frames);
+    } else
+    #elif defined(SDL_NEON_INTRINSICS)
+    if (MIX_HasNEON) {
+        MIX_ApplyDynamics_neon(dynamics, pcm, src, src_frames, in_meter, out_meter, frames);
+    } else
+    #endif
+
+    {
+    #if SDL_MIXER_NEED_SCALAR_FALLBACK
+        MIX_ApplyDynamics_scalar(dynamics, pcm, src, src_frames, in_meter, out_meter, frames);
+    #endif
+    }
+
+    // report the most gain reduction we applied during this buffer, in decibels. Makeup gain doesn't count.
+    const float reduction_db = dynamics->max_compressor_reduction_db - LinearToDecibels(dynamics->min_limiter_gain);
+    MIX_SetAtomicFloat(gain_reduction, SDL_max(reduction_db, 0.0f));
+    return true;
+}
@@ -0,0 +1,412 @@
+/*
+  SDL_mixer:  An audio mixer library based on the SDL library
+  Copyright (C) 1997-2025 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "SDL_mixer_internal.h"
+
+// Biquad filters for tracks and groups.
+//
+// Coefficients come from Robert Bristow-Johnson's "Cookbook formulae for audio EQ biquad filter coefficients":
+//   https://www.w3.org/TR/audio-eq-cookbook/
+//
+// The filters run as "Transposed Direct Form II", which only needs two state variables per channel and
+// behaves well with floating point:
+//   y = b0*x + z1
+//   z1 = b1*x - a1*y + z2
+//   z2 = b2*x - a2*y
+//
+// Each stage runs across the whole buffer before the next stage starts. The SIMD versions put each
+// channel of a sample frame in its own lane, so a stereo or 5.1 frame is filtered all at once.
+//
+// When the app changes a filter, we don't jump to the new coefficients (which clicks); we ramp them
+// linearly across the next buffer we process.
+
+static void CalculateBiquadCoefficients(const MIX_Filter *filter, int freq, MIX_BiquadCoefficients *coeffs)
+{
+    const float nyquist = ((float) freq) * 0.5f;
+    const float frequency = SDL_clamp(filter->frequency, 10.0f, nyquist * 0.98f);
+    const float q = SDL_max(filter->q, 0.025f);
+    const float w0 = 2.0f * SDL_PI_F * frequency / ((float) freq);
+    const float cosw0 = SDL_cosf(w0);
+    const float alpha = SDL_sinf(w0) / (2.0f * q);
+    const float A = SDL_powf(10.0f, filter->gain_db / 40.0f);   // only used for peaking and shelving filters.
+    float b0, b1, b2, a0, a1, a2;
+
+    switch (filter->type) {
+        case MIX_FILTER_LOWPASS:
+            b0 = (1.0f - cosw0) * 0.5f;
+            b1 = 1.0f - cosw0;
+            b2 = (1.0f - cosw0) * 0.5f;
+            a0 = 1.0f + alpha;
+            a1 = -2.0f * cosw0;
+            a2 = 1.0f - alpha;
+            break;
+
+        case MIX_FILTER_HIGHPASS:
+            b0 = (1.0f + cosw0) * 0.5f;
+            b1 = -(1.0f + cosw0);
+            b2 = (1.0f + cosw0) * 0.5f;
+            a0 = 1.0f + alpha;
+            a1 = -2.0f * cosw0;
+            a2 = 1.0f - alpha;
+            break;
+
+        case MIX_FILTER_BANDPASS:  // constant 0dB peak gain.
+            b0 = alpha;
+            b1 = 0.0f;
+            b2 = -alpha;
+            a0 = 1.0f + alpha;
+            a1 = -2.0f * cosw0;
+            a2 = 1.0f - alpha;
+            break;
+
+        case MIX_FILTER_NOTCH:
+            b0 = 1.0f;
+            b1 = -2.0f * cosw0;
+            b2 = 1.0f;
+            a0 = 1.0f + alpha;
+            a1 = -2.0f * cosw0;
+            a2 = 1.0f - alpha;
+            break;
+
+        case MIX_FILTER_PEAKING:
+            b0 = 1.0f + (alpha * A);
+            b1 = -2.0f * cosw0;
+            b2 = 1.0f - (alpha * A);
+            a0 = 1.0f + (alpha / A);
+            a1 = -2.0f * cosw0;
+            a2 = 1.0f - (alpha / A);
+            break;
+
+        case MIX_FILTER_LOWSHELF: {
+            const float sqA = 2.0f * SDL_sqrtf(A) * alpha;
+            b0 = A * ((A + 1.0f) - ((A - 1.0f) * cosw0) + sqA);
+            b1 = 2.0f * A * ((A - 1.0f) - ((A + 1.0f) * cosw0));
+            b2 = A * ((A + 1.0f) - ((A - 1.0f) * cosw0) - sqA);
+            a0 = (A + 1.0f) + ((A - 1.0f) * cosw0) + sqA;
+            a1 = -2.0f * ((A - 1.0f) + ((A + 1.0f) * cosw0));
+            a2 = (A + 1.0f) + ((A - 1.0f) * cosw0) - sqA;
+            break;
+        }
+
+        case MIX_FILTER_HIGHSHELF: {
+            const float sqA = 2.0f * SDL_sqrtf(A) * alpha;
+            b0 = A * ((A + 1.0f) + ((A - 1.0f) * cosw0) + sqA);
+            b1 = -2.0f * A * ((A - 1.0f) + ((A + 1.0f) * cosw0));
+            b2 = A * ((A + 1.0f) + ((A - 1.0f) * cosw0) - sqA);
+            a0 = (A + 1.0f) - ((A - 1.0f) * cosw0) + sqA;
+            a1 = 2.0f * ((A - 1.0f) - ((A + 1.0f) * cosw0));
+            a2 = (A + 1.0f) - ((A - 1.0f) * cosw0) - sqA;
+            break;
+        }
+
+        default:
+            SDL_assert(!"Unexpected filter type");
+            b0 = a0 = 1.0f;  // pass through.
+            b1 = b2 = a1 = a2 = 0.0f;
+            break;
+    }
+
+    // normalize so a0 is 1.0f, which means we never have to multiply by it.
+    coeffs->b0 = b0 / a0;
+    coeffs->b1 = b1 / a0;
+    coeffs->b2 = b2 / a0;
+    coeffs->a1 = a1 / a0;
+    coeffs->a2 = a2 / a0;
+}
+
+bool MIX_SetFilterChain(MIX_FilterChain **_chain, const MIX_Filter *filters, int count)
+{
+    MIX_FilterChain *chain = *_chain;
+
+    if (count == 0) {
+        if (chain) {
+            chain->num_filters = 0;  // just turn it off; keep the allocation in case the app turns it back on.
+        }
+        return true;
+    }
+
+    for (int i = 0; i < count; i++) {
+        if ((((int) filters[i].type) < 0) || (filters[i].type > MIX_FILTER_HIGHSHELF)) {
+            return SDL_SetError("Invalid filter type");
+        } else if (filters[i].frequency <= 0.0f) {
+            return SDL_SetError("Invalid filter frequency");
+        } else if (filters[i].q <= 0.0f) {
+            return SDL_SetError("Invalid filter Q");
+        }
+    }
+
+    if (!chain) {
+        chain = (MIX_FilterChain *) SDL_aligned_alloc(SDL_GetSIMDAlignment(), sizeof (*chain));
+        if (!chain) {
+            return false;
+        }
+        SDL_zerop(chain);
+        *_chain = chain;
+    }
+
+    // stages that were already running get their coefficients ramped to the new values; new stages start clean.
+    for (int i = 0; i < count; i++) {
+        chain->fresh[i] = (i >= chain->num_filters) || (chain->filters[i].type != filters[i].type);
+    }
+
+    SDL_memcpy(chain->filters, filters, sizeof (*filters) * count);
+    chain->num_filters = count;
+    chain->dirty = true;
+    return true;
+}
+
+void MIX_DestroyFilterChain(MIX_FilterChain *chain)
+{
+    SDL_aligned_free(chain);
+}
+
+// after a filter rings out, its state decays toward zero through denormal values, which are
+//  _extremely_ slow on many CPUs, so snap tiny state values to zero between buffers.
+static void FlushDenormals(float *state, int count)
+{
+    for (int i = 0; i < count; i++) {
+        if (SDL_fabsf(state[i]) < 1e-15f) {
+            state[i] = 0.0f;
+        }
+    }
+}
+
+#if SDL_MIXER_NEED_SCALAR_FALLBACK
+static void MIX_ApplyBiquad_scalar(MIX_FilterChain *chain, int stage, float *pcm, int channels, int frames, const MIX_BiquadCoefficients *delta)
+{
+    MIX_BiquadCoefficients c = chain->current[stage];
+    float *z1 = chain->z1[stage];
+    float *z2 = chain->z2[stage];
+
+    for (int i = 0; i < frames; i++, pcm += channels) {
+        for (int ch = 0; ch < channels; ch++) {
+            const float x = pcm[ch];
+            const float y = (c.b0 * x) + z1[ch];
+            z1[ch] = (c.b1 * x) - (c.a1 * y) + z2[ch];
+            z2[ch] = (c.b2 * x) - (c.a2 * y);
+            pcm[ch] = y;
+        }
+
+        if (delta) {
+            c.b0 += delta->b0;
+            c.b1 += delta->b1;
+            c.b2 += delta->b2;
+            c.a1 += delta->a1;
+            c.a2 += delta->a2;
+        }
+    }
+}
+#endif
+
+#if defined(SDL_SSE_INTRINSICS)
+static void SDL_TARGETING("sse") MIX_ApplyBiquad_sse(MIX_FilterChain *chain, int stage, float *pcm, int channels, int frames, const MIX_BiquadCoefficients *delta)
+{
+    const MIX_BiquadCoefficients *c = &chain->current[stage];
+    __m128 b0 = _mm_set1_ps(c->b0);
+    __m128 b1 = _mm_set1_ps(c->b1);
+    __m128 b2 = _mm_set1_ps(c->b2);
+    __m128 a1 = _mm_set1_ps(c->a1);
+    __m128 a2 = _mm_set1_ps(c->a2);
+    const __m128 d0 = _mm_set1_ps(delta ? delta->b0 : 0.0f);
+    const __m128 d1 = _mm_set1_ps(delta ? delta->b1 : 0.0f);
+    const __m128 d2 = _mm_set1_ps(delta ? delta->b2 : 0.0f);
+    const __m128 d3 = _mm_set1_ps(delta ? delta->a1 : 0.0f);
+    const __m128 d4 = _mm_set1_ps(delta ? delta->a2 : 0.0f);
+    float *z1 = chain->z1[stage];
+    float *z2 = chain->z2[stage];
+
+    // channels 0-3 in the "lo" registers, 4-7 (if any) in the "hi" registers.
+    const int lo_channels = SDL_min(channels, 4);
+    const int hi_channels = channels - lo_channels;
+    __m128 z1lo = _mm_load_ps(z1);
+    __m128 z2lo = _mm_load_ps(z2);
+    __m128 z1hi = _mm_load_ps(z1 + 4);
+    __m128 z2hi = _mm_load_ps(z2 + 4);
+
+    // flush denormals to zero while we work; a decaying filter tail produces a lot of them. Put things back when we're done.
+    const unsigned int csr = _mm_getcsr();
+    _mm_setcsr(csr | _MM_FLUSH_ZERO_ON);
+
+    for (int i = 0; i < frames; i++, pcm += channels) {
+        const __m128 xlo = MIX_LoadPartial_sse(pcm, lo_channels);
+        const __m128 ylo = _mm_add_ps(_mm_mul_ps(b0, xlo), z1lo);
+        z1lo = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(b1, xlo), _mm_mul_ps(a1, ylo)), z2lo);
+        z2lo = _mm_sub_ps(_mm_mul_ps(b2, xlo), _mm_mul_ps(a2, ylo));
+        MIX_StorePartial_sse(pcm, ylo, lo_channels);
+
+        if (hi_channels) {
+            const __m128 xhi = MIX_LoadPartial_sse(pcm + 4, hi_channels);
+            const __m128 yhi = _mm_add_ps(_mm_mul_ps(b0, xhi), z1hi);
+            z1hi = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(b1, xhi), _mm_mul_ps(a1, yhi)), z2hi);
+            z2hi = _mm_sub_ps(_mm_mul_ps(b2, xhi), _mm_mul_ps(a2, yhi));
+            MIX_StorePartial_sse(pcm + 4, yhi, hi_channels);
+        }
+
+        if (delta) {
+            b0 = _mm_add_ps(b0, d0);
+            b1 = _mm_add_ps(b1, d1);
+            b2 = _mm_add_ps(b2, d2);
+            a1 = _mm_add_ps(a1, d3);
+            a2 = _mm_add_ps(a2, d4);
+        }
+    }
+
+    _mm_store_ps(z1, z1lo);
+    _mm_store_ps(z2, z2lo);
+    _mm_store_ps(z1 + 4, z1hi);
+    _mm_store_ps(z2 + 4, z2hi);
+
+    _mm_setcsr(csr);
+}
+#endif
+
+#if defined(SDL_NEON_INTRINSICS)
+static void MIX_ApplyBiquad_neon(MIX_FilterChain *chain, int stage, float *pcm, int channels, int frames, const MIX_BiquadCoefficients *delta)
+{
+    const MIX_BiquadCoefficients *c = &chain->current[stage];
+    float32x4_t b0 = vdupq_n_f32(c->b0);
+    float32x4_t b1 = vdupq_n_f32(c->b1);
+    float32x4_t b2 = vdupq_n_f32(c->b2);
+    float32x4_t a1 = vdupq_n_f32(c->a1);
+    float32x4_t a2 = vdupq_n_f32(c->a2);
+    const float32x4_t d0 = vdupq_n_f32(delta ? delta->b0 : 0.0f);
+    const float32x4_t d1 = vdupq_n_f32(delta ? delta->b1 : 0.0f);
+    const float32x4_t d2 = vdupq_n_f32(delta ? delta->b2 : 0.0f);
+    const float32x4_t d3 = vdupq_n_f32(delta ? delta->a1 : 0.0f);
+    const float32x4_t d4 = vdupq_n_f32(delta ? delta->a2 : 0.0f);
+    float *z1 = chain->z1[stage];
+    float *z2 = chain->z2[stage];
+
+    // channels 0-3 in the "lo" registers, 4-7 (if any) in the "hi" registers.
+    const int lo_channels = SDL_min(channels, 4);
+    const int hi_channels = channels - lo_channels;
+    float32x4_t z1lo = vld1q_f32(z1);
+    float32x4_t z2lo = vld1q_f32(z2);
+    float32x4_t z1hi = vld1q_f32(z1 + 4);
+    float32x4_t z2hi = vld1q_f32(z2 + 4);
+
+    for (int i = 0; i < frames; i++, pcm += channels) {
+        const float32x4_t xlo = MIX_LoadPartial_neon(pcm, lo_channels);
+        const float32x4_t ylo = vmlaq_f32(z1lo, b0, xlo);
+        z1lo = vaddq_f32(vmlsq_f32(vmulq_f32(b1, xlo), a1, ylo), z2lo);
+        z2lo = vmlsq_f32(vmulq_f32(b2, xlo), a2, ylo);
+        MIX_StorePartial_neon(pcm, ylo, lo_channels);
+
+        if (hi_channels) {
+            const float32x4_t xhi = MIX_LoadPartial_neon(pcm + 4, hi_channels);
+            const float32x4_t yhi = vmlaq_f32(z1hi, b0, xhi);
+            z1hi = vaddq_f32(vmlsq_f32(vmulq_f32(b1, xhi), a1, yhi), z2hi);
+            z2hi = vmlsq_f32(vmulq_f32(b2, xhi), a2, yhi);
+            MIX_StorePartial_neon(pcm + 4, yhi, hi_channels);
+        }
+
+        if (delta) {
+            b0 = vaddq_f32(b0, d0);
+            b1 = vaddq_f32(b1, d1);
+            b2 = vaddq_f32(b2, d2);
+            a1 = vaddq_f32(a1, d3);
+            a2 = vaddq_f32(a2, d4);
+        }
+    }
+
+    vst1q_f32(z1, z1lo);
+    vst1q_f32(z2, z2lo);
+    vst1q_f32(z1 + 4, z1hi);
+    vst1q_f32(z2 + 4, z2hi);
+}
+#endif
+
+static void MIX_ApplyBiquad(MIX_FilterChain *chain, int stage, float *pcm, int channels, int frames, const MIX_BiquadCoefficients *delta)
+{
+    #if defined(SDL_SSE_INTRINSICS)
+    if (MIX_HasSSE) {
+        MIX_ApplyBiquad_sse(chain, stage, pcm, channels, frames, delta);
+    } else
+    #elif defined(SDL_NEON_INTRINSICS)
+    if (MIX_HasNEON) {
+        MIX_ApplyBiquad_neon(chain, stage, pcm, channels, frames, delta);
+    } else
+    #endif
+
+    {
+    #if SDL_MIXER_NEED_SCALAR_FALLBACK
+        MIX_ApplyBiquad_scalar(chain, stage, pcm, channels, frames, delta);
+    #endif
+    }
+}
+
+void MIX_ApplyFilterChain(MIX_FilterChain *chain, float *pcm, int channels, int freq, int frames)
+{
+    SDL_assert( (((size_t) chain->z1) % 16) == 0 );  // must be aligned for SIMD access.
+    SDL_assert( (((size_t) chain->z2) % 16) == 0 );  // must be aligned for SIMD access.
+
+    const int num_filters = chain->num_filters;
+    if ((num_filters == 0) || (frames <= 0)) {
+        return;
+    } else if ((channels <= 0) || (channels > MIX_VBAP2D_MAX_SPEAKER_COUNT)) {
+        return;  // !!! FIXME: we don't have state for more channels than this; just leave it unfiltered.
+    }
+
+    // if the format changed, the old state is meaningless and the coefficients are wrong. Start over.
+    if ((chain->channels != channels) || (chain->freq != freq)) {
+        chain->channels = channels;
+        chain->freq = freq;
+        chain->dirty = true;
+        for (int i = 0; i < num_filters; i++) {
+            chain->fresh[i] = true;
+        }
+    }
+
+    MIX_BiquadCoefficients target[MIX_MAX_FILTERS];
+    if (chain->dirty) {
+        for (int i = 0; i < num_filters; i++) {
+            CalculateBiquadCoefficients(&chain->filters[i], freq, &target[i]);
+            if (chain->fresh[i]) {
+                SDL_copyp(&chain->current[i], &target[i]);
+                SDL_memset(chain->z1[i], '\0', sizeof (chain->z1[i]));
+                SDL_memset(chain->z2[i], '\0', sizeof (chain->z2[i]));
+                chain->fresh[i] = false;
+            }
+        }
+    }
+
+    for (int i = 0; i < num_filters; i++) {
+        MIX_BiquadCoefficients *current = &chain->current[i];
+        if (!chain->dirty || (SDL_memcmp(current, &target[i], sizeof (*current)) == 0)) {
+            MIX_ApplyBiquad(chain, i, pcm, channels, frames, NULL);
+        } else {
+            const float scale = 1.0f / ((float) frames);
+            MIX_BiquadCoefficients delta;
+            delta.b0 = (target[i].b0 - current->b0) * scale;
+            delta.b1 = (target[i].b1 - current->b1) * scale;
+            delta.b2 = (target[i].b2 - current->b2) * scale;
+            delta.a1 = (target[i].a1 - current->a1) * scale;
+            delta.a2 = (target[i].a2 - current->a2) * scale;
+            MIX_ApplyBiquad(chain, i, pcm, channels, frames, &delta);
+            SDL_copyp(current, &target[i]);   // land exactly on the target, no matter what rounding did during the ramp.
+        }
+
+        FlushDenormals(chain->z1[i], channels);
+        FlushDenormals(chain->z2[i], channels);
+    }
+
+    chain->dirty = false;
+}
@@ -55,6 +55,56 @@ extern bool MIX_HasNEON;
 #endif
 #endif
 
+#if defined(SDL_SSE_INTRINSICS)
+// load/store the first `count` floats (1 to 4) of an interleaved sample frame without touching memory past the end of it. Unused lanes load as zero.
+static SDL_INLINE __m128 SDL_TARGETING("sse") MIX_LoadPartial_sse(const float *src, int count)
+{
+    switch (count) {
+        case 1: return _mm_load_ss(src);
+        case 2: return _mm_loadl_pi(_mm_setzero_ps(), (const __m64 *) src);
+        case 3: return _mm_movelh_ps(_mm_loadl_pi(_mm_setzero_ps(), (const __m64 *) src), _mm_load_ss(src + 2));
+        default: break;
+    }
+    return _mm_loadu_ps(src);
+}
+
+static SDL_INLINE void SDL_TARGETING("sse") MIX_StorePartial_sse(float *dst, __m128 v, int count)
+{
+    switch (count) {
+        case 1: _mm_store_ss(dst, v); return;
+        case 2: _mm_storel_pi((__m64 *) dst, v); return;
+        case 3: _mm_storel_pi((__m64 *) dst, v); _mm_store_ss(dst + 2, _mm_movehl_ps(v, v)); return;
+        default: break;
+    }
+    _mm_storeu_ps(dst, v);
+}
+#endif
+
+#if defined(SDL_NEON_INTRINSICS)
+// same as the SSE versions above: the first `count` floats (1 to 4) of a sample frame, nothing past the end of it. Unused lanes load as zero.
+static SDL_INLINE float32x4_t MIX_LoadPartial_neon(const float *src, int count)
+{
+    switch (count) {
+        case 1: return vld1q_lane_f32(src, vdupq_n_f32(0.0f), 0);
+        case 2: return vcombine_f32(vld1_f32(src), vdup_n_f32(0.0f));
+        case 3: return vld1q_lane_f32(src + 2, vcombine_f32(vld1_f32(src), vdup_n_f32(0.0f)), 2);
+        default: break;
+    }
+    return vld1q_f32(src);
+}
+
+static SDL_INLINE void MIX_StorePartial_neon(float *dst, float32x4_t v, int count)
+{
+    switch (count) {
+        case 1: vst1q_lane_f32(dst, v, 0); return;
+        case 2: vst1_f32(dst, vget_low_f32(v)); return;
+        case 3: vst1_f32(dst, vget_low_f32(v)); vst1q_lane_f32(dst + 2, v, 2); return;
+        default: break;
+    }
+    vst1q_f32(dst, v);
+}
+#endif
+
 #include "SDL3_mixer/SDL_mixer.h"
 
 typedef enum MIX_SpatializationMode
@@ -82,6 +132,257 @@ typedef struct MIX_VBAP2D
 
 void MIX_VBAP2D_Init(MIX_VBAP2D *vbap2d, int speaker_count);
 
+// Biquad filter chains, for MIX_SetTrackFilters and MIX_SetGroupFilters.
+#define MIX_MAX_FILTERS 4
+
+typedef struct MIX_BiquadCoefficients
+{
+    float b0, b1, b2, a1, a2;   // normalized so a0 is always 1.0f.
+} MIX_BiquadCoefficients;
+
+typedef struct MIX_FilterChain
+{
+    float SDL_ALIGNED(16) z1[MIX_MAX_FILTERS][MIX_VBAP2D_MAX_SPEAKER_COUNT];  // per-stage, per-channel filter state.
+    float SDL_ALIGNED(16) z2[MIX_MAX_FILTERS][MIX_VBAP2D_MAX_SPEAKER_COUNT];
+    MIX_BiquadCoefficients current[MIX_MAX_FILTERS];  // coefficients in use right now. We ramp toward new ones when `dirty`.
+    MIX_Filter filters[MIX_MAX_FILTERS];  // what the app asked for.
+    bool fresh[MIX_MAX_FILTERS];  // true if this stage should start from scratch instead of ramping.
+    int num_filters;  // zero if disabled.
+    int channels;  // format the state and coefficients are for.
+    int freq;
+    bool dirty;  // true if `filters` changed since we last calculated coefficients.
+} MIX_FilterChain;
+
+// `*chain` is allocated if necessary. Must hold the mixer lock.
+bool MIX_SetFilterChain(MIX_FilterChain **chain, const MIX_Filter *filters, int count);
+void MIX_DestroyFilterChain(MIX_FilterChain *chain);
+
+// filters `frames` of interleaved `pcm` in-place.
+void MIX_ApplyFilterChain(MIX_FilterChain *chain, float *pcm, int channels, int freq, int frames);
+
+// Peak/RMS meters, published with atomics so any thread can read them without locking the mixer.
+typedef struct MIX_Meter
+{
+    SDL_AtomicU32 peak;  // float, linear amplitude.
+    SDL_AtomicU32 rms;   // float, linear amplitude.
+} MIX_Meter;
+
+// The mixing loops fill this in as they go, when metering is enabled.
+typedef struct MIX_MeterAccumulator
+{
+    float peak;
+    float sum_squares;
+    int samples;
+} MIX_MeterAccumulator;
+
+// Dynamics processing (compressor and look-ahead limiter), for MIX_SetMixerDynamics and MIX_SetGroupDynamics.
+#define MIX_DYNAMICS_DELAY_STRIDE 8   // floats per frame in the look-ahead delay line, so every frame is aligned for SIMD. This is also the max channels we can process.
+
+typedef struct MIX_Dynamics
+{
+    // settings, from the app's properties.
+    bool limiter_enabled;
+    float limiter_ceiling_db;
+    float limiter_lookahead_ms;
+    float limiter_release_ms;
+    bool compressor_enabled;
+    float compressor_threshold_db;
+    float compressor_ratio;
+    float compressor_attack_ms;
+    float compressor_release_ms;
+    float compressor_window_ms;
+    float compressor_makeup_db;
+
+    // current state, reset when the format changes.
+    int channels;   // zero until first use.
+    int freq;
+    int lookahead_frames;   // zero if the limiter is disabled.
+    float *delay;  // `lookahead_frames` frames of MIX_DYNAMICS_DELAY_STRIDE floats, aligned. The other arrays are in the same allocation.
+    float *delayed_gains;  // compressor gains that go with each frame in the delay line.
+    float *moving_average;  // last `lookahead_frames` held-minimum limiter gains.
+    float *min_values;  // monotonic queue for the sliding minimum of required limiter gain.
+    Uint32 *min_frames;
+    int min_head;
+    int min_tail;
+    int delay_position;
+    Uint32 frame_counter;
+    double moving_average_sum;
+    float limiter_ceiling;
+    float limiter_gain;
+    float limiter_release_coefficient;
+    float min_limiter_gain;  // for metering, lowest limiter gain in the current buffer.
+    float compressor_mean_square;
+    float compressor_gain_reduction_db;
+    float max_compressor_reduction_db;  // for metering, most compressor gain reduction in the current buffer.
+    float compressor_makeup;
+    float compressor_gain;
+    float compressor_gain_step;
+    int compressor_countdown;
+    float compressor_window_coefficient;
+    float compressor_attack_coefficient;
+    float compressor_release_coefficient;
+} MIX_Dynamics;
+
+// this allocates everything for `channels` and `freq` up front, so the audio thread doesn't have to.
+MIX_Dynamics *MIX_CreateDynamics(SDL_PropertiesID props, int channels, int freq);
+void MIX_DestroyDynamics(MIX_Dynamics *dynamics);
+
+// reallocate and reset for a new output format, when the device format changes. Don't call this from the audio thread.
+bool MIX_SetDynamicsFormat(MIX_Dynamics *dynamics, int channels, int freq);
+
+// processes `frames` of interleaved `pcm` in-place, and stores the gain reduction (in decibels) in `gain_reduction`.
+// If `src` isn't NULL, its first `src_frames` frames are added to `pcm` on the way through, so the last sum into a buffer
+// and its dynamics processing are one pass. If not NULL, `in_meter` measures what comes in (`src` if it isn't NULL, `pcm` otherwise)
+// and `out_meter` measures what comes out.
+// Returns false without touching anything if `dynamics` isn't set up for this format; this never allocates.
+bool MIX_ApplyDynamics(MIX_Dynamics *dynamics, SDL_AtomicU32 *gain_reduction, float *pcm, const float *src, int src_frames, MIX_MeterAccumulator *in_meter, MIX_MeterAccumulator *out_meter, int channels, int freq, int frames);
+
+// Loudness analysis (EBU R128), for MIX_PROP_AUDIO_LOAD_ANALYZE_LOUDNESS_BOOLEAN.
+typedef struct MIX_LoudnessAnalyzer MIX_LoudnessAnalyzer;
+
+MIX_LoudnessAnalyzer *MIX_CreateLoudnessAnalyzer(const SDL_AudioSpec *spec);
+void MIX_DestroyLoudnessAnalyzer(MIX_LoudnessAnalyzer *analyzer);
+
+// forget everything fed so far, as if the analyzer was just created.
+void MIX_ResetLoudnessAnalyzer(MIX_LoudnessAnalyzer *analyzer);
+
+// feed data in the format given to MIX_CreateLoudnessAnalyzer. It doesn't have to be whole sample frames.
+bool MIX_FeedLoudnessAnalyzer(MIX_LoudnessAnalyzer *analyzer, const void *buffer, int buflen);
+
+// sets MIX_PROP_METADATA_LOUDNESS_* properties in `props`, for whatever could be measured.
+bool MIX_FinishLoudnessAnalyzer(MIX_LoudnessAnalyzer *analyzer, SDL_PropertiesID props);
+
+// Our own resampler, for MIX_SetTrackResampler and MIX_SetGroupResampler.
+#define MIX_RESAMPLER_MAX_TAPS 64
+
+typedef struct MIX_Resampler
+{
+    MIX_ResamplerQuality quality;
+    int taps;  // input frames that go into each output frame.
+    int left;  // how many of those taps are before the current position.
+    int channels;  // zero until MIX_SetResamplerFormat is called.
+    int stride;  // floats per frame in `frames`: channels, padded to 4 or 8.
+    int src_freq;
+    int dst_freq;
+    float *table;  // windowed-sinc weights for each cutoff band, built up front. NULL if not MIX_RESAMPLER_SINC.
+    float *frames;  // input frames that are still needed, aligned.
+    int frames_allocated;
+    int frames_available;
+    float *output;  // interleaved resampled output.
+    int output_allocated;  // in samples.
+    double position;  // input frame (and fraction) of the next output frame, relative to `frames`.
+    double step;  // the step used for the latest output frame, zero if nothing was resampled since the last reset.
+    int glide_frames;  // output frames left to ramp from `step` to a new one, instead of jumping to it.
+} MIX_Resampler;
+
+MIX_Resampler *MIX_CreateResampler(MIX_ResamplerQuality quality, int sinc_taps);
+void MIX_DestroyResampler(MIX_Resampler *resampler);
+bool MIX_SetResamplerFormat(MIX_Resampler *resampler, int channels, int src_freq, int dst_freq);  // resets the resampler if anything changed.
+void MIX_ResetResampler(MIX_Resampler *resampler);
+
+// the next time MIX_Resample gets a different `step`, ramp to it across `frames` output frames instead of jumping.
+void MIX_SetResamplerGlide(MIX_Resampler *resampler, int frames);
+
+// `step` is input frames per output frame. Returns number of output frames, or -1 on error. `*output` is owned by the resampler, valid until the next call.
+// Set `input` to NULL to feed `input_frames` of silence.
+int MIX_Resample(MIX_Resampler *resampler, const float *input, int input_frames, double step, const float **output);
+
+// get the last few frames out of the resampler at the end of the input.
+int MIX_FlushResampler(MIX_Resampler *resampler, double step, const float **output);
+
+// when switching resamplers mid-playback: give a brand new resampler the old one's format, history and position, so nothing is dropped.
+bool MIX_TransferResamplerHistory(MIX_Resampler *to, const MIX_Resampler *from);
+
+// when going back to SDL_AudioStream resampling: the input frames the resampler is holding that it hasn't reached yet.
+// Returns number of frames (interleaved in `*input`, owned by the resampler), or -1 on error.
+int MIX_GetResamplerInput(MIX_Resampler *resampler, const float **input);
+
+// Time-stretcher (WSOLA), for MIX_SetTrackTempo: changes tempo without changing pitch.
+typedef struct MIX_TimeStretch
+{
+    int channels;  // zero until MIX_SetTimeStretchFormat is called.
+    int freq;
+    int sequence_frames;  // length of each chunk of input that gets played as-is.
+    int seek_frames;  // how far we search for the best place to start each sequence.
+    int overlap_frames;  // how long each sequence crossfades into the next.
+    float *ramp;  // crossfade weights, one per sample (not per frame) of the overlap.
+    float *overlap;  // the tail of the last sequence, waiting to be crossfaded into the next one. Same size as `ramp`.
+    int ramp_allocated;  // in samples, not frames, since the format can change without reallocating.
+    bool have_overlap;
+    float *input;  // input frames that are still needed.
+    int input_allocated;  // in samples.
+    int input_frames;
+    double skip_fraction;  // fractional input frame we still owe, so odd tempos don't drift.
+    double expected_frames;  // how much output the input so far should make, for trimming the flush.
+    Sint64 output_total;  // how much output we've actually made since the last reset.
+    float tempo;  // the tempo of the last MIX_ApplyTimeStretch call.
+    float *output;  // interleaved stretched output.
+    int output_allocated;  // in samples.
+} MIX_TimeStretch;
+
+MIX_TimeStretch *MIX_CreateTimeStretch(void);
+void MIX_DestroyTimeStretch(MIX_TimeStretch *timestretch);
+// Grows the time-stretcher's buffers to handle `channels` and `freq` at `tempo`. Never shrinks them. This is the only thing that allocates,
+//  so call it off the audio thread (with the track locked) whenever the tempo or the input format changes.
+bool MIX_ReserveTimeStretch(MIX_TimeStretch *timestretch, int channels, int freq, float tempo);
+// resets the time-stretcher if anything changed. Doesn't allocate; returns false if MIX_ReserveTimeStretch didn't make room for this format.
+bool MIX_SetTimeStretchFormat(MIX_TimeStretch *timestretch, int channels, int freq);
+void MIX_ResetTimeStretch(MIX_TimeStretch *timestretch);  // cheap, doesn't free anything.
+
+// `tempo` is input frames per output frame. Returns number of output frames, or -1 if MIX_ReserveTimeStretch didn't make room for this tempo.
+//  `*output` is owned by the time-stretcher, valid until the next call. This doesn't allocate, so it might not take all the input at once;
+//  `*consumed` is set to how many input frames it used, and the caller should call again with the rest.
+// Set `input` to NULL to feed `input_frames` of silence. This holds on to some input between calls, so output lags a little.
+int MIX_ApplyTimeStretch(MIX_TimeStretch *timestretch, const float *input, int input_frames, float tempo, int *consumed, const float **output);
+
+// get the rest of the input out of the time-stretcher at the end of the input, and reset it.
+int MIX_FlushTimeStretch(MIX_TimeStretch *timestretch, const float **output);
+
+static SDL_INLINE void MIX_SetAtomicFloat(SDL_AtomicU32 *a, float f)
+{
+    union { float f; Uint32 u; } cvt;
+    cvt.f = f;
+    SDL_SetAtomicU32(a, cvt.u);
+}
+
+static SDL_INLINE float MIX_GetAtomicFloat(SDL_AtomicU32 *a)
+{
+    union { float f; Uint32 u; } cvt;
+    cvt.u = SDL_GetAtomicU32(a);
+    return cvt.f;
+}
+
+// Doppler shift for a 3D track, as a frequency ratio, clamped to MIX_DOPPLER_MIN_RATIO...MIX_DOPPLER_MAX_RATIO (one octave either way,
+//  as documented for MIX_SetTrack3DVelocity). `position` and velocities are 3 floats (no alignment requirements).
+#define MIX_DOPPLER_MIN_RATIO 0.5f
+#define MIX_DOPPLER_MAX_RATIO 2.0f
+#define MIX_DEFAULT_SPEED_OF_SOUND 343.3f
+float MIX_CalculateDopplerRatio(const float *position, const float *velocity, const float *listener_velocity, float speed_of_sound);
+
+// Ambisonic bus stuff, for 3D tracks when the app opts in with MIX_SetAmbisonicOrder().
+// Tracks encode into ACN channel order with SN3D normalization, so a lower order is just a prefix of the higher-order channels.
+#define MIX_AMBISONIC_MAX_ORDER 3
+#define MIX_AMBISONIC_MAX_CHANNELS 16   // (order+1)^2 for third order.
+#define MIX_AMBISONIC_STRIDE(order) ((((order)+1) * ((order)+1) + 3) & ~3)   // channels per frame in the bus, padded out for SIMD.
+
+typedef struct MIX_AmbisonicDecoder
+{
+    int order;
+    int speaker_count;
+    float SDL_ALIGNED(16) matrix[MIX_AMBISONIC_MAX_CHANNELS][MIX_VBAP2D_MAX_SPEAKER_COUNT];  // [ambisonic channel][output speaker], transposed so SIMD can do four speakers at once.
+} MIX_AmbisonicDecoder;
+
+void MIX_AmbisonicDecoder_Init(MIX_AmbisonicDecoder *decoder, int order, int speaker_count);
+
+// `gains` must be MIX_AMBISONIC_MAX_CHANNELS floats, aligned to 16 bytes. `position` must be 16 bytes (only 12 are used), aligned to 16 bytes. This always encodes at the max order.
+void MIX_AmbisonicEncode(const float *position, float *gains);
+
+// `src` is `frames` of ambisonic data, MIX_AMBISONIC_STRIDE(decoder->order) floats per frame. This _adds_ the decoded audio to `dst`, which has decoder->speaker_count channels.
+void MIX_AmbisonicDecode(const MIX_AmbisonicDecoder *decoder, float *dst, const float *src, int frames);
+
+// `src` is `frames` of mono audio. This _adds_ it to `dst`, which is MIX_AMBISONIC_STRIDE(order) floats per frame, encoded with `gains` (from MIX_AmbisonicEncode) and scaled by `gain`.
+void MIX_AmbisonicEncodeMix(float *dst, const float *src, int frames, int order, const float *gains, float gain, MIX_MeterAccumulator *meter);  // `meter` (if not NULL) measures `src` with `gain` applied.
+
 
 // Clamp an IOStream to a subset of its available data...this is used to cut ID3 (etc) tags off
 //  both ends of an audio file, making it look like the file just doesn't have those bytes.
@@ -96,18 +397,44 @@ typedef struct MIX_IoClamp
 
 extern SDL_IOStream *MIX_OpenIoClamp(MIX_IoClamp *clamp, SDL_IOStream *io);
 
+// like MIX_OpenIoClamp, but limited to `length` bytes at `start` in `io`, and the MIX_IoClamp is allocated here and freed when the
+//  returned stream closes, so anything holding on to the stream (a track's input, a retired queue item, etc) has its own.
+extern SDL_IOStream *MIX_OpenIoClampRange(SDL_IOStream *io, Sint64 start, Sint64 length);
+
+// MIX_QueueTrackAudio prepares these ahead of time, so the mixer can switch to the next input without a gap.
+//  When a track moves on from an input, the old input goes into one of these too, so it can be cleaned up off the audio thread.
+typedef struct MIX_TrackQueueItem
+{
+    MIX_Audio *audio;  // holds a reference. NULL if this is a retired MIX_SetTrackAudioStream input.
+    void *decoder_userdata;
+    SDL_IOStream *io;
+    SDL_IOStream *clamped_io;  // if `io` is an IoClamp, this is the stream it reads from.
+    bool closeio;  // close `io` (and `clamped_io`, if set) when done.
+    SDL_AudioStream *stream;  // decoded float data. For queued items, the first few blocks are already decoded.
+    float crossfade_gain;  // if this is fading out in a MIX_CrossfadeTrackAudio, the gain it was playing at when the fade started.
+    Sint64 crossfade_total_frames;
+    Sint64 crossfade_frames;  // remaining frames to fade out.
+    MIX_CrossfadeCurve crossfade_curve;
+    struct MIX_TrackQueueItem *next;
+} MIX_TrackQueueItem;
+
 
 typedef struct MIX_Decoder
 {
     const char *name;
     bool (SDLCALL *init)(void);   // initialize the decoder (load external libraries, etc).
-    bool (SDLCALL *init_audio)(SDL_IOStream *io, SDL_AudioSpec *spec, SDL_PropertiesID props, Sint64 *duration_frames, void **audio_userdata);  // see if it's a supported format, init spec, set metadata in props, allocate static userdata and payload.
-    bool (SDLCALL *init_track)(void *audio_userdata, SDL_IOStream *io, const SDL_AudioSpec *spec, SDL_PropertiesID props, void **track_userdata);  // init decoder instance data for a single track.
+    bool (SDLCALL *init_audio)(SDL_IOStream *io, SDL_AudioSpec *spec, SDL_PropertiesID props, Sint64 *duration_frames, void **audio_userdata);  // see if it's a supported format, init spec, set metadata in props, allocate static userdata and payload. If `io` is memory (MIX_GetConstIOBuffer), it stays valid until quit_audio.
+    bool (SDLCALL *init_track)(void *audio_userdata, SDL_IOStream *io, const SDL_AudioSpec *spec, SDL_PropertiesID props, void **track_userdata);  // init decoder instance data for a single track. `props` are the MIX_Track's (maybe zero), or the audio's when there's no track (predecoding, etc).
     bool (SDLCALL *decode)(void *track_userdata, SDL_AudioStream *stream);
     bool (SDLCALL *seek)(void *track_userdata, Uint64 frame);
     void (SDLCALL *quit_track)(void *track_userdata);
     void (SDLCALL *quit_audio)(void *audio_userdata);
     void (SDLCALL *quit)(void);   // deinitialize the decoder (unload external libraries, etc).
+    int (SDLCALL *decode_into)(void *track_userdata, float *dst, int frames);  // optional, for SDL_AUDIO_F32 decoders: decode up to `frames` straight into `dst`. Returns frames written (maybe fewer), or -1 at EOF or on failure. Zero is treated like the end of the data.
+    int preferred_frames;  // how many frames decode_into likes to do per call, when the caller gets to choose. Zero if it doesn't care.
+    bool exact_seek;  // true if decoding after seek() gives exactly the frames that decoding straight through would, and seek() is cheap (if build_seek_index exists, once it succeeds), so predecoding can split the work across threads.
+    bool (SDLCALL *build_seek_index)(void *audio_userdata, SDL_IOStream *io);  // optional: build the seek table seek() uses, reading from `io`. Returns true if there's one now. Runs while loading or on a background thread; seek() must never build it.
+    bool (SDLCALL *prepare_seek)(void *track_userdata);  // optional: called off the mixer thread before a track starts playing in a way that seeks from the mixer thread (looping, etc), so those seeks never have to set up anything expensive.
 } MIX_Decoder;
 
 typedef enum MIX_TrackState
@@ -127,16 +454,36 @@ struct MIX_Audio
     const void *precache;    // non-NULL if this cached the audio data (might be NULL if we're feeding from an external SDL_IOStream).
     size_t precachelen;
     bool free_precache;
+    bool aligned_precache;  // precache is predecoded audio from SDL_aligned_alloc, so it needs SDL_aligned_free.
     Sint64 duration_frames;
     Sint64 clamp_offset;
     Sint64 clamp_length;
+    MIX_Audio *seek_index_next;  // queue of audio waiting for the background seek index thread. Protected by its lock.
     MIX_Audio *prev;  // double-linked list for all_audios.
     MIX_Audio *next;
 };
 
+// size of MIX_Track::crossfade_buffer. The outgoing audio is mixed in chunks of this size.
+#define MIX_CROSSFADE_BUFFER_BYTES (16 * 1024)
+
+// stop_mixer_frame when there isn't a stop scheduled. Zero can't be used, because that's a real (past) frame.
+#define MIX_UNSCHEDULED_MIXER_FRAME SDL_MAX_UINT64
+
 struct MIX_Track
 {
     float SDL_ALIGNED(16) position3d[4];   // we only need the X, Y, and Z coords, but the 4th element makes this SIMD-friendly.
+    float SDL_ALIGNED(16) ambisonic_gains[MIX_AMBISONIC_MAX_CHANNELS];  // encoding gains for the mixer's ambisonic bus, if the mixer is using one.
+    float SDL_ALIGNED(16) velocity3d[4];   // units per second, for the Doppler effect. Only X, Y, and Z are used.
+    float frequency_ratio;  // what the app asked for with MIX_SetTrackFrequencyRatio. The output_stream's ratio might also include Doppler shift.
+    float doppler_ratio;  // current Doppler shift applied to output_stream, 1.0f if none.
+    float normalization_gain;  // from MIX_PROP_PLAY_LOUDNESS_TARGET_FLOAT, 1.0f if none. Applied when mixing, along with the mixer's gain.
+    float output_ratio;  // frequency_ratio * doppler_ratio, what we actually resample by.
+    MIX_ResamplerQuality resampler_quality;  // what the app asked for with MIX_SetTrackResampler.
+    int resampler_taps;
+    MIX_Resampler *resampler;  // NULL if SDL_AudioStream is resampling for us.
+    SDL_AudioSpec input_spec;  // format of the data coming from input_stream. Zero'd if nothing has been bound yet.
+    float tempo;  // from MIX_SetTrackTempo, 1.0f for normal speed.
+    MIX_TimeStretch *timestretch;  // NULL until the app changes the tempo for the first time.
     MIX_SpatializationMode spatialization_mode;
     float spatialization_panning[2];
     int spatialization_speakers[2];
@@ -144,9 +491,16 @@ struct MIX_Track
     SDL_PropertiesID props;
     float *input_buffer;  // a place to process audio as it progresses through the callback.
     size_t input_buffer_len;  // number of bytes allocated to input_buffer.
+    MIX_TrackQueueItem *queue;  // inputs from MIX_QueueTrackAudio, ready to go, in the order they'll play.
+    MIX_TrackQueueItem *retired;  // inputs the mixer moved on from, waiting to be cleaned up off the audio thread.
+    MIX_TrackQueueItem *crossfade_from;  // inputs that MIX_CrossfadeTrackAudio is fading out, newest first. NULL if none (or they already ran out).
+    Sint64 crossfade_total_frames;  // how long the current input fades in for.
+    Sint64 crossfade_frames;  // remaining frames to fade in the current input. Zero if not crossfading.
+    MIX_CrossfadeCurve crossfade_curve;
+    float *crossfade_buffer;  // MIX_CROSSFADE_BUFFER_BYTES, where crossfade_from's audio is decoded to before mixing. Allocated by MIX_CrossfadeTrackAudio, never by the audio thread.
     MIX_Audio *input_audio;    // non-NULL if used with MIX_SetTrackAudioStream. Holds a reference.
     SDL_IOStream *io;  // used for MIX_SetTrackAudio and MIX_SetTrackIOStream. Might be owned by us (SDL_IOFromConstMem of MIX_Audio::precache), or owned by the app.
-    MIX_IoClamp ioclamp;  // used for MIX_SetTrackAudio and MIX_SetTrackIOStream.
+    SDL_IOStream *clamped_io;  // if `io` is an IoClamp (MIX_SetTrackIOStream with ID3 tags, etc), this is the stream it reads from. The clamp belongs to `io`.
     bool closeio;  // true if we should close `io` when changing track data.
     SDL_AudioStream *input_stream;  // used for both MIX_SetTrackAudio and MIX_SetTrackAudioStream. Maybe not owned by SDL_mixer!
     SDL_AudioStream *internal_stream;  // used with MIX_SetTrackAudio, where it is also assigned to input_stream. Owned by SDL_mixer!
@@ -161,9 +515,15 @@ struct MIX_Track
     Sint64 total_fade_frames;  // fade in or out for this many sample frames.
     Sint64 fade_frames;  // remaining frames to fade.
     int fade_direction;  // -1: fade out  0: don't fade  1: fade in
+    Uint64 start_mixer_frame;  // don't mix until the mixer clock reaches this frame. Zero if not scheduled.
+    SDL_AtomicInt prebuffering;  // nonzero while MIX_PlayTag/MIX_SetTagPlaybackPosition decode ahead with the track locked. The mixer skips the track instead of waiting.
+    Uint64 stop_mixer_frame;  // stop when the mixer clock reaches this frame. MIX_UNSCHEDULED_MIXER_FRAME if not scheduled.
+    Sint64 stop_fade_frames;  // fade-out to use when reaching stop_mixer_frame.
     int loops_remaining;  // seek to loop_start and continue this many more times at end of input. Negative to loop forever.
     int loop_start;      // sample frame position for loops to begin, so you can play an intro once and then loop from an internal point thereafter.
     SDL_PropertiesID tags;  // lookup tags to see if they are currently applied to this track (true or false).
+    MIX_FilterChain *filters;  // NULL until the app sets filters on this track.
+    MIX_Meter meter;  // this track's output (after gain, before spatialization), if the mixer is metering.
     MIX_TrackMixCallback raw_callback;
     void *raw_callback_userdata;
     MIX_TrackMixCallback cooked_callback;
@@ -183,6 +543,12 @@ struct MIX_Group
     MIX_Mixer *mixer;
     MIX_Track *tracks;
     SDL_PropertiesID props;
+    MIX_FilterChain *filters;  // NULL until the app sets filters on this group.
+    MIX_Dynamics *dynamics;  // NULL unless the app enabled a compressor/limiter on this group.
+    SDL_AtomicU32 gain_reduction;  // float, decibels of gain reduction applied by `dynamics` in the latest buffer.
+    MIX_Meter meter;  // this group's output, after the postmix callback, if the mixer is metering.
+    MIX_ResamplerQuality resampler_quality;  // for tracks in this group using MIX_RESAMPLER_DEFAULT.
+    int resampler_taps;
     MIX_GroupMixCallback postmix_callback;
     void *postmix_callback_userdata;
     MIX_Group *prev;  // double-linked list for all_groups.
@@ -206,6 +572,17 @@ struct MIX_Mixer
     size_t mix_buffer_allocation;
     float gain;
     MIX_VBAP2D vbap2d;
+    MIX_Dynamics *dynamics;  // NULL unless the app enabled a compressor/limiter on the final mix.
+    SDL_AtomicU32 gain_reduction;  // float, decibels of gain reduction applied by `dynamics` in the latest buffer.
+    float listener_velocity3d[4];  // units per second, for the Doppler effect. Only X, Y, and Z are used.
+    float speed_of_sound;  // units per second, from MIX_PROP_MIXER_SPEED_OF_SOUND_FLOAT. MixerCallback refreshes this every buffer.
+    int ambisonic_order;  // zero if 3D tracks are panned directly to speakers instead of through an ambisonic bus.
+    MIX_AmbisonicDecoder ambisonic_decoder;
+    int meter_interval;  // measure one of every `meter_interval` mixed buffers. Zero if not metering.
+    int meter_countdown;  // buffers left until we measure again.
+    MIX_Meter meter;  // the final mix, after dynamics, before the postmix callback.
+    Uint64 clock;  // sample frames mixed since creation. Only MixerCallback writes this; others read it through clock_sequence.
+    SDL_AtomicInt clock_sequence;  // odd while `clock` is being updated, so MIX_GetMixerClock can read it without locking.
     MIX_Mixer *prev;  // double-linked list for all_mixers.
     MIX_Mixer *next;
 };
@@ -260,6 +637,33 @@ typedef struct MIX_OggLoop
 
 void MIX_ParseOggComments(SDL_PropertiesID props, int freq, const char *vendor, const char * const *user_comments, int num_comments, MIX_OggLoop *loop);
 
+// Where pages start in an Ogg stream, by granule position, so seeks can jump near their target instead of bisecting the file.
+//  Decoders build one per MIX_Audio in their build_seek_index, and share it with every track.
+typedef struct MIX_OggSeekPoint
+{
+    Sint64 offset;  // byte offset of the page in the stream.
+    Sint64 page_end;  // byte offset just past the end of the page.
+    Uint64 granule;  // granule position of the page (the last sample frame that finishes on it).
+} MIX_OggSeekPoint;
+
+typedef struct MIX_OggSeekIndex
+{
+    MIX_OggSeekPoint *points;  // sorted by offset, which also sorts them by granule.
+    int num_points;
+} MIX_OggSeekIndex;
+
+// `*shared_index` is a MIX_OggSeekIndex, accessed atomically, built from `io` (with a point about every `interval` frames) if it doesn't exist yet. `io`'s position is restored.
+// Returns false if there's no index and we couldn't (or shouldn't) build one. This scans the whole stream, so never call it from seek().
+bool MIX_BuildOggSeekIndex(void **shared_index, SDL_IOStream *io, Uint64 interval);
+
+// returns the index of the last point that finishes before `granule`, or -1 if there isn't one.
+int MIX_FindOggSeekPoint(const MIX_OggSeekIndex *index, Uint64 granule);
+
+void MIX_DestroyOggSeekIndex(MIX_OggSeekIndex *index);
+
+// Turn ReplayGain and R128 tags (from ID3v2, APE, or Ogg comments) into MIX_PROP_METADATA_LOUDNESS_* properties. Returns true if integrated loudness was found.
+bool MIX_ResolveLoudnessTags(SDL_PropertiesID props);
+
 // `panning` and `speakers` need to be arrays of 2 elements each, to be filled in with what speakers to write to, and at what gain. `position` must be 16 bytes (only 12 are used), aligned to 16 bytes.
 void MIX_Spatialize(const MIX_VBAP2D *vbap2d, const float *position, float *panning, int *speakers);
 
@@ -273,6 +677,18 @@ void *MIX_SlurpConstIO(SDL_IOStream *io, size_t *datalen, bool *copied);
 extern const float MIX_alawToFloat[256];
 extern const float MIX_ulawToFloat[256];
 
+// Lookup tables for IMA ADPCM (WAV and AIFF-C's "ima4" both use it). These replace the bit twiddling in the reference
+//  decoder with a single load per nybble, and still produce exactly the same output. Decoders that need them build
+//  MIX_IMAADPCM_tables in their init; it always comes out the same, so it doesn't matter if more than one does.
+typedef struct MIX_IMAADPCMTables
+{
+    Sint32 delta[89][16];       // sample delta for each step index and nybble.
+    Uint8 next_index[89][16];   // (clamped) step index that follows each step index and nybble.
+} MIX_IMAADPCMTables;
+
+extern MIX_IMAADPCMTables MIX_IMAADPCM_tables;
+void MIX_BuildIMAADPCMTables(MIX_IMAADPCMTables *tables);
+
 // these might not all be available, but they are all declared here as if they are.
 extern MIX_Decoder MIX_Decoder_AU;
 extern MIX_Decoder MIX_Decoder_VOC;
@@ -0,0 +1,493 @@
+/*
+  SDL_mixer:  An audio mixer library based on the SDL library
+  Copyright (C) 1997-2025 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "SDL_mixer_internal.h"
+
+// Loudness analysis, as described by ITU-R BS.1770-4 and EBU R128 (and EBU Tech 3341/3342).
+//
+// This only runs when loading a MIX_Audio, if the app asks for it, so it favors accuracy over speed
+// (everything is in doubles), but it's still a single pass over the data with no extra copies of the
+// decoded audio.
+//
+// - Each channel goes through the "K-weighting" filter (a high shelf and a high pass, as two biquads).
+// - We keep the weighted mean square of each 100 millisecond sub-block.
+// - Four sub-blocks make a 400 millisecond gating block (so gating blocks overlap by 75%). These
+//   make the integrated loudness, after dropping blocks below -70 LUFS, and then blocks more than
+//   10 LU below what's left.
+// - Thirty sub-blocks make a 3 second short-term block. The loudness range is the spread between the
+//   10th and 95th percentile of these, after dropping blocks below -70 LUFS and then blocks more
+//   than 20 LU below what's left.
+// - True peak comes from oversampling each channel (4x below 96kHz, 2x below 192kHz) with a
+//   windowed-sinc interpolator and taking the largest absolute sample.
+
+#define LOUDNESS_TAPS_PER_PHASE 12
+#define LOUDNESS_MAX_OVERSAMPLE 4
+#define LOUDNESS_SHORT_TERM_SUBBLOCKS 30
+#define LOUDNESS_MOMENTARY_SUBBLOCKS 4
+#define LOUDNESS_ABSOLUTE_GATE -70.0
+#define LOUDNESS_RELATIVE_GATE -10.0
+#define LOUDNESS_RANGE_RELATIVE_GATE -20.0
+#define LOUDNESS_SCRATCH_FLOATS 4096
+
+typedef struct LoudnessBiquad
+{
+    double b0, b1, b2, a1, a2;
+} LoudnessBiquad;
+
+typedef struct LoudnessBlocks
+{
+    double *energies;
+    size_t count;
+    size_t allocated;
+} LoudnessBlocks;
+
+struct MIX_LoudnessAnalyzer
+{
+    SDL_AudioSpec spec;
+    SDL_AudioStream *converter;   // NULL if the data is already float32.
+    float *scratch;
+    LoudnessBiquad shelf;
+    LoudnessBiquad highpass;
+    double *filter_state;   // 4 doubles per channel: two per biquad.
+    const float *channel_weights;
+    int subblock_frames;
+    int subblock_position;
+    double subblock_sum;
+    double subblocks[LOUDNESS_SHORT_TERM_SUBBLOCKS];   // ring buffer of recent sub-block mean squares.
+    int total_subblocks;
+    LoudnessBlocks momentary;
+    LoudnessBlocks short_term;
+    int oversample;
+    float interpolator[LOUDNESS_MAX_OVERSAMPLE][LOUDNESS_TAPS_PER_PHASE];
+    float *history;   // LOUDNESS_TAPS_PER_PHASE floats per channel.
+    int history_position;
+    float peak;
+    float partial_frame[8];  // float32 input that didn't end on a sample frame boundary waits here for the rest of its frame.
+    int partial_bytes;
+};
+
+// BS.1770 channel weights, by SDL's channel layouts. LFE is ignored, surrounds are boosted.
+static const float weights_1[] = { 1.0f };
+static const float weights_2[] = { 1.0f, 1.0f };
+static const float weights_3[] = { 1.0f, 1.0f, 0.0f };
+static const float weights_4[] = { 1.0f, 1.0f, 1.41f, 1.41f };
+static const float weights_5[] = { 1.0f, 1.0f, 0.0f, 1.41f, 1.41f };
+static const float weights_6[] = { 1.0f, 1.0f, 1.0f, 0.0f, 1.41f, 1.41f };
+static const float weights_7[] = { 1.0f, 1.0f, 1.0f, 0.0f, 1.41f, 1.41f, 1.41f };
+static const float weights_8[] = { 1.0f, 1.0f, 1.0f, 0.0f, 1.41f, 1.41f, 1.41f, 1.41f };
+static const float * const channel_weights[] = { weights_1, weights_2, weights_3, weights_4, weights_5, weights_6, weights_7, weights_8 };
+
+// the K-weighting filter is specified at 48kHz in BS.1770; these are the analog prototypes so it works at any sample rate.
+static void InitKWeighting(MIX_LoudnessAnalyzer *analyzer, int freq)
+{
+    const double pi = 3.14159265358979323846;
+
+    double f0 = 1681.974450955533;
+    double Q = 0.7071752369554196;
+    double K = SDL_tan(pi * f0 / (double) freq);
+    const double Vh = SDL_pow(10.0, 3.999843853973347 / 20.0);
+    const double Vb = SDL_pow(Vh, 0.4996667741545416);
+    double a0 = 1.0 + K / Q + K * K;
+    analyzer->shelf.b0 = (Vh + Vb * K / Q + K * K) / a0;
+    analyzer->shelf.b1 = 2.0 * (K * K - Vh) / a0;
+    analyzer->shelf.b2 = (Vh - Vb * K / Q + K * K) / a0;
+    analyzer->shelf.a1 = 2.0 * (K * K - 1.0) / a0;
+    analyzer->shelf.a2 = (1.0 - K / Q + K * K) / a0;
+
+    f0 = 38.13547087602444;
+    Q = 0.5003270373238773;
+    K = SDL_tan(pi * f0 / (double) freq);
+    a0 = 1.0 + K / Q + K * K;
+    analyzer->highpass.b0 = 1.0;
+    analyzer->highpass.b1 = -2.0;
+    analyzer->highpass.b2 = 1.0;
+    analyzer->highpass.a1 = 2.0 * (K * K - 1.0) / a0;
+    analyzer->highpass.a2 = (1.0 - K / Q + K * K) / a0;
+}
+
+// polyphase windowed-sinc interpolator. Phase 0 lands exactly on the original samples.
+static void InitInterpolator(MIX_LoudnessAnalyzer *analyzer, int freq)
+{
+    const double pi = 3.14159265358979323846;
+    const int oversample = (freq < 96000) ? 4 : (freq < 192000) ? 2 : 1;
+    const int taps = oversample * LOUDNESS_TAPS_PER_PHASE;
+    const int center = taps / 2;
+
+    analyzer->oversample = oversample;
+    for (int i = 0; i < taps; i++) {
+        const double x = (double) (i - center) / (double) oversample;
+        const double sinc = (i == center) ? 1.0 : (SDL_sin(pi * x) / (pi * x));
+        const double window = 0.42 - 0.5 * SDL_cos(2.0 * pi * i / (2.0 * center)) + 0.08 * SDL_cos(4.0 * pi * i / (2.0 * center));  // Blackman
+        analyzer->interpolator[i % oversample][i / oversample] = (float) (sinc * window);
+    }
+}
+
+MIX_LoudnessAnalyzer *MIX_CreateLoudnessAnalyzer(const SDL_AudioSpec *spec)
+{
+    if ((spec->channels < 1) || (spec->channels > (int) SDL_arraysize(channel_weights))) {
+        SDL_SetError("Can't analyze loudness of %d channel audio", spec->channels);
+        return NULL;
+    } else if (spec->freq < 10) {
+        SDL_SetError("Can't analyze loudness of %dHz audio", spec->freq);
+        return NULL;
+    }
+
+    MIX_LoudnessAnalyzer *analyzer = (MIX_LoudnessAnalyzer *) SDL_calloc(1, sizeof (*analyzer));
+    if (!analyzer) {
+        return NULL;
+    }
+
+    SDL_copyp(&analyzer->spec, spec);
+
+    if (spec->format != SDL_AUDIO_F32) {
+        const SDL_AudioSpec float_spec = { SDL_AUDIO_F32, spec->channels, spec->freq };
+        analyzer->converter = SDL_CreateAudioStream(spec, &float_spec);
+        if (!analyzer->converter) {
+            MIX_DestroyLoudnessAnalyzer(analyzer);
+            return NULL;
+        }
+    }
+
+    analyzer->scratch = (float *) SDL_malloc(LOUDNESS_SCRATCH_FLOATS * sizeof (float));
+    analyzer->filter_state = (double *) SDL_calloc(spec->channels * 4, sizeof (double));
+    analyzer->history = (float *) SDL_calloc(spec->channels * LOUDNESS_TAPS_PER_PHASE, sizeof (float));
+    if (!analyzer->scratch || !analyzer->filter_state || !analyzer->history) {
+        MIX_DestroyLoudnessAnalyzer(analyzer);
+        return NULL;
+    }
+
+    analyzer->channel_weights = channel_weights[spec->channels - 1];
+    analyzer->subblock_frames = spec->freq / 10;
+    InitKWeighting(analyzer, spec->freq);
+    InitInterpolator(analyzer, spec->freq);
+
+    return analyzer;
+}
+
+void MIX_ResetLoudnessAnalyzer(MIX_LoudnessAnalyzer *analyzer)
+{
+    const int channels = analyzer->spec.channels;
+    if (analyzer->converter) {
+        SDL_ClearAudioStream(analyzer->converter);
+    }
+    SDL_memset(analyzer->filter_state, 0, channels * 4 * sizeof (double));
+    SDL_memset(analyzer->history, 0, channels * LOUDNESS_TAPS_PER_PHASE * sizeof (float));
+    analyzer->history_position = 0;
+    analyzer->subblock_position = 0;
+    analyzer->subblock_sum = 0.0;
+    analyzer->total_subblocks = 0;
+    analyzer->momentary.count = 0;  // keep the allocations, they'll just fill up again.
+    analyzer->short_term.count = 0;
+    analyzer->peak = 0.0f;
+    analyzer->partial_bytes = 0;
+}
+
+void MIX_DestroyLoudnessAnalyzer(MIX_LoudnessAnalyzer *analyzer)
+{
+    if (analyzer) {
+        SDL_DestroyAudioStream(analyzer->converter);
+        SDL_free(analyzer->scratch);
+        SDL_free(analyzer->filter_state);
+        SDL_free(analyzer->history);
+        SDL_free(analyzer->momentary.energies);
+        SDL_free(analyzer->short_term.energies);
+        SDL_free(analyzer);
+    }
+}
+
+static bool AddLoudnessBlock(LoudnessBlocks *blocks, double energy)
+{
+    if (blocks->count >= blocks->allocated) {
+        const size_t allocated = blocks->allocated ? (blocks->allocated * 2) : 1024;
+        double *ptr = (double *) SDL_realloc(blocks->energies, allocated * sizeof (double));
+        if (!ptr) {
+            return false;
+        }
+        blocks->energies = ptr;
+        blocks->allocated = allocated;
+    }
+    blocks->energies[blocks->count++] = energy;
+    return true;
+}
+
+static bool FinishSubblock(MIX_LoudnessAnalyzer *analyzer)
+{
+    analyzer->subblocks[analyzer->total_subblocks % LOUDNESS_SHORT_TERM_SUBBLOCKS] = analyzer->subblock_sum / (double) analyzer->subblock_frames;
+    analyzer->total_subblocks++;
+    analyzer->subblock_sum = 0.0;
+    analyzer->subblock_position = 0;
+
+    if (analyzer->total_subblocks >= LOUDNESS_MOMENTARY_SUBBLOCKS) {
+        double sum = 0.0;
+        for (int i = 1; i <= LOUDNESS_MOMENTARY_SUBBLOCKS; i++) {
+            sum += analyzer->subblocks[(analyzer->total_subblocks - i) % LOUDNESS_SHORT_TERM_SUBBLOCKS];
+        }
+        if (!AddLoudnessBlock(&analyzer->momentary, sum / LOUDNESS_MOMENTARY_SUBBLOCKS)) {
+            return false;
+        }
+    }
+
+    if (analyzer->total_subblocks >= LOUDNESS_SHORT_TERM_SUBBLOCKS) {
+        double sum = 0.0;
+        for (int i = 0; i < LOUDNESS_SHORT_TERM_SUBBLOCKS; i++) {
+            sum += analyzer->subblocks[i];
+        }
+        if (!AddLoudnessBlock(&analyzer->short_term, sum / LOUDNESS_SHORT_TERM_SUBBLOCKS)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool AnalyzeFloat32(MIX_LoudnessAnalyzer *analyzer, const float *pcm, int frames)
+{
+    const int channels = analyzer->spec.channels;
+    const float *weights = analyzer->channel_weights;
+    const LoudnessBiquad *shelf = &analyzer->shelf;
+    const LoudnessBiquad *highpass = &analyzer->highpass;
+    const int oversample = analyzer->oversample;
+    float peak = analyzer->peak;
+
+    for (int i = 0; i < frames; i++) {
+        const int hpos = analyzer->history_position;
+        double frame_sum = 0.0;
+
+        for (int channel = 0; channel < channels; channel++) {
+            const float sample = *(pcm++);
+
+            // K-weighting, two biquads in Transposed Direct Form II.
+            double *z = &analyzer->filter_state[channel * 4];
+            const double x = (double) sample;
+            const double y1 = shelf->b0 * x + z[0];
+            z[0] = shelf->b1 * x - shelf->a1 * y1 + z[1];
+            z[1] = shelf->b2 * x - shelf->a2 * y1;
+            const double y2 = highpass->b0 * y1 + z[2];
+            z[2] = highpass->b1 * y1 - highpass->a1 * y2 + z[3];
+            z[3] = highpass->b2 * y1 - highpass->a2 * y2;
+            frame_sum += weights[channel] * y2 * y2;
+
+            // true peak.
+            float *history = &analyzer->history[channel * LOUDNESS_TAPS_PER_PHASE];
+            history[hpos] = sample;
+            if (oversample == 1) {
+                const float a = SDL_fabsf(sample);
+                peak = SDL_max(peak, a);
+            } else {
+                for (int phase = 0; phase < oversample; phase++) {
+                    const float *taps = analyzer->interpolator[phase];
+                    float interpolated = 0.0f;
+                    for (int tap = 0; tap < LOUDNESS_TAPS_PER_PHASE; tap++) {
+                        interpolated += taps[tap] * history[(hpos + LOUDNESS_TAPS_PER_PHASE - tap) % LOUDNESS_TAPS_PER_PHASE];
+                    }
+                    const float a = SDL_fabsf(interpolated);
+                    peak = SDL_max(peak, a);
+                }
+            }
+        }
+
+        analyzer->history_position = (hpos + 1) % LOUDNESS_TAPS_PER_PHASE;
+        analyzer->subblock_sum += frame_sum;
+        if (++analyzer->subblock_position == analyzer->subblock_frames) {
+            if (!FinishSubblock(analyzer)) {
+                analyzer->peak = peak;
+                return false;
+            }
+        }
+    }
+
+    analyzer->peak = peak;
+    return true;
+}
+
+// float32 data doesn't need the converter, but callers can hand us any number of bytes, so we have to deal with partial frames ourselves.
+static bool FeedFloat32(MIX_LoudnessAnalyzer *analyzer, const Uint8 *buffer, int buflen)
+{
+    const int framesize = (int) sizeof (float) * analyzer->spec.channels;
+
+    // finish the frame left over from last time, if there is one.
+    if (analyzer->partial_bytes > 0) {
+        const int cpy = SDL_min(buflen, framesize - analyzer->partial_bytes);
+        SDL_memcpy(((Uint8 *) analyzer->partial_frame) + analyzer->partial_bytes, buffer, cpy);
+        analyzer->partial_bytes += cpy;
+        buffer += cpy;
+        buflen -= cpy;
+        if (analyzer->partial_bytes < framesize) {
+            return true;  // still not a whole frame.
+        }
+        analyzer->partial_bytes = 0;
+        if (!AnalyzeFloat32(analyzer, analyzer->partial_frame, 1)) {
+            return false;
+        }
+    }
+
+    const int frames = buflen / framesize;
+    if ((((size_t) buffer) % sizeof (float)) == 0) {
+        if (!AnalyzeFloat32(analyzer, (const float *) buffer, frames)) {
+            return false;
+        }
+    } else {  // finishing a partial frame left us misaligned, so go through the scratch buffer.
+        const int scratch_frames = LOUDNESS_SCRATCH_FLOATS / analyzer->spec.channels;
+        for (int done = 0; done < frames; ) {
+            const int chunk = SDL_min(scratch_frames, frames - done);
+            SDL_memcpy(analyzer->scratch, buffer + (done * framesize), chunk * framesize);
+            if (!AnalyzeFloat32(analyzer, analyzer->scratch, chunk)) {
+                return false;
+            }
+            done += chunk;
+        }
+    }
+
+    // hold onto anything past the last whole frame.
+    analyzer->partial_bytes = buflen - (frames * framesize);
+    SDL_memcpy(analyzer->partial_frame, buffer + (frames * framesize), analyzer->partial_bytes);
+    return true;
+}
+
+bool MIX_FeedLoudnessAnalyzer(MIX_LoudnessAnalyzer *analyzer, const void *buffer, int buflen)
+{
+    if (!analyzer->converter) {
+        return FeedFloat32(analyzer, (const Uint8 *) buffer, buflen);
+    } else if (!SDL_PutAudioStreamData(analyzer->converter, buffer, buflen)) {
+        return false;
+    }
+
+    const int scratch_frames = LOUDNESS_SCRATCH_FLOATS / analyzer->spec.channels;
+    const int scratch_bytes = scratch_frames * analyzer->spec.channels * (int) sizeof (float);
+    while (SDL_GetAudioStreamAvailable(analyzer->converter) >= scratch_bytes) {
+        const int br = SDL_GetAudioStreamData(analyzer->converter, analyzer->scratch, scratch_bytes);
+        if (br < 0) {
+            return false;
+        } else if (!AnalyzeFloat32(analyzer, analyzer->scratch, br / (int) (sizeof (float) * analyzer->spec.channels))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static double EnergyToLoudness(double energy)
+{
+    return -0.691 + 10.0 * SDL_log10(energy);
+}
+
+static double LoudnessToEnergy(double loudness)
+{
+    return SDL_pow(10.0, (loudness + 0.691) / 10.0);
+}
+
+// returns the mean energy of blocks at or above `threshold`, and how many there were.
+static double GatedMeanEnergy(const LoudnessBlocks *blocks, double threshold, size_t *gated_count)
+{
+    double sum = 0.0;
+    size_t count = 0;
+    for (size_t i = 0; i < blocks->count; i++) {
+        if (blocks->energies[i] >= threshold) {
+            sum += blocks->energies[i];
+            count++;
+        }
+    }
+    *gated_count = count;
+    return count ? (sum / (double) count) : 0.0;
+}
+
+static int SDLCALL CompareDoubles(const void *a, const void *b)
+{
+    const double x = *(const double *) a;
+    const double y = *(const double *) b;
+    return (x < y) ? -1 : (x > y) ? 1 : 0;
+}
+
+bool MIX_FinishLoudnessAnalyzer(MIX_LoudnessAnalyzer *analyzer, SDL_PropertiesID props)
+{
+    if (analyzer->converter) {
+        if (!SDL_FlushAudioStream(analyzer->converter)) {
+            return false;
+        }
+        const int channels = analyzer->spec.channels;
+        const int scratch_bytes = (LOUDNESS_SCRATCH_FLOATS / channels) * channels * (int) sizeof (float);
+        int br;
+        while ((br = SDL_GetAudioStreamData(analyzer->converter, analyzer->scratch, scratch_bytes)) > 0) {
+            if (!AnalyzeFloat32(analyzer, analyzer->scratch, br / (int) (sizeof (float) * channels))) {
+                return false;
+            }
+        }
+        if (br < 0) {
+            return false;
+        }
+    }
+
+    // true peak needs the interpolator to run past the last real sample, so push some silence through it.
+    for (int i = 0; i < LOUDNESS_TAPS_PER_PHASE / 2; i++) {
+        const int hpos = analyzer->history_position;
+        for (int channel = 0; channel < analyzer->spec.channels; channel++) {
+            float *history = &analyzer->history[channel * LOUDNESS_TAPS_PER_PHASE];
+            history[hpos] = 0.0f;
+            for (int phase = 0; phase < analyzer->oversample; phase++) {
+                const float *taps = analyzer->interpolator[phase];
+                float interpolated = 0.0f;
+                for (int tap = 0; tap < LOUDNESS_TAPS_PER_PHASE; tap++) {
+                    interpolated += taps[tap] * history[(hpos + LOUDNESS_TAPS_PER_PHASE - tap) % LOUDNESS_TAPS_PER_PHASE];
+                }
+                const float a = SDL_fabsf(interpolated);
+                analyzer->peak = SDL_max(analyzer->peak, a);
+            }
+        }
+        analyzer->history_position = (hpos + 1) % LOUDNESS_TAPS_PER_PHASE;
+    }
+
+    if (analyzer->peak > 0.0f) {
+        SDL_SetFloatProperty(props, MIX_PROP_METADATA_LOUDNESS_TRUE_PEAK_FLOAT, (float) (20.0 * SDL_log10((double) analyzer->peak)));
+    }
+
+    // integrated loudness. Audio shorter than one gating block (400 milliseconds) doesn't get a value.
+    const double absolute_gate = LoudnessToEnergy(LOUDNESS_ABSOLUTE_GATE);
+    size_t count = 0;
+    double energy = GatedMeanEnergy(&analyzer->momentary, absolute_gate, &count);
+    if (count > 0) {
+        const double relative_gate = LoudnessToEnergy(EnergyToLoudness(energy) + LOUDNESS_RELATIVE_GATE);
+        energy = GatedMeanEnergy(&analyzer->momentary, SDL_max(absolute_gate, relative_gate), &count);
+        if (count > 0) {
+            SDL_SetFloatProperty(props, MIX_PROP_METADATA_LOUDNESS_INTEGRATED_FLOAT, (float) EnergyToLoudness(energy));
+        }
+    }
+
+    // loudness range. Audio shorter than one short-term block (3 seconds) doesn't get a value.
+    energy = GatedMeanEnergy(&analyzer->short_term, absolute_gate, &count);
+    if (count > 0) {
+        const double gate = SDL_max(absolute_gate, LoudnessToEnergy(EnergyToLoudness(energy) + LOUDNESS_RANGE_RELATIVE_GATE));
+        LoudnessBlocks *blocks = &analyzer->short_term;
+        size_t gated = 0;
+        for (size_t i = 0; i < blocks->count; i++) {   // compact the gated blocks to the start of the array; we don't need the rest anymore.
+            if (blocks->energies[i] >= gate) {
+                blocks->energies[gated++] = blocks->energies[i];
+            }
+        }
+        if (gated > 0) {
+            SDL_qsort(blocks->energies, gated, sizeof (double), CompareDoubles);
+            const double low = EnergyToLoudness(blocks->energies[(size_t) ((gated - 1) * 0.10 + 0.5)]);
+            const double high = EnergyToLoudness(blocks->energies[(size_t) ((gated - 1) * 0.95 + 0.5)]);
+            SDL_SetFloatProperty(props, MIX_PROP_METADATA_LOUDNESS_RANGE_FLOAT, (float) (high - low));
+        }
+    }
+
+    return true;
+}
+
@@ -286,12 +286,69 @@ static void set_id3v2_string_prop(SDL_PropertiesID props, const char *key, const
     }
 }
 
+// TXXX frames are a description and a value, each in the frame's text encoding. We store them as "SDL_mixer.metadata.id3v2.TXXX.description".
+static void handle_id3v2_txxx(SDL_PropertiesID props, const Uint8 *string, size_t size)
+{
+    if (size < 3) {
+        return;  // not enough for an encoding byte and two strings.
+    }
+
+    const Uint8 encoding = string[0];
+    const bool wide = (encoding == 1) || (encoding == 2);  // UTF-16
+    size_t i = 1;
+    if (wide) {
+        while (((i + 1) < size) && (string[i] || string[i+1])) {
+            i += 2;
+        }
+    } else {
+        while ((i < size) && string[i]) {
+            i++;
+        }
+    }
+
+    const size_t desc_len = i - 1;
+    const size_t value_start = i + (wide ? 2 : 1);
+    if ((desc_len == 0) || (value_start >= size)) {
+        return;  // no description or no value.
+    }
+
+    // id3v2_decode_string wants the encoding byte first, so build a buffer for each piece.
+    const size_t value_len = size - value_start;
+    Uint8 *buffer = (Uint8 *) SDL_malloc(SDL_max(desc_len, value_len) + 3);
+    if (!buffer) {
+        return;  // Out of memory
+    }
+
+    buffer[0] = encoding;
+    SDL_memcpy(buffer + 1, string + 1, desc_len);
+    buffer[desc_len + 1] = buffer[desc_len + 2] = '\0';
+    char *desc = id3v2_decode_string(buffer, desc_len + (wide ? 1 : 2));
+
+    SDL_memcpy(buffer + 1, string + value_start, value_len);
+    buffer[value_len + 1] = buffer[value_len + 2] = '\0';
+    char *value = id3v2_decode_string(buffer, value_len + (wide ? 1 : 2));
+
+    char *generic_key = NULL;
+    const char *basekey = "SDL_mixer.metadata.id3v2.TXXX.";
+    if (desc && value && (SDL_asprintf(&generic_key, "%s%s", basekey, desc) > 0)) {
+        for (char *ptr = generic_key + SDL_strlen(basekey); *ptr; ptr++) {
+            *ptr = SDL_tolower(*ptr);
+        }
+        SDL_SetStringProperty(props, generic_key, value);
+        SDL_free(generic_key);
+    }
+
+    SDL_free(desc);
+    SDL_free(value);
+    SDL_free(buffer);
+}
+
 // Identify a meta-key and decode the string (Note: input buffer should have at least 4 characters!)
 static void handle_id3v2_string(SDL_PropertiesID props, const char *key, const Uint8 *string, size_t size)
 {
     // put most text things in props in a generic "this is what the id3v2 key was" so apps can handle things we didn't pick out
     //  specifically, or new tags in the hypothetical future.
-    if (SDL_memcmp(key+1, "XXX", 3) != 0) {   // !!! FIXME: we (currently) skip ?XXX because they aren't simple key/value pairs.
+    if (SDL_memcmp(key+1, "XXX", 3) != 0) {   // ?XXX frames aren't simple key/value pairs. We handle TXXX below; !!! FIXME: we (currently) skip WXXX.
         char generic_key[64];
         SDL_snprintf(generic_key, sizeof (generic_key), "SDL_mixer.metadata.id3v2.%c%c%c%c", key[0], key[1], key[2], key[3]);
         if (key[0] == 'T') {  // all text keys start with 'T'
@@ -303,12 +360,9 @@ static void handle_id3v2_string(SDL_PropertiesID props, const char *key, const U
                 SDL_free(decoded);
             }
         }
+    } else if (SDL_memcmp(key, "TXXX", 4) == 0) {
+        handle_id3v2_txxx(props, string, size);
     }
-
-// TODO: Extract "Copyright message" from TXXX value: a KEY=VALUE string divided by a zero byte:*/
-//  else if (SDL_memcmp(key, "TXXX", 4) == 0) {
-//      set_id3v2_string_prop(props, MIX_META_COPYRIGHT, string, size);
-//  }
 }
 
 // Identify a meta-key and decode the string (Note: input buffer should have at least 4 characters!)
@@ -1199,6 +1253,56 @@ bool MIX_ReadMetadataTags(SDL_IOStream *io, SDL_PropertiesID props, MIX_IoClamp
     return true;
 }
 
+static bool ParseLoudnessTag(SDL_PropertiesID props, const char *key, double *value)
+{
+    const char *str = SDL_GetStringProperty(props, key, NULL);
+    if (str) {
+        char *endp = NULL;
+        *value = SDL_strtod(str, &endp);
+        if (endp != str) {  // ReplayGain values usually have a " dB" suffix, so don't insist on the whole string being a number.
+            return true;
+        }
+    }
+    return false;
+}
+
+bool MIX_ResolveLoudnessTags(SDL_PropertiesID props)
+{
+    // ReplayGain 2.0 gains are relative to -18 LUFS, R128 gains (Opus, etc) are Q7.8 fixed point relative to -23 LUFS.
+    // Favor R128, then Ogg comments, then APE, then ID3v2.
+    static const char * const replaygain_keys[] = { "SDL_mixer.metadata.ogg.replaygain_track_gain", "SDL_mixer.metadata.ape.replaygain_track_gain", "SDL_mixer.metadata.id3v2.TXXX.replaygain_track_gain" };
+    static const char * const peak_keys[] = { "SDL_mixer.metadata.ogg.replaygain_track_peak", "SDL_mixer.metadata.ape.replaygain_track_peak", "SDL_mixer.metadata.id3v2.TXXX.replaygain_track_peak" };
+
+    if (!SDL_HasProperty(props, MIX_PROP_METADATA_LOUDNESS_TRUE_PEAK_FLOAT)) {
+        for (size_t i = 0; i < SDL_arraysize(peak_keys); i++) {
+            double peak;
+            if (ParseLoudnessTag(props, peak_keys[i], &peak) && (peak > 0.0)) {
+                SDL_SetFloatProperty(props, MIX_PROP_METADATA_LOUDNESS_TRUE_PEAK_FLOAT, (float) (20.0 * SDL_log10(peak)));  // this is a sample peak, but it's the best we have.
+                break;
+            }
+        }
+    }
+
+    if (SDL_HasProperty(props, MIX_PROP_METADATA_LOUDNESS_INTEGRATED_FLOAT)) {
+        return true;
+    }
+
+    double gain;
+    if (ParseLoudnessTag(props, "SDL_mixer.metadata.ogg.r128_track_gain", &gain)) {
+        SDL_SetFloatProperty(props, MIX_PROP_METADATA_LOUDNESS_INTEGRATED_FLOAT, (float) (-23.0 - (gain / 256.0)));
+        return true;
+    }
+
+    for (size_t i = 0; i < SDL_arraysize(replaygain_keys); i++) {
+        if (ParseLoudnessTag(props, replaygain_keys[i], &gain)) {
+            SDL_SetFloatProperty(props, MIX_PROP_METADATA_LOUDNESS_INTEGRATED_FLOAT, (float) (-18.0 - gain));
+            return true;
+        }
+    }
+
+    return false;
+}
+
 
 static bool IsOggLoopTag(const char *tag)
 {
@@ -0,0 +1,150 @@
+/*
+  SDL_mixer:  An audio mixer library based on the SDL library
+  Copyright (C) 1997-2025 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "SDL_mixer_internal.h"
+
+// Scan the Ogg pages in `io` to build a table of where each `interval` frames (roughly) starts in the file.
+//  This only indexes the first logical stream; if it's chained, seeks past the first link go the slow way.
+static MIX_OggSeekIndex *CreateOggSeekIndex(SDL_IOStream *io, Uint64 interval)
+{
+    const Sint64 origpos = SDL_TellIO(io);
+    if ((origpos < 0) || (SDL_SeekIO(io, 0, SDL_IO_SEEK_SET) < 0)) {
+        return NULL;
+    }
+
+    MIX_OggSeekIndex *index = (MIX_OggSeekIndex *) SDL_calloc(1, sizeof (*index));
+    if (!index) {
+        SDL_SeekIO(io, origpos, SDL_IO_SEEK_SET);
+        return NULL;
+    }
+
+    bool okay = true;
+    bool have_serial = false;
+    Uint32 serial = 0;
+    Uint64 next_granule = 0;
+    int allocated = 0;
+    Sint64 offset = 0;
+    Uint8 header[27];
+    Uint8 lacing[255];
+
+    while (okay && (SDL_ReadIO(io, header, sizeof (header)) == sizeof (header))) {
+        if ((SDL_memcmp(header, "OggS", 4) != 0) || (SDL_ReadIO(io, lacing, header[26]) != header[26])) {
+            break;  // not a page (or truncated), so stop here. Seeks past this point will just do it the slow way.
+        }
+
+        Sint64 page_len = (Sint64) (sizeof (header) + header[26]);
+        for (int i = 0; i < header[26]; i++) {
+            page_len += lacing[i];
+        }
+
+        Uint32 page_serial;
+        SDL_memcpy(&page_serial, &header[14], sizeof (page_serial));
+        page_serial = SDL_Swap32LE(page_serial);
+        if (!have_serial) {
+            serial = page_serial;
+            have_serial = true;
+        } else if (page_serial != serial) {
+            break;  // chained stream (or multiplexed, which we don't play anyhow).
+        }
+
+        // a granule position of -1 means no packet finishes on this page, so it's no use for seeking.
+        Uint64 granule;
+        SDL_memcpy(&granule, &header[6], sizeof (granule));
+        granule = SDL_Swap64LE(granule);
+        if ((granule != ~((Uint64) 0)) && (granule >= next_granule)) {
+            if (index->num_points >= allocated) {
+                const int newlen = allocated ? (allocated * 2) : 256;
+                void *ptr = SDL_realloc(index->points, newlen * sizeof (*index->points));
+                if (!ptr) {
+                    okay = false;
+                    break;
+                }
+                index->points = (MIX_OggSeekPoint *) ptr;
+                allocated = newlen;
+            }
+            MIX_OggSeekPoint *point = &index->points[index->num_points++];
+            point->offset = offset;
+            point->page_end = offset + page_len;
+            point->granule = granule;
+            next_granule = granule + interval;
+        }
+
+        offset += page_len;
+        if (SDL_SeekIO(io, offset, SDL_IO_SEEK_SET) < 0) {
+            break;
+        }
+    }
+
+    if (SDL_SeekIO(io, origpos, SDL_IO_SEEK_SET) < 0) {  // put this back where the decoder expects it.
+        okay = false;
+    }
+
+    if (!okay || (index->num_points == 0)) {
+        MIX_DestroyOggSeekIndex(index);
+        return NULL;
+    }
+
+    return index;
+}
+
+bool MIX_BuildOggSeekIndex(void **shared_index, SDL_IOStream *io, Uint64 interval)
+{
+    if (SDL_GetAtomicPointer(shared_index)) {
+        return true;
+    } else if (!interval) {
+        return false;
+    }
+
+    MIX_OggSeekIndex *index = CreateOggSeekIndex(io, interval);
+    if (!index) {
+        return false;  // we'll just seek without it.
+    }
+
+    if (!SDL_CompareAndSwapAtomicPointer(shared_index, NULL, index)) {  // someone beat us to it? Use theirs.
+        MIX_DestroyOggSeekIndex(index);
+    }
+
+    return true;
+}
+
+int MIX_FindOggSeekPoint(const MIX_OggSeekIndex *index, Uint64 granule)
+{
+    // binary search for the last page that finishes before `granule`.
+    int lo = 0;
+    int hi = index->num_points;
+    while (lo < hi) {
+        const int mid = lo + ((hi - lo) / 2);
+        if (index->points[mid].granule < granule) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo - 1;
+}
+
+void MIX_DestroyOggSeekIndex(MIX_OggSeekIndex *index)
+{
+    if (index) {
+        SDL_free(index->points);
+        SDL_free(index);
+    }
+}
@@ -0,0 +1,509 @@
+/*
+  SDL_mixer:  An audio mixer library based on the SDL library
+  Copyright (C) 1997-2025 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "SDL_mixer_internal.h"
+
+// Our own resampler, for tracks that asked for a specific quality with MIX_SetTrackResampler or
+// MIX_SetGroupResampler. Otherwise, tracks let SDL_AudioStream resample for them.
+//
+// Every quality level is the same thing underneath: each output frame is a weighted sum of `taps`
+// input frames around the current position. Only the weights change:
+//
+// - nearest: one weight is 1.0, the other 0.0.
+// - linear: two weights, by distance.
+// - cubic: four weights, Catmull-Rom spline.
+// - sinc: `taps` weights from a table of windowed-sinc values (Blackman window), interpolated between
+//   MIX_RESAMPLER_SINC_PHASES precomputed phases. When downsampling, the sinc is stretched to cut off
+//   below the new Nyquist frequency, so it doesn't alias.
+//
+// The cutoff depends on the step, which moves with the track's frequency ratio and Doppler shift, so
+// there's a table for each of MIX_RESAMPLER_SINC_BANDS cutoffs, half an octave apart, all built when the
+// resampler is created (never on the audio thread). Each output frame blends the two tables on either
+// side of min(1, 1/step), so the cutoff follows the step smoothly.
+//
+// Input frames are stored padded out to 4 or 8 floats, so the SIMD versions can put every channel of a
+// frame in its own lane and process all channels at once, with aligned loads.
+
+#define MIX_RESAMPLER_SINC_PHASES 128
+#define MIX_RESAMPLER_SINC_BANDS 8
+#define MIX_RESAMPLER_SINC_TABLE_SIZE(taps) ((MIX_RESAMPLER_SINC_PHASES + 1) * (taps))
+
+static int GetResamplerTaps(MIX_ResamplerQuality quality, int sinc_taps)
+{
+    switch (quality) {
+        case MIX_RESAMPLER_NEAREST: return 2;
+        case MIX_RESAMPLER_LINEAR: return 2;
+        case MIX_RESAMPLER_CUBIC: return 4;
+        case MIX_RESAMPLER_SINC: return sinc_taps;
+        default: break;
+    }
+    return 0;
+}
+
+// fill in the table for one cutoff band. Band zero is for upsampling (and anything else that doesn't need
+// to lower the cutoff), each band after that cuts off half an octave lower.
+static void BuildSincTable(MIX_Resampler *resampler, int band)
+{
+    const double pi = 3.14159265358979323846;
+    const int taps = resampler->taps;
+    const int left = resampler->left;
+    const double half_width = (double) (taps / 2);
+    const double cutoff = 0.97 * SDL_pow(2.0, -0.5 * (double) band);  // with a little room for the transition band.
+
+    for (int phase = 0; phase <= MIX_RESAMPLER_SINC_PHASES; phase++) {
+        const double frac = ((double) phase) / ((double) MIX_RESAMPLER_SINC_PHASES);
+        float *row = &resampler->table[(band * MIX_RESAMPLER_SINC_TABLE_SIZE(taps)) + (phase * taps)];
+        double sum = 0.0;
+        for (int i = 0; i < taps; i++) {
+            const double distance = ((double) (i - left)) - frac;
+            const double x = pi * cutoff * distance;
+            const double sinc = (x == 0.0) ? 1.0 : (SDL_sin(x) / x);
+            const double w = SDL_clamp((distance + half_width) / (2.0 * half_width), 0.0, 1.0);
+            const double window = 0.42 - 0.5 * SDL_cos(2.0 * pi * w) + 0.08 * SDL_cos(4.0 * pi * w);
+            const double value = sinc * window;
+            row[i] = (float) value;
+            sum += value;
+        }
+
+        // normalize, so each phase has unity gain at DC.
+        if (sum != 0.0) {
+            for (int i = 0; i < taps; i++) {
+                row[i] = (float) (row[i] / sum);
+            }
+        }
+    }
+}
+
+MIX_Resampler *MIX_CreateResampler(MIX_ResamplerQuality quality, int sinc_taps)
+{
+    const int taps = GetResamplerTaps(quality, sinc_taps);
+    SDL_assert((taps >= 2) && (taps <= MIX_RESAMPLER_MAX_TAPS) && ((taps % 2) == 0));
+
+    MIX_Resampler *resampler = (MIX_Resampler *) SDL_calloc(1, sizeof (*resampler));
+    if (!resampler) {
+        return NULL;
+    }
+
+    resampler->quality = quality;
+    resampler->taps = taps;
+    resampler->left = (taps / 2) - 1;
+
+    if (quality == MIX_RESAMPLER_SINC) {
+        resampler->table = (float *) SDL_malloc(MIX_RESAMPLER_SINC_BANDS * MIX_RESAMPLER_SINC_TABLE_SIZE(taps) * sizeof (float));
+        if (!resampler->table) {
+            SDL_free(resampler);
+            return NULL;
+        }
+        for (int band = 0; band < MIX_RESAMPLER_SINC_BANDS; band++) {
+            BuildSincTable(resampler, band);
+        }
+    }
+
+    return resampler;
+}
+
+void MIX_DestroyResampler(MIX_Resampler *resampler)
+{
+    if (resampler) {
+        SDL_free(resampler->table);
+        SDL_aligned_free(resampler->frames);
+        SDL_free(resampler->output);
+        SDL_free(resampler);
+    }
+}
+
+void MIX_ResetResampler(MIX_Resampler *resampler)
+{
+    // start with `left` frames of silence, so the first output frame lands exactly on the first input frame.
+    if (resampler->frames) {
+        SDL_memset(resampler->frames, '\0', resampler->frames_allocated * resampler->stride * sizeof (float));
+    }
+    resampler->frames_available = resampler->left;
+    resampler->position = (double) resampler->left;
+    resampler->step = 0.0;
+    resampler->glide_frames = 0;
+}
+
+void MIX_SetResamplerGlide(MIX_Resampler *resampler, int frames)
+{
+    resampler->glide_frames = SDL_max(frames, 0);
+}
+
+bool MIX_SetResamplerFormat(MIX_Resampler *resampler, int channels, int src_freq, int dst_freq)
+{
+    SDL_assert((channels > 0) && (channels <= 8));
+    SDL_assert((src_freq > 0) && (dst_freq > 0));
+
+    if ((resampler->channels == channels) && (resampler->src_freq == src_freq) && (resampler->dst_freq == dst_freq)) {
+        return true;  // nothing to do.
+    }
+
+    const int stride = (channels <= 4) ? 4 : 8;
+    if (stride != resampler->stride) {
+        SDL_aligned_free(resampler->frames);
+        resampler->frames = NULL;
+        resampler->frames_allocated = 0;
+    }
+
+    resampler->channels = channels;
+    resampler->stride = stride;
+    resampler->src_freq = src_freq;
+    resampler->dst_freq = dst_freq;
+
+    MIX_ResetResampler(resampler);
+    return true;
+}
+
+static bool EnsureResamplerFrames(MIX_Resampler *resampler, int needed)
+{
+    if (needed <= resampler->frames_allocated) {
+        return true;
+    }
+
+    const int allocated = SDL_max(needed, resampler->frames_allocated * 2);
+    const size_t framesize = resampler->stride * sizeof (float);
+    float *ptr = (float *) SDL_aligned_alloc(SDL_GetSIMDAlignment(), allocated * framesize);
+    if (!ptr) {
+        return false;
+    }
+
+    // the padding lanes have to be zero (well, finite), since the SIMD code multiplies them too.
+    SDL_memset(ptr, '\0', allocated * framesize);
+    if (resampler->frames) {
+        SDL_memcpy(ptr, resampler->frames, resampler->frames_available * framesize);
+        SDL_aligned_free(resampler->frames);
+    }
+    resampler->frames = ptr;
+    resampler->frames_allocated = allocated;
+    return true;
+}
+
+// `sinc` and `sinc_next` are the tables for the cutoff bands on either side of the one we want, `blend` is how far between them.
+static void CalculateResamplerWeights(const MIX_Resampler *resampler, float frac, const float *sinc, const float *sinc_next, float blend, float *weights)
+{
+    switch (resampler->quality) {
+        case MIX_RESAMPLER_NEAREST:
+            weights[0] = (frac < 0.5f) ? 1.0f : 0.0f;
+            weights[1] = 1.0f - weights[0];
+            break;
+
+        case MIX_RESAMPLER_LINEAR:
+            weights[0] = 1.0f - frac;
+            weights[1] = frac;
+            break;
+
+        case MIX_RESAMPLER_CUBIC: {
+            const float t = frac;
+            const float t2 = t * t;
+            const float t3 = t2 * t;
+            weights[0] = 0.5f * (-t3 + 2.0f * t2 - t);
+            weights[1] = 0.5f * (3.0f * t3 - 5.0f * t2 + 2.0f);
+            weights[2] = 0.5f * (-3.0f * t3 + 4.0f * t2 + t);
+            weights[3] = 0.5f * (t3 - t2);
+            break;
+        }
+
+        case MIX_RESAMPLER_SINC: {
+            const int taps = resampler->taps;
+            const float phase = frac * MIX_RESAMPLER_SINC_PHASES;
+            const int row = SDL_min((int) phase, MIX_RESAMPLER_SINC_PHASES - 1);
+            const float t = phase - (float) row;
+            const float *a = &sinc[row * taps];
+            const float *b = a + taps;
+            for (int i = 0; i < taps; i++) {
+                weights[i] = a[i] + ((b[i] - a[i]) * t);
+            }
+            if (blend > 0.0f) {
+                a = &sinc_next[row * taps];
+                b = a + taps;
+                for (int i = 0; i < taps; i++) {
+                    const float w = a[i] + ((b[i] - a[i]) * t);
+                    weights[i] += (w - weights[i]) * blend;
+                }
+            }
+            break;
+        }
+
+        default:
+            SDL_assert(!"Unexpected resampler quality");
+            break;
+    }
+}
+
+#if SDL_MIXER_NEED_SCALAR_FALLBACK
+static void ResampleFrame_scalar(const MIX_Resampler *resampler, const float *src, const float *weights, float *dst)
+{
+    const int channels = resampler->channels;
+    const int stride = resampler->stride;
+    const int taps = resampler->taps;
+    for (int channel = 0; channel < channels; channel++) {
+        const float *ptr = src + channel;
+        float sum = 0.0f;
+        for (int i = 0; i < taps; i++, ptr += stride) {
+            sum += *ptr * weights[i];
+        }
+        dst[channel] = sum;
+    }
+}
+#endif
+
+#if defined(SDL_SSE_INTRINSICS)
+static void SDL_TARGETING("sse") ResampleFrame_sse(const MIX_Resampler *resampler, const float *src, const float *weights, float *dst)
+{
+    const int channels = resampler->channels;
+    const int stride = resampler->stride;
+    const int taps = resampler->taps;
+    __m128 lo = _mm_setzero_ps();
+    __m128 hi = _mm_setzero_ps();
+
+    if (stride == 4) {
+        for (int i = 0; i < taps; i++, src += 4) {
+            lo = _mm_add_ps(lo, _mm_mul_ps(_mm_load_ps(src), _mm_set1_ps(weights[i])));
+        }
+        MIX_StorePartial_sse(dst, lo, channels);
+    } else {
+        for (int i = 0; i < taps; i++, src += 8) {
+            const __m128 w = _mm_set1_ps(weights[i]);
+            lo = _mm_add_ps(lo, _mm_mul_ps(_mm_load_ps(src), w));
+            hi = _mm_add_ps(hi, _mm_mul_ps(_mm_load_ps(src + 4), w));
+        }
+        _mm_storeu_ps(dst, lo);
+        MIX_StorePartial_sse(dst + 4, hi, channels - 4);
+    }
+}
+#endif
+
+#if defined(SDL_NEON_INTRINSICS)
+static void ResampleFrame_neon(const MIX_Resampler *resampler, const float *src, const float *weights, float *dst)
+{
+    const int channels = resampler->channels;
+    const int stride = resampler->stride;
+    const int taps = resampler->taps;
+    float32x4_t lo = vdupq_n_f32(0.0f);
+    float32x4_t hi = vdupq_n_f32(0.0f);
+    float SDL_ALIGNED(16) frame[8];
+
+    // !!! FIXME: partial stores instead of going through `frame`.
+    if (stride == 4) {
+        for (int i = 0; i < taps; i++, src += 4) {
+            lo = vmlaq_n_f32(lo, vld1q_f32(src), weights[i]);
+        }
+        vst1q_f32(frame, lo);
+    } else {
+        for (int i = 0; i < taps; i++, src += 8) {
+            lo = vmlaq_n_f32(lo, vld1q_f32(src), weights[i]);
+            hi = vmlaq_n_f32(hi, vld1q_f32(src + 4), weights[i]);
+        }
+        vst1q_f32(frame, lo);
+        vst1q_f32(frame + 4, hi);
+    }
+    SDL_memcpy(dst, frame, channels * sizeof (float));
+}
+#endif
+
+static void ResampleFrame(const MIX_Resampler *resampler, const float *src, const float *weights, float *dst)
+{
+    #if defined(SDL_SSE_INTRINSICS)
+    if (MIX_HasSSE) {
+        ResampleFrame_sse(resampler, src, weights, dst);
+        return;
+    }
+    #elif defined(SDL_NEON_INTRINSICS)
+    if (MIX_HasNEON) {
+        ResampleFrame_neon(resampler, src, weights, dst);
+        return;
+    }
+    #endif
+
+    #if SDL_MIXER_NEED_SCALAR_FALLBACK
+    ResampleFrame_scalar(resampler, src, weights, dst);
+    #endif
+}
+
+int MIX_Resample(MIX_Resampler *resampler, const float *input, int input_frames, double step, const float **output)
+{
+    const int channels = resampler->channels;
+    const int stride = resampler->stride;
+    const int taps = resampler->taps;
+    const int left = resampler->left;
+
+    SDL_assert(channels > 0);  // MIX_SetResamplerFormat must be called first!
+    SDL_assert(step > 0.0);
+
+    if (!EnsureResamplerFrames(resampler, resampler->frames_available + input_frames)) {
+        return -1;
+    }
+
+    float *dst = resampler->frames + (resampler->frames_available * stride);
+    if (!input) {
+        SDL_memset(dst, '\0', input_frames * stride * sizeof (float));
+    } else if (channels == stride) {
+        SDL_memcpy(dst, input, input_frames * stride * sizeof (float));
+    } else {
+        for (int i = 0; i < input_frames; i++, dst += stride, input += channels) {
+            SDL_memcpy(dst, input, channels * sizeof (float));
+        }
+    }
+    resampler->frames_available += input_frames;
+
+    // if we're gliding to a new step, move a little closer to it every output frame, so the pitch doesn't jump.
+    double current = step;
+    double delta = 0.0;
+    int glide = 0;
+    if ((resampler->step > 0.0) && (resampler->step != step) && (resampler->glide_frames > 0)) {
+        current = resampler->step;
+        glide = resampler->glide_frames;
+        delta = (step - current) / ((double) glide);
+    }
+
+    // make sure there's room for everything we could possibly generate from what we have.
+    const int max_output = (int) (((double) resampler->frames_available - resampler->position) / SDL_min(current, step)) + 2;
+    if (max_output > resampler->output_allocated) {
+        float *ptr = (float *) SDL_realloc(resampler->output, max_output * channels * sizeof (float));
+        if (!ptr) {
+            return -1;
+        }
+        resampler->output = ptr;
+        resampler->output_allocated = max_output;
+    }
+
+    // pick the sinc cutoff for the widest step we'll use in this call: min(1, 1/step), in half-octave bands.
+    const float *sinc = resampler->table;
+    const float *sinc_next = resampler->table;
+    float blend = 0.0f;
+    if (resampler->table) {
+        const double widest = SDL_max(current, step);
+        if (widest > 1.0) {
+            const double band_position = SDL_min(2.0 * SDL_log(widest) / SDL_log(2.0), (double) (MIX_RESAMPLER_SINC_BANDS - 1));
+            const int band = (int) band_position;
+            sinc = resampler->table + (band * MIX_RESAMPLER_SINC_TABLE_SIZE(taps));
+            sinc_next = (band < (MIX_RESAMPLER_SINC_BANDS - 1)) ? (sinc + MIX_RESAMPLER_SINC_TABLE_SIZE(taps)) : sinc;
+            blend = (float) (band_position - (double) band);
+        }
+    }
+
+    float SDL_ALIGNED(16) weights[MIX_RESAMPLER_MAX_TAPS];
+    float *out = resampler->output;
+    double position = resampler->position;
+    int output_frames = 0;
+    while (output_frames < max_output) {
+        const int index = (int) position;
+        if ((index - left + taps) > resampler->frames_available) {
+            break;  // need more input before we can generate this frame.
+        }
+        CalculateResamplerWeights(resampler, (float) (position - (double) index), sinc, sinc_next, blend, weights);
+        ResampleFrame(resampler, resampler->frames + ((index - left) * stride), weights, out);
+        out += channels;
+        output_frames++;
+        position += current;
+        if (glide > 0) {
+            current = (--glide > 0) ? (current + delta) : step;
+        }
+    }
+
+    resampler->step = current;
+    if (delta != 0.0) {
+        resampler->glide_frames = glide;
+    }
+
+    // drop input frames we won't need again.
+    const int drop = SDL_clamp(((int) position) - left, 0, resampler->frames_available);
+    if (drop > 0) {
+        resampler->frames_available -= drop;
+        SDL_memmove(resampler->frames, resampler->frames + (drop * stride), resampler->frames_available * stride * sizeof (float));
+        position -= (double) drop;
+    }
+    resampler->position = position;
+
+    *output = resampler->output;
+    return output_frames;
+}
+
+bool MIX_TransferResamplerHistory(MIX_Resampler *to, const MIX_Resampler *from)
+{
+    if (from->channels == 0) {
+        return true;  // never used, nothing to carry over.
+    }
+
+    SDL_assert(to->frames == NULL);  // must be a new resampler.
+    to->channels = from->channels;
+    to->stride = from->stride;
+    to->src_freq = from->src_freq;
+    to->dst_freq = from->dst_freq;
+
+    // line up the current position, giving the new kernel silence if it reaches back further than the old one kept.
+    const int index = (int) from->position;
+    const int padding = SDL_max(to->left - index, 0);
+    const int skip = SDL_clamp(index - to->left, 0, from->frames_available);
+    const int available = from->frames_available - skip;
+    if (!EnsureResamplerFrames(to, padding + available)) {
+        return false;
+    }
+
+    const int stride = to->stride;
+    SDL_memset(to->frames, '\0', padding * stride * sizeof (float));
+    if (from->frames) {  // if NULL, it was just reset and is only holding (implied) silence, which EnsureResamplerFrames gave us already.
+        SDL_memcpy(to->frames + (padding * stride), from->frames + (skip * stride), available * stride * sizeof (float));
+    }
+    to->frames_available = padding + available;
+    to->position = (from->position - (double) skip) + (double) padding;
+    to->step = from->step;
+    to->glide_frames = from->glide_frames;
+    return true;
+}
+
+int MIX_GetResamplerInput(MIX_Resampler *resampler, const float **input)
+{
+    const int channels = resampler->channels;
+    const int stride = resampler->stride;
+    const int index = SDL_min((int) resampler->position, resampler->frames_available);
+    const int frames = resampler->frames_available - index;
+
+    *input = NULL;
+    if ((frames <= 0) || !resampler->frames) {
+        return 0;
+    }
+
+    if (frames > resampler->output_allocated) {
+        float *ptr = (float *) SDL_realloc(resampler->output, frames * channels * sizeof (float));
+        if (!ptr) {
+            return -1;
+        }
+        resampler->output = ptr;
+        resampler->output_allocated = frames;
+    }
+
+    const float *src = resampler->frames + (index * stride);
+    float *dst = resampler->output;
+    for (int i = 0; i < frames; i++, src += stride, dst += channels) {
+        SDL_memcpy(dst, src, channels * sizeof (float));
+    }
+
+    *input = resampler->output;
+    return frames;
+}
+
+int MIX_FlushResampler(MIX_Resampler *resampler, double step, const float **output)
+{
+    // push enough silence through to get the kernel past the last real input frame.
+    return MIX_Resample(resampler, NULL, resampler->taps - 1 - resampler->left, step, output);
+}
+
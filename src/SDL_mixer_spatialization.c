@@ -467,3 +467,404 @@ void MIX_Spatialize(const MIX_VBAP2D *vbap2d, const float *position, float *pann
     }
 }
 
+
+// This is the OpenAL 1.1 Doppler model (section 3.5.2 of the spec), with a
+//  Doppler factor of 1.0. The speed of sound defaults to 343.3 units per
+//  second (so a unit is a meter in dry air at 20 degrees Celsius, the AL
+//  default), but the app can change it with MIX_PROP_MIXER_SPEED_OF_SOUND_FLOAT.
+//
+// The listener is always at the origin, so the vector from the source to
+//  the listener is just the source's position, negated. Velocities along
+//  that vector are moving toward the listener.
+float MIX_CalculateDopplerRatio(const float *position, const float *velocity, const float *listener_velocity, float speed_of_sound)
+{
+    const float distance = SDL_sqrtf((position[0] * position[0]) + (position[1] * position[1]) + (position[2] * position[2]));
+    if (distance == 0.0f) {
+        return 1.0f;  // no direction, no shift.
+    }
+
+    // project each velocity onto the source-to-listener vector.
+    float vls = -((listener_velocity[0] * position[0]) + (listener_velocity[1] * position[1]) + (listener_velocity[2] * position[2])) / distance;
+    float vss = -((velocity[0] * position[0]) + (velocity[1] * position[1]) + (velocity[2] * position[2])) / distance;
+
+    // the spec clamps these so nothing goes supersonic (which would make the math go negative or divide by zero).
+    vls = SDL_min(vls, speed_of_sound * 0.99f);
+    vss = SDL_min(vss, speed_of_sound * 0.99f);
+
+    const float ratio = (speed_of_sound - vls) / (speed_of_sound - vss);
+
+    return SDL_clamp(ratio, MIX_DOPPLER_MIN_RATIO, MIX_DOPPLER_MAX_RATIO);
+}
+
+// Ambisonics! Optionally, 3D tracks are encoded into an Ambisonic sound field (ACN channel
+//  order, SN3D normalization, up to third order), which is mixed per group, and then decoded
+//  once to whatever speakers we have. Sources that move between speakers don't jump from one
+//  VBAP speaker pair to another this way, and the decode is paid once per group instead of
+//  once per track.
+//
+// Ambisonics uses a different coordinate system than OpenAL: +X is forward, +Y is to the left,
+//  +Z is up. Our listener faces -Z with +Y up, so we just shuffle things around.
+//
+// https://en.wikipedia.org/wiki/Ambisonic_data_exchange_formats has the formulas for the
+//  spherical harmonics, as written in Cartesian coordinates, in the SN3D table.
+
+void MIX_AmbisonicEncode(const float *position, float *gains)
+{
+    SDL_assert( (((size_t) position) % 16) == 0 );  // must be aligned for SIMD access.
+    SDL_assert( (((size_t) gains) % 16) == 0 );  // must be aligned for SIMD access.
+
+    SDL_memset(gains, '\0', sizeof (float) * MIX_AMBISONIC_MAX_CHANNELS);
+
+    const float distance = SDL_sqrtf((position[0] * position[0]) + (position[1] * position[1]) + (position[2] * position[2]));
+    const float gain = calculate_distance_attenuation(distance);
+
+    gains[0] = gain;   // W is omnidirectional.
+
+    if (distance == 0.0f) {
+        return;  // sound is on top of the listener, it has no direction, so it's just W.
+    }
+
+    // convert to the Ambisonic coordinate system, as a unit vector.
+    const float x = -position[2] / distance;
+    const float y = -position[0] / distance;
+    const float z = position[1] / distance;
+    const float x2 = x * x;
+    const float y2 = y * y;
+    const float z2 = z * z;
+
+    #define SQRT3 1.7320508076f
+    #define SQRT15 3.8729833462f
+    #define SQRT3_DIV8 0.6123724357f  // sqrt(3.0 / 8.0)
+    #define SQRT5_DIV8 0.7905694150f  // sqrt(5.0 / 8.0)
+
+    // first order.
+    gains[1] = gain * y;
+    gains[2] = gain * z;
+    gains[3] = gain * x;
+
+    // second order.
+    gains[4] = gain * (SQRT3 * x * y);
+    gains[5] = gain * (SQRT3 * y * z);
+    gains[6] = gain * (0.5f * ((3.0f * z2) - 1.0f));
+    gains[7] = gain * (SQRT3 * x * z);
+    gains[8] = gain * ((SQRT3 / 2.0f) * (x2 - y2));
+
+    // third order.
+    gains[9] = gain * (SQRT5_DIV8 * y * ((3.0f * x2) - y2));
+    gains[10] = gain * (SQRT15 * x * y * z);
+    gains[11] = gain * (SQRT3_DIV8 * y * ((5.0f * z2) - 1.0f));
+    gains[12] = gain * (0.5f * z * ((5.0f * z2) - 3.0f));
+    gains[13] = gain * (SQRT3_DIV8 * x * ((5.0f * z2) - 1.0f));
+    gains[14] = gain * ((SQRT15 / 2.0f) * z * (x2 - y2));
+    gains[15] = gain * (SQRT5_DIV8 * x * (x2 - (3.0f * y2)));
+
+    #undef SQRT3
+    #undef SQRT15
+    #undef SQRT3_DIV8
+    #undef SQRT5_DIV8
+}
+
+void MIX_AmbisonicDecoder_Init(MIX_AmbisonicDecoder *decoder, int order, int speaker_count)
+{
+    SDL_assert(order > 0);
+    SDL_assert(order <= MIX_AMBISONIC_MAX_ORDER);
+    SDL_assert(speaker_count > 0);
+    SDL_assert(speaker_count <= MIX_VBAP2D_MAX_SPEAKER_COUNT);
+
+    SDL_zerop(decoder);
+    decoder->order = order;
+    decoder->speaker_count = speaker_count;
+
+    if (speaker_count == 1) {  // mono output only gets the omnidirectional part.
+        decoder->matrix[0][0] = 1.0f;
+        return;
+    } else if (speaker_count < 4) {  // stereo (and 2.1) get a pair of virtual cardioid mics pointed left and right.
+        decoder->matrix[0][0] = decoder->matrix[0][1] = 0.5f;  // W
+        decoder->matrix[1][0] = 0.5f;   // +Y is to the left...
+        decoder->matrix[1][1] = -0.5f;  // ...so it's subtracted on the right.
+        return;
+    }
+
+    // Surround sound. All our speaker layouts are horizontal, so this is a
+    //  "basic" 2D decoder for the circular harmonics (the parts of the sound
+    //  field that vary by azimuth). The other components carry height
+    //  information, which we don't have speakers for, so they get dropped.
+    //
+    // For a speaker at azimuth `phi`, the gain is:
+    //   (1/L) * (W + 2 * sum(m=1..M, w_m * (cos(m*phi) * C_m + sin(m*phi) * S_m) / k_m))
+    //  ...where C_m and S_m are the cos/sin components of order m, k_m is the
+    //  SN3D scale those components have on the horizontal plane, and w_m is a
+    //  "max-rE" weight, which keeps energy from leaking into speakers
+    //  on the opposite side of the sound.
+    static const int acn_cos[MIX_AMBISONIC_MAX_ORDER] = { 3, 8, 15 };
+    static const int acn_sin[MIX_AMBISONIC_MAX_ORDER] = { 1, 4, 9 };
+    static const float k[MIX_AMBISONIC_MAX_ORDER] = { 1.0f, 0.8660254038f, 0.7905694150f };  // 1, sqrt(3)/2, sqrt(5/8)
+
+    const MIX_VBAP2D_SpeakerLayout *speaker_layout = &MIX_VBAP2D_SpeakerLayouts[speaker_count - 4];  // offset to zero, skip mono/stereo/2.1
+    const int num_positions = (speaker_layout->lfe_channel >= 0) ? (speaker_count - 1) : speaker_count;  // the subwoofer isn't in the positions list.
+
+    // you can't resolve more orders than you have pairs of speakers.
+    const int max_order = SDL_min(order, (num_positions - 1) / 2);
+
+    float weights[MIX_AMBISONIC_MAX_ORDER];
+    for (int m = 1; m <= max_order; m++) {
+        weights[m - 1] = SDL_cosf(((float) m) * SDL_PI_F / ((float) ((2 * max_order) + 2)));
+    }
+
+    for (int i = 0; i < num_positions; i++) {
+        const MIX_VBAP2D_SpeakerPosition *pos = &speaker_layout->positions[i];
+        const int channel = pos->sdl_channel;
+        const float phi = MIX_VBAP2D_division_to_angle(pos->division) - (SDL_PI_F / 2.0f);  // VBAP angles are from due east, ambisonics is from straight ahead.
+        decoder->matrix[0][channel] = 1.0f;
+        for (int m = 1; m <= max_order; m++) {
+            float sine, cosine;
+            calculate_sincos(((float) m) * phi, &sine, &cosine);
+            decoder->matrix[acn_cos[m - 1]][channel] = 2.0f * weights[m - 1] * cosine / k[m - 1];
+            decoder->matrix[acn_sin[m - 1]][channel] = 2.0f * weights[m - 1] * sine / k[m - 1];
+        }
+    }
+
+    // Our layouts aren't regular polygons, so rather than work out the
+    //  normalization analytically, decode a sound from a bunch of directions
+    //  and scale things so the average power comes out to unity.
+    #define NUM_PROBES 72
+    float total_power = 0.0f;
+    for (int probe = 0; probe < NUM_PROBES; probe++) {
+        float sine, cosine;
+        const float phi = ((float) probe) * (2.0f * SDL_PI_F) / ((float) NUM_PROBES);
+        for (int i = 0; i < num_positions; i++) {
+            const int channel = speaker_layout->positions[i].sdl_channel;
+            float g = decoder->matrix[0][channel];
+            for (int m = 1; m <= max_order; m++) {
+                calculate_sincos(((float) m) * phi, &sine, &cosine);
+                g += decoder->matrix[acn_cos[m - 1]][channel] * (k[m - 1] * cosine);
+                g += decoder->matrix[acn_sin[m - 1]][channel] * (k[m - 1] * sine);
+            }
+            total_power += g * g;
+        }
+    }
+
+    const float scale = (total_power > 0.0f) ? SDL_sqrtf(((float) NUM_PROBES) / total_power) : 0.0f;
+    #undef NUM_PROBES
+
+    for (int i = 0; i < MIX_AMBISONIC_MAX_CHANNELS; i++) {
+        for (int j = 0; j < MIX_VBAP2D_MAX_SPEAKER_COUNT; j++) {
+            decoder->matrix[i][j] *= scale;
+        }
+    }
+}
+
+// the decoder never uses anything past the circular harmonics of the decoder's order, so don't bother multiplying zeros.
+static int ambisonic_decode_channels(const MIX_AmbisonicDecoder *decoder)
+{
+    if (decoder->speaker_count < 4) {
+        return (decoder->speaker_count == 1) ? 1 : 2;   // just W (or W and Y).
+    }
+    return (decoder->order + 1) * (decoder->order + 1);
+}
+
+#if SDL_MIXER_NEED_SCALAR_FALLBACK
+static void MIX_AmbisonicDecode_scalar(const MIX_AmbisonicDecoder *decoder, float *dst, const float *src, int frames)
+{
+    const int stride = MIX_AMBISONIC_STRIDE(decoder->order);
+    const int ambisonic_channels = ambisonic_decode_channels(decoder);
+    const int speaker_count = decoder->speaker_count;
+
+    for (int i = 0; i < frames; i++, dst += speaker_count, src += stride) {
+        for (int j = 0; j < ambisonic_channels; j++) {
+            const float sample = src[j];
+            const float *row = decoder->matrix[j];
+            for (int k = 0; k < speaker_count; k++) {
+                dst[k] += sample * row[k];
+            }
+        }
+    }
+}
+#endif
+
+#if defined(SDL_SSE_INTRINSICS)
+static void SDL_TARGETING("sse") MIX_AmbisonicDecode_sse(const MIX_AmbisonicDecoder *decoder, float *dst, const float *src, int frames)
+{
+    const int stride = MIX_AMBISONIC_STRIDE(decoder->order);
+    const int ambisonic_channels = ambisonic_decode_channels(decoder);
+    const int speaker_count = decoder->speaker_count;
+    float SDL_ALIGNED(16) accum[MIX_VBAP2D_MAX_SPEAKER_COUNT];
+
+    for (int i = 0; i < frames; i++, dst += speaker_count, src += stride) {
+        __m128 lo = _mm_setzero_ps();
+        __m128 hi = _mm_setzero_ps();
+        for (int j = 0; j < ambisonic_channels; j++) {
+            const __m128 sample = _mm_set1_ps(src[j]);
+            const float *row = decoder->matrix[j];
+            lo = _mm_add_ps(lo, _mm_mul_ps(sample, _mm_load_ps(row)));
+            hi = _mm_add_ps(hi, _mm_mul_ps(sample, _mm_load_ps(row + 4)));
+        }
+        _mm_store_ps(accum, lo);
+        _mm_store_ps(accum + 4, hi);
+        for (int k = 0; k < speaker_count; k++) {
+            dst[k] += accum[k];
+        }
+    }
+}
+#endif
+
+#if defined(SDL_NEON_INTRINSICS)
+static void MIX_AmbisonicDecode_neon(const MIX_AmbisonicDecoder *decoder, float *dst, const float *src, int frames)
+{
+    const int stride = MIX_AMBISONIC_STRIDE(decoder->order);
+    const int ambisonic_channels = ambisonic_decode_channels(decoder);
+    const int speaker_count = decoder->speaker_count;
+    float SDL_ALIGNED(16) accum[MIX_VBAP2D_MAX_SPEAKER_COUNT];
+
+    for (int i = 0; i < frames; i++, dst += speaker_count, src += stride) {
+        float32x4_t lo = vdupq_n_f32(0.0f);
+        float32x4_t hi = vdupq_n_f32(0.0f);
+        for (int j = 0; j < ambisonic_channels; j++) {
+            const float32x4_t sample = vdupq_n_f32(src[j]);
+            const float *row = decoder->matrix[j];
+            lo = vmlaq_f32(lo, sample, vld1q_f32(row));
+            hi = vmlaq_f32(hi, sample, vld1q_f32(row + 4));
+        }
+        vst1q_f32(accum, lo);
+        vst1q_f32(accum + 4, hi);
+        for (int k = 0; k < speaker_count; k++) {
+            dst[k] += accum[k];
+        }
+    }
+}
+#endif
+
+void MIX_AmbisonicDecode(const MIX_AmbisonicDecoder *decoder, float *dst, const float *src, int frames)
+{
+    SDL_assert( (((size_t) decoder->matrix) % 16) == 0 );  // must be aligned for SIMD access.
+
+    #if defined(SDL_SSE_INTRINSICS)
+    if (MIX_HasSSE) {
+        MIX_AmbisonicDecode_sse(decoder, dst, src, frames);
+    } else
+    #elif defined(SDL_NEON_INTRINSICS)
+    if (MIX_HasNEON) {
+        MIX_AmbisonicDecode_neon(decoder, dst, src, frames);
+    } else
+    #endif
+
+    {
+    #if SDL_MIXER_NEED_SCALAR_FALLBACK
+        MIX_AmbisonicDecode_scalar(decoder, dst, src, frames);
+    #endif
+    }
+}
+
+#if SDL_MIXER_NEED_SCALAR_FALLBACK
+static void MIX_AmbisonicEncodeMix_scalar(float *dst, const float *src, int frames, int order, const float *gains, float gain, float *peak, float *sum_squares)
+{
+    const int stride = MIX_AMBISONIC_STRIDE(order);
+    float scaled[MIX_AMBISONIC_MAX_CHANNELS];
+    for (int i = 0; i < stride; i++) {
+        scaled[i] = gains[i] * gain;
+    }
+
+    float max = 0.0f;
+    float sum = 0.0f;
+    for (int i = 0; i < frames; i++, dst += stride) {
+        const float sample = src[i];
+        for (int j = 0; j < stride; j++) {
+            dst[j] += sample * scaled[j];
+        }
+        max = SDL_max(max, SDL_fabsf(sample));
+        sum += sample * sample;
+    }
+    *peak = max;
+    *sum_squares = sum;
+}
+#endif
+
+#if defined(SDL_SSE_INTRINSICS)
+static void SDL_TARGETING("sse") MIX_AmbisonicEncodeMix_sse(float *dst, const float *src, int frames, int order, const float *gains, float gain, float *peak, float *sum_squares)
+{
+    const int stride = MIX_AMBISONIC_STRIDE(order);
+    const __m128 gain_sse = _mm_set1_ps(gain);
+    __m128 scaled[MIX_AMBISONIC_MAX_CHANNELS / 4];
+    for (int i = 0; i < stride; i += 4) {
+        scaled[i / 4] = _mm_mul_ps(_mm_load_ps(gains + i), gain_sse);
+    }
+
+    float max = 0.0f;
+    float sum = 0.0f;
+    for (int i = 0; i < frames; i++, dst += stride) {
+        const float s = src[i];
+        const __m128 sample = _mm_set1_ps(s);
+        for (int j = 0; j < stride; j += 4) {
+            _mm_storeu_ps(dst + j, _mm_add_ps(_mm_loadu_ps(dst + j), _mm_mul_ps(sample, scaled[j / 4])));
+        }
+        max = SDL_max(max, SDL_fabsf(s));
+        sum += s * s;
+    }
+    *peak = max;
+    *sum_squares = sum;
+}
+#endif
+
+#if defined(SDL_NEON_INTRINSICS)
+static void MIX_AmbisonicEncodeMix_neon(float *dst, const float *src, int frames, int order, const float *gains, float gain, float *peak, float *sum_squares)
+{
+    const int stride = MIX_AMBISONIC_STRIDE(order);
+    float32x4_t scaled[MIX_AMBISONIC_MAX_CHANNELS / 4];
+    for (int i = 0; i < stride; i += 4) {
+        scaled[i / 4] = vmulq_n_f32(vld1q_f32(gains + i), gain);
+    }
+
+    float max = 0.0f;
+    float sum = 0.0f;
+    for (int i = 0; i < frames; i++, dst += stride) {
+        const float s = src[i];
+        const float32x4_t sample = vdupq_n_f32(s);
+        for (int j = 0; j < stride; j += 4) {
+            vst1q_f32(dst + j, vmlaq_f32(vld1q_f32(dst + j), sample, scaled[j / 4]));
+        }
+        max = SDL_max(max, SDL_fabsf(s));
+        sum += s * s;
+    }
+    *peak = max;
+    *sum_squares = sum;
+}
+#endif
+
+void MIX_AmbisonicEncodeMix(float *dst, const float *src, int frames, int order, const float *gains, float gain, MIX_MeterAccumulator *meter)
+{
+    SDL_assert( (((size_t) gains) % 16) == 0 );  // must be aligned for SIMD access.
+
+    if (meter) {
+        meter->samples += frames;
+    }
+
+    if (gain == 0.0f) {
+        return;  // don't mix silence.
+    }
+
+    // the track is mono going in, so measuring it costs a couple of scalar ops per frame next to the encoding.
+    float peak = 0.0f;
+    float sum_squares = 0.0f;
+
+    #if defined(SDL_SSE_INTRINSICS)
+    if (MIX_HasSSE) {
+        MIX_AmbisonicEncodeMix_sse(dst, src, frames, order, gains, gain, &peak, &sum_squares);
+    } else
+    #elif defined(SDL_NEON_INTRINSICS)
+    if (MIX_HasNEON) {
+        MIX_AmbisonicEncodeMix_neon(dst, src, frames, order, gains, gain, &peak, &sum_squares);
+    } else
+    #endif
+
+    {
+    #if SDL_MIXER_NEED_SCALAR_FALLBACK
+        MIX_AmbisonicEncodeMix_scalar(dst, src, frames, order, gains, gain, &peak, &sum_squares);
+    #endif
+    }
+
+    if (meter) {
+        meter->peak = SDL_max(meter->peak, peak * SDL_fabsf(gain));
+        meter->sum_squares += sum_squares * gain * gain;
+    }
+}
+
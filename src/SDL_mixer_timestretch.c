@@ -0,0 +1,450 @@
+/*
+  SDL_mixer:  An audio mixer library based on the SDL library
+  Copyright (C) 1997-2025 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "SDL_mixer_internal.h"
+
+// Time-stretching (changing tempo without changing pitch) for MIX_SetTrackTempo. This is WSOLA
+// (Waveform Similarity Overlap-Add), more or less the same approach as SoundTouch's TDStretch.
+//
+// Input is cut into sequences of MIX_TIMESTRETCH_SEQUENCE_MS, which play at their original speed,
+// crossfading into each other over MIX_TIMESTRETCH_OVERLAP_MS. To play faster, we skip more input
+// between sequences than we output; to play slower, we skip less (and reuse some). Where each
+// sequence actually starts is nudged, within MIX_TIMESTRETCH_SEEK_MS, to whatever spot best matches
+// the end of the previous sequence (by normalized cross-correlation), so the waveforms line up
+// through the crossfade instead of phasing or clicking.
+//
+// The correlation search is most of the cost. It checks every MIX_TIMESTRETCH_COARSE_STEP frames
+// first, then refines around the best match, and the dot products are SIMD'd. Interleaved channels
+// are treated as one long vector, since every channel shifts by the same number of frames.
+
+#define MIX_TIMESTRETCH_SEQUENCE_MS 40
+#define MIX_TIMESTRETCH_SEEK_MS 15
+#define MIX_TIMESTRETCH_OVERLAP_MS 8
+#define MIX_TIMESTRETCH_COARSE_STEP 4
+
+MIX_TimeStretch *MIX_CreateTimeStretch(void)
+{
+    return (MIX_TimeStretch *) SDL_calloc(1, sizeof (MIX_TimeStretch));
+}
+
+void MIX_DestroyTimeStretch(MIX_TimeStretch *timestretch)
+{
+    if (timestretch) {
+        SDL_free(timestretch->ramp);
+        SDL_free(timestretch->overlap);
+        SDL_free(timestretch->input);
+        SDL_free(timestretch->output);
+        SDL_free(timestretch);
+    }
+}
+
+void MIX_ResetTimeStretch(MIX_TimeStretch *timestretch)
+{
+    timestretch->have_overlap = false;
+    timestretch->input_frames = 0;
+    timestretch->skip_fraction = 0.0;
+    timestretch->expected_frames = 0.0;
+    timestretch->output_total = 0;
+}
+
+// the sizes of everything, in frames, for a given sample rate.
+static void GetTimeStretchFrames(int freq, int *sequence_frames, int *seek_frames, int *overlap_frames)
+{
+    *overlap_frames = SDL_max(16, (freq * MIX_TIMESTRETCH_OVERLAP_MS) / 1000);
+    *sequence_frames = SDL_max(*overlap_frames * 3, (freq * MIX_TIMESTRETCH_SEQUENCE_MS) / 1000);
+    *seek_frames = SDL_max(MIX_TIMESTRETCH_COARSE_STEP, (freq * MIX_TIMESTRETCH_SEEK_MS) / 1000);
+}
+
+// how many input frames we need on hand to make one sequence of output.
+static int GetTimeStretchNeededFrames(int sequence_frames, int seek_frames, int overlap_frames, float tempo)
+{
+    const double skip = ((double) (sequence_frames - overlap_frames)) * tempo;
+    return SDL_max(seek_frames + sequence_frames, ((int) SDL_ceil(skip)) + 1);
+}
+
+static bool GrowTimeStretchBuffer(float **buffer, int *allocated, int samples)
+{
+    if (samples > *allocated) {
+        float *ptr = (float *) SDL_realloc(*buffer, samples * sizeof (float));  // realloc, since this might be holding input right now.
+        if (!ptr) {
+            return false;
+        }
+        *buffer = ptr;
+        *allocated = samples;
+    }
+    return true;
+}
+
+bool MIX_ReserveTimeStretch(MIX_TimeStretch *timestretch, int channels, int freq, float tempo)
+{
+    SDL_assert(channels > 0);
+    SDL_assert(freq > 0);
+    SDL_assert(tempo > 0.0f);
+
+    int sequence_frames, seek_frames, overlap_frames;
+    GetTimeStretchFrames(freq, &sequence_frames, &seek_frames, &overlap_frames);
+    const int hop_frames = sequence_frames - overlap_frames;
+    const double skip = ((double) hop_frames) * tempo;
+    const int skip_frames = SDL_max(1, (int) skip);
+    const int needed = GetTimeStretchNeededFrames(sequence_frames, seek_frames, overlap_frames, tempo);
+    const int flush_frames = seek_frames + sequence_frames + ((int) SDL_ceil(skip)) + 1;  // the silence MIX_FlushTimeStretch pushes through.
+
+    // we hold on to less than `needed` frames between calls, so this always leaves room for a whole flush.
+    const int input_frames = needed + flush_frames;
+    const int output_frames = ((input_frames / skip_frames) + 2) * hop_frames;  // one more sequence than that could make, since MIX_ApplyTimeStretch rounds down.
+
+    if (!GrowTimeStretchBuffer(&timestretch->ramp, &timestretch->ramp_allocated, overlap_frames * channels)) {
+        return false;
+    }
+
+    // overlap is always the same size as ramp.
+    float *ptr = (float *) SDL_realloc(timestretch->overlap, timestretch->ramp_allocated * sizeof (float));
+    if (!ptr) {
+        return false;
+    }
+    timestretch->overlap = ptr;
+
+    return GrowTimeStretchBuffer(&timestretch->input, &timestretch->input_allocated, input_frames * channels) &&
+           GrowTimeStretchBuffer(&timestretch->output, &timestretch->output_allocated, output_frames * channels);
+}
+
+bool MIX_SetTimeStretchFormat(MIX_TimeStretch *timestretch, int channels, int freq)
+{
+    SDL_assert(channels > 0);
+    SDL_assert(freq > 0);
+
+    if ((timestretch->channels == channels) && (timestretch->freq == freq)) {
+        return true;  // nothing to do.
+    }
+
+    // the old input is in the wrong format now (and this is cheaper than converting it).
+    MIX_ResetTimeStretch(timestretch);
+
+    int sequence_frames, seek_frames, overlap_frames;
+    GetTimeStretchFrames(freq, &sequence_frames, &seek_frames, &overlap_frames);
+
+    // this might be the audio thread, so we don't allocate here; MIX_ReserveTimeStretch has to have made room already.
+    if ((overlap_frames * channels) > timestretch->ramp_allocated) {
+        timestretch->channels = 0;
+        timestretch->freq = 0;
+        return false;
+    }
+
+    // one weight per sample, not per frame, so the crossfade can run straight down the interleaved data.
+    float *ptr = timestretch->ramp;
+    for (int i = 0; i < overlap_frames; i++) {
+        const float weight = ((float) i) / ((float) overlap_frames);
+        for (int channel = 0; channel < channels; channel++) {
+            *(ptr++) = weight;
+        }
+    }
+
+    timestretch->channels = channels;
+    timestretch->freq = freq;
+    timestretch->sequence_frames = sequence_frames;
+    timestretch->seek_frames = seek_frames;
+    timestretch->overlap_frames = overlap_frames;
+    return true;
+}
+
+// Returns the dot product of `a` and `b`, and stores the dot product of `b` with itself in `*energy`.
+#if SDL_MIXER_NEED_SCALAR_FALLBACK
+static float Correlate_scalar(const float *a, const float *b, int samples, float *energy)
+{
+    float dot = 0.0f;
+    float sum_squares = 0.0f;
+    for (int i = 0; i < samples; i++) {
+        dot += a[i] * b[i];
+        sum_squares += b[i] * b[i];
+    }
+    *energy = sum_squares;
+    return dot;
+}
+#endif
+
+#if defined(SDL_SSE_INTRINSICS)
+static float SDL_TARGETING("sse") Correlate_sse(const float *a, const float *b, int samples, float *energy)
+{
+    __m128 dot = _mm_setzero_ps();
+    __m128 sum_squares = _mm_setzero_ps();
+    int i = 0;
+    for (; (i + 4) <= samples; i += 4) {
+        const __m128 vb = _mm_loadu_ps(b + i);
+        dot = _mm_add_ps(dot, _mm_mul_ps(_mm_loadu_ps(a + i), vb));
+        sum_squares = _mm_add_ps(sum_squares, _mm_mul_ps(vb, vb));
+    }
+
+    float SDL_ALIGNED(16) dots[4];
+    float SDL_ALIGNED(16) energies[4];
+    _mm_store_ps(dots, dot);
+    _mm_store_ps(energies, sum_squares);
+    float retval = (dots[0] + dots[1]) + (dots[2] + dots[3]);
+    float total_energy = (energies[0] + energies[1]) + (energies[2] + energies[3]);
+    for (; i < samples; i++) {
+        retval += a[i] * b[i];
+        total_energy += b[i] * b[i];
+    }
+    *energy = total_energy;
+    return retval;
+}
+#endif
+
+#if defined(SDL_NEON_INTRINSICS)
+static float Correlate_neon(const float *a, const float *b, int samples, float *energy)
+{
+    float32x4_t dot = vdupq_n_f32(0.0f);
+    float32x4_t sum_squares = vdupq_n_f32(0.0f);
+    int i = 0;
+    for (; (i + 4) <= samples; i += 4) {
+        const float32x4_t vb = vld1q_f32(b + i);
+        dot = vmlaq_f32(dot, vld1q_f32(a + i), vb);
+        sum_squares = vmlaq_f32(sum_squares, vb, vb);
+    }
+
+    float SDL_ALIGNED(16) dots[4];
+    float SDL_ALIGNED(16) energies[4];
+    vst1q_f32(dots, dot);
+    vst1q_f32(energies, sum_squares);
+    float retval = (dots[0] + dots[1]) + (dots[2] + dots[3]);
+    float total_energy = (energies[0] + energies[1]) + (energies[2] + energies[3]);
+    for (; i < samples; i++) {
+        retval += a[i] * b[i];
+        total_energy += b[i] * b[i];
+    }
+    *energy = total_energy;
+    return retval;
+}
+#endif
+
+static float Correlate(const float *a, const float *b, int samples, float *energy)
+{
+    #if defined(SDL_SSE_INTRINSICS)
+    if (MIX_HasSSE) {
+        return Correlate_sse(a, b, samples, energy);
+    }
+    #elif defined(SDL_NEON_INTRINSICS)
+    if (MIX_HasNEON) {
+        return Correlate_neon(a, b, samples, energy);
+    }
+    #endif
+
+    #if SDL_MIXER_NEED_SCALAR_FALLBACK
+    return Correlate_scalar(a, b, samples, energy);
+    #else
+    *energy = 0.0f;
+    return 0.0f;
+    #endif
+}
+
+// dst = a + ((b - a) * ramp), which fades from `a` to `b`.
+#if SDL_MIXER_NEED_SCALAR_FALLBACK
+static void Crossfade_scalar(float *dst, const float *a, const float *b, const float *ramp, int samples)
+{
+    for (int i = 0; i < samples; i++) {
+        dst[i] = a[i] + ((b[i] - a[i]) * ramp[i]);
+    }
+}
+#endif
+
+#if defined(SDL_SSE_INTRINSICS)
+static void SDL_TARGETING("sse") Crossfade_sse(float *dst, const float *a, const float *b, const float *ramp, int samples)
+{
+    int i = 0;
+    for (; (i + 4) <= samples; i += 4) {
+        const __m128 va = _mm_loadu_ps(a + i);
+        _mm_storeu_ps(dst + i, _mm_add_ps(va, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(b + i), va), _mm_loadu_ps(ramp + i))));
+    }
+    for (; i < samples; i++) {
+        dst[i] = a[i] + ((b[i] - a[i]) * ramp[i]);
+    }
+}
+#endif
+
+#if defined(SDL_NEON_INTRINSICS)
+static void Crossfade_neon(float *dst, const float *a, const float *b, const float *ramp, int samples)
+{
+    int i = 0;
+    for (; (i + 4) <= samples; i += 4) {
+        const float32x4_t va = vld1q_f32(a + i);
+        vst1q_f32(dst + i, vmlaq_f32(va, vsubq_f32(vld1q_f32(b + i), va), vld1q_f32(ramp + i)));
+    }
+    for (; i < samples; i++) {
+        dst[i] = a[i] + ((b[i] - a[i]) * ramp[i]);
+    }
+}
+#endif
+
+static void Crossfade(float *dst, const float *a, const float *b, const float *ramp, int samples)
+{
+    #if defined(SDL_SSE_INTRINSICS)
+    if (MIX_HasSSE) {
+        Crossfade_sse(dst, a, b, ramp, samples);
+        return;
+    }
+    #elif defined(SDL_NEON_INTRINSICS)
+    if (MIX_HasNEON) {
+        Crossfade_neon(dst, a, b, ramp, samples);
+        return;
+    }
+    #endif
+
+    #if SDL_MIXER_NEED_SCALAR_FALLBACK
+    Crossfade_scalar(dst, a, b, ramp, samples);
+    #endif
+}
+
+static float ScoreOffset(const MIX_TimeStretch *timestretch, const float *input, int offset)
+{
+    const int channels = timestretch->channels;
+    float energy = 0.0f;
+    const float dot = Correlate(timestretch->overlap, input + (offset * channels), timestretch->overlap_frames * channels, &energy);
+    return dot / SDL_sqrtf(energy + 1e-9f);  // normalize, so louder spots don't win just for being louder.
+}
+
+// find where, in the seek window at the start of `input`, the next sequence should start.
+static int FindBestOffset(const MIX_TimeStretch *timestretch, const float *input)
+{
+    const int seek_frames = timestretch->seek_frames;
+    int best_offset = 0;
+    float best_score = ScoreOffset(timestretch, input, 0);
+
+    for (int offset = MIX_TIMESTRETCH_COARSE_STEP; offset < seek_frames; offset += MIX_TIMESTRETCH_COARSE_STEP) {
+        const float score = ScoreOffset(timestretch, input, offset);
+        if (score > best_score) {
+            best_score = score;
+            best_offset = offset;
+        }
+    }
+
+    const int coarse_offset = best_offset;
+    const int start = SDL_max(0, coarse_offset - (MIX_TIMESTRETCH_COARSE_STEP - 1));
+    const int end = SDL_min(seek_frames - 1, coarse_offset + (MIX_TIMESTRETCH_COARSE_STEP - 1));
+    for (int offset = start; offset <= end; offset++) {
+        if (offset != coarse_offset) {
+            const float score = ScoreOffset(timestretch, input, offset);
+            if (score > best_score) {
+                best_score = score;
+                best_offset = offset;
+            }
+        }
+    }
+
+    return best_offset;
+}
+
+int MIX_ApplyTimeStretch(MIX_TimeStretch *timestretch, const float *input, int input_frames, float tempo, int *consumed, const float **output)
+{
+    const int channels = timestretch->channels;
+    SDL_assert(channels > 0);  // MIX_SetTimeStretchFormat must be called first!
+    SDL_assert(tempo > 0.0f);
+
+    const int overlap_frames = timestretch->overlap_frames;
+    const int overlap_samples = overlap_frames * channels;
+    const int hop_frames = timestretch->sequence_frames - overlap_frames;  // output frames per sequence.
+    const double skip = ((double) hop_frames) * tempo;  // input frames per sequence.
+    const int needed = GetTimeStretchNeededFrames(timestretch->sequence_frames, timestretch->seek_frames, overlap_frames, tempo);
+    const size_t framesize = channels * sizeof (float);
+
+    timestretch->tempo = tempo;
+    *consumed = 0;
+
+    // this runs on the audio thread, so only take as much input as we have room for (and can make room for the output of).
+    //  MIX_ReserveTimeStretch sized things so this is always enough for a whole flush.
+    const int output_allocated = timestretch->output_allocated / channels;
+    const int max_input = ((output_allocated / hop_frames) - 1) * SDL_max(1, (int) skip);  // at most (frames / skip) + 1 sequences come out of `frames` of input.
+    const int room = SDL_min(timestretch->input_allocated / channels, max_input) - timestretch->input_frames;
+    if (room <= 0) {
+        return -1;  // MIX_ReserveTimeStretch wasn't called for this format and tempo.
+    }
+    input_frames = SDL_min(input_frames, room);
+
+    float *dst = timestretch->input + (timestretch->input_frames * channels);
+    if (input) {
+        SDL_memcpy(dst, input, input_frames * framesize);
+    } else {
+        SDL_memset(dst, '\0', input_frames * framesize);
+    }
+    timestretch->input_frames += input_frames;
+    timestretch->expected_frames += ((double) input_frames) / ((double) tempo);
+    *consumed = input_frames;
+
+    float *out = timestretch->output;
+    int output_frames = 0;
+    int start = 0;  // where the next sequence's seek window starts in `input`.
+    while ((timestretch->input_frames - start) >= needed) {
+        const float *window = timestretch->input + (start * channels);
+        const float *sequence = window + ((timestretch->have_overlap ? FindBestOffset(timestretch, window) : 0) * channels);
+
+        if (timestretch->have_overlap) {
+            Crossfade(out, timestretch->overlap, sequence, timestretch->ramp, overlap_samples);
+        } else {
+            SDL_memcpy(out, sequence, overlap_samples * sizeof (float));  // first sequence since a reset, nothing to fade from.
+        }
+        SDL_memcpy(out + overlap_samples, sequence + overlap_samples, (hop_frames - overlap_frames) * framesize);
+        SDL_memcpy(timestretch->overlap, sequence + (hop_frames * channels), overlap_samples * sizeof (float));
+        timestretch->have_overlap = true;
+
+        out += hop_frames * channels;
+        output_frames += hop_frames;
+
+        timestretch->skip_fraction += skip;
+        const int whole_frames = (int) timestretch->skip_fraction;
+        timestretch->skip_fraction -= (double) whole_frames;
+        start += whole_frames;
+    }
+
+    // drop input frames we won't need again.
+    if (start > 0) {
+        timestretch->input_frames -= start;
+        SDL_memmove(timestretch->input, timestretch->input + (start * channels), timestretch->input_frames * framesize);
+    }
+
+    timestretch->output_total += output_frames;
+    *output = timestretch->output;
+    return output_frames;
+}
+
+int MIX_FlushTimeStretch(MIX_TimeStretch *timestretch, const float **output)
+{
+    if (!timestretch->have_overlap && (timestretch->input_frames == 0)) {
+        return 0;  // nothing pending.
+    }
+
+    SDL_assert(timestretch->tempo > 0.0f);
+
+    // push silence through until all the real input has made it out, then trim the output to the
+    //  length the real input should have come out to, so we don't add a gap.
+    const float tempo = timestretch->tempo;
+    const int hop_frames = timestretch->sequence_frames - timestretch->overlap_frames;
+    const int silence = timestretch->seek_frames + timestretch->sequence_frames + ((int) SDL_ceil(hop_frames * tempo)) + 1;
+    const double expected_frames = timestretch->expected_frames;
+    const Sint64 output_total = timestretch->output_total;
+
+    int consumed = 0;
+    int retval = MIX_ApplyTimeStretch(timestretch, NULL, silence, tempo, &consumed, output);
+    if (retval > 0) {
+        const Sint64 wanted = ((Sint64) expected_frames) - output_total;
+        retval = (int) SDL_clamp(wanted, 0, (Sint64) retval);
+    }
+
+    MIX_ResetTimeStretch(timestretch);
+    return retval;
+}
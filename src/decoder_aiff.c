@@ -62,6 +62,15 @@
 #define fl32        0x32336C66      /* "fl32" */
 #define fl64        0x34366C66      /* "fl64" */
 #define FL32        0x32334C46      /* "FL32" */
+#define FL64        0x34364C46      /* "FL64" */
+#define ima4        0x34616D69      /* "ima4" */
+
+// Apple's IMA ADPCM ("ima4") stores each channel's samples in 34-byte packets: a 2-byte header and 64 4-bit samples.
+#define IMA4_PACKET_SIZE 34
+#define IMA4_PACKET_FRAMES 64
+
+// how many bytes of ima4 packets to read and decode at once (at least one block of packets, though).
+#define IMA4_READ_SIZE 4096
 
 typedef struct AIFF_TrackData AIFF_TrackData;
 
@@ -71,8 +80,11 @@ typedef struct AIFF_AudioData
 {
     Sint64 start;
     Sint64 stop;
+    int channels;
     int framesize;
     int decoded_framesize;
+    int frames_per_block;   // 1 for uncompressed data, IMA4_PACKET_FRAMES for ima4.
+    int blocksize;          // bytes for each frames_per_block frames (so, the frame size for uncompressed data).
     AIFF_FetchFn fetch;
     Sint64 num_pcm_frames;
 } AIFF_AudioData;
@@ -81,12 +93,30 @@ struct AIFF_TrackData
 {
     const AIFF_AudioData *adata;
     SDL_IOStream *io;
+    const Uint8 *const_data;  // non-NULL if this is plain PCM in const memory, so we can give it to the audio stream without copying.
+    size_t const_datalen;
+    Uint8 *ima4_input;         // ima4 blocks, straight from the file, read several at a time.
+    size_t ima4_inputlen;
+    float *ima4_output;        // decoded ima4 frames.
+    int ima4_output_frames;    // frames decoded into ima4_output.
+    int ima4_output_read;      // frames already handed out from ima4_output.
 };
 
+// read sound data, but never past the end of it (there might be other chunks after the SSND chunk).
+static size_t ReadSoundData(AIFF_TrackData *tdata, void *buffer, size_t buflen)
+{
+    const Sint64 pos = SDL_TellIO(tdata->io);
+    const Sint64 available = (pos < 0) ? 0 : (tdata->adata->stop - pos);
+    if (available <= 0) {
+        return 0;
+    }
+    return SDL_ReadIO(tdata->io, buffer, (size_t) SDL_min((Sint64) buflen, available));
+}
+
 static int FetchXLaw(AIFF_TrackData *tdata, Uint8 *buffer, int buflen, const float *lut)
 {
     int length = buflen;
-    length = (int) SDL_ReadIO(tdata->io, buffer, (size_t)(length / 4));
+    length = (int) ReadSoundData(tdata, buffer, (size_t)(length / 4));
     if (length % tdata->adata->framesize != 0) {
         length -= length % tdata->adata->framesize;
     }
@@ -109,13 +139,13 @@ static int FetchALaw(AIFF_TrackData *tdata, Uint8 *buffer, int buflen)
 
 static int FetchPCM(AIFF_TrackData *tdata, Uint8 *buffer, int buflen)
 {
-    return SDL_ReadIO(tdata->io, buffer, buflen);
+    return ReadSoundData(tdata, buffer, buflen);
 }
 
 static int FetchPCM24LE(AIFF_TrackData *tdata, Uint8 *buffer, int buflen)
 {
     int length = buflen;
-    length = (int) SDL_ReadIO(tdata->io, buffer, (size_t)((length / 4) * 3));
+    length = (int) ReadSoundData(tdata, buffer, (size_t)((length / 4) * 3));
     if ((length % tdata->adata->framesize) != 0) {
         length -= length % tdata->adata->framesize;
     }
@@ -132,7 +162,7 @@ static int FetchPCM24LE(AIFF_TrackData *tdata, Uint8 *buffer, int buflen)
 static int FetchPCM24BE(AIFF_TrackData *tdata, Uint8 *buffer, int buflen)
 {
     int length = buflen;
-    length = (int) SDL_ReadIO(tdata->io, buffer, (size_t)((length / 4) * 3));
+    length = (int) ReadSoundData(tdata, buffer, (size_t)((length / 4) * 3));
     if ((length % tdata->adata->framesize) != 0) {
         length -= length % tdata->adata->framesize;
     }
@@ -165,7 +195,7 @@ static double MIX_SwapDoubleBE(double x)
 static int FetchFloat64BE(AIFF_TrackData *tdata, Uint8 *buffer, int buflen)
 {
     int length = buflen;
-    length = (int) SDL_ReadIO(tdata->io, buffer, (size_t)length);
+    length = (int) ReadSoundData(tdata, buffer, (size_t)length);
     if (length % tdata->adata->framesize != 0) {
         length -= length % tdata->adata->framesize;
     }
@@ -177,6 +207,61 @@ static int FetchFloat64BE(AIFF_TrackData *tdata, Uint8 *buffer, int buflen)
     return length / 2;
 }
 
+static void DecodeIMA4Block(const MIX_IMAADPCMTables *tables, const Uint8 *block, int channels, float *output)
+{
+    for (int c = 0; c < channels; c++) {
+        const Uint8 *packet = block + (c * IMA4_PACKET_SIZE);
+        const Uint16 header = (Uint16) ((((Uint16) packet[0]) << 8) | packet[1]);  // top 9 bits: predictor, bottom 7 bits: step index.
+        Sint32 sample = (Sint32) ((Sint16) (header & 0xFF80));
+        Uint8 index = (Uint8) SDL_min(header & 0x7F, 88);
+        float *dst = output + c;
+        for (int i = 0; i < (IMA4_PACKET_FRAMES / 2); i++) {
+            const Uint8 byte = packet[2 + i];
+            for (int shift = 0; shift <= 4; shift += 4) {  // low nybble first.
+                const Uint8 nybble = (byte >> shift) & 0x0F;
+                sample += tables->delta[index][nybble];
+                sample = SDL_clamp(sample, -32768, 32767);
+                index = tables->next_index[index][nybble];
+                *dst = ((float) sample) * (1.0f / 32768.0f);
+                dst += channels;
+            }
+        }
+    }
+}
+
+// Read and decode as many ima4 blocks as fit in the track's buffers. Returns false if there was nothing left to decode.
+static bool DecodeIMA4Blocks(AIFF_TrackData *tdata)
+{
+    const AIFF_AudioData *adata = tdata->adata;
+    const size_t br = ReadSoundData(tdata, tdata->ima4_input, tdata->ima4_inputlen);
+    const int num_blocks = (int) (br / adata->blocksize);  // an incomplete block at the end of the data is dropped.
+    for (int i = 0; i < num_blocks; i++) {
+        DecodeIMA4Block(&MIX_IMAADPCM_tables, tdata->ima4_input + (i * adata->blocksize), adata->channels, tdata->ima4_output + (i * IMA4_PACKET_FRAMES * adata->channels));
+    }
+    tdata->ima4_output_frames = num_blocks * IMA4_PACKET_FRAMES;
+    tdata->ima4_output_read = 0;
+    return (num_blocks > 0);
+}
+
+static int FetchIMA4(AIFF_TrackData *tdata, Uint8 *buffer, int buflen)
+{
+    const int channels = tdata->adata->channels;
+    float *dst = (float *) buffer;
+    int frames_left = buflen / tdata->adata->decoded_framesize;
+
+    while (frames_left > 0) {
+        if ((tdata->ima4_output_read == tdata->ima4_output_frames) && !DecodeIMA4Blocks(tdata)) {
+            break;
+        }
+        const int total = SDL_min(frames_left, tdata->ima4_output_frames - tdata->ima4_output_read);
+        SDL_memcpy(dst, tdata->ima4_output + (tdata->ima4_output_read * channels), total * channels * sizeof (float));
+        tdata->ima4_output_read += total;
+        dst += total * channels;
+        frames_left -= total;
+    }
+
+    return (int) (((Uint8 *) dst) - buffer);
+}
 
 
 // I couldn't get SANE_to_double() to work, so I stole this from libsndfile.
@@ -237,6 +322,12 @@ static bool CheckAIFFMetadataField(const char *propname, SDL_IOStream *io, SDL_P
     return true;
 }
 
+static bool SDLCALL AIFF_init(void)
+{
+    MIX_BuildIMAADPCMTables(&MIX_IMAADPCM_tables);  // for ima4. The WAV decoder shares these.
+    return true;
+}
+
 static bool AIFF_init_audio_internal(AIFF_AudioData *adata, SDL_IOStream *io, SDL_AudioSpec *spec, SDL_PropertiesID props)
 {
     Uint32 offset = 0;
@@ -251,6 +342,7 @@ static bool AIFF_init_audio_internal(AIFF_AudioData *adata, SDL_IOStream *io, SD
     Uint32 chunk_length = 0;
     Uint32 chunk_type = 0;
     int anno_count = 0;
+    Sint64 ssnd_end = 0;
 
     const Sint64 flen = SDL_GetIOSize(io);
 
@@ -303,6 +395,7 @@ static bool AIFF_init_audio_internal(AIFF_AudioData *adata, SDL_IOStream *io, SD
                 return false;
             }
             adata->start = SDL_TellIO(io) + offset;
+            ssnd_end = chunk_start_position + chunk_length;
             (void)blocksize; // unused
             break;
 
@@ -378,100 +471,107 @@ static bool AIFF_init_audio_internal(AIFF_AudioData *adata, SDL_IOStream *io, SD
         return SDL_SetError("AIFF: Bad AIFF-C file (no FVER chunk)");
     }
 
+    adata->channels = channels;
     adata->framesize = channels * (samplesize / 8);
-    adata->stop = adata->start + channels * numsamples * (samplesize / 8);
+    adata->frames_per_block = 1;
     adata->fetch = FetchPCM;
 
     // Decode the audio data format
     spec->freq = (int)frequency;
     bool unsupported_format = false;
-    switch (samplesize) {
-    case 8:
-        if (!is_AIFC) {
-            spec->format = SDL_AUDIO_S8;
-        } else {
-            switch (compressionType) {
-            case raw_: spec->format = SDL_AUDIO_U8; break;
-            case sowt: spec->format = SDL_AUDIO_S8; break;
-            case ulaw:
-                spec->format = SDL_AUDIO_F32;
-                adata->fetch = FetchULaw;
-                break;
-            case alaw:
-                spec->format = SDL_AUDIO_F32;
-                adata->fetch = FetchALaw;
-                break;
-            default: unsupported_format = true; break;
+    if (channels == 0) {
+        unsupported_format = true;
+    } else if (is_AIFC && ((compressionType == ulaw) || (compressionType == ULAW) || (compressionType == alaw) || (compressionType == ALAW))) {
+        // these are always 8 bits per sample in the file, whatever COMM says (Apple's tools say 16).
+        spec->format = SDL_AUDIO_F32;
+        adata->fetch = ((compressionType == ulaw) || (compressionType == ULAW)) ? FetchULaw : FetchALaw;
+        adata->framesize = channels;
+    } else if (is_AIFC && (compressionType == ima4)) {
+        // COMM counts ima4 packets (per channel) instead of sample frames.
+        spec->format = SDL_AUDIO_F32;
+        adata->fetch = FetchIMA4;
+        adata->framesize = channels * IMA4_PACKET_SIZE;
+        adata->frames_per_block = IMA4_PACKET_FRAMES;
+    } else {
+        switch (samplesize) {
+        case 8:
+            if (!is_AIFC) {
+                spec->format = SDL_AUDIO_S8;
+            } else {
+                switch (compressionType) {
+                case raw_: spec->format = SDL_AUDIO_U8; break;
+                case sowt: spec->format = SDL_AUDIO_S8; break;
+                default: unsupported_format = true; break;
+                }
             }
-        }
-        break;
-    case 16:
-        if (!is_AIFC) {
-            spec->format = SDL_AUDIO_S16BE;
-        } else {
-            switch (compressionType) {
-            case sowt: spec->format = SDL_AUDIO_S16LE; break;
-            case NONE: spec->format = SDL_AUDIO_S16BE; break;
-            case ULAW:
-                spec->format = SDL_AUDIO_F32;
-                adata->fetch = FetchULaw;
-                break;
-            case ALAW:
-                spec->format = SDL_AUDIO_F32;
-                adata->fetch = FetchALaw;
-                break;
-            default: unsupported_format = true; break;
+            break;
+        case 16:
+            if (!is_AIFC) {
+                spec->format = SDL_AUDIO_S16BE;
+            } else {
+                switch (compressionType) {
+                case sowt: spec->format = SDL_AUDIO_S16LE; break;
+                case NONE: spec->format = SDL_AUDIO_S16BE; break;
+                default: unsupported_format = true; break;
+                }
             }
-        }
-        break;
-    case 24:
-        adata->fetch = FetchPCM24BE;
-        spec->format = SDL_AUDIO_F32; 
-        if (is_AIFC) {
-            switch (compressionType) {
-            case sowt: adata->fetch = FetchPCM24LE; break;
-            case NONE: break;
-            default: unsupported_format = true; break;
+            break;
+        case 24:
+            adata->fetch = FetchPCM24BE;
+            spec->format = SDL_AUDIO_F32; 
+            if (is_AIFC) {
+                switch (compressionType) {
+                case sowt: adata->fetch = FetchPCM24LE; break;
+                case NONE: break;
+                default: unsupported_format = true; break;
+                }
             }
-        }
-        break;
-    case 32:
-        if (!is_AIFC) {
-            spec->format = SDL_AUDIO_S32BE;
-        } else {
-            switch (compressionType) {
-            case sowt: spec->format = SDL_AUDIO_S32LE; break;
-            case NONE: spec->format = SDL_AUDIO_S32BE; break;
-            case fl32:
-            case FL32: spec->format = SDL_AUDIO_F32BE; break;
-            default: unsupported_format = true; break;
+            break;
+        case 32:
+            if (!is_AIFC) {
+                spec->format = SDL_AUDIO_S32BE;
+            } else {
+                switch (compressionType) {
+                case sowt: spec->format = SDL_AUDIO_S32LE; break;
+                case NONE: spec->format = SDL_AUDIO_S32BE; break;
+                case fl32:
+                case FL32: spec->format = SDL_AUDIO_F32BE; break;
+                default: unsupported_format = true; break;
+                }
             }
-        }
-        break;
-    case 64:
-        adata->fetch = FetchFloat64BE;
-        if (!is_AIFC) {
-            spec->format = SDL_AUDIO_F32;
-        } else {
-            switch (compressionType) {
-            case fl64:
+            break;
+        case 64:
+            adata->fetch = FetchFloat64BE;
+            if (!is_AIFC) {
                 spec->format = SDL_AUDIO_F32;
-                break;
-            default: unsupported_format = true; break;
+            } else {
+                switch (compressionType) {
+                case fl64:
+                case FL64:
+                    spec->format = SDL_AUDIO_F32;
+                    break;
+                default: unsupported_format = true; break;
+                }
             }
+            break;
+        default:
+            unsupported_format = true;
+            break;
         }
-        break;
-    default:
-        unsupported_format = true;
-        break;
     }
 
-    if (unsupported_format) {
+    if (unsupported_format || (adata->framesize == 0)) {
         return SDL_SetError("AIFF: unsupported data format");
     }
 
     spec->channels = (Uint8) channels;
     adata->decoded_framesize = SDL_AUDIO_FRAMESIZE(*spec);
+    adata->blocksize = adata->framesize;
+
+    // COMM knows how long this is, but don't trust it to fit in the SSND chunk.
+    adata->stop = SDL_min(adata->start + (((Sint64) numsamples) * adata->blocksize), ssnd_end);
+    adata->stop = SDL_max(adata->stop, adata->start);
+    adata->num_pcm_frames = ((adata->stop - adata->start) / adata->blocksize) * adata->frames_per_block;
 
     return true;
 }
@@ -499,7 +599,6 @@ static bool SDLCALL AIFF_init_audio(SDL_IOStream *io, SDL_AudioSpec *spec, SDL_P
         return false;
     }
 
-    adata->num_pcm_frames = MIX_DURATION_UNKNOWN;  // !!! FIXME: AIFF_init_audio_internal needs to set this.
     const bool rc = AIFF_init_audio_internal(adata, io, spec, props);
     if (!rc) {
         SDL_free(adata);
@@ -523,6 +622,21 @@ static bool SDLCALL AIFF_init_track(void *audio_userdata, SDL_IOStream *io, cons
     tdata->adata = adata;
     tdata->io = io;
 
+    if (adata->fetch == FetchPCM) {  // no conversion needed? We can use the data right where it sits if it's in memory.
+        tdata->const_data = (const Uint8 *) MIX_GetConstIOBuffer(io, &tdata->const_datalen);
+    } else if (adata->fetch == FetchIMA4) {
+        const int num_blocks = SDL_max(1, IMA4_READ_SIZE / adata->blocksize);
+        tdata->ima4_inputlen = (size_t) (num_blocks * adata->blocksize);
+        tdata->ima4_input = (Uint8 *) SDL_malloc(tdata->ima4_inputlen);
+        tdata->ima4_output = (float *) SDL_malloc(num_blocks * IMA4_PACKET_FRAMES * adata->decoded_framesize);
+        if (!tdata->ima4_input || !tdata->ima4_output) {
+            SDL_free(tdata->ima4_input);
+            SDL_free(tdata->ima4_output);
+            SDL_free(tdata);
+            return false;
+        }
+    }
+
     *track_userdata = tdata;
 
     return true;
@@ -532,13 +646,30 @@ static bool SDLCALL AIFF_decode(void *track_userdata, SDL_AudioStream *stream)
 {
     AIFF_TrackData *tdata = (AIFF_TrackData *) track_userdata;
 
-    Uint8 buffer[1024];
+    if (tdata->const_data) {  // memory-backed PCM? Push the rest of the sound data in one shot, without copying it.
+        const Sint64 pos = SDL_TellIO(tdata->io);
+        if ((pos < 0) || (pos >= tdata->adata->stop) || (((size_t) pos) >= tdata->const_datalen)) {
+            return false;
+        }
+        Uint64 spanlen = SDL_min((Uint64) (tdata->adata->stop - pos), (Uint64) (tdata->const_datalen - ((size_t) pos)));
+        spanlen = SDL_min(spanlen, SDL_MAX_SINT32);  // if it's ridiculously huge, we'll get the rest on the next decode.
+        spanlen -= spanlen % tdata->adata->framesize;
+        if (spanlen == 0) {
+            return false;
+        } else if (SDL_SeekIO(tdata->io, (Sint64) spanlen, SDL_IO_SEEK_CUR) < 0) {
+            return false;
+        }
+        SDL_PutAudioStreamDataNoCopy(stream, tdata->const_data + pos, (int) spanlen, NULL, NULL);
+        return true;
+    }
+
+    float buffer[256];  // (float, so the fetchers that convert to float32 get aligned memory.)
     int buflen = (int) sizeof (buffer);
     const int mod = buflen % tdata->adata->decoded_framesize;
     if (mod) {
         buflen -= mod;
     }
-    const int br = tdata->adata->fetch(tdata, buffer, buflen);  // this will deal with different formats that might need decompression or conversion.
+    const int br = tdata->adata->fetch(tdata, (Uint8 *) buffer, buflen);  // this will deal with different formats that might need decompression or conversion.
     if (br <= 0) {
         return false;
     }
@@ -547,11 +678,20 @@ static bool SDLCALL AIFF_decode(void *track_userdata, SDL_AudioStream *stream)
     return true;
 }
 
+// this only gets used for formats we decode to float32 (ima4, a-law, 24-bit, etc), so the fetchers write straight into `dst`.
+static int SDLCALL AIFF_decode_into(void *track_userdata, float *dst, int frames)
+{
+    AIFF_TrackData *tdata = (AIFF_TrackData *) track_userdata;
+    const int decoded_framesize = tdata->adata->decoded_framesize;
+    const int br = tdata->adata->fetch(tdata, (Uint8 *) dst, frames * decoded_framesize);
+    return (br > 0) ? (br / decoded_framesize) : -1;
+}
+
 static bool SDLCALL AIFF_seek(void *track_userdata, Uint64 frame)
 {
     AIFF_TrackData *tdata = (AIFF_TrackData *) track_userdata;
     const AIFF_AudioData *adata = tdata->adata;
-    const Sint64 dest_offset = (Sint64)frame * adata->framesize;
+    const Sint64 dest_offset = ((Sint64) (frame / adata->frames_per_block)) * adata->blocksize;  // the start of the block with this frame in it.
     const Sint64 destpos = adata->start + dest_offset;
     if (destpos > adata->stop) {
         return false;
@@ -559,12 +699,26 @@ static bool SDLCALL AIFF_seek(void *track_userdata, Uint64 frame)
         return false;
     }
 
+    if (adata->fetch == FetchIMA4) {
+        // decode the block and skip ahead in the output to the exact frame we want.
+        tdata->ima4_output_frames = tdata->ima4_output_read = 0;
+        const int skip = (int) (frame % adata->frames_per_block);
+        if (skip > 0) {
+            if (!DecodeIMA4Blocks(tdata) || (skip > tdata->ima4_output_frames)) {
+                return false;
+            }
+            tdata->ima4_output_read = skip;
+        }
+    }
+
     return true;
 }
 
 static void SDLCALL AIFF_quit_track(void *track_userdata)
 {
     AIFF_TrackData *tdata = (AIFF_TrackData *) track_userdata;
+    SDL_free(tdata->ima4_input);
+    SDL_free(tdata->ima4_output);
     SDL_free(tdata);
 }
 
@@ -576,14 +730,17 @@ static void SDLCALL AIFF_quit_audio(void *audio_userdata)
 
 MIX_Decoder MIX_Decoder_AIFF = {
     "AIFF",
-    NULL,  // init
+    AIFF_init,
     AIFF_init_audio,
     AIFF_init_track,
     AIFF_decode,
     AIFF_seek,
     AIFF_quit_track,
     AIFF_quit_audio,
-    NULL  // quit
+    NULL,  // quit
+    AIFF_decode_into,
+    4096,  // preferred_frames
+    true  // exact_seek
 };
 
 #endif
@@ -73,6 +73,8 @@ typedef struct AU_TrackData
 {
     const AU_AudioData *adata;
     SDL_IOStream *io;
+    const Uint8 *const_data;  // non-NULL if this is linear PCM in const memory, so we can give it to the audio stream without copying.
+    size_t const_datalen;
 } AU_TrackData;
 
 // Read in the AU header from disk. This makes this process safe
@@ -191,6 +193,10 @@ static bool SDLCALL AU_init_track(void *audio_userdata, SDL_IOStream *io, const
     tdata->adata = adata;
     tdata->io = io;
 
+    if ((adata->encoding == AU_ENC_LINEAR_8) || (adata->encoding == AU_ENC_LINEAR_16)) {  // no conversion needed? We can use the data right where it sits if it's in memory.
+        tdata->const_data = (const Uint8 *) MIX_GetConstIOBuffer(io, &tdata->const_datalen);
+    }
+
     *track_userdata = tdata;
 
     return true;
@@ -222,6 +228,22 @@ static bool SDLCALL AU_decode(void *track_userdata, SDL_AudioStream *stream)
 
         case AU_ENC_LINEAR_8:
         case AU_ENC_LINEAR_16: {
+            if (tdata->const_data) {  // memory-backed? Push the rest of the file in one shot, without copying it.
+                const Sint64 pos = SDL_TellIO(tdata->io);
+                if ((pos < 0) || (((size_t) pos) >= tdata->const_datalen)) {
+                    return false;  // nothing else to read.
+                }
+                size_t spanlen = SDL_min(tdata->const_datalen - ((size_t) pos), SDL_MAX_SINT32);  // if it's ridiculously huge, we'll get the rest on the next decode.
+                spanlen -= (spanlen % framesize);
+                if (spanlen == 0) {
+                    return false;  // nothing else to read.
+                } else if (SDL_SeekIO(tdata->io, (Sint64) spanlen, SDL_IO_SEEK_CUR) < 0) {
+                    return false;
+                }
+                SDL_PutAudioStreamDataNoCopy(stream, tdata->const_data + pos, (int) spanlen, NULL, NULL);
+                return true;
+            }
+
             Sint16 buffer[MAX_SAMPS];
             int max_read = MAX_SAMPS * ((tdata->adata->encoding == AU_ENC_LINEAR_16) ? 2 : 1);
             max_read -= (max_read % framesize);
@@ -218,14 +218,11 @@ static bool SDLCALL DRFLAC_init_track(void *audio_userdata, SDL_IOStream *io, co
 
 static bool SDLCALL DRFLAC_seek(void *track_userdata, Uint64 frame);
 
-static bool SDLCALL DRFLAC_decode(void *track_userdata, SDL_AudioStream *stream)
+static int DRFLAC_ReadFrames(DRFLAC_TrackData *tdata, float *dst, int frames)
 {
-    DRFLAC_TrackData *tdata = (DRFLAC_TrackData *) track_userdata;
-    const int framesize = tdata->adata->framesize;
-    float samples[256];
-    drflac_uint64 amount = drflac_read_pcm_frames_f32(tdata->decoder, sizeof (samples) / framesize, samples);
+    drflac_uint64 amount = drflac_read_pcm_frames_f32(tdata->decoder, (drflac_uint64) frames, dst);
     if (!amount) {
-        return false;  // done decoding.
+        return -1;  // done decoding.
     }
 
     const MIX_OggLoop *loop = &tdata->adata->loop;
@@ -261,7 +258,7 @@ static bool SDLCALL DRFLAC_decode(void *track_userdata, SDL_AudioStream *stream)
             if (should_loop) {
                 const Uint64 nextframe = ((Uint64) loop->start) + ( ((Uint64) loop->len) * ((Uint64) tdata->current_iteration) );
                 if (!DRFLAC_seek(tdata, nextframe)) {
-                    return false;
+                    return -1;
                 }
             } else {
                 tdata->current_iteration = -1;
@@ -270,11 +267,28 @@ static bool SDLCALL DRFLAC_decode(void *track_userdata, SDL_AudioStream *stream)
         }
     }
 
-    if (amount > 0) {
+    tdata->current_iteration_frames += amount;
+    return (int) amount;  // might be zero if we just looped, but there's more data to decode.
+}
+
+static int SDLCALL DRFLAC_decode_into(void *track_userdata, float *dst, int frames)
+{
+    DRFLAC_TrackData *tdata = (DRFLAC_TrackData *) track_userdata;
+    const int amount = DRFLAC_ReadFrames(tdata, dst, frames);
+    return amount ? amount : DRFLAC_ReadFrames(tdata, dst, frames);  // if we just looped, read from the loop start, since zero means we're stalled.
+}
+
+static bool SDLCALL DRFLAC_decode(void *track_userdata, SDL_AudioStream *stream)
+{
+    DRFLAC_TrackData *tdata = (DRFLAC_TrackData *) track_userdata;
+    const int framesize = tdata->adata->framesize;
+    float samples[256];
+    const int amount = DRFLAC_decode_into(tdata, samples, sizeof (samples) / framesize);
+    if (amount < 0) {
+        return false;  // done decoding.
+    } else if (amount > 0) {
         SDL_PutAudioStreamData(stream, samples, amount * framesize);
-        tdata->current_iteration_frames += amount;
     }
-
     return true;  // had more data to decode.
 }
 
@@ -333,7 +347,10 @@ MIX_Decoder MIX_Decoder_DRFLAC = {
     DRFLAC_seek,
     DRFLAC_quit_track,
     DRFLAC_quit_audio,
-    NULL  // quit
+    NULL,  // quit
+    DRFLAC_decode_into,
+    4096,  // preferred_frames: a common FLAC block size.
+    true  // exact_seek
 };
 
 #endif
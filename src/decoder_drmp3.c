@@ -46,16 +46,23 @@
 
 #include "dr_libs/dr_mp3.h"
 
-typedef struct DRMP3_AudioData
+typedef struct DRMP3_SeekTable
 {
-    size_t framesize;
     drmp3_seek_point *seek_points;
     drmp3_uint32 num_seek_points;
+} DRMP3_SeekTable;
+
+typedef struct DRMP3_AudioData
+{
+    size_t framesize;
+    drmp3_uint64 total_frames;
+    drmp3_uint64 seek_interval_frames;  // PCM frames between seek points. Zero to never build a seek table.
+    void *seek_table;  // a DRMP3_SeekTable, built while loading or on a background thread, then shared with all tracks. Access atomically!
 } DRMP3_AudioData;
 
 typedef struct DRMP3_TrackData
 {
-    const DRMP3_AudioData *adata;
+    DRMP3_AudioData *adata;
     drmp3 decoder;
 } DRMP3_TrackData;
 
@@ -80,6 +87,69 @@ static drmp3_bool32 DRMP3_IoTell(void *context, drmp3_int64 *pos)
 }
 
 
+// dr_mp3 gets the length from Xing/Info (and LAME) headers, but doesn't know about Fraunhofer's VBRI header, which has it too.
+static bool DRMP3_ReadVBRIFrameCount(SDL_IOStream *io, drmp3_uint64 offset, drmp3_uint64 *pcm_frames)
+{
+    Uint8 data[36 + 18];  // VBRI always starts 32 bytes past the first frame's 4-byte header.
+    if ((SDL_SeekIO(io, (Sint64) offset, SDL_IO_SEEK_SET) < 0) || (SDL_ReadIO(io, data, sizeof (data)) != sizeof (data))) {
+        return false;
+    } else if ((data[0] != 0xFF) || ((data[1] & 0xE0) != 0xE0)) {
+        return false;  // not a frame header?!
+    }
+
+    const Uint8 *vbri = data + 36;
+    if (SDL_memcmp(vbri, "VBRI", 4) != 0) {
+        return false;
+    }
+
+    const Uint32 frames = (((Uint32) vbri[14]) << 24) | (((Uint32) vbri[15]) << 16) | (((Uint32) vbri[16]) << 8) | ((Uint32) vbri[17]);
+    const int version = (data[1] >> 3) & 3;  // 3 is MPEG-1, 2 is MPEG-2, 0 is MPEG-2.5.
+    const int layer = (data[1] >> 1) & 3;  // 1 is Layer III, 2 is Layer II, 3 is Layer I.
+    int samples_per_frame;
+    if (layer == 3) {
+        samples_per_frame = 384;
+    } else if ((layer == 2) || (version == 3)) {
+        samples_per_frame = 1152;
+    } else {
+        samples_per_frame = 576;  // MPEG-2/2.5 Layer III.
+    }
+
+    *pcm_frames = ((drmp3_uint64) frames) * samples_per_frame;
+    return (frames > 0);
+}
+
+// Build a seek table with `decoder`, if there isn't one yet, and share it with every track.
+static const DRMP3_SeekTable *DRMP3_GetSeekTable(DRMP3_AudioData *adata, drmp3 *decoder)
+{
+    DRMP3_SeekTable *table = (DRMP3_SeekTable *) SDL_GetAtomicPointer(&adata->seek_table);
+    if (table || !adata->seek_interval_frames) {
+        return table;
+    }
+
+    const drmp3_uint64 num_seek_points = (adata->total_frames / adata->seek_interval_frames) + 1;
+    table = (DRMP3_SeekTable *) SDL_calloc(1, sizeof (*table));
+    if (table) {
+        table->num_seek_points = (drmp3_uint32) SDL_min(num_seek_points, 0xFFFFFFFF);
+        table->seek_points = (drmp3_seek_point *) SDL_calloc(table->num_seek_points, sizeof (*table->seek_points));
+    }
+
+    if (!table || !table->seek_points || !drmp3_calculate_seek_points(decoder, &table->num_seek_points, table->seek_points)) {
+        if (table) {
+            SDL_free(table->seek_points);
+            SDL_free(table);
+        }
+        return NULL;  // we'll just seek without it.
+    }
+
+    if (!SDL_CompareAndSwapAtomicPointer(&adata->seek_table, NULL, table)) {  // someone beat us to it? Use theirs.
+        SDL_free(table->seek_points);
+        SDL_free(table);
+        table = (DRMP3_SeekTable *) SDL_GetAtomicPointer(&adata->seek_table);
+    }
+
+    return table;
+}
+
 static bool SDLCALL DRMP3_init_audio(SDL_IOStream *io, SDL_AudioSpec *spec, SDL_PropertiesID props, Sint64 *duration_frames, void **audio_userdata)
 {
     drmp3 decoder;
@@ -94,30 +164,20 @@ static bool SDLCALL DRMP3_init_audio(SDL_IOStream *io, SDL_AudioSpec *spec, SDL_
         return false;
     }
 
-    // I don't know if this is a great idea, as this is allegedly inefficient, but let's precalculate a seek table at load time, so each track can reuse it.
-    // (If any of this fails, we go on without it.)
-    drmp3_uint64 num_mp3_frames = 0;
+    // Use the length from the Xing/Info/VBRI header if there is one, so we don't have to read the whole file here.
+    //  Otherwise, count the frames (this is the slow part of loading an MP3). The seek table is built later, by
+    //  DRMP3_build_seek_index, so we don't scan the file for it here.
     drmp3_uint64 num_pcm_frames = 0;
-    if (drmp3_get_mp3_and_pcm_frame_count(&decoder, &num_mp3_frames, &num_pcm_frames)) {
-        adata->num_seek_points = (drmp3_uint32) num_mp3_frames;
-        adata->seek_points = (drmp3_seek_point *) SDL_calloc(num_mp3_frames, sizeof (*adata->seek_points));
-        if (adata->seek_points) {
-            if (drmp3_calculate_seek_points(&decoder, &adata->num_seek_points, adata->seek_points)) {
-                // shrink the array if possible.
-                if (adata->num_seek_points < ((drmp3_uint32) num_mp3_frames)) {
-                    void *ptr = SDL_realloc(adata->seek_points, adata->num_seek_points * sizeof (*adata->seek_points));
-                    if (ptr) {
-                        adata->seek_points = (drmp3_seek_point *) ptr;
-                    }
-                }
-            } else {  // failed, oh well. Live without.
-                SDL_free(adata->seek_points);
-                adata->seek_points = NULL;
-                adata->num_seek_points = 0;
-            }
-        }
+    if (decoder.totalPCMFrameCount != DRMP3_UINT64_MAX) {
+        num_pcm_frames = drmp3_get_pcm_frame_count(&decoder);  // this doesn't scan when the header had the length.
+    } else if (!DRMP3_ReadVBRIFrameCount(io, decoder.streamStartOffset, &num_pcm_frames)) {
+        num_pcm_frames = drmp3_get_pcm_frame_count(&decoder);  // zero if this fails.
     }
 
+    const Sint64 seek_interval_ms = SDL_GetNumberProperty(props, MIX_PROP_AUDIO_LOAD_SEEK_INTERVAL_MS_NUMBER, 1000);
+    adata->total_frames = num_pcm_frames;
+    adata->seek_interval_frames = (seek_interval_ms > 0) ? SDL_max(1, (((drmp3_uint64) seek_interval_ms) * decoder.sampleRate) / 1000) : 0;
+
     spec->format = SDL_AUDIO_F32;
     spec->channels = (int) decoder.channels;
     spec->freq = (int) decoder.sampleRate;
@@ -134,7 +194,7 @@ static bool SDLCALL DRMP3_init_audio(SDL_IOStream *io, SDL_AudioSpec *spec, SDL_
 
 static bool SDLCALL DRMP3_init_track(void *audio_userdata, SDL_IOStream *io, const SDL_AudioSpec *spec, SDL_PropertiesID props, void **track_userdata)
 {
-    const DRMP3_AudioData *adata = (const DRMP3_AudioData *) audio_userdata;
+    DRMP3_AudioData *adata = (DRMP3_AudioData *) audio_userdata;
     DRMP3_TrackData *tdata = (DRMP3_TrackData *) SDL_calloc(1, sizeof (*tdata));
     if (!tdata) {
         return false;
@@ -145,8 +205,9 @@ static bool SDLCALL DRMP3_init_track(void *audio_userdata, SDL_IOStream *io, con
         return false;
     }
 
-    if (adata->seek_points) {
-        drmp3_bind_seek_table(&tdata->decoder, adata->num_seek_points, adata->seek_points);
+    const DRMP3_SeekTable *table = (const DRMP3_SeekTable *) SDL_GetAtomicPointer(&adata->seek_table);
+    if (table) {  // might still be building; if so, seek() will pick it up later.
+        drmp3_bind_seek_table(&tdata->decoder, table->num_seek_points, table->seek_points);
     }
 
     tdata->adata = adata;
@@ -168,12 +229,42 @@ static bool SDLCALL DRMP3_decode(void *track_userdata, SDL_AudioStream *stream)
     return true;
 }
 
+static int SDLCALL DRMP3_decode_into(void *track_userdata, float *dst, int frames)
+{
+    DRMP3_TrackData *tdata = (DRMP3_TrackData *) track_userdata;
+    const drmp3_uint64 rc = drmp3_read_pcm_frames_f32(&tdata->decoder, (drmp3_uint64) frames, dst);
+    return rc ? (int) rc : -1;  // zero frames means we're done decoding.
+}
+
 static bool SDLCALL DRMP3_seek(void *track_userdata, Uint64 frame)
 {
     DRMP3_TrackData *tdata = (DRMP3_TrackData *) track_userdata;
+    if (!tdata->decoder.pSeekPoints) {
+        // this runs on the mixer thread when a track loops, so never build the table here; use it only if it's ready.
+        const DRMP3_SeekTable *table = (const DRMP3_SeekTable *) SDL_GetAtomicPointer(&tdata->adata->seek_table);
+        if (table) {
+            drmp3_bind_seek_table(&tdata->decoder, table->num_seek_points, table->seek_points);
+        }
+    }
     return !!drmp3_seek_to_pcm_frame(&tdata->decoder, (drmp3_uint64) frame);
 }
 
+static bool SDLCALL DRMP3_build_seek_index(void *audio_userdata, SDL_IOStream *io)
+{
+    DRMP3_AudioData *adata = (DRMP3_AudioData *) audio_userdata;
+    if (!adata->seek_interval_frames) {
+        return false;  // the app doesn't want a table.
+    }
+
+    drmp3 decoder;
+    if (!drmp3_init(&decoder, DRMP3_IoRead, DRMP3_IoSeek, DRMP3_IoTell, NULL, io, NULL)) {
+        return false;
+    }
+    const bool retval = (DRMP3_GetSeekTable(adata, &decoder) != NULL);
+    drmp3_uninit(&decoder);
+    return retval;
+}
+
 static void SDLCALL DRMP3_quit_track(void *track_userdata)
 {
     DRMP3_TrackData *tdata = (DRMP3_TrackData *) track_userdata;
@@ -184,7 +275,11 @@ static void SDLCALL DRMP3_quit_track(void *track_userdata)
 static void SDLCALL DRMP3_quit_audio(void *audio_userdata)
 {
     DRMP3_AudioData *adata = (DRMP3_AudioData *) audio_userdata;
-    SDL_free(adata->seek_points);
+    DRMP3_SeekTable *table = (DRMP3_SeekTable *) SDL_GetAtomicPointer(&adata->seek_table);
+    if (table) {
+        SDL_free(table->seek_points);
+        SDL_free(table);
+    }
     SDL_free(adata);
 }
 
@@ -197,7 +292,11 @@ MIX_Decoder MIX_Decoder_DRMP3 = {
     DRMP3_seek,
     DRMP3_quit_track,
     DRMP3_quit_audio,
-    NULL  // quit
+    NULL,  // quit
+    DRMP3_decode_into,
+    1152 * 4,  // preferred_frames: a few MPEG audio frames.
+    true,  // exact_seek
+    DRMP3_build_seek_index
 };
 
 #endif
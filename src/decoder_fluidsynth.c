@@ -332,6 +332,18 @@ bool SDLCALL FLUIDSYNTH_decode(void *track_userdata, SDL_AudioStream *stream)
     return true;
 }
 
+int SDLCALL FLUIDSYNTH_decode_into(void *track_userdata, float *dst, int frames)
+{
+    FLUIDSYNTH_TrackData *tdata = (FLUIDSYNTH_TrackData *) track_userdata;
+
+    if (fluidsynth.fluid_player_get_status(tdata->player) != FLUID_PLAYER_PLAYING) {
+        return -1;
+    } else if (fluidsynth.fluid_synth_write_float(tdata->synth, frames, dst, 0, 2, dst, 1, 2) != FLUID_OK) {
+        return -1;  // maybe EOF...?
+    }
+    return frames;
+}
+
 bool SDLCALL FLUIDSYNTH_seek(void *track_userdata, Uint64 frame)
 {
 #if (FLUIDSYNTH_VERSION_MAJOR < 2)
@@ -371,7 +383,9 @@ MIX_Decoder MIX_Decoder_FLUIDSYNTH = {
     FLUIDSYNTH_seek,
     FLUIDSYNTH_quit_track,
     FLUIDSYNTH_quit_audio,
-    FLUIDSYNTH_quit
+    FLUIDSYNTH_quit,
+    FLUIDSYNTH_decode_into,
+    1024  // preferred_frames: a multiple of FluidSynth's internal 64-frame block.
 };
 
 #endif
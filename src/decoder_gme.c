@@ -32,6 +32,7 @@
 #define MIX_LOADER_FUNCTIONS \
     MIX_LOADER_FUNCTION(true,gme_err_t,gme_open_data,(void const*, long, Music_Emu**, int)) \
     MIX_LOADER_FUNCTION(true,const char*,gme_identify_header,(void const*)) \
+    MIX_LOADER_FUNCTION(true,int,gme_track_count,(Music_Emu const*)) \
     MIX_LOADER_FUNCTION(true,gme_err_t,gme_start_track,(Music_Emu*, int)) \
     MIX_LOADER_FUNCTION(true,int,gme_track_ended,(Music_Emu const*)) \
     MIX_LOADER_FUNCTION(true,int,gme_voice_count,(Music_Emu const*)) \
@@ -46,6 +47,23 @@
 #include "SDL_mixer_loader.h"
 
 
+typedef struct GME_AudioData
+{
+    const Uint8 *data;  // the whole file; libgme copies what it needs out of this, but every new emulator needs it again.
+    size_t datalen;
+    bool free_data;  // true if we loaded `data` ourselves, false if it's the MIX_Audio's precache.
+    // emulators that tracks are done with, so the next track doesn't have to parse the file again. Access atomically!
+    void *spare_emus[4];
+    int subsong;  // the sub-song from the load properties. Tracks play this unless their own properties pick another.
+} GME_AudioData;
+
+typedef struct GME_TrackData
+{
+    GME_AudioData *adata;
+    Music_Emu *emu;
+} GME_TrackData;
+
+
 static bool SDLCALL GME_init(void)
 {
     return LoadModule_gme();
@@ -56,6 +74,57 @@ static void SDLCALL GME_quit(void)
     UnloadModule_gme();
 }
 
+// figure out which sub-song (NSF, SPC sets, etc, can have many) the app wants from `props`, or `default_subsong` if it doesn't say.
+static bool GetGmeSubsong(Music_Emu *emu, SDL_PropertiesID props, int default_subsong, int *subsong)
+{
+    const Sint64 si64subsong = SDL_GetNumberProperty(props, MIX_PROP_DECODER_GME_TRACK_NUMBER, default_subsong);
+    const int track_count = gme.gme_track_count(emu);
+    if ((si64subsong < 0) || (si64subsong >= track_count)) {
+        return SDL_SetError("GME track %" SDL_PRIs64 " doesn't exist (this file has %d)", si64subsong, track_count);
+    }
+    *subsong = (int) si64subsong;
+    return true;
+}
+
+// put an emulator back in the pool for the next track, or delete it if the pool is full.
+static void ReleaseGmeEmu(GME_AudioData *adata, Music_Emu *emu)
+{
+    for (int i = 0; i < SDL_arraysize(adata->spare_emus); i++) {
+        if (SDL_CompareAndSwapAtomicPointer(&adata->spare_emus[i], NULL, emu)) {
+            return;
+        }
+    }
+    gme.gme_delete(emu);
+}
+
+static Music_Emu *AcquireGmeEmu(GME_AudioData *adata, int freq)
+{
+    for (int i = 0; i < SDL_arraysize(adata->spare_emus); i++) {
+        void *spare;
+        do {
+            spare = SDL_GetAtomicPointer(&adata->spare_emus[i]);
+        } while (spare && !SDL_CompareAndSwapAtomicPointer(&adata->spare_emus[i], spare, NULL));
+        if (spare) {
+            return (Music_Emu *) spare;
+        }
+    }
+
+    // nothing in the pool, make a new one.
+    Music_Emu *emu = NULL;
+    const gme_err_t err = gme.gme_open_data(adata->data, (long) adata->datalen, &emu, freq);
+    if (err) {
+        SDL_SetError("gme_open_data failed: %s", err);
+        return NULL;
+    }
+
+    // Set this flag BEFORE calling the gme_start_track() to fix an inability to loop forever
+    if (gme.gme_set_autoload_playback_limit) {
+        gme.gme_set_autoload_playback_limit(emu, 0);
+    }
+
+    return emu;
+}
+
 static bool SDLCALL GME_init_audio(SDL_IOStream *io, SDL_AudioSpec *spec, SDL_PropertiesID props, Sint64 *duration_frames, void **audio_userdata)
 {
     // just load the bare minimum from the IOStream to verify it's a supported file.
@@ -69,29 +138,38 @@ static bool SDLCALL GME_init_audio(SDL_IOStream *io, SDL_AudioSpec *spec, SDL_Pr
         return SDL_SetError("Not a libgme-supported audio stream");
     }
 
-    // Go back and do a proper load now to get metadata.
-    bool copied = false;
-    size_t datalen = 0;
-    Uint8 *data = (Uint8 *) MIX_SlurpConstIO(io, &datalen, &copied);
-    if (!data) {
+    // Go back and do a proper load now. We need this data for the lifetime of the MIX_Audio. If `io` is memory,
+    //  it's the MIX_Audio's precache (or the stream its tracks read from), which outlives us, so use it in place.
+    GME_AudioData *adata = (GME_AudioData *) SDL_calloc(1, sizeof (*adata));
+    if (!adata) {
         return false;
     }
 
-    Music_Emu *emu = NULL;
-    gme_err_t err = gme.gme_open_data(data, (long)datalen, &emu, gme_info_only);
-
-    if (copied) {
-        SDL_free(data);
+    adata->data = (const Uint8 *) MIX_SlurpConstIO(io, &adata->datalen, &adata->free_data);
+    if (!adata->data) {
+        SDL_free(adata);
+        return false;
     }
 
-    if (err) {
-        return SDL_SetError("gme_open_data failed: %s", err);
+    // libgme generates in whatever sample rate, so use the current device spec->freq. Open a real
+    //  emulator instead of a gme_info_only one, so the first track can use it instead of parsing the file again.
+    Music_Emu *emu = AcquireGmeEmu(adata, spec->freq);
+    int subsong = 0;
+    if (!emu || !GetGmeSubsong(emu, props, 0, &subsong)) {
+        if (emu) {
+            gme.gme_delete(emu);
+        }
+        if (adata->free_data) {
+            SDL_free((void *) adata->data);
+        }
+        SDL_free(adata);
+        return false;
     }
 
     *duration_frames = -1;
 
     gme_info_t *info = NULL;
-    err = gme.gme_track_info(emu, &info, 0);
+    gme_err_t err = gme.gme_track_info(emu, &info, subsong);
     if (!err) {  // if this fails, oh well.
         #define SET_GME_METADATA(gmestr, mixerprop) { \
             if (info->gmestr && *info->gmestr) { \
@@ -117,65 +195,76 @@ static bool SDLCALL GME_init_audio(SDL_IOStream *io, SDL_AudioSpec *spec, SDL_Pr
         gme.gme_free_info(info);
     }
 
-    gme.gme_delete(emu);
+    // the mixer uses this duration for every track of this audio, but tracks can pick another sub-song in their own
+    //  properties, so don't report a length that might belong to a different sub-song. An infinite loop is still
+    //  reported, so nothing tries to predecode the default sub-song forever.
+    const int track_count = gme.gme_track_count(emu);
+    if ((track_count > 1) && (*duration_frames >= 0)) {
+        *duration_frames = MIX_DURATION_UNKNOWN;
+    }
+
+    SDL_SetNumberProperty(props, MIX_PROP_METADATA_TRACK_NUMBER, subsong + 1);
+    SDL_SetNumberProperty(props, MIX_PROP_METADATA_TOTAL_TRACKS_NUMBER, track_count);
+
+    ReleaseGmeEmu(adata, emu);
 
     // libgme only outputs Sint16 stereo data.
     spec->format = SDL_AUDIO_S16;
     spec->channels = 2;
-    // libgme generates in whatever sample rate, so use the current device spec->freq.
 
-    *audio_userdata = NULL;  // no state.
+    adata->subsong = subsong;
+    *audio_userdata = adata;
 
     return true;
 }
 
 bool SDLCALL GME_init_track(void *audio_userdata, SDL_IOStream *io, const SDL_AudioSpec *spec, SDL_PropertiesID props, void **track_userdata)
 {
-    SDL_assert(audio_userdata == NULL);  // no state.
+    GME_AudioData *adata = (GME_AudioData *) audio_userdata;
 
-    bool copied = false;
-    size_t datalen = 0;
-    Uint8 *data = (Uint8 *) MIX_SlurpConstIO(io, &datalen, &copied);
-    if (!data) {
+    // we kept the file data in GME_init_audio, so we don't touch `io` at all.
+    GME_TrackData *tdata = (GME_TrackData *) SDL_calloc(1, sizeof (*tdata));
+    if (!tdata) {
         return false;
     }
 
-    Music_Emu *emu = NULL;
-    gme_err_t err = gme.gme_open_data(data, (long) datalen, &emu, spec->freq);
-
-    if (copied) {
-        SDL_free(data);
-    }
-
-    if (err) {
-        return SDL_SetError("gme_open_data failed: %s", err);
+    tdata->adata = adata;
+    tdata->emu = AcquireGmeEmu(adata, spec->freq);
+    if (!tdata->emu) {
+        SDL_free(tdata);
+        return false;
     }
 
-    // Set this flag BEFORE calling the gme_start_track() to fix an inability to loop forever
-    if (gme.gme_set_autoload_playback_limit) {
-        gme.gme_set_autoload_playback_limit(emu, 0);
+    // `props` are the track's, so each track can play its own sub-song; otherwise, it plays the one the audio was loaded with.
+    // gme_start_track() resets the emulator, so it doesn't matter what a pooled one was playing before.
+    int subsong = 0;
+    if (!GetGmeSubsong(tdata->emu, props, adata->subsong, &subsong)) {
+        ReleaseGmeEmu(adata, tdata->emu);
+        SDL_free(tdata);
+        return false;
     }
 
-    err = gme.gme_start_track(emu, 0);
+    const gme_err_t err = gme.gme_start_track(tdata->emu, subsong);
     if (err) {
-        gme.gme_delete(emu);
+        gme.gme_delete(tdata->emu);
+        SDL_free(tdata);
         return SDL_SetError("gme_start_track failed: %s", err);
     }
 
-    *track_userdata = emu;
+    *track_userdata = tdata;
 
     return true;
 }
 
 bool SDLCALL GME_decode(void *track_userdata, SDL_AudioStream *stream)
 {
-    Music_Emu *emu = (Music_Emu *) track_userdata;
-    if (gme.gme_track_ended(emu)) {
+    GME_TrackData *tdata = (GME_TrackData *) track_userdata;
+    if (gme.gme_track_ended(tdata->emu)) {
         return false;  // all done.
     }
 
-    Sint16 samples[256];
-    gme_err_t err = gme.gme_play(emu, SDL_arraysize(samples), (short*) samples);
+    Sint16 samples[4096];  // this is interleaved stereo, so 2048 sample frames.
+    gme_err_t err = gme.gme_play(tdata->emu, SDL_arraysize(samples), (short*) samples);
     if (err != NULL) {
         return SDL_SetError("GME: %s", err);  // i guess we're done.
     }
@@ -187,20 +276,32 @@ bool SDLCALL GME_decode(void *track_userdata, SDL_AudioStream *stream)
 
 bool SDLCALL GME_seek(void *track_userdata, Uint64 frame)
 {
-    Music_Emu *emu = (Music_Emu *) track_userdata;
-    gme_err_t err = gme.gme_seek_samples(emu, (int) frame);
+    GME_TrackData *tdata = (GME_TrackData *) track_userdata;
+    // libgme counts samples, not sample frames, and it always outputs stereo.
+    gme_err_t err = gme.gme_seek_samples(tdata->emu, (int) (frame * 2));
     return err ? SDL_SetError("gme_seek_samples failed: %s", err) : true;
 }
 
 void SDLCALL GME_quit_track(void *track_userdata)
 {
-    Music_Emu *emu = (Music_Emu *) track_userdata;
-    gme.gme_delete(emu);
+    GME_TrackData *tdata = (GME_TrackData *) track_userdata;
+    ReleaseGmeEmu(tdata->adata, tdata->emu);
+    SDL_free(tdata);
 }
 
 void SDLCALL GME_quit_audio(void *audio_userdata)
 {
-    SDL_assert(audio_userdata == NULL);  // no state.
+    GME_AudioData *adata = (GME_AudioData *) audio_userdata;
+    for (int i = 0; i < SDL_arraysize(adata->spare_emus); i++) {
+        void *spare = SDL_GetAtomicPointer(&adata->spare_emus[i]);
+        if (spare) {
+            gme.gme_delete((Music_Emu *) spare);
+        }
+    }
+    if (adata->free_data) {
+        SDL_free((void *) adata->data);
+    }
+    SDL_free(adata);
 }
 
 MIX_Decoder MIX_Decoder_GME = {
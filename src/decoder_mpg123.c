@@ -65,7 +65,9 @@
         MIX_LOADER_FUNCTION(true,int,mpg123_reader64,(mpg123_handle *mh, int (*r_read)(void*, void*, size_t, size_t*), int64_t (*r_lseek)(void*, int64_t, int), void (*cleanup)(void*))) \
         MIX_LOADER_FUNCTION(true,int64_t,mpg123_seek64,(mpg123_handle *mh, int64_t sampleoff, int whence)) \
         MIX_LOADER_FUNCTION(true,int64_t,mpg123_tell64,(mpg123_handle *mh)) \
-        MIX_LOADER_FUNCTION(true,int64_t,mpg123_length64,(mpg123_handle *mh))
+        MIX_LOADER_FUNCTION(true,int64_t,mpg123_length64,(mpg123_handle *mh)) \
+        MIX_LOADER_FUNCTION(true,int,mpg123_index64,(mpg123_handle *mh, int64_t **offsets, int64_t *step, size_t *fill)) \
+        MIX_LOADER_FUNCTION(true,int,mpg123_set_index64,(mpg123_handle *mh, int64_t *offsets, int64_t step, size_t fill))
 #else
     #define MIX_LOADER_FUNCTIONS \
         MIX_LOADER_FUNCTIONS_mpg123base \
@@ -74,12 +76,37 @@
         MIX_LOADER_FUNCTION(true,int,mpg123_replace_reader_handle,(mpg123_handle *mh, Mpg123SSizeType (*r_read)(void *, void *, size_t), off_t (*r_lseek)(void *, off_t, int), void (*cleanup)(void*))) \
         MIX_LOADER_FUNCTION(true,off_t,mpg123_seek,(mpg123_handle *mh, off_t sampleoff, int whence)) \
         MIX_LOADER_FUNCTION(true,off_t,mpg123_tell,(mpg123_handle *mh)) \
-        MIX_LOADER_FUNCTION(true,off_t,mpg123_length,(mpg123_handle *mh))
+        MIX_LOADER_FUNCTION(true,off_t,mpg123_length,(mpg123_handle *mh)) \
+        MIX_LOADER_FUNCTION(true,int,mpg123_index,(mpg123_handle *mh, off_t **offsets, off_t *step, size_t *fill)) \
+        MIX_LOADER_FUNCTION(true,int,mpg123_set_index,(mpg123_handle *mh, off_t *offsets, off_t step, size_t fill))
 #endif
 
 #define MIX_LOADER_MODULE mpg123
 #include "SDL_mixer_loader.h"
 
+#if (MPG123_API_VERSION >= 49)
+#define Mpg123OffsetType int64_t
+#else
+#define Mpg123OffsetType off_t
+#endif
+
+// mpg123_read fills the whole buffer if it can, so make it hold several complete MPEG frames (1152 samples each) in the largest format we accept.
+#define MPG123_DECODE_BUFFER_SIZE (1152 * 4 * 2 * sizeof (float))
+
+typedef struct MPG123_AudioData
+{
+    // the frame index that mpg123_scan built in MPG123_init_audio. Every track gets a copy, so seeks never have to scan.
+    Mpg123OffsetType *index_offsets;
+    Mpg123OffsetType index_step;
+    size_t index_fill;
+} MPG123_AudioData;
+
+typedef struct MPG123_TrackData
+{
+    mpg123_handle *handle;
+    Uint8 buffer[MPG123_DECODE_BUFFER_SIZE];
+} MPG123_TrackData;
+
 
 static bool SDLCALL MPG123_init(void)
 {
@@ -224,6 +251,7 @@ static bool SDLCALL MPG123_init_audio(SDL_IOStream *io, SDL_AudioSpec *spec, SDL
         }
     }
 
+    MPG123_AudioData *adata = NULL;
     const long *rates = NULL;
     size_t num_rates = 0;
     int encoding = 0;
@@ -300,12 +328,35 @@ static bool SDLCALL MPG123_init_audio(SDL_IOStream *io, SDL_AudioSpec *spec, SDL
     #else
     *duration_frames = (Sint64) mpg123.mpg123_length(handle);
     #endif
-    
+
+    adata = (MPG123_AudioData *) SDL_calloc(1, sizeof (*adata));
+    if (!adata) {
+        goto failed;
+    }
+
+    // the scan filled in the frame index, too. Keep a copy, since it belongs to this handle. If this fails, tracks just build their own as they go.
+    Mpg123OffsetType *offsets = NULL;
+    Mpg123OffsetType step = 0;
+    size_t fill = 0;
+    #if (MPG123_API_VERSION >= 49)
+    result = mpg123.mpg123_index64(handle, &offsets, &step, &fill);
+    #else
+    result = mpg123.mpg123_index(handle, &offsets, &step, &fill);
+    #endif
+    if ((result == MPG123_OK) && offsets && (fill > 0)) {
+        adata->index_offsets = (Mpg123OffsetType *) SDL_malloc(fill * sizeof (*offsets));
+        if (adata->index_offsets) {
+            SDL_memcpy(adata->index_offsets, offsets, fill * sizeof (*offsets));
+            adata->index_step = step;
+            adata->index_fill = fill;
+        }
+    }
+
     mpg123.mpg123_close(handle);
     mpg123.mpg123_delete(handle);
     handle = NULL;
 
-    *audio_userdata = NULL;  // no state.
+    *audio_userdata = adata;
 
     return true;
 
@@ -314,16 +365,23 @@ failed:
         mpg123.mpg123_close(handle);
         mpg123.mpg123_delete(handle);
     }
+    SDL_free(adata);
     return false;
 }
 
 bool SDLCALL MPG123_init_track(void *audio_userdata, SDL_IOStream *io, const SDL_AudioSpec *spec, SDL_PropertiesID props, void **track_userdata)
 {
-    SDL_assert(audio_userdata == NULL);  // no state.
+    const MPG123_AudioData *adata = (const MPG123_AudioData *) audio_userdata;
+
+    MPG123_TrackData *tdata = (MPG123_TrackData *) SDL_calloc(1, sizeof (*tdata));
+    if (!tdata) {
+        return false;
+    }
 
     int result = 0;
     mpg123_handle *handle = mpg123.mpg123_new(NULL, &result);
     if (result != MPG123_OK) {
+        SDL_free(tdata);
         return SDL_SetError("mpg123_new failed");
     }
 
@@ -337,6 +395,7 @@ bool SDLCALL MPG123_init_track(void *audio_userdata, SDL_IOStream *io, const SDL
     if (result != MPG123_OK) {
         SDL_SetError("mpg123_replace_reader_handle: %s", mpg_err(handle, result));
         mpg123.mpg123_delete(handle);
+        SDL_free(tdata);
         return false;
     }
 
@@ -345,6 +404,7 @@ bool SDLCALL MPG123_init_track(void *audio_userdata, SDL_IOStream *io, const SDL
     if (result != MPG123_OK) {
         SDL_SetError("mpg123_format_none: %s", mpg_err(handle, result));
         mpg123.mpg123_delete(handle);
+        SDL_free(tdata);
         return false;
     }
 
@@ -369,27 +429,37 @@ bool SDLCALL MPG123_init_track(void *audio_userdata, SDL_IOStream *io, const SDL
     if (result != MPG123_OK) {
         SDL_SetError("mpg123_open_handle: %s", mpg_err(handle, result));
         mpg123.mpg123_delete(handle);
+        SDL_free(tdata);
         return false;
     }
 
-    // !!! FIXME: should we do this? It makes seeking better, maybe?  mpg123.mpg123_scan(handle);
+    // hand over the frame index that MPG123_init_audio's scan built, so seeking doesn't have to scan again in every track.
+    //  (mpg123_set_index copies it. If it fails, the handle just builds its own index as it goes, like it would have anyhow.)
+    if (adata->index_offsets) {
+        #if (MPG123_API_VERSION >= 49)
+        mpg123.mpg123_set_index64(handle, adata->index_offsets, adata->index_step, adata->index_fill);
+        #else
+        mpg123.mpg123_set_index(handle, adata->index_offsets, adata->index_step, adata->index_fill);
+        #endif
+    }
 
-    *track_userdata = handle;
+    tdata->handle = handle;
+    *track_userdata = tdata;
 
     return true;
 }
 
 bool SDLCALL MPG123_decode(void *track_userdata, SDL_AudioStream *stream)
 {
-    mpg123_handle *handle = (mpg123_handle *) track_userdata;
+    MPG123_TrackData *tdata = (MPG123_TrackData *) track_userdata;
+    mpg123_handle *handle = tdata->handle;
     SDL_AudioSpec spec;
     int result;
     size_t amount = 0;
     long rate;
     int channels, encoding;
-    Uint8 buffer[1024];
 
-    result = mpg123.mpg123_read(handle, buffer, sizeof (buffer), &amount);
+    result = mpg123.mpg123_read(handle, tdata->buffer, sizeof (tdata->buffer), &amount);
 
     if (result == MPG123_NEW_FORMAT) {
         result = mpg123.mpg123_getformat(handle, &rate, &channels, &encoding);
@@ -410,7 +480,7 @@ bool SDLCALL MPG123_decode(void *track_userdata, SDL_AudioStream *stream)
     }
 
     if (amount > 0) {
-        SDL_PutAudioStreamData(stream, buffer, (int)amount);
+        SDL_PutAudioStreamData(stream, tdata->buffer, (int)amount);
     }
 
     if ((result != MPG123_OK) && (result != MPG123_DONE)) {
@@ -422,7 +492,7 @@ bool SDLCALL MPG123_decode(void *track_userdata, SDL_AudioStream *stream)
 
 bool SDLCALL MPG123_seek(void *track_userdata, Uint64 frame)
 {
-    mpg123_handle *handle = (mpg123_handle *) track_userdata;
+    mpg123_handle *handle = ((MPG123_TrackData *) track_userdata)->handle;
     #if (MPG123_API_VERSION >= 49)
     const int64_t rc = mpg123.mpg123_seek64(handle, (int64_t) frame, SEEK_SET);
     #else
@@ -433,14 +503,17 @@ bool SDLCALL MPG123_seek(void *track_userdata, Uint64 frame)
 
 void SDLCALL MPG123_quit_track(void *track_userdata)
 {
-    mpg123_handle *handle = (mpg123_handle *) track_userdata;
-    mpg123.mpg123_close(handle);
-    mpg123.mpg123_delete(handle);
+    MPG123_TrackData *tdata = (MPG123_TrackData *) track_userdata;
+    mpg123.mpg123_close(tdata->handle);
+    mpg123.mpg123_delete(tdata->handle);
+    SDL_free(tdata);
 }
 
 void SDLCALL MPG123_quit_audio(void *audio_userdata)
 {
-    SDL_assert(audio_userdata == NULL);  // no state.
+    MPG123_AudioData *adata = (MPG123_AudioData *) audio_userdata;
+    SDL_free(adata->index_offsets);
+    SDL_free(adata);
 }
 
 MIX_Decoder MIX_Decoder_MPG123 = {
@@ -39,6 +39,7 @@
     MIX_LOADER_FUNCTION(true,const OpusTags *,op_tags,(const OggOpusFile *,int)) \
     MIX_LOADER_FUNCTION(true,OggOpusFile *,op_open_callbacks,(void *,const OpusFileCallbacks *,const unsigned char *,size_t,int *)) \
     MIX_LOADER_FUNCTION(true,OggOpusFile *,op_test_callbacks,(void *,const OpusFileCallbacks *,const unsigned char *,size_t,int *)) \
+    MIX_LOADER_FUNCTION(true,int,op_test_open,(OggOpusFile *)) \
     MIX_LOADER_FUNCTION(true,void,op_free,(OggOpusFile *)) \
     MIX_LOADER_FUNCTION(true,const OpusHead *,op_head,(const OggOpusFile *,int)) \
     MIX_LOADER_FUNCTION(true,int,op_seekable,(const OggOpusFile *)) \
@@ -52,6 +53,9 @@
 #include "SDL_mixer_loader.h"
 
 
+// How much we try to decode per OPUS_decode call: four 20ms Opus frames of stereo (more frames if mono, fewer if surround).
+#define OPUS_DECODE_FLOATS (960 * 4 * 2)
+
 typedef struct OPUS_AudioData
 {
     MIX_OggLoop loop;
@@ -60,11 +64,19 @@ typedef struct OPUS_AudioData
 typedef struct OPUS_TrackData
 {
     const OPUS_AudioData *adata;
+    SDL_IOStream *io;
+    Sint64 start_pos;  // where the Opus data starts in `io`.
     OggOpusFile *of;
+    bool seekable;  // false if `of` was opened without seek callbacks, which skips scanning the whole stream.
     int current_channels;
     int current_bitstream;
+    int pending_frames;  // frames from a new link, decoded at the end of the last call but not sent yet.
+    int pending_channels;
+    int pending_bitstream;
+    int pending_offset;  // where the pending frames start in `samples`.
     Sint64 current_iteration;
     Sint64 current_iteration_frames;
+    float samples[OPUS_DECODE_FLOATS];
 } OPUS_TrackData;
 
 
@@ -126,37 +138,39 @@ static int OPUS_IoClose(void *datasource)
 
 static const OpusFileCallbacks OPUS_IoCallbacks = { OPUS_IoRead, OPUS_IoSeek, OPUS_IoTell, OPUS_IoClose };
 
+// Without a seek callback, libopusfile treats the data as a live stream: it only reads the headers of the first link,
+//  instead of bisecting the whole file to find every link and the total length. That's all a track needs until it seeks;
+//  OPUS_init_audio already figured out everything else.
+static const OpusFileCallbacks OPUS_IoCallbacksStreaming = { OPUS_IoRead, NULL, NULL, OPUS_IoClose };
+
 
 static bool SDLCALL OPUS_init_audio(SDL_IOStream *io, SDL_AudioSpec *spec, SDL_PropertiesID props, Sint64 *duration_frames, void **audio_userdata)
 {
     // just load the bare minimum from the IOStream to verify it's an Opus file.
-    // !!! FIXME: is op_open_callbacks going to return more slowly if this isn't an Opus file? It's probably better to just do the full open.
     int rc = 0;
     OggOpusFile *of = opus.op_test_callbacks(io, &OPUS_IoCallbacks, NULL, 0, &rc);
     if (!of) {
         return SDL_SetError("Not an Opus audio stream");
     }
-    opus.op_free(of);
-
-    // Go back and do a proper load now to get metadata.
-    if (SDL_SeekIO(io, 0, SDL_IO_SEEK_SET) < 0) {
-        return false;
-    }
 
     OPUS_AudioData *adata = (OPUS_AudioData *) SDL_calloc(1, sizeof (*adata));
     if (!adata) {
+        opus.op_free(of);
         return false;
     }
 
-    // now open the stream for serious processing.
-    of = opus.op_open_callbacks(io, &OPUS_IoCallbacks, NULL, 0, &rc);
-    if (!of) {
-        return set_op_error("ov_open_callbacks", rc);
+    // now finish opening the stream for serious processing, without parsing the headers a second time.
+    rc = opus.op_test_open(of);
+    if (rc != 0) {
+        opus.op_free(of);
+        SDL_free(adata);
+        return set_op_error("op_test_open", rc);
     }
 
     const OpusHead *info = opus.op_head(of, -1);
     if (!info) {
         opus.op_free(of);
+        SDL_free(adata);
         return SDL_SetError("Couldn't get Opus info; corrupt data?");
     }
 
@@ -189,6 +203,39 @@ static bool SDLCALL OPUS_init_audio(SDL_IOStream *io, SDL_AudioSpec *spec, SDL_P
     return true;
 }
 
+// (re)open the track's OggOpusFile at the start of the data. Streaming opens are cheap, but can't seek.
+//  If this fails, the old OggOpusFile (if any) can keep decoding from where it was, or it's dropped if it can't.
+static bool OPUS_OpenTrackFile(OPUS_TrackData *tdata, bool seekable)
+{
+    const Sint64 origpos = SDL_TellIO(tdata->io);
+    if ((origpos < 0) || (SDL_SeekIO(tdata->io, tdata->start_pos, SDL_IO_SEEK_SET) < 0)) {
+        return false;
+    }
+
+    int rc = 0;
+    OggOpusFile *of = opus.op_open_callbacks(tdata->io, seekable ? &OPUS_IoCallbacks : &OPUS_IoCallbacksStreaming, NULL, 0, &rc);
+    if (!of) {
+        set_op_error("op_open_callbacks", rc);
+        // a streaming OggOpusFile reads from wherever `io` is, so put it back where the old one left it.
+        if (tdata->of && (SDL_SeekIO(tdata->io, origpos, SDL_IO_SEEK_SET) < 0)) {
+            opus.op_free(tdata->of);
+            tdata->of = NULL;
+            tdata->seekable = false;
+        }
+        return false;
+    }
+
+    if (tdata->of) {
+        opus.op_free(tdata->of);
+    }
+
+    tdata->of = of;
+    tdata->seekable = seekable;
+    tdata->current_bitstream = -1;
+    tdata->pending_frames = 0;
+    return true;
+}
+
 bool SDLCALL OPUS_init_track(void *audio_userdata, SDL_IOStream *io, const SDL_AudioSpec *spec, SDL_PropertiesID props, void **track_userdata)
 {
     OPUS_TrackData *tdata = (OPUS_TrackData *) SDL_calloc(1, sizeof (*tdata));
@@ -198,16 +245,16 @@ bool SDLCALL OPUS_init_track(void *audio_userdata, SDL_IOStream *io, const SDL_A
 
     const OPUS_AudioData *adata = (const OPUS_AudioData *) audio_userdata;
 
-    // now open the stream for serious processing.
-    int rc = 0;
-    tdata->of = opus.op_open_callbacks(io, &OPUS_IoCallbacks, NULL, 0, &rc);
-    if (!tdata->of) {
+    // a loop tag means OPUS_decode will seek from the mixer thread, so do the full, seekable open now instead of
+    //  then. Otherwise, do a cheap streaming open, and we'll do the full one later if something seeks.
+    tdata->io = io;
+    tdata->start_pos = SDL_TellIO(io);
+    if ((tdata->start_pos < 0) || !OPUS_OpenTrackFile(tdata, adata->loop.active)) {
         SDL_free(tdata);
-        return set_op_error("op_open_callbacks", rc);
+        return false;
     }
 
     tdata->current_channels = spec->channels;
-    tdata->current_bitstream = -1;
     tdata->current_iteration = -1;
     tdata->adata = adata;
 
@@ -221,29 +268,65 @@ bool SDLCALL OPUS_seek(void *track_userdata, Uint64 frame);
 bool SDLCALL OPUS_decode(void *track_userdata, SDL_AudioStream *stream)
 {
     OPUS_TrackData *tdata = (OPUS_TrackData *) track_userdata;
+    float *samples = tdata->samples;
+    int amount = 0;
     int bitstream = tdata->current_bitstream;
-    float samples[256];
-
-    const int channels = tdata->current_channels;
-    int amount = (int)opus.op_read_float(tdata->of, samples, SDL_arraysize(samples), &bitstream);
-    if (amount < 0) {
-        return set_op_error("op_read_float", amount);
-    } else if (amount == 0) {
-        return false;  // EOF
+
+    if (!tdata->of) {
+        return false;  // a failed reopen lost our place, so there's nothing left to decode.
     }
 
-    SDL_assert((amount * channels) <= SDL_arraysize(samples));
+    if (tdata->pending_frames > 0) {  // start with what the last call decoded from a new link.
+        amount = tdata->pending_frames;
+        bitstream = tdata->pending_bitstream;
+        SDL_memmove(samples, samples + tdata->pending_offset, amount * tdata->pending_channels * sizeof (float));
+        tdata->pending_frames = 0;
+    }
 
-    if (bitstream != tdata->current_bitstream) {
-        const OpusHead *info = opus.op_head(tdata->of, -1);
-        if (info) {  // this _shouldn't_ be NULL, but if it is, we're just going on without it and hoping the stream format didn't change.
-            if (tdata->current_channels != info->channel_count) {
-                const SDL_AudioSpec spec = { SDL_AUDIO_F32, info->channel_count, 48000 };
-                SDL_SetAudioStreamFormat(stream, &spec, NULL);
-                tdata->current_channels = info->channel_count;
+    // op_read_float gives us at most one Opus packet per call (usually 20ms), so keep going until the buffer is full.
+    while (true) {
+        int channels = tdata->current_channels;
+        if (bitstream != tdata->current_bitstream) {
+            const OpusHead *info = opus.op_head(tdata->of, -1);
+            if (info) {  // this _shouldn't_ be NULL, but if it is, we're just going on without it and hoping the stream format didn't change.
+                if (tdata->current_channels != info->channel_count) {
+                    const SDL_AudioSpec spec = { SDL_AUDIO_F32, info->channel_count, 48000 };
+                    SDL_SetAudioStreamFormat(stream, &spec, NULL);
+                    tdata->current_channels = channels = info->channel_count;
+                }
+            }
+            tdata->current_bitstream = bitstream;
+        }
+
+        const int offset = amount * channels;
+        const int space = OPUS_DECODE_FLOATS - offset;
+        if (space < channels) {
+            break;  // buffer is full.
+        }
+
+        int li = bitstream;
+        const int rc = (int)opus.op_read_float(tdata->of, samples + offset, space, &li);
+        if (rc < 0) {
+            if (amount == 0) {
+                return set_op_error("op_read_float", rc);
+            }
+            break;  // send what we have, we'll hit the error again next time.
+        } else if (rc == 0) {
+            if (amount == 0) {
+                return false;  // EOF
             }
+            break;
+        } else if ((li != bitstream) && (amount > 0)) {  // moved to a new link; the format might change, so hold these for next time.
+            const OpusHead *info = opus.op_head(tdata->of, li);
+            tdata->pending_frames = rc;
+            tdata->pending_channels = info ? info->channel_count : channels;
+            tdata->pending_bitstream = li;
+            tdata->pending_offset = offset;
+            break;
         }
-        tdata->current_bitstream = bitstream;
+
+        amount += rc;
+        bitstream = li;
     }
 
     const MIX_OggLoop *loop = &tdata->adata->loop;
@@ -289,7 +372,7 @@ bool SDLCALL OPUS_decode(void *track_userdata, SDL_AudioStream *stream)
     }
 
     if (amount > 0) {
-        SDL_PutAudioStreamData(stream, samples, amount * tdata->current_channels * sizeof (float));
+        SDL_PutAudioStreamData(stream, samples, amount * tdata->current_channels * (int) sizeof (float));
         tdata->current_iteration_frames += amount;
     }
 
@@ -318,8 +401,19 @@ bool SDLCALL OPUS_seek(void *track_userdata, Uint64 frame)
         }
     }
 
+    if (!tdata->seekable) {
+        // a streaming open can't seek, but reopening one at the start is cheap. Anywhere else needs the full, seekable open.
+        //  The mixer only seeks from its own thread when looping, and OPUS_prepare_seek already made this seekable by
+        //  then, so the reopen always happens on the app's thread.
+        if (!OPUS_OpenTrackFile(tdata, frame != 0)) {
+            return false;
+        }
+    } else {
+        tdata->pending_frames = 0;
+    }
+
     // !!! FIXME: I assume op_raw_seek is faster if we're seeking to start, but I could be wrong.
-    const int rc = (frame == 0) ? opus.op_raw_seek(tdata->of, 0) : opus.op_pcm_seek(tdata->of, (Sint64) frame);
+    const int rc = (frame == 0) ? (tdata->seekable ? opus.op_raw_seek(tdata->of, 0) : 0) : opus.op_pcm_seek(tdata->of, (Sint64) frame);
     if (rc != 0) {
         return set_op_error("op_pcm_seek", rc);
     }
@@ -330,10 +424,25 @@ bool SDLCALL OPUS_seek(void *track_userdata, Uint64 frame)
     return true;
 }
 
+// the track is going to loop, so the mixer will seek from its own thread. Do the full, seekable open now, since
+//  reopening in OPUS_seek would allocate (and scan the file) right there. Once it's seekable, it stays that way.
+static bool SDLCALL OPUS_prepare_seek(void *track_userdata)
+{
+    OPUS_TrackData *tdata = (OPUS_TrackData *) track_userdata;
+    if (tdata->seekable) {
+        return true;
+    }
+    tdata->current_iteration = -1;
+    tdata->current_iteration_frames = 0;
+    return OPUS_OpenTrackFile(tdata, true);  // this starts over at the beginning, but the mixer seeks to the start position right after this.
+}
+
 void SDLCALL OPUS_quit_track(void *track_userdata)
 {
     OPUS_TrackData *tdata = (OPUS_TrackData *) track_userdata;
-    opus.op_free(tdata->of);
+    if (tdata->of) {
+        opus.op_free(tdata->of);
+    }
     SDL_free(tdata);
 }
 
@@ -352,7 +461,12 @@ MIX_Decoder MIX_Decoder_OPUS = {
     OPUS_seek,
     OPUS_quit_track,
     OPUS_quit_audio,
-    OPUS_quit
+    OPUS_quit,
+    NULL,  // decode_into
+    0,  // preferred_frames
+    false,  // exact_seek
+    NULL,  // build_seek_index
+    OPUS_prepare_seek
 };
 
 #endif
@@ -23,7 +23,11 @@
 
 #include "SDL_mixer_internal.h"
 
-// !!! FIXME: change track interface to provide the stream when seeking, and a means to see if we're backed by a memory SDL_IOStream, then we could use SDL_AudioStreamPutDataNoCopy to push the whole buffer upfront for free, and clear/push a subset when seeking.
+// When we're backed by memory, we push everything from the current position to the end of the buffer to the stream in one
+//  SDL_PutAudioStreamDataNoCopy call, which costs nothing. The mixer clears the stream after every seek, so seeking just
+//  moves our position, and the next decode pushes the new subrange.
+// Otherwise, we read from the SDL_IOStream in large blocks.
+#define RAW_READ_SIZE (16 * 1024)
 
 typedef struct RAW_TrackData
 {
@@ -32,6 +36,8 @@ typedef struct RAW_TrackData
     const Uint8 *const_data;
     size_t const_datalen;
     Sint64 position;
+    Uint8 *buffer;  // only allocated if we aren't backed by const_data.
+    size_t buflen;
 } RAW_TrackData;
 
 static bool SDLCALL RAW_init_audio(SDL_IOStream *io, SDL_AudioSpec *spec, SDL_PropertiesID props, Sint64 *duration_frames, void **audio_userdata)
@@ -76,6 +82,15 @@ bool SDLCALL RAW_init_track(void *audio_userdata, SDL_IOStream *io, const SDL_Au
     tdata->framesize = (int) (SDL_AUDIO_FRAMESIZE(*spec));
     tdata->const_data = (const Uint8 *) MIX_GetConstIOBuffer(tdata->io, &tdata->const_datalen);
 
+    if (!tdata->const_data) {
+        tdata->buflen = SDL_max(RAW_READ_SIZE - (RAW_READ_SIZE % tdata->framesize), tdata->framesize);
+        tdata->buffer = (Uint8 *) SDL_malloc(tdata->buflen);
+        if (!tdata->buffer) {
+            SDL_free(tdata);
+            return false;
+        }
+    }
+
     *track_userdata = tdata;
 
     return true;
@@ -84,25 +99,25 @@ bool SDLCALL RAW_init_track(void *audio_userdata, SDL_IOStream *io, const SDL_Au
 bool SDLCALL RAW_decode(void *track_userdata, SDL_AudioStream *stream)
 {
     RAW_TrackData *tdata = (RAW_TrackData *) track_userdata;
-    Uint8 buffer[256];
 
     if (tdata->const_data) {
-        size_t readlen = (size_t) (((Sint64) tdata->const_datalen) - tdata->position);
-        readlen = SDL_min(sizeof (buffer), readlen);
+        // push everything that's left at once. The only limit is SDL_PutAudioStreamDataNoCopy's int length, so huge buffers might take a few calls.
+        size_t readlen = (tdata->position < (Sint64) tdata->const_datalen) ? (size_t) (((Sint64) tdata->const_datalen) - tdata->position) : 0;
+        readlen = SDL_min(readlen, (size_t) SDL_MAX_SINT32);
         readlen -= (readlen % tdata->framesize);
         if (readlen == 0) {
             return false;  // nothing else to read.
+        } else if (!SDL_PutAudioStreamDataNoCopy(stream, tdata->const_data + tdata->position, (int) readlen, NULL, NULL)) {
+            return false;
         }
-        SDL_PutAudioStreamDataNoCopy(stream, tdata->const_data + tdata->position, readlen, NULL, NULL);
         tdata->position += readlen;
     } else {
-        const size_t readlen = sizeof (buffer) - (sizeof (buffer) % tdata->framesize);
-        size_t br = SDL_ReadIO(tdata->io, buffer, readlen);
+        size_t br = SDL_ReadIO(tdata->io, tdata->buffer, tdata->buflen);
         br -= (br % tdata->framesize);
         if (br == 0) {
             return false;  // eof or error, can't supply more data.
         }
-        SDL_PutAudioStreamData(stream, buffer, br);
+        SDL_PutAudioStreamData(stream, tdata->buffer, (int) br);
         tdata->position += br;
     }
 
@@ -122,7 +137,9 @@ bool SDLCALL RAW_seek(void *track_userdata, Uint64 frame)
 
 void SDLCALL RAW_quit_track(void *track_userdata)
 {
-    SDL_free(track_userdata);
+    RAW_TrackData *tdata = (RAW_TrackData *) track_userdata;
+    SDL_free(tdata->buffer);
+    SDL_free(tdata);
 }
 
 void SDLCALL RAW_quit_audio(void *audio_userdata)
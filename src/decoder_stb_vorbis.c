@@ -106,11 +106,13 @@ static bool SetStbVorbisError(const char *function, int error)
 typedef struct STBVORBIS_AudioData
 {
     MIX_OggLoop loop;
+    Uint64 seek_interval;  // sample frames between seek index points. Zero to never build an index.
+    void *seek_index;  // a MIX_OggSeekIndex, built while loading or on a background thread, shared by all tracks. Access atomically!
 } STBVORBIS_AudioData;
 
 typedef struct STBVORBIS_TrackData
 {
-    const STBVORBIS_AudioData *adata;
+    STBVORBIS_AudioData *adata;
     stb_vorbis *vorbis;
     Uint32 skip_samples;
     Sint64 current_iteration;
@@ -174,6 +176,9 @@ static bool SDLCALL STBVORBIS_init_audio(SDL_IOStream *io, SDL_AudioSpec *spec,
     }
     stb_vorbis_close(vorbis);  // done with this instance. Tracks will maintain their own stb_vorbis object.
 
+    const Sint64 seek_interval_ms = SDL_GetNumberProperty(props, MIX_PROP_AUDIO_LOAD_SEEK_INTERVAL_MS_NUMBER, 1000);
+    adata->seek_interval = (seek_interval_ms > 0) ? SDL_max(1, (((Uint64) seek_interval_ms) * spec->freq) / 1000) : 0;
+
     if (adata->loop.active) {
         *duration_frames = (adata->loop.count < 0) ? MIX_DURATION_INFINITE : (full_length * adata->loop.count);
     } else {
@@ -200,7 +205,7 @@ bool SDLCALL STBVORBIS_init_track(void *audio_userdata, SDL_IOStream *io, const
         return SetStbVorbisError("stb_vorbis_open_io", error);
     }
 
-    tdata->adata = (const STBVORBIS_AudioData *) audio_userdata;
+    tdata->adata = (STBVORBIS_AudioData *) audio_userdata;
 
     *track_userdata = tdata;
 
@@ -318,7 +323,41 @@ bool SDLCALL STBVORBIS_seek(void *track_userdata, Uint64 frame)
         }
     }
 
-    const int rc = stb_vorbis_seek_frame(tdata->vorbis, (unsigned int) frame);
+    // stb_vorbis bisects the file between the pages in p_first and p_last. If we have an index, point those at the
+    //  indexed pages around the target, so it only has to search between them. (Rewinding to the start is already fast.)
+    stb_vorbis *vorbis = tdata->vorbis;
+    STBVORBIS_AudioData *adata = tdata->adata;
+    const MIX_OggSeekIndex *index = (frame > 0) ? (const MIX_OggSeekIndex *) SDL_GetAtomicPointer(&adata->seek_index) : NULL;
+    int i = -1;
+    if (index && (stb_vorbis_stream_length_in_samples(vorbis) > 0)) {  // this also makes sure p_last is set up.
+        const Uint32 padding = (Uint32) ((vorbis->blocksize_1 - vorbis->blocksize_0) >> 2);  // stb_vorbis aims this far before the target.
+        i = MIX_FindOggSeekPoint(index, (frame < padding) ? 0 : (frame - padding));
+        if ((i >= 0) && ((index->points[i].offset - (Sint64) vorbis->io_start) < (Sint64) vorbis->p_first.page_start)) {
+            i = -1;  // that's a header page (or the first audio page), let stb_vorbis handle it normally.
+        }
+    }
+
+    int rc;
+    if (i < 0) {
+        rc = stb_vorbis_seek_frame(vorbis, (unsigned int) frame);
+    } else {
+        const ProbedPage first = vorbis->p_first;
+        const ProbedPage last = vorbis->p_last;
+        const MIX_OggSeekPoint *left = &index->points[i];
+        vorbis->p_first.page_start = (uint32) (left->offset - vorbis->io_start);
+        vorbis->p_first.page_end = (uint32) (left->page_end - vorbis->io_start);
+        vorbis->p_first.last_decoded_sample = (uint32) left->granule;
+        if ((i + 1) < index->num_points) {
+            const MIX_OggSeekPoint *right = &index->points[i + 1];
+            vorbis->p_last.page_start = (uint32) (right->offset - vorbis->io_start);
+            vorbis->p_last.page_end = (uint32) (right->page_end - vorbis->io_start);
+            vorbis->p_last.last_decoded_sample = (uint32) right->granule;
+        }
+        rc = stb_vorbis_seek_frame(vorbis, (unsigned int) frame);
+        vorbis->p_first = first;
+        vorbis->p_last = last;
+    }
+
     if (!rc) {
         return SetStbVorbisError("stb_vorbis_seek", stb_vorbis_get_error(tdata->vorbis));
     }
@@ -330,6 +369,12 @@ bool SDLCALL STBVORBIS_seek(void *track_userdata, Uint64 frame)
     return true;
 }
 
+static bool SDLCALL STBVORBIS_build_seek_index(void *audio_userdata, SDL_IOStream *io)
+{
+    STBVORBIS_AudioData *adata = (STBVORBIS_AudioData *) audio_userdata;
+    return MIX_BuildOggSeekIndex(&adata->seek_index, io, adata->seek_interval);
+}
+
 void SDLCALL STBVORBIS_quit_track(void *track_userdata)
 {
     STBVORBIS_TrackData *tdata = (STBVORBIS_TrackData *) track_userdata;
@@ -339,7 +384,9 @@ void SDLCALL STBVORBIS_quit_track(void *track_userdata)
 
 void SDLCALL STBVORBIS_quit_audio(void *audio_userdata)
 {
-    SDL_free(audio_userdata);
+    STBVORBIS_AudioData *adata = (STBVORBIS_AudioData *) audio_userdata;
+    MIX_DestroyOggSeekIndex((MIX_OggSeekIndex *) SDL_GetAtomicPointer(&adata->seek_index));
+    SDL_free(adata);
 }
 
 MIX_Decoder MIX_Decoder_STBVORBIS = {
@@ -351,7 +398,11 @@ MIX_Decoder MIX_Decoder_STBVORBIS = {
     STBVORBIS_seek,
     STBVORBIS_quit_track,
     STBVORBIS_quit_audio,
-    STBVORBIS_quit
+    STBVORBIS_quit,
+    NULL,  // decode_into
+    0,  // preferred_frames
+    false,  // exact_seek
+    STBVORBIS_build_seek_index
 };
 
 #endif
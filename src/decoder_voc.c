@@ -37,18 +37,65 @@
 #define VOC_EXTENDED 8
 #define VOC_DATA_16  9
 
+#define VOC_CODEC_PCM8   0
+#define VOC_CODEC_ADPCM4 1  // Creative 8-bit to 4-bit ADPCM.
+#define VOC_CODEC_ADPCM3 2  // Creative 8-bit to 3-bit ("2.6 bit") ADPCM: two 3-bit codes and one 2-bit code per byte.
+#define VOC_CODEC_ADPCM2 3  // Creative 8-bit to 2-bit ADPCM.
+#define VOC_CODEC_PCM16  4
+
+// every this many bytes of ADPCM data, we save the decoder state, so seeking never has to decode more than one of these from scratch.
+#define VOC_ADPCM_CHECKPOINT_BYTES 1024
+
+typedef struct VOC_ADPCMTable
+{
+    Sint8 delta[4][16];  // [step][code] change to apply to the predictor.
+    Uint8 next_step[4][16];  // [step][code] step to use for the next code.
+} VOC_ADPCMTable;
+
+// 4-bit codes, 3-bit codes, the 2-bit code at the end of a 3-bit byte, and 2-bit codes. Built once in VOC_init.
+static VOC_ADPCMTable VOC_ADPCM_tables[4];
+
+typedef struct VOC_ADPCMState
+{
+    Sint16 sample;  // predictor, as a signed 8-bit value.
+    Uint8 step;
+} VOC_ADPCMState;
+
+typedef struct VOC_ADPCMCheckpoint
+{
+    Uint64 iopos;  // byte position in i/o stream of the next compressed byte.
+    VOC_ADPCMState state;  // decoder state before decoding that byte.
+} VOC_ADPCMCheckpoint;
+
 typedef struct VOC_Block
 {
-    int loop_count;  // 0=data or silence block, >0=loop block of X loops, -1=infinite loop block, -2=endloop block.
-    Uint64 iopos;  // byte position in i/o stream of this block's data. Might be 0 for things like loop and silence blocks.
+    Uint64 iopos;  // byte position in i/o stream of this block's data. 0 for silence blocks.
     SDL_AudioSpec spec;
+    int codec;  // VOC_CODEC_*
     Uint64 frames;
+    Uint64 start_frame;  // where this block starts, counting from the start of its segment.
+    bool has_reference;  // ADPCM only: the first byte is an uncompressed sample that resets the decoder.
+    size_t first_checkpoint;  // ADPCM only: index into VOC_AudioData::checkpoints.
 } VOC_Block;
 
+// LOOP/LOOPEND split the file into segments: runs of blocks that play some number of times before moving on to the next run.
+typedef struct VOC_Segment
+{
+    size_t first_block;
+    size_t num_blocks;
+    Uint64 frames;  // frames in one iteration of this segment.
+    int iterations;  // times to play this segment, -1 for infinite.
+    Uint64 start_frame;  // where this segment starts, counting from the start of the audio, with all loop iterations before it.
+} VOC_Segment;
+
 typedef struct VOC_AudioData
 {
     VOC_Block *blocks;
     size_t num_blocks;
+    VOC_Segment *segments;
+    size_t num_segments;
+    VOC_ADPCMCheckpoint *checkpoints;
+    size_t num_checkpoints;
 } VOC_AudioData;
 
 typedef struct VOC_TrackData
@@ -56,15 +103,158 @@ typedef struct VOC_TrackData
     const VOC_AudioData *adata;
     SDL_IOStream *io;
     SDL_AudioSpec spec;
+    size_t current_segment;
+    int iteration;
     size_t current_block;
-    size_t frame_pos;
-    const VOC_Block *loop_start;
-    int loop_count;
+    bool block_started;
+    Uint64 frame_pos;
+    VOC_ADPCMState adpcm_state;
+    Uint64 adpcm_bytes_left;
+    size_t adpcm_out_pos;
+    size_t adpcm_out_len;
+    Uint8 adpcm_out[VOC_ADPCM_CHECKPOINT_BYTES * 4];
 } VOC_TrackData;
 
 
-static VOC_Block *AddVocBlock(VOC_AudioData *adata)
+static bool VOC_IsADPCM(int codec)
 {
+    return (codec >= VOC_CODEC_ADPCM4) && (codec <= VOC_CODEC_ADPCM2);
+}
+
+static bool VOC_IsSupportedCodec(int codec)
+{
+    // !!! FIXME: there are other formats (a-law, u-law, 16-bit ADPCM), but we don't support them at the moment.
+    return (codec == VOC_CODEC_PCM8) || (codec == VOC_CODEC_PCM16) || VOC_IsADPCM(codec);
+}
+
+static SDL_AudioFormat VOC_CodecFormat(int codec)
+{
+    return (codec == VOC_CODEC_PCM16) ? SDL_AUDIO_S16LE : SDL_AUDIO_U8;   // ADPCM decodes to 8-bit samples.
+}
+
+static int VOC_ADPCMFramesPerByte(int codec)
+{
+    switch (codec) {
+        case VOC_CODEC_ADPCM4: return 2;
+        case VOC_CODEC_ADPCM3: return 3;
+        case VOC_CODEC_ADPCM2: return 4;
+        default: break;
+    }
+    SDL_assert(!"Not an ADPCM codec");
+    return 1;
+}
+
+static void BuildVocADPCMTable(VOC_ADPCMTable *table, int bits, int shift)
+{
+    const int signbit = 1 << (bits - 1);
+    const int threshold = (bits * 2) - 3;  // magnitudes at or above this make the step larger.
+    for (int step = 0; step < 4; step++) {
+        for (int code = 0; code < (1 << bits); code++) {
+            const int magnitude = code & (signbit - 1);
+            const int diff = magnitude << (step + shift);
+            table->delta[step][code] = (Sint8) ((code & signbit) ? -diff : diff);
+            if ((magnitude >= threshold) && (step < 3)) {
+                table->next_step[step][code] = (Uint8) (step + 1);
+            } else if ((magnitude == 0) && (step > 0)) {
+                table->next_step[step][code] = (Uint8) (step - 1);
+            } else {
+                table->next_step[step][code] = (Uint8) step;
+            }
+        }
+    }
+}
+
+static SDL_INLINE Uint8 VOC_ADPCMProcessCode(const VOC_ADPCMTable *table, VOC_ADPCMState *state, Uint8 code)
+{
+    const int step = state->step;
+    const int sample = SDL_clamp(state->sample + table->delta[step][code], -128, 127);
+    state->sample = (Sint16) sample;
+    state->step = table->next_step[step][code];
+    return (Uint8) (sample + 128);
+}
+
+// decodes `srclen` bytes of Creative ADPCM to U8 samples, returns number of samples written to `dst`.
+static size_t VOC_DecodeADPCM(int codec, VOC_ADPCMState *adpcm_state, const Uint8 *src, size_t srclen, Uint8 *dst)
+{
+    VOC_ADPCMState state = *adpcm_state;
+    Uint8 *out = dst;
+
+    switch (codec) {
+        case VOC_CODEC_ADPCM4: {
+            const VOC_ADPCMTable *table = &VOC_ADPCM_tables[0];
+            for (size_t i = 0; i < srclen; i++) {
+                const Uint8 byte = src[i];
+                *(out++) = VOC_ADPCMProcessCode(table, &state, byte >> 4);
+                *(out++) = VOC_ADPCMProcessCode(table, &state, byte & 0xF);
+            }
+            break;
+        }
+
+        case VOC_CODEC_ADPCM3: {
+            const VOC_ADPCMTable *table = &VOC_ADPCM_tables[1];
+            const VOC_ADPCMTable *lasttable = &VOC_ADPCM_tables[2];
+            for (size_t i = 0; i < srclen; i++) {
+                const Uint8 byte = src[i];
+                *(out++) = VOC_ADPCMProcessCode(table, &state, byte >> 5);
+                *(out++) = VOC_ADPCMProcessCode(table, &state, (byte >> 2) & 0x7);
+                *(out++) = VOC_ADPCMProcessCode(lasttable, &state, byte & 0x3);
+            }
+            break;
+        }
+
+        case VOC_CODEC_ADPCM2: {
+            const VOC_ADPCMTable *table = &VOC_ADPCM_tables[3];
+            for (size_t i = 0; i < srclen; i++) {
+                const Uint8 byte = src[i];
+                *(out++) = VOC_ADPCMProcessCode(table, &state, byte >> 6);
+                *(out++) = VOC_ADPCMProcessCode(table, &state, (byte >> 4) & 0x3);
+                *(out++) = VOC_ADPCMProcessCode(table, &state, (byte >> 2) & 0x3);
+                *(out++) = VOC_ADPCMProcessCode(table, &state, byte & 0x3);
+            }
+            break;
+        }
+
+        default:
+            SDL_assert(!"Not an ADPCM codec");
+            break;
+    }
+
+    *adpcm_state = state;
+    return (size_t) (out - dst);
+}
+
+static bool SDLCALL VOC_init(void)
+{
+    BuildVocADPCMTable(&VOC_ADPCM_tables[0], 4, 0);
+    BuildVocADPCMTable(&VOC_ADPCM_tables[1], 3, 0);
+    BuildVocADPCMTable(&VOC_ADPCM_tables[2], 2, 0);
+    BuildVocADPCMTable(&VOC_ADPCM_tables[3], 2, 2);
+    return true;
+}
+
+
+static bool AddVocSegment(VOC_AudioData *adata, int iterations)
+{
+    void *ptr = SDL_realloc(adata->segments, (adata->num_segments + 1) * sizeof (*adata->segments));
+    if (!ptr) {
+        return false;
+    }
+
+    adata->segments = (VOC_Segment *) ptr;
+    VOC_Segment *segment = &adata->segments[adata->num_segments];
+    SDL_zerop(segment);
+    segment->first_block = adata->num_blocks;
+    segment->iterations = iterations;
+    adata->num_segments++;
+    return true;
+}
+
+static VOC_Block *AddVocBlock(VOC_AudioData *adata, Uint64 iopos, const SDL_AudioSpec *spec, int codec, Uint64 frames)
+{
+    if ((adata->num_segments == 0) && !AddVocSegment(adata, 1)) {
+        return NULL;
+    }
+
     void *ptr = SDL_realloc(adata->blocks, (adata->num_blocks + 1) * sizeof (*adata->blocks));
     if (!ptr) {
         return NULL;
@@ -72,61 +262,130 @@ static VOC_Block *AddVocBlock(VOC_AudioData *adata)
 
     adata->blocks = (VOC_Block *) ptr;
     VOC_Block *block = &adata->blocks[adata->num_blocks];
+    VOC_Segment *segment = &adata->segments[adata->num_segments - 1];
     SDL_zerop(block);
+    block->iopos = iopos;
+    SDL_copyp(&block->spec, spec);
+    block->codec = codec;
+    block->frames = frames;
+    block->start_frame = segment->frames;
+    segment->frames += frames;
+    segment->num_blocks++;
     adata->num_blocks++;
     return block;
 }
 
-static VOC_Block *AddVocDataBlock(VOC_AudioData *adata, Sint64 iopos, const SDL_AudioSpec *spec, Uint64 frames)
+// Walk a block of ADPCM data once, saving the decoder state every VOC_ADPCM_CHECKPOINT_BYTES, so seeks can start decoding close to their target.
+//  Returns the number of bytes actually available (the file might be truncated), or -1 on error.
+static Sint64 ScanVocADPCM(SDL_IOStream *io, VOC_AudioData *adata, int codec, Uint64 datalen, VOC_ADPCMState *state)
 {
-    if (iopos < 0) {  // SDL_TellIO failed?
-        return NULL;
+    Sint64 iopos = SDL_TellIO(io);
+    if (iopos < 0) {
+        return -1;
     }
 
-    VOC_Block *block = AddVocBlock(adata);
-    block->iopos = (Uint64) iopos;
-    block->loop_count = 0;
-    SDL_copyp(&block->spec, spec);
-    block->frames = frames;
-    return block;
+    const size_t num_checkpoints = (size_t) SDL_max(1, (datalen + VOC_ADPCM_CHECKPOINT_BYTES - 1) / VOC_ADPCM_CHECKPOINT_BYTES);
+    void *ptr = SDL_realloc(adata->checkpoints, (adata->num_checkpoints + num_checkpoints) * sizeof (*adata->checkpoints));
+    if (!ptr) {
+        return -1;
+    }
+    adata->checkpoints = (VOC_ADPCMCheckpoint *) ptr;
+
+    Uint8 input[VOC_ADPCM_CHECKPOINT_BYTES];
+    Uint8 output[VOC_ADPCM_CHECKPOINT_BYTES * 4];
+    Uint64 available = 0;
+    for (size_t i = 0; i < num_checkpoints; i++) {
+        VOC_ADPCMCheckpoint *checkpoint = &adata->checkpoints[adata->num_checkpoints++];
+        checkpoint->iopos = (Uint64) iopos;
+        SDL_copyp(&checkpoint->state, state);
+
+        const size_t len = (size_t) SDL_min(datalen - available, sizeof (input));
+        const size_t br = (len > 0) ? SDL_ReadIO(io, input, len) : 0;
+        VOC_DecodeADPCM(codec, state, input, br, output);
+        available += br;
+        iopos += (Sint64) br;
+        if (br < len) {
+            break;  // truncated file, just stop here.
+        }
+    }
+
+    return (Sint64) available;
 }
 
-static VOC_Block *AddVocLoopBlock(VOC_AudioData *adata, int loop_count)
+// Adds a block of PCM or ADPCM data; the i/o stream should be at the start of the block's data.
+//  (new_data is true for VOC_DATA and VOC_DATA_16 blocks, where ADPCM data starts with a reference byte, and false for VOC_CONT blocks.)
+static bool AddVocDataBlock(SDL_IOStream *io, VOC_AudioData *adata, const SDL_AudioSpec *spec, int codec, Uint64 datalen, bool new_data, VOC_ADPCMState *adpcm_state)
 {
-    VOC_Block *block = AddVocBlock(adata);
-    if (block) {
-        block->loop_count = loop_count;
+    const Sint64 iopos = SDL_TellIO(io);
+    if (iopos < 0) {  // SDL_TellIO failed?
+        return false;
     }
-    return block;
+
+    if (!VOC_IsADPCM(codec)) {
+        const int framelen = SDL_AUDIO_FRAMESIZE(*spec);
+        return AddVocBlock(adata, (Uint64) iopos, spec, codec, datalen / framelen) != NULL;
+    }
+
+    Uint64 frames = 0;
+    if (new_data) {
+        Uint8 reference;
+        if (datalen == 0) {
+            return SDL_SetError("Corrupt VOC data");
+        } else if (SDL_ReadIO(io, &reference, 1) != 1) {
+            return false;
+        }
+        adpcm_state->sample = ((Sint16) reference) - 128;
+        adpcm_state->step = 0;
+        datalen--;
+        frames++;
+    }
+
+    const size_t first_checkpoint = adata->num_checkpoints;
+    const Sint64 available = ScanVocADPCM(io, adata, codec, datalen, adpcm_state);
+    if (available < 0) {
+        return false;
+    }
+
+    frames += ((Uint64) available) * VOC_ADPCMFramesPerByte(codec);
+
+    VOC_Block *block = AddVocBlock(adata, (Uint64) iopos, spec, codec, frames);
+    if (!block) {
+        return false;
+    }
+    block->has_reference = new_data;
+    block->first_checkpoint = first_checkpoint;
+    return true;
 }
 
 
 // this runs during VOC_audio_init to walk the whole .VOC for metadata and sanity checks.
 static bool ParseVocFile(SDL_IOStream *io, VOC_AudioData *adata, SDL_PropertiesID props, SDL_AudioSpec *spec, Sint64 *duration_frames)
 {
-    Sint64 total_frames = 0;
-    VOC_Block *loop_start = NULL;
-    Sint64 loop_frames = 0;
+    bool in_loop = false;
     SDL_AudioSpec original_spec;
     SDL_AudioSpec current_spec;
+    int current_codec = VOC_CODEC_PCM8;
+    VOC_ADPCMState adpcm_state;
     int text_count = 0;
+    bool done = false;
 
     Sint64 pos = SDL_TellIO(io);
     if (pos < 0) {
         return false;
     }
 
+    SDL_zero(adpcm_state);
     SDL_copyp(&original_spec, spec);
     SDL_copyp(&current_spec, spec);
     spec->format = SDL_AUDIO_UNKNOWN;
 
-    while (true) {
+    while (!done) {
         Uint8 block;
         Uint32 blen = 0;
         if (SDL_ReadIO(io, &block, 1) != 1) {
-            return true;   // assume that's the end of the file.
+            break;   // assume that's the end of the file.
         } else if (block == VOC_TERM) {
-            return true;  // that's the (optional) end.
+            break;  // that's the (optional) end.
         } else if (block != VOC_LOOPEND) {  // TERM and LOOPEND don't have a size field.
             Uint8 bits24[3];
             if (SDL_ReadIO(io, bits24, sizeof(bits24)) != sizeof(bits24)) {
@@ -144,23 +403,22 @@ static bool ParseVocFile(SDL_IOStream *io, VOC_AudioData *adata, SDL_PropertiesI
         switch (block) {
             case VOC_DATA: {
                 Uint8 codec, rateu8;
-                if (SDL_ReadIO(io, &rateu8, 1) != 1) {
+                if (blen < 2) {
+                    return SDL_SetError("Corrupt VOC data");
+                } else if (SDL_ReadIO(io, &rateu8, 1) != 1) {
                     return false;
                 } else if (SDL_ReadIO(io, &codec, 1) != 1) {
                     return false;
-                }
-
-                if ((codec != 0) && (codec != 4)) {  // !!! FIXME: there are other formats (adpcm, etc), but we don't support them at the moment.
+                } else if (!VOC_IsSupportedCodec(codec)) {
                     return SDL_SetError("Unsupported VOC data format");
                 }
 
+                current_codec = (int) codec;
                 current_spec.freq = (int) (1000000 / (256 - rateu8));
                 current_spec.channels = 1;
-                current_spec.format = (codec == 0) ? SDL_AUDIO_U8 : SDL_AUDIO_S16LE;
+                current_spec.format = VOC_CodecFormat(current_codec);
 
-                const int framelen = SDL_AUDIO_FRAMESIZE(current_spec);
-                const Uint64 frames = (Uint64) ((blen - 2) / framelen);
-                if (!AddVocDataBlock(adata, SDL_TellIO(io), &current_spec, frames)) {
+                if (!AddVocDataBlock(io, adata, &current_spec, current_codec, blen - 2, true, &adpcm_state)) {
                     return false;
                 }
 
@@ -168,16 +426,14 @@ static bool ParseVocFile(SDL_IOStream *io, VOC_AudioData *adata, SDL_PropertiesI
                     SDL_copyp(spec, &current_spec);
                 }
 
-                if (total_frames != -1) {
-                    loop_frames += frames;
-                }
-
                 break;
             }
 
             case VOC_DATA_16: {
                 Uint32 rate32;
-                if (!SDL_ReadU32LE(io, &rate32)) {
+                if (blen < 12) {
+                    return SDL_SetError("Corrupt VOC data");
+                } else if (!SDL_ReadU32LE(io, &rate32)) {
                     return false;
                 } else if (rate32 == 0) {
                     return SDL_SetError("VOC sample rate is zero?");
@@ -186,25 +442,29 @@ static bool ParseVocFile(SDL_IOStream *io, VOC_AudioData *adata, SDL_PropertiesI
                 Uint8 bits, channels, codec;
                 if (SDL_ReadIO(io, &bits, 1) != 1) {
                     return false;
-                } else if ((bits != 8) && (bits != 16)) {
-                    return SDL_SetError("Unsupported VOC data format");
                 } else if (SDL_ReadIO(io, &channels, 1) != 1) {   // I assume you have mono or stereo, but we'll let you go wild with whatever.
                     return false;
                 } else if (SDL_ReadIO(io, &codec, 1) != 1) {
                     return false;
-                } else if ((codec != 0) && (codec != 4)) {  // !!! FIXME: there are other formats (adpcm, etc), but we don't support them at the moment.
+                } else if (!VOC_IsSupportedCodec(codec)) {
+                    return SDL_SetError("Unsupported VOC data format");
+                } else if (VOC_IsADPCM(codec) && (channels != 1)) {  // !!! FIXME: stereo ADPCM interleaves the channels' codes, but we don't support it at the moment.
                     return SDL_SetError("Unsupported VOC data format");
-                } else if (((codec == 0) && (bits != 8)) || ((codec == 4) && (bits != 16))) {
+                } else if ((channels == 0) || ((codec == VOC_CODEC_PCM8) && (bits != 8)) || ((codec == VOC_CODEC_PCM16) && (bits != 16))) {
                     return SDL_SetError("Corrupt VOC data");
                 }
 
+                // the rest of the 12-byte header is reserved, skip it.
+                if (SDL_SeekIO(io, pos + 12, SDL_IO_SEEK_SET) < 0) {
+                    return false;
+                }
+
+                current_codec = (int) codec;
                 current_spec.freq = (int) rate32;
                 current_spec.channels = (int) channels;
-                current_spec.format = (codec == 0) ? SDL_AUDIO_U8 : SDL_AUDIO_S16LE;
+                current_spec.format = VOC_CodecFormat(current_codec);
 
-                const int framelen = SDL_AUDIO_FRAMESIZE(current_spec);
-                const Uint64 frames = (Uint64) ((blen - 12) / framelen);
-                if (!AddVocDataBlock(adata, SDL_TellIO(io), &current_spec, frames)) {
+                if (!AddVocDataBlock(io, adata, &current_spec, current_codec, blen - 12, true, &adpcm_state)) {
                     return false;
                 }
 
@@ -212,10 +472,6 @@ static bool ParseVocFile(SDL_IOStream *io, VOC_AudioData *adata, SDL_PropertiesI
                     SDL_copyp(spec, &current_spec);
                 }
 
-                if (total_frames != -1) {
-                    loop_frames += frames;
-                }
-
                 break;
             }
 
@@ -224,15 +480,10 @@ static bool ParseVocFile(SDL_IOStream *io, VOC_AudioData *adata, SDL_PropertiesI
                     return SDL_SetError("VOC continuation block before a data type is set.");
                 }
 
-                const int framelen = SDL_AUDIO_FRAMESIZE(current_spec);
-                const Uint64 frames = (Uint64) (blen / framelen);
-                if (!AddVocDataBlock(adata, SDL_TellIO(io), &current_spec, frames)) {
+                // ADPCM continues from wherever the previous block left the decoder.
+                if (!AddVocDataBlock(io, adata, &current_spec, current_codec, blen, false, &adpcm_state)) {
                     return false;
                 }
-
-                if (total_frames != -1) {
-                    loop_frames += frames;
-                }
                 break;
             }
 
@@ -241,62 +492,36 @@ static bool ParseVocFile(SDL_IOStream *io, VOC_AudioData *adata, SDL_PropertiesI
                 Uint16 frames;
                 if (!SDL_ReadU16LE(io, &frames)) {
                     return false;
-                } else if (!AddVocDataBlock(adata, 0, &current_spec, frames + 1)) {
+                } else if (!AddVocBlock(adata, 0, &current_spec, VOC_CODEC_PCM8, ((Uint64) frames) + 1)) {
                     return false;
                 }
-
-                if (total_frames != -1) {
-                    loop_frames += frames + 1;
-                }
                 break;
             }
 
             case VOC_LOOP: {
                 Uint16 iterations = 0;
 
-                // !!! FIXME: can LOOP/LOOPEND sections nest? https://moddingwiki.shikadi.net/wiki/VOC_Format suggests no, saying LOOPEND goes back to _most recent_ LOOP start.
-                if (loop_start) {
+                // LOOP/LOOPEND sections can't nest; https://moddingwiki.shikadi.net/wiki/VOC_Format says LOOPEND goes back to the _most recent_ LOOP start.
+                if (in_loop) {
                     return SDL_SetError("VOC has nested loop");
                 } else if (!SDL_ReadU16LE(io, &iterations)) {
                     return false;
-                }
-
-                int loop_count = -1;
-                if (iterations == 0xFFFF) {
-                    total_frames = -1;   // it's infinite.
-                } else {
-                    loop_count = ((int) iterations) + 1;
-                }
-
-                if (total_frames != -1) {
-                    total_frames += loop_frames;   // add in anything that's accumulated until now.
-                }
-
-                loop_frames = 0;
-
-                loop_start = AddVocLoopBlock(adata, loop_count);
-                if (!loop_start) {
+                } else if (!AddVocSegment(adata, (iterations == 0xFFFF) ? -1 : (((int) iterations) + 1))) {
                     return false;
                 }
+
+                in_loop = true;
                 break;
             }
 
             case VOC_LOOPEND: {
-                if (!loop_start) {
+                if (!in_loop) {
                     return SDL_SetError("VOC has a LOOPEND without a matching LOOP");
-                }
-
-                VOC_Block *block = AddVocLoopBlock(adata, -2);
-                if (!block) {
+                } else if (!AddVocSegment(adata, 1)) {
                     return false;
                 }
 
-                if (total_frames != -1) {
-                    total_frames += loop_frames * loop_start->loop_count;
-                }
-
-                loop_start = NULL;
-                loop_frames = 0;
+                in_loop = false;
                 break;
             }
 
@@ -307,16 +532,19 @@ static bool ParseVocFile(SDL_IOStream *io, VOC_AudioData *adata, SDL_PropertiesI
                     return false;
                 } else if (SDL_ReadIO(io, &codec, 1) != 1) {
                     return false;
-                } else if ((codec != 0) && (codec != 4)) {  // !!! FIXME: there are other formats (adpcm, etc), but we don't support them at the moment.
+                } else if (!VOC_IsSupportedCodec(codec)) {
                     return SDL_SetError("Unsupported VOC data format");
                 } else if (SDL_ReadIO(io, &channelsu8, 1) != 1) {
                     return false;
+                } else if (VOC_IsADPCM(codec) && (channelsu8 != 0)) {  // !!! FIXME: stereo ADPCM interleaves the channels' codes, but we don't support it at the moment.
+                    return SDL_SetError("Unsupported VOC data format");
                 }
 
                 const int channels = ((int) channelsu8) + 1;
+                current_codec = (int) codec;
                 current_spec.freq = (256000000 / (channels * (65536 - rateu16)));
                 current_spec.channels = channels;
-                current_spec.format = (codec == 0) ? SDL_AUDIO_U8 : SDL_AUDIO_S16LE;
+                current_spec.format = VOC_CodecFormat(current_codec);
 
                 if (spec->format == SDL_AUDIO_UNKNOWN) {
                     SDL_copyp(spec, &current_spec);
@@ -356,19 +584,29 @@ static bool ParseVocFile(SDL_IOStream *io, VOC_AudioData *adata, SDL_PropertiesI
         }
     }
 
-    if (loop_start) {  // !!! FIXME: should we just treat EOF as the loop end in this case?
-        return SDL_SetError("VOC has a LOOP without a matching LOOPEND");
-    }
+    // a LOOP without a matching LOOPEND just loops to the end of the file.
 
     if (spec->format == SDL_AUDIO_UNKNOWN) {  // theoretically this can happen if you only have VOC_SILENCE blocks. Set it to the original device format.
         SDL_copyp(spec, &original_spec);
     }
 
-    if (total_frames != -1) {
-        total_frames += loop_frames;
+    // now that we know every segment's length, figure out where each one starts in the final output, for seeking.
+    Uint64 total_frames = 0;
+    bool infinite = false;
+    for (size_t i = 0; i < adata->num_segments; i++) {
+        VOC_Segment *segment = &adata->segments[i];
+        segment->start_frame = total_frames;
+        if (segment->frames == 0) {
+            segment->iterations = 1;  // don't spin forever on an empty loop.
+        } else if (segment->iterations < 0) {
+            adata->num_segments = i + 1;  // nothing after an infinite loop will ever play.
+            infinite = true;
+            break;
+        }
+        total_frames += segment->frames * segment->iterations;
     }
 
-    *duration_frames = total_frames;
+    *duration_frames = infinite ? MIX_DURATION_INFINITE : (Sint64) total_frames;
 
     return true;
 }
@@ -396,6 +634,8 @@ static bool SDLCALL VOC_init_audio(SDL_IOStream *io, SDL_AudioSpec *spec, SDL_Pr
         return false;
     } else if (!ParseVocFile(io, adata, props, spec, duration_frames)) {
         SDL_free(adata->blocks);
+        SDL_free(adata->segments);
+        SDL_free(adata->checkpoints);
         SDL_free(adata);
         return false;
     }
@@ -422,57 +662,110 @@ bool SDLCALL VOC_init_track(void *audio_userdata, SDL_IOStream *io, const SDL_Au
     return true;
 }
 
+static bool VOC_DecodeADPCMChunk(VOC_TrackData *tdata, const VOC_Block *block)
+{
+    Uint8 input[VOC_ADPCM_CHECKPOINT_BYTES];
+    const size_t len = (size_t) SDL_min(tdata->adpcm_bytes_left, sizeof (input));
+    const size_t br = (len > 0) ? SDL_ReadIO(tdata->io, input, len) : 0;
+    if (br == 0) {
+        return false;  // uhoh.
+    }
+    tdata->adpcm_bytes_left -= br;
+    tdata->adpcm_out_len = VOC_DecodeADPCM(block->codec, &tdata->adpcm_state, input, br, tdata->adpcm_out);
+    tdata->adpcm_out_pos = 0;
+    return true;
+}
+
+// get ready to decode `block`, starting `frame_pos` frames into it.
+static bool VOC_StartBlock(VOC_TrackData *tdata, const VOC_Block *block, Uint64 frame_pos)
+{
+    tdata->block_started = false;
+    tdata->frame_pos = frame_pos;
+    tdata->adpcm_out_pos = tdata->adpcm_out_len = 0;
+
+    if (SDL_memcmp(&tdata->spec, &block->spec, sizeof (tdata->spec)) != 0) {
+        tdata->spec.format = SDL_AUDIO_UNKNOWN;  // we'll set it later.
+    }
+
+    if (block->iopos == 0) {  // silence, nothing to read.
+    } else if (!VOC_IsADPCM(block->codec)) {
+        const int framesize = SDL_AUDIO_FRAMESIZE(block->spec);
+        if (SDL_SeekIO(tdata->io, block->iopos + (frame_pos * framesize), SDL_IO_SEEK_SET) < 0) {
+            return false;  // uhoh.
+        }
+    } else if ((frame_pos == 0) && block->has_reference) {  // the reference byte is the first sample, and resets the decoder.
+        const int fpb = VOC_ADPCMFramesPerByte(block->codec);
+        Uint8 reference;
+        if (SDL_SeekIO(tdata->io, block->iopos, SDL_IO_SEEK_SET) < 0) {
+            return false;  // uhoh.
+        } else if (SDL_ReadIO(tdata->io, &reference, 1) != 1) {
+            return false;  // uhoh.
+        }
+        tdata->adpcm_state.sample = ((Sint16) reference) - 128;
+        tdata->adpcm_state.step = 0;
+        tdata->adpcm_bytes_left = (block->frames - 1) / fpb;
+        tdata->adpcm_out[0] = reference;
+        tdata->adpcm_out_len = 1;
+    } else {  // jump to the nearest checkpoint and decode forward from there.
+        const int fpb = VOC_ADPCMFramesPerByte(block->codec);
+        const Uint64 first_frame = block->has_reference ? 1 : 0;
+        const Uint64 frames_per_checkpoint = VOC_ADPCM_CHECKPOINT_BYTES * fpb;
+        const Uint64 offset = frame_pos - first_frame;
+        const Uint64 checkpoint_index = offset / frames_per_checkpoint;
+        const VOC_ADPCMCheckpoint *checkpoint = &tdata->adata->checkpoints[block->first_checkpoint + checkpoint_index];
+        if (SDL_SeekIO(tdata->io, checkpoint->iopos, SDL_IO_SEEK_SET) < 0) {
+            return false;  // uhoh.
+        }
+        SDL_copyp(&tdata->adpcm_state, &checkpoint->state);
+        tdata->adpcm_bytes_left = ((block->frames - first_frame) / fpb) - (checkpoint_index * VOC_ADPCM_CHECKPOINT_BYTES);
+
+        Uint64 skip = offset % frames_per_checkpoint;
+        if (skip > 0) {
+            // checkpoints land on our chunk boundaries, so this is always exactly one chunk to decode.
+            if (!VOC_DecodeADPCMChunk(tdata, block) || (skip > tdata->adpcm_out_len)) {
+                return false;  // uhoh.
+            }
+            tdata->adpcm_out_pos = (size_t) skip;
+        }
+    }
+
+    tdata->block_started = true;
+    return true;
+}
+
 bool SDLCALL VOC_decode(void *userdata, SDL_AudioStream *stream)
 {
     VOC_TrackData *tdata = (VOC_TrackData *) userdata;
+    const VOC_AudioData *adata = tdata->adata;
 
-    if (tdata->current_block >= tdata->adata->num_blocks) {
+    if (tdata->current_segment >= adata->num_segments) {
         return false;  // EOF.
     }
 
-    const VOC_Block *block = &tdata->adata->blocks[tdata->current_block];
+    const VOC_Segment *segment = &adata->segments[tdata->current_segment];
+    if (tdata->current_block >= (segment->first_block + segment->num_blocks)) {  // done with an iteration of this segment.
+        tdata->block_started = false;
+        if ((segment->iterations < 0) || (++tdata->iteration < segment->iterations)) {
+            tdata->current_block = segment->first_block;  // go around again.
+        } else {
+            tdata->iteration = 0;
+            tdata->current_segment++;  // the next segment's blocks start right after this one's, so current_block is already correct.
+        }
+        return true;  // try again on new block.
+    }
 
-    if (tdata->frame_pos == 0) {  // starting a new block, see what we're doing...
-        if (block->loop_count == 0) {  // it's data.
-            if (block->iopos) {  // have to read actual file data from this block.
-                if (SDL_SeekIO(tdata->io, block->iopos, SDL_IO_SEEK_SET) != block->iopos) {
-                    return false;  // uhoh.
-                }
-            }
-            if (SDL_memcmp(&tdata->spec, &block->spec, sizeof (tdata->spec)) != 0) {
-                tdata->spec.format = SDL_AUDIO_UNKNOWN;  // we'll set it later.
-            }
-        } else if (block->loop_count == -2) {   // it's an endloop block.
-            SDL_assert(tdata->loop_start != NULL);
-            const size_t start_block = (tdata->loop_start - tdata->adata->blocks) + 1;
-            if (tdata->loop_count < 0) {   // infinite loop
-                tdata->current_block = start_block;
-            } else if (tdata->loop_count == 0) {  // last iteration
-                tdata->current_block++;
-                tdata->loop_start = NULL;
-            } else {
-                tdata->loop_count--;
-                tdata->current_block = start_block;
-            }
-            return true;  // try again on new block.
-        } else {  // it's a loop block.
-            SDL_assert(tdata->loop_start == NULL);
-            tdata->loop_start = block;
-            tdata->loop_count = block->loop_count;
-            tdata->current_block++;
-            return true;  // try again on new block.
+    const VOC_Block *block = &adata->blocks[tdata->current_block];
+
+    if (!tdata->block_started) {  // starting a new block, see what we're doing...
+        if (!VOC_StartBlock(tdata, block, 0)) {
+            return false;
         }
     }
-            
-    // still here? Feed data.
+
     SDL_assert(tdata->frame_pos <= block->frames);
     const Uint64 available = block->frames - tdata->frame_pos;
-    Uint8 buffer[512 * sizeof (Uint32)];
-    const int framesize = SDL_AUDIO_FRAMESIZE(block->spec);
-    const Uint64 frames = SDL_min(available, sizeof (buffer) / framesize);
-
-    if (frames == 0) {  // finished this block.
-        tdata->frame_pos = 0;
+    if (available == 0) {  // finished this block.
+        tdata->block_started = false;
         tdata->current_block++;
         return true;  // try again, there might be more data available.
     }
@@ -483,10 +776,22 @@ bool SDLCALL VOC_decode(void *userdata, SDL_AudioStream *stream)
     }
 
     if (block->iopos == 0) {  // zero position means write silence (you can't have a data block at position 0 because of headers, etc).
+        const int frames = (int) SDL_min(available, 2048);
         const void *nullp = NULL;
-        SDL_PutAudioStreamPlanarData(stream, &nullp, 1, (int) frames);   // push silence to the stream.
+        SDL_PutAudioStreamPlanarData(stream, &nullp, 1, frames);   // push silence to the stream.
+        tdata->frame_pos += frames;
+    } else if (VOC_IsADPCM(block->codec)) {
+        if ((tdata->adpcm_out_pos >= tdata->adpcm_out_len) && !VOC_DecodeADPCMChunk(tdata, block)) {
+            return false;  // uhoh.
+        }
+        const int frames = (int) SDL_min(available, tdata->adpcm_out_len - tdata->adpcm_out_pos);
+        SDL_PutAudioStreamData(stream, tdata->adpcm_out + tdata->adpcm_out_pos, frames);  // ADPCM is always mono U8, so frames == bytes.
+        tdata->adpcm_out_pos += frames;
         tdata->frame_pos += frames;
     } else {
+        Uint8 buffer[512 * sizeof (Uint32)];
+        const int framesize = SDL_AUDIO_FRAMESIZE(block->spec);
+        const Uint64 frames = SDL_min(available, sizeof (buffer) / framesize);
         const size_t total = (size_t) (frames * framesize);
         const size_t br = SDL_ReadIO(tdata->io, buffer, total);
         const int frames_read = (int) (br / framesize);
@@ -503,66 +808,67 @@ bool SDLCALL VOC_decode(void *userdata, SDL_AudioStream *stream)
 bool SDLCALL VOC_seek(void *userdata, Uint64 frame)
 {
     VOC_TrackData *tdata = (VOC_TrackData *) userdata;
-    VOC_TrackData cpy;
-
-    SDL_copyp(&cpy, tdata);
-
-    tdata->loop_start = NULL;
-    tdata->loop_count = 0;
-    tdata->frame_pos = 0;
-    tdata->current_block = 0;
+    const VOC_AudioData *adata = tdata->adata;
 
     if (frame == 0) {
-        tdata->spec.format = SDL_AUDIO_UNKNOWN;  // we'll set it later.
+        tdata->current_segment = 0;
+        tdata->iteration = 0;
+        tdata->current_block = 0;
+        tdata->block_started = false;
+        tdata->frame_pos = 0;
         return true;  // easy seek to start.
     }
 
-    const size_t num_blocks = tdata->adata->num_blocks;
-    Uint64 framepos = 0;
-    while (tdata->current_block < num_blocks) {
-        const VOC_Block *block = &tdata->adata->blocks[tdata->current_block];
-        if (block->loop_count == 0) {  // it's data.
-            const int framesize = SDL_AUDIO_FRAMESIZE(block->spec);
-            if (frame < (framepos + block->frames)) {
-                SDL_assert(frame >= framepos);
-                tdata->frame_pos = frame - framepos;
-                if (block->iopos) {  // have to read actual file data from this block.
-                    if (SDL_SeekIO(tdata->io, block->iopos + (tdata->frame_pos * framesize), SDL_IO_SEEK_SET) < 0) {
-                        return false;  // uhoh.
-                    }
-                }
-                if (SDL_memcmp(&tdata->spec, &block->spec, sizeof (tdata->spec)) != 0) {
-                    tdata->spec.format = SDL_AUDIO_UNKNOWN;  // we'll set it later.
-                }
-                return true;  // we're ready!
-            } else {
-                framepos += block->frames;  // not there yet, keep walking through blocks.
-                tdata->current_block++;
-            }
-        } else if (block->loop_count == -2) {   // it's an endloop block.
-            SDL_assert(tdata->loop_start != NULL);
-            const size_t start_block = (tdata->loop_start - tdata->adata->blocks) + 1;
-            if (tdata->loop_count < 0) {   // infinite loop
-                tdata->current_block = start_block;
-            } else if (tdata->loop_count == 0) {  // last iteration
-                tdata->current_block++;
-                tdata->loop_start = NULL;
-            } else {
-                tdata->loop_count--;
-                tdata->current_block = start_block;
-            }
-            // try again on new block.
-        } else {  // it's a loop block.
-            SDL_assert(tdata->loop_start == NULL);
-            tdata->loop_start = block;
-            tdata->loop_count = block->loop_count;
-            tdata->current_block++;
-            // try again on new block.
+    // find the last segment that starts at or before `frame`. Segments are sorted by start_frame, so binary search.
+    //  Blocks (and segments) vary in length, so a fixed-stride frame index would still need a scan from the entry it lands
+    //  on, and it'd cost memory per file; a binary search over the few hundred blocks a large VOC has is already cheap.
+    size_t lo = 0;
+    size_t hi = adata->num_segments;
+    while (lo < hi) {
+        const size_t mid = lo + ((hi - lo) / 2);
+        if (adata->segments[mid].start_frame <= frame) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
         }
     }
 
-    // still here? Seek was past EOF.
-    return false;
+    if (lo == 0) {
+        return false;  // no segments at all, so seek was past EOF.
+    }
+
+    const VOC_Segment *segment = &adata->segments[lo - 1];
+    Uint64 offset = frame - segment->start_frame;
+    if (segment->frames == 0) {
+        return false;  // an empty segment can only be last in line here if the seek was past EOF.
+    }
+
+    const Uint64 iteration = offset / segment->frames;
+    if ((segment->iterations >= 0) && (iteration >= (Uint64) segment->iterations)) {
+        return false;  // seek was past EOF.
+    }
+    offset %= segment->frames;
+
+    // now find the block in this segment that holds `offset`, the same way.
+    lo = segment->first_block;
+    hi = segment->first_block + segment->num_blocks;
+    while (lo < hi) {
+        const size_t mid = lo + ((hi - lo) / 2);
+        if (adata->blocks[mid].start_frame <= offset) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    SDL_assert(lo > segment->first_block);
+    const VOC_Block *block = &adata->blocks[lo - 1];
+    SDL_assert(offset < (block->start_frame + block->frames));
+
+    tdata->current_segment = (size_t) (segment - adata->segments);
+    tdata->iteration = (segment->iterations < 0) ? 0 : (int) iteration;
+    tdata->current_block = lo - 1;
+    return VOC_StartBlock(tdata, block, offset - block->start_frame);
 }
 
 void SDLCALL VOC_quit_track(void *userdata)
@@ -573,14 +879,16 @@ void SDLCALL VOC_quit_track(void *userdata)
 
 void SDLCALL VOC_quit_audio(void *audio_userdata)
 {
-    VOC_AudioData *tdata = (VOC_AudioData *) audio_userdata;
-    SDL_free(tdata->blocks);
-    SDL_free(tdata);
+    VOC_AudioData *adata = (VOC_AudioData *) audio_userdata;
+    SDL_free(adata->blocks);
+    SDL_free(adata->segments);
+    SDL_free(adata->checkpoints);
+    SDL_free(adata);
 }
 
 MIX_Decoder MIX_Decoder_VOC = {
     "VOC",
-    NULL, // init
+    VOC_init,
     VOC_init_audio,
     VOC_init_track,
     VOC_decode,
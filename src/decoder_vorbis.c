@@ -73,11 +73,13 @@ typedef struct VORBIS_AudioData
 {
     size_t framesize;
     MIX_OggLoop loop;
+    Uint64 seek_interval;  // sample frames between seek index points. Zero to never build an index.
+    void *seek_index;  // a MIX_OggSeekIndex, built while loading or on a background thread, shared by all tracks. Access atomically!
 } VORBIS_AudioData;
 
 typedef struct VORBIS_TrackData
 {
-    const VORBIS_AudioData *adata;
+    VORBIS_AudioData *adata;
     OggVorbis_File vf;
     int current_channels;
     int current_freq;
@@ -200,6 +202,9 @@ static bool SDLCALL VORBIS_init_audio(SDL_IOStream *io, SDL_AudioSpec *spec, SDL
 
     vorbis.ov_clear(&vf);  // done with this instance. Tracks will maintain their own OggVorbis_File object.
 
+    const Sint64 seek_interval_ms = SDL_GetNumberProperty(props, MIX_PROP_AUDIO_LOAD_SEEK_INTERVAL_MS_NUMBER, 1000);
+    adata->seek_interval = (seek_interval_ms > 0) ? SDL_max(1, (((Uint64) seek_interval_ms) * spec->freq) / 1000) : 0;
+
     if (adata->loop.active) {
         *duration_frames = (adata->loop.count < 0) ? MIX_DURATION_INFINITE : (full_length * adata->loop.count);
     } else {
@@ -218,7 +223,7 @@ bool SDLCALL VORBIS_init_track(void *audio_userdata, SDL_IOStream *io, const SDL
         return false;
     }
 
-    const VORBIS_AudioData *adata = (const VORBIS_AudioData *) audio_userdata;
+    VORBIS_AudioData *adata = (VORBIS_AudioData *) audio_userdata;
 
     // now open the stream for serious processing.
     int rc = vorbis.ov_open_callbacks(io, &tdata->vf, NULL, 0, VORBIS_IoCallbacks);
@@ -332,6 +337,50 @@ bool SDLCALL VORBIS_decode(void *track_userdata, SDL_AudioStream *stream)
     return true;  // had more data to decode.
 }
 
+// libvorbisfile has no way to hint ov_pcm_seek, so if we have an index, raw-seek to the indexed page before the
+//  target and decode forward from there. Returns false if the index can't help, so the caller can ov_pcm_seek instead.
+static bool VORBIS_SeekWithIndex(VORBIS_TrackData *tdata, Uint64 frame)
+{
+    VORBIS_AudioData *adata = tdata->adata;
+    const MIX_OggSeekIndex *index = (const MIX_OggSeekIndex *) SDL_GetAtomicPointer(&adata->seek_index);
+    if (!index) {
+        return false;
+    }
+
+    // only use it when the target is between two index points, so we never decode forward more than one interval.
+    //  (The index stops at the first chained link, so this keeps us out of later links, too.)
+    const int i = MIX_FindOggSeekPoint(index, frame);
+    if ((i < 0) || ((i + 1) >= index->num_points)) {
+        return false;
+    } else if (vorbis.ov_raw_seek(&tdata->vf, (ogg_int64_t) index->points[i].offset) != 0) {
+        return false;
+    }
+
+    ogg_int64_t pos = vorbis.ov_pcm_tell(&tdata->vf);
+    if ((pos < 0) || (((Uint64) pos) > frame)) {
+        return false;
+    }
+
+    while (((Uint64) pos) < frame) {
+        const int wanted = (int) SDL_min(frame - ((Uint64) pos), 1024);
+        int bitstream = 0;
+        #ifdef VORBIS_USE_TREMOR
+        Uint8 samples[1024];
+        const long br = vorbis.ov_read(&tdata->vf, (char *) samples, (int) SDL_min(sizeof (samples), wanted * adata->framesize), &bitstream);
+        const long amount = (br <= 0) ? br : (long) (br / adata->framesize);
+        #else
+        float **pcm_channels = NULL;
+        const long amount = vorbis.ov_read_float(&tdata->vf, &pcm_channels, wanted, &bitstream);
+        #endif
+        if (amount <= 0) {
+            return false;  // error or EOF before we got there; let ov_pcm_seek sort it out.
+        }
+        pos += amount;
+    }
+
+    return true;
+}
+
 bool SDLCALL VORBIS_seek(void *track_userdata, Uint64 frame)
 {
     VORBIS_TrackData *tdata = (VORBIS_TrackData *) track_userdata;
@@ -355,9 +404,16 @@ bool SDLCALL VORBIS_seek(void *track_userdata, Uint64 frame)
     }
 
     // !!! FIXME: I assume ov_raw_seek is faster if we're seeking to start, but I could be wrong.
-    const int rc = (frame == 0) ? vorbis.ov_raw_seek(&tdata->vf, 0) : vorbis.ov_pcm_seek(&tdata->vf, (ogg_int64_t) frame);
-    if (rc != 0) {
-        return SetOggVorbisError("ov_pcm_seek", rc);
+    if (frame == 0) {
+        const int rc = vorbis.ov_raw_seek(&tdata->vf, 0);
+        if (rc != 0) {
+            return SetOggVorbisError("ov_raw_seek", rc);
+        }
+    } else if (!VORBIS_SeekWithIndex(tdata, frame)) {
+        const int rc = vorbis.ov_pcm_seek(&tdata->vf, (ogg_int64_t) frame);
+        if (rc != 0) {
+            return SetOggVorbisError("ov_pcm_seek", rc);
+        }
     }
 
     tdata->current_iteration = final_iteration;
@@ -366,6 +422,12 @@ bool SDLCALL VORBIS_seek(void *track_userdata, Uint64 frame)
     return true;
 }
 
+static bool SDLCALL VORBIS_build_seek_index(void *audio_userdata, SDL_IOStream *io)
+{
+    VORBIS_AudioData *adata = (VORBIS_AudioData *) audio_userdata;
+    return MIX_BuildOggSeekIndex(&adata->seek_index, io, adata->seek_interval);
+}
+
 void SDLCALL VORBIS_quit_track(void *track_userdata)
 {
     VORBIS_TrackData *tdata = (VORBIS_TrackData *) track_userdata;
@@ -375,7 +437,9 @@ void SDLCALL VORBIS_quit_track(void *track_userdata)
 
 void SDLCALL VORBIS_quit_audio(void *audio_userdata)
 {
-    SDL_free(audio_userdata);
+    VORBIS_AudioData *adata = (VORBIS_AudioData *) audio_userdata;
+    MIX_DestroyOggSeekIndex((MIX_OggSeekIndex *) SDL_GetAtomicPointer(&adata->seek_index));
+    SDL_free(adata);
 }
 
 MIX_Decoder MIX_Decoder_VORBIS = {
@@ -387,7 +451,11 @@ MIX_Decoder MIX_Decoder_VORBIS = {
     VORBIS_seek,
     VORBIS_quit_track,
     VORBIS_quit_audio,
-    VORBIS_quit
+    VORBIS_quit,
+    NULL,  // decode_into
+    0,  // preferred_frames
+    false,  // exact_seek
+    VORBIS_build_seek_index
 };
 
 #endif
@@ -141,7 +141,14 @@ typedef struct ADPCM_DecoderState
 
     void *cstate;           // Decoding state for each channel.
 
-    // Current ADPCM block
+    // Raw ADPCM blocks, read several at a time.
+    struct
+    {
+        Uint8 *data;
+        size_t size;
+    } input;
+
+    // Current ADPCM block (points into `input`).
     struct
     {
         Uint8 *data;
@@ -159,6 +166,9 @@ typedef struct ADPCM_DecoderState
     } output;
 } ADPCM_DecoderState;
 
+// how many bytes of ADPCM blocks to read and decode at once (at least one block, though).
+#define ADPCM_READ_SIZE 4096
+
 typedef struct MS_ADPCM_ChannelState
 {
     Uint16 delta;
@@ -209,6 +219,8 @@ struct WAV_TrackData
     const WAVSeekBlock *seekblock;  // current seekblock we're decoding.
     Uint32 current_iteration;        // current loop iteration in seekblock
     Uint32 current_iteration_frames;  // current framecount into seekblock.
+    const Uint8 *const_data;  // non-NULL if this is plain PCM in const memory, so we can give it to the audio stream without copying.
+    size_t const_datalen;
 };
 
 static bool IsADPCM(const Uint16 encoding)
@@ -506,63 +518,16 @@ static bool IMA_ADPCM_Init(ADPCM_DecoderInfo *info, const Uint8 *chunk_data, Uin
     return true;
 }
 
-static Sint16 IMA_ADPCM_ProcessNibble(Sint8 *cindex, Sint16 lastsample, Uint8 nybble)
+static Sint16 IMA_ADPCM_ProcessNibble(const MIX_IMAADPCMTables *tables, Uint8 *cindex, Sint16 lastsample, Uint8 nybble)
 {
     const Sint32 max_audioval = 32767;
     const Sint32 min_audioval = -32768;
-    static const Sint8 index_table_4b[16] = {
-        -1, -1, -1, -1,
-        2, 4, 6, 8,
-        -1, -1, -1, -1,
-        2, 4, 6, 8
-    };
-    static const Uint16 step_table[89] = {
-        7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31,
-        34, 37, 41, 45, 50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130,
-        143, 157, 173, 190, 209, 230, 253, 279, 307, 337, 371, 408,
-        449, 494, 544, 598, 658, 724, 796, 876, 963, 1060, 1166, 1282,
-        1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327,
-        3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630,
-        9493, 10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350,
-        22385, 24623, 27086, 29794, 32767
-    };
-
-    Sint8 index = *cindex;
-
-    // Clamp index into valid range.
-    if (index > 88) {
-        index = 88;
-    } else if (index < 0) {
-        index = 0;
-    }
-
-    // explicit cast to avoid gcc warning about using 'char' as array index
-    const Uint32 step = step_table[(size_t)index];
+    const Uint8 index = *cindex;
 
     // Update index value
-    *cindex = index + index_table_4b[nybble];
+    *cindex = tables->next_index[index][nybble];
 
-    /* This calculation uses shifts and additions because multiplications were
-     * much slower back then. Sadly, this can't just be replaced with an actual
-     * multiplication now as the old algorithm drops some bits. The closest
-     * approximation I could find is something like this:
-     * (nybble & 0x8 ? -1 : 1) * ((nybble & 0x7) * step / 4 + step / 8)
-     */
-    Sint32 delta = step >> 3;
-    if (nybble & 0x04) {
-        delta += step;
-    }
-    if (nybble & 0x02) {
-        delta += step >> 1;
-    }
-    if (nybble & 0x01) {
-        delta += step >> 2;
-    }
-    if (nybble & 0x08) {
-        delta = -delta;
-    }
-
-    Sint32 sample = lastsample + delta;
+    Sint32 sample = lastsample + tables->delta[index][nybble];
 
     // Clamp output sample
     if (sample > max_audioval) {
@@ -593,9 +558,9 @@ static bool IMA_ADPCM_DecodeBlockHeader(ADPCM_DecoderState *state)
         }
         state->output.data[state->output.pos++] = (Sint16)sample;
 
-        // Channel step index.
+        // Channel step index (a signed byte, clamped into the valid range).
         const Sint16 step = (Sint16)state->block.data[o + 2];
-        cstate[c] = (Sint8)(step > 0x80 ? step - 0x100 : step);
+        cstate[c] = (Uint8)SDL_clamp(step > 0x80 ? step - 0x100 : step, 0, 88);
 
         // Reserved byte in block header, should be 0.
         if (state->block.data[o + 3] != 0) {
@@ -642,6 +607,8 @@ static bool IMA_ADPCM_DecodeBlockData(ADPCM_DecoderState *state)
      * decodes the samples as they come from the input data and puts them at
      * the appropriate places in the output data.
      */
+    const MIX_IMAADPCMTables *tables = &MIX_IMAADPCM_tables;  // built in WAV_init.
+    Uint8 *cstate = (Uint8 *)state->cstate;
     while (blockframesleft > 0) {
         const size_t subblocksamples = blockframesleft < 8 ? (size_t)blockframesleft : 8;
 
@@ -657,7 +624,7 @@ static bool IMA_ADPCM_DecodeBlockData(ADPCM_DecoderState *state)
                     nybble = state->block.data[blockpos++];
                 }
 
-                sample = IMA_ADPCM_ProcessNibble((Sint8 *)state->cstate + c, sample, nybble & 0x0f);
+                sample = IMA_ADPCM_ProcessNibble(tables, cstate + c, sample, nybble & 0x0f);
                 state->output.data[outpos + c + i * channels] = sample;
             }
         }
@@ -680,53 +647,70 @@ static void ADPCM_InfoCleanup(ADPCM_DecoderInfo *info)
 static void ADPCM_StateCleanup(ADPCM_DecoderState *state)
 {
     SDL_free(state->cstate);
-    SDL_free(state->block.data);
+    SDL_free(state->input.data);
     SDL_free(state->output.data);
 }
 
 typedef bool (*ADPCM_DecodeBlockFn)(ADPCM_DecoderState *state);
 
-static int FetchADPCM(WAV_TrackData *tdata, Uint8 *buffer, int buflen, ADPCM_DecodeBlockFn DecodeBlockHeader, ADPCM_DecodeBlockFn DecodeBlockData)
+// Read and decode as many ADPCM blocks as fit in the track's buffers, so we aren't going back to the IOStream (and
+//  setting up a block) for every few hundred samples. Returns false if there was nothing left to decode.
+static bool DecodeADPCMBlocks(WAV_TrackData *tdata)
 {
+    const WAV_AudioData *adata = tdata->adata;
     ADPCM_DecoderState *state = &tdata->adpcm_state;
     const ADPCM_DecoderInfo *info = state->info;
-    size_t left = (size_t)buflen;
-    Uint8 *dst = buffer;
+    const bool is_ms = (adata->encoding == MS_ADPCM_CODE);
+    const ADPCM_DecodeBlockFn DecodeBlockHeader = is_ms ? MS_ADPCM_DecodeBlockHeader : IMA_ADPCM_DecodeBlockHeader;
+    const ADPCM_DecodeBlockFn DecodeBlockData = is_ms ? MS_ADPCM_DecodeBlockData : IMA_ADPCM_DecodeBlockData;
 
-    while (left > 0) {
-        if (state->output.read == state->output.pos) {
-            size_t bytesread = SDL_ReadIO(tdata->io, state->block.data, info->blocksize);
-            if (bytesread == 0) {
-                return buflen - left;
-            }
+    state->output.pos = 0;
+    state->output.read = 0;
+
+    const Sint64 pos = SDL_TellIO(tdata->io);
+    const Sint64 available = (pos < 0) ? 0 : (adata->stop - pos);  // don't decode whatever chunks follow the sound data.
+    if (available <= 0) {
+        return false;
+    }
 
-            state->block.size = (bytesread < info->blocksize) ? bytesread : info->blocksize;
-            state->block.pos = 0;
-            state->output.pos = 0;
-            state->output.read = 0;
+    const size_t bytesread = SDL_ReadIO(tdata->io, state->input.data, (size_t)SDL_min((Sint64)state->input.size, available));
+    for (size_t offset = 0; offset < bytesread; offset += info->blocksize) {
+        state->block.data = state->input.data + offset;
+        state->block.size = SDL_min(info->blocksize, bytesread - offset);
+        state->block.pos = 0;
 
-            if (!DecodeBlockHeader(state) || !DecodeBlockData(state)) {
-                return -1;
-            }
+        // a short block (at the end of the data, hopefully) decodes what it can and then we're done.
+        if (!DecodeBlockHeader(state) || !DecodeBlockData(state)) {
+            break;
         }
-        const size_t len = SDL_min(left, (state->output.pos - state->output.read) * sizeof(Sint16));
-        SDL_memcpy(dst, &state->output.data[state->output.read], len);
-        state->output.read += (len / sizeof(Sint16));
-        dst += len;
-        left -= len;
     }
 
-    return buflen;
+    return (state->output.pos > 0);
 }
 
-static int FetchMSADPCM(WAV_TrackData *tdata, Uint8 *buffer, int buflen)
+static int FetchADPCM(WAV_TrackData *tdata, Uint8 *buffer, int buflen)
 {
-    return FetchADPCM(tdata, buffer, buflen, MS_ADPCM_DecodeBlockHeader, MS_ADPCM_DecodeBlockData);
-}
+    ADPCM_DecoderState *state = &tdata->adpcm_state;
+    float *dst = (float *)buffer;
+    size_t left = (size_t)buflen / sizeof(float);
 
-static int FetchIMAADPCM(WAV_TrackData *tdata, Uint8 *buffer, int buflen)
-{
-    return FetchADPCM(tdata, buffer, buflen, IMA_ADPCM_DecodeBlockHeader, IMA_ADPCM_DecodeBlockData);
+    while (left > 0) {
+        if ((state->output.read == state->output.pos) && !DecodeADPCMBlocks(tdata)) {
+            break;
+        }
+
+        // we decode to Sint16, since that's what the format specifies and the predictors need, but hand out float32.
+        const size_t total = SDL_min(left, state->output.pos - state->output.read);
+        const Sint16 *src = &state->output.data[state->output.read];
+        for (size_t i = 0; i < total; i++) {
+            dst[i] = ((float)src[i]) * (1.0f / 32768.0f);
+        }
+        state->output.read += total;
+        dst += total;
+        left -= total;
+    }
+
+    return buflen - (int)(left * sizeof(float));
 }
 
 static int FetchXLaw(WAV_TrackData *tdata, Uint8 *buffer, int buflen, const float *lut)
@@ -853,14 +837,14 @@ static bool ParseFMT(WAV_AudioData *adata, SDL_IOStream *io, SDL_AudioSpec *spec
             adata->fetch = FetchALaw;
             break;
         case MS_ADPCM_CODE:
-            adata->fetch = FetchMSADPCM;
+            adata->fetch = FetchADPCM;
             if (!MS_ADPCM_Init(&adata->adpcm_info, chunk, chunk_length)) {
                 SDL_free(chunk);
                 return false;
             }
             break;
         case IMA_ADPCM_CODE:
-            adata->fetch = FetchIMAADPCM;
+            adata->fetch = FetchADPCM;
             if (!IMA_ADPCM_Init(&adata->adpcm_info, chunk, chunk_length)) {
                 SDL_free(chunk);
                 return false;
@@ -882,8 +866,8 @@ static bool ParseFMT(WAV_AudioData *adata, SDL_IOStream *io, SDL_AudioSpec *spec
     switch (bits) {
         case 4:
             switch(adata->encoding) {
-            case MS_ADPCM_CODE: spec->format = SDL_AUDIO_S16; break;
-            case IMA_ADPCM_CODE: spec->format = SDL_AUDIO_S16; break;
+            case MS_ADPCM_CODE: spec->format = SDL_AUDIO_F32; break;   // FetchADPCM converts as it goes.
+            case IMA_ADPCM_CODE: spec->format = SDL_AUDIO_F32; break;
             default: unknown_bits = true; break;
             }
             break;
@@ -1299,6 +1283,12 @@ static bool WAV_init_audio_internal(WAV_AudioData *adata, SDL_IOStream *io, SDL_
     return true;
 }
 
+static bool SDLCALL WAV_init(void)
+{
+    MIX_BuildIMAADPCMTables(&MIX_IMAADPCM_tables);  // shared by every IMA ADPCM file (and AIFF-C's ima4).
+    return true;
+}
+
 static void SDLCALL WAV_quit_audio(void *audio_userdata);
 
 static bool SDLCALL WAV_init_audio(SDL_IOStream *io, SDL_AudioSpec *spec, SDL_PropertiesID props, Sint64 *duration_frames, void **audio_userdata)
@@ -1356,13 +1346,17 @@ static bool SDLCALL WAV_init_track(void *audio_userdata, SDL_IOStream *io, const
     tdata->current_iteration = 0;
     tdata->current_iteration_frames = 0;
 
+    if (adata->fetch == FetchPCM) {  // no conversion needed? We can use the data right where it sits if it's in memory.
+        tdata->const_data = (const Uint8 *) MIX_GetConstIOBuffer(io, &tdata->const_datalen);
+    }
+
     ADPCM_DecoderState *state = &tdata->adpcm_state;
     state->info = &adata->adpcm_info;
     if (IsADPCM(adata->encoding)) {
         if (adata->encoding == MS_ADPCM_CODE) {
             state->cstate = SDL_calloc(state->info->channels, sizeof(MS_ADPCM_ChannelState));
         } else if (adata->encoding == IMA_ADPCM_CODE) {
-            state->cstate = SDL_calloc(state->info->channels, sizeof(Sint8));
+            state->cstate = SDL_calloc(state->info->channels, sizeof(Uint8));
         } else {
             SDL_assert(!"WAV: Unexpected ADPCM encoding");
         }
@@ -1372,18 +1366,19 @@ static bool SDLCALL WAV_init_track(void *audio_userdata, SDL_IOStream *io, const
             return false;
         }
 
-        state->block.size = adata->adpcm_info.blocksize;
-        state->block.data = (Uint8 *)SDL_calloc(1, state->block.size);
-        if (!state->block.data) {
+        const size_t num_blocks = SDL_max(1, ADPCM_READ_SIZE / adata->adpcm_info.blocksize);
+        state->input.size = num_blocks * adata->adpcm_info.blocksize;
+        state->input.data = (Uint8 *)SDL_calloc(1, state->input.size);
+        if (!state->input.data) {
             SDL_free(state->cstate);
             SDL_free(tdata);
             return false;
         }
 
-        state->output.size = state->info->samplesperblock * state->info->channels;
+        state->output.size = num_blocks * state->info->samplesperblock * state->info->channels;
         state->output.data = (Sint16 *)SDL_calloc(sizeof(Sint16), state->output.size);
         if (!state->output.data) {
-            SDL_free(state->block.data);
+            SDL_free(state->input.data);
             SDL_free(state->cstate);
             SDL_free(tdata);
             return false;
@@ -1397,12 +1392,11 @@ static bool SDLCALL WAV_init_track(void *audio_userdata, SDL_IOStream *io, const
 
 static bool SDLCALL WAV_seek(void *track_userdata, Uint64 frame);
 
-static bool SDLCALL WAV_decode(void *track_userdata, SDL_AudioStream *stream)
+// see if we are at the end of a loop, etc, and move to the right place if so. Returns false if there's nothing left to play.
+static bool WAV_UpdateSeekBlock(WAV_TrackData *tdata)
 {
-    WAV_TrackData *tdata = (WAV_TrackData *) track_userdata;
     const WAVSeekBlock *seekblock = tdata->seekblock;
 
-    // see if we are at the end of a loop, etc.
     SDL_assert(tdata->current_iteration_frames <= seekblock->num_frames);
     while (tdata->current_iteration_frames == seekblock->num_frames) {
         //SDL_Log("Decoded to the end of a seekblock! (iteration %d of %d)", (int) tdata->current_iteration, (int) seekblock->iterations);
@@ -1445,11 +1439,42 @@ static bool SDLCALL WAV_decode(void *track_userdata, SDL_AudioStream *stream)
         tdata->current_iteration_frames = 0;
     }
 
+    return true;
+}
+
+static bool SDLCALL WAV_decode(void *track_userdata, SDL_AudioStream *stream)
+{
+    WAV_TrackData *tdata = (WAV_TrackData *) track_userdata;
+    if (!WAV_UpdateSeekBlock(tdata)) {
+        return false;
+    }
+
+    const WAVSeekBlock *seekblock = tdata->seekblock;
     const int decoded_framesize = tdata->adata->decoded_framesize;
     const Uint64 available_bytes = (seekblock->num_frames - tdata->current_iteration_frames) * decoded_framesize;
 
+    if (tdata->const_data) {  // memory-backed PCM? Push the rest of this seekblock in one shot, without copying it.
+        const Sint64 pos = SDL_TellIO(tdata->io);
+        if ((pos < 0) || (pos >= tdata->adata->stop) || (((size_t) pos) >= tdata->const_datalen)) {
+            return false;
+        }
+        Uint64 spanlen = SDL_min(available_bytes, (Uint64) (tdata->adata->stop - pos));
+        spanlen = SDL_min(spanlen, (Uint64) (tdata->const_datalen - ((size_t) pos)));
+        spanlen = SDL_min(spanlen, SDL_MAX_SINT32);  // if it's ridiculously huge, we'll get the rest on the next decode.
+        spanlen -= spanlen % decoded_framesize;
+        if (spanlen == 0) {
+            return false;
+        } else if (SDL_SeekIO(tdata->io, (Sint64) spanlen, SDL_IO_SEEK_CUR) < 0) {
+            return false;
+        }
+        SDL_PutAudioStreamDataNoCopy(stream, tdata->const_data + pos, (int) spanlen, NULL, NULL);
+        tdata->current_iteration_frames += (Uint32) (spanlen / decoded_framesize);
+        SDL_assert(tdata->current_iteration_frames <= seekblock->num_frames);
+        return true;
+    }
+
     // !!! FIXME: looping.
-    Uint8 buffer[1024];
+    float buffer[256];  // (float, so the fetchers that convert to float32 get aligned memory.)
     int buflen = (int) sizeof (buffer);
     const int mod = buflen % decoded_framesize;
     if (mod) {
@@ -1459,7 +1484,7 @@ static bool SDLCALL WAV_decode(void *track_userdata, SDL_AudioStream *stream)
     buflen = SDL_min(buflen, available_bytes);
     SDL_assert(buflen > 0);  // we should have caught this in the seekblock code.
 
-    const int br = tdata->adata->fetch(tdata, buffer, buflen);  // this will deal with different formats that might need decompression or conversion.
+    const int br = tdata->adata->fetch(tdata, (Uint8 *) buffer, buflen);  // this will deal with different formats that might need decompression or conversion.
     //SDL_Log("Requested %d bytes, read %d bytes (%d frames)!", buflen, br, br / decoded_framesize);
     if (br <= 0) {
         return false;
@@ -1473,6 +1498,29 @@ static bool SDLCALL WAV_decode(void *track_userdata, SDL_AudioStream *stream)
     return true;
 }
 
+// this only gets used for formats we decode to float32 (ADPCM, float, a-law, etc), so the fetchers write straight into `dst`.
+static int SDLCALL WAV_decode_into(void *track_userdata, float *dst, int frames)
+{
+    WAV_TrackData *tdata = (WAV_TrackData *) track_userdata;
+    if (!WAV_UpdateSeekBlock(tdata)) {
+        return -1;
+    }
+
+    const int decoded_framesize = tdata->adata->decoded_framesize;
+    const Sint64 available_frames = tdata->seekblock->num_frames - tdata->current_iteration_frames;
+    const int buflen = (int) SDL_min(frames, available_frames) * decoded_framesize;
+    SDL_assert(buflen > 0);  // we should have caught this in the seekblock code.
+
+    const int br = tdata->adata->fetch(tdata, (Uint8 *) dst, buflen);
+    if (br <= 0) {
+        return -1;
+    }
+
+    tdata->current_iteration_frames += (br / decoded_framesize);
+    SDL_assert(tdata->current_iteration_frames <= tdata->seekblock->num_frames);
+    return br / decoded_framesize;
+}
+
 static bool FindWAVSeekBlock(const WAVSeekBlock *seekblocks, int num_seekblocks, Uint64 ui64frame, const WAVSeekBlock **result)
 {
     SDL_assert(seekblocks != NULL);
@@ -1530,17 +1578,16 @@ static bool SDLCALL WAV_seek(void *track_userdata, Uint64 frame)
             return false;
         }
 
-        tdata->adpcm_state.output.pos = tdata->adpcm_state.output.read = 0;  // reset this for the new block.
+        ADPCM_DecoderState *state = &tdata->adpcm_state;
+        state->output.pos = state->output.read = 0;  // reset this for the new block.
 
-        // We're at the start of the right ADPCM block now; decode and throw away until we hit the exact frame we want to seek to.
-        int remainder = ((int)(frame % adata->adpcm_info.samplesperblock)) * adata->decoded_framesize;
-        while (remainder > 0) {
-            Uint8 buffer[1024];
-            const int br = adata->fetch(tdata, buffer, SDL_min(remainder, sizeof (buffer)));
-            if (br <= 0) {
+        // We're at the start of the right ADPCM block now; decode it and skip ahead in the output to the exact frame we want to seek to.
+        const size_t skip = ((size_t)(frame % adata->adpcm_info.samplesperblock)) * adata->adpcm_info.channels;
+        if (skip > 0) {
+            if (!DecodeADPCMBlocks(tdata) || (skip > state->output.pos)) {
                 return false;
             }
-            remainder -= br;
+            state->output.read = skip;
         }
     } else {
         const Sint64 dest_offset = (Sint64)frame * adata->framesize;
@@ -1577,14 +1624,17 @@ static void SDLCALL WAV_quit_audio(void *audio_userdata)
 
 MIX_Decoder MIX_Decoder_WAV = {
     "WAV",
-    NULL,  // init
+    WAV_init,
     WAV_init_audio,
     WAV_init_track,
     WAV_decode,
     WAV_seek,
     WAV_quit_track,
     WAV_quit_audio,
-    NULL  // quit
+    NULL,  // quit
+    WAV_decode_into,
+    4096,  // preferred_frames
+    true  // exact_seek
 };
 
 #endif
@@ -50,6 +50,7 @@ struct xmp_callbacks {
     MIX_LOADER_FUNCTION(true,xmp_context,xmp_create_context,(void)) \
     MIX_LOADER_FUNCTION(false,int,xmp_test_module_from_callbacks,(void *, struct xmp_callbacks, struct xmp_test_info *)) \
     MIX_LOADER_FUNCTION(true,int,xmp_load_module_from_callbacks,(xmp_context, void *, struct xmp_callbacks)) \
+    MIX_LOADER_FUNCTION(true,int,xmp_load_module_from_memory,(xmp_context, LIBXMP_CONST void *, long)) \
     MIX_LOADER_FUNCTION(true,int,xmp_start_player,(xmp_context, int, int)) \
     MIX_LOADER_FUNCTION(true,void,xmp_end_player,(xmp_context)) \
     MIX_LOADER_FUNCTION(true,void,xmp_get_module_info,(xmp_context, struct xmp_module_info *)) \
@@ -99,13 +100,29 @@ static bool SetLibXmpError(const char *function, int error)
     return SDL_SetError("%s: unknown error %d", function, error);
 }
 
+typedef struct XMP_AudioData
+{
+    // libxmp can't share a loaded module between contexts, but we can reuse a context that already has the module loaded:
+    //  tracks put theirs back here when they're done, for the next track to pick up. It's only kept while other tracks
+    //  are still playing this audio, so an idle MIX_Audio doesn't hold on to a parsed module. Access atomically!
+    void *spare_ctx;
+    SDL_AtomicInt active_tracks;
+} XMP_AudioData;
+
 typedef struct XMP_TrackData
 {
+    XMP_AudioData *adata;
     int freq;
     xmp_context ctx;
 } XMP_TrackData;
 
 
+static void FreeXmpContext(xmp_context ctx)
+{
+    libxmp.xmp_release_module(ctx);
+    libxmp.xmp_free_context(ctx);
+}
+
 static bool SDLCALL XMP_init(void)
 {
     return LoadModule_libxmp();
@@ -141,7 +158,7 @@ static bool SDLCALL XMP_init_audio(SDL_IOStream *io, SDL_AudioSpec *spec, SDL_Pr
     err = libxmp.xmp_load_module_from_callbacks(ctx, io, XMP_IoCallbacks);
     if (err) {
         libxmp.xmp_free_context(ctx);
-        return SetLibXmpError("xmp_load_module_from_memory", err);
+        return SetLibXmpError("xmp_load_module_from_callbacks", err);
     }
 
     struct xmp_module_info info;
@@ -166,38 +183,34 @@ static bool SDLCALL XMP_init_audio(SDL_IOStream *io, SDL_AudioSpec *spec, SDL_Pr
         }
     }
 
-    // !!! FIXME: is this necessary?
-    err = libxmp.xmp_start_player(ctx, spec->freq, 0);  // start this running at device sample rate, so we can calculate total_time.
-    if (err) {
-        libxmp.xmp_release_module(ctx);
-        libxmp.xmp_free_context(ctx);
-        return SetLibXmpError("xmp_start_player", err);
+    // libxmp scans the module's sequences while loading it, so the duration of the first one (what the player starts on) is already known.
+    //  No need to start a player to get it.
+    if ((info.num_sequences > 0) && info.seq_data) {
+        *duration_frames = MIX_MSToFrames(spec->freq, (Uint64) info.seq_data[0].duration);   // closest we can get.
+    } else {
+        *duration_frames = MIX_DURATION_UNKNOWN;
     }
 
-    struct xmp_frame_info frame_info;
-    libxmp.xmp_get_frame_info(ctx, &frame_info);
+    FreeXmpContext(ctx);  // tracks load their own when they need it, so we don't hold a parsed module for audio that isn't playing.
 
-    *duration_frames = MIX_MSToFrames(spec->freq, (Uint64) frame_info.total_time);   // closest we can get.
-
-    libxmp.xmp_stop_module(ctx);
-    libxmp.xmp_end_player(ctx);
-    libxmp.xmp_release_module(ctx);
-    libxmp.xmp_free_context(ctx);
+    XMP_AudioData *adata = (XMP_AudioData *) SDL_calloc(1, sizeof (*adata));
+    if (!adata) {
+        return false;
+    }
 
     // libxmp prefers to generate Sint16, stereo data.
     spec->format = SDL_AUDIO_S16;
     spec->channels = 2;
     // libxmp generates in whatever sample rate, so use the current device spec->freq.
 
-    *audio_userdata = NULL;  // no state.
+    *audio_userdata = adata;
 
     return true;
 }
 
 bool SDLCALL XMP_init_track(void *audio_userdata, SDL_IOStream *io, const SDL_AudioSpec *spec, SDL_PropertiesID props, void **track_userdata)
 {
-    SDL_assert(audio_userdata == NULL);  // no state.
-
+    XMP_AudioData *adata = (XMP_AudioData *) audio_userdata;
     int err;
 
     XMP_TrackData *tdata = (XMP_TrackData *) SDL_calloc(1, sizeof (*tdata));
@@ -205,25 +218,48 @@ bool SDLCALL XMP_init_track(void *audio_userdata, SDL_IOStream *io, const SDL_Au
         return false;
     }
 
+    tdata->adata = adata;
     tdata->freq = spec->freq;
 
-    tdata->ctx = libxmp.xmp_create_context();
-    if (!tdata->ctx) {
-        SDL_free(tdata);
-        return SDL_OutOfMemory();
-    }
+    SDL_AddAtomicInt(&adata->active_tracks, 1);  // do this first, so XMP_quit_track doesn't free a spare we're about to take.
+
+    // take the spare context, with the module already loaded, if nothing else is using it.
+    void *spare;
+    do {
+        spare = SDL_GetAtomicPointer(&adata->spare_ctx);
+    } while (spare && !SDL_CompareAndSwapAtomicPointer(&adata->spare_ctx, spare, NULL));
+
+    if (spare) {
+        tdata->ctx = (xmp_context) spare;
+    } else {
+        tdata->ctx = libxmp.xmp_create_context();
+        if (!tdata->ctx) {
+            SDL_AddAtomicInt(&adata->active_tracks, -1);
+            SDL_free(tdata);
+            return SDL_OutOfMemory();
+        }
 
-    err = libxmp.xmp_load_module_from_callbacks(tdata->ctx, io, XMP_IoCallbacks);
-    if (err) {
-        libxmp.xmp_free_context(tdata->ctx);
-        SDL_free(tdata);
-        return SetLibXmpError("xmp_load_module_from_memory", err);
+        // if the data is already in memory, let libxmp parse it from there instead of pulling it through the i/o callbacks.
+        size_t datalen = 0;
+        const void *data = MIX_GetConstIOBuffer(io, &datalen);
+        if (data && (datalen <= (size_t) SDL_MAX_SINT32)) {
+            err = libxmp.xmp_load_module_from_memory(tdata->ctx, (LIBXMP_CONST void *) data, (long) datalen);
+        } else {
+            err = libxmp.xmp_load_module_from_callbacks(tdata->ctx, io, XMP_IoCallbacks);
+        }
+
+        if (err) {
+            libxmp.xmp_free_context(tdata->ctx);
+            SDL_AddAtomicInt(&adata->active_tracks, -1);
+            SDL_free(tdata);
+            return SetLibXmpError("xmp_load_module", err);
+        }
     }
 
     err = libxmp.xmp_start_player(tdata->ctx, spec->freq, 0);
     if (err) {
-        libxmp.xmp_release_module(tdata->ctx);
-        libxmp.xmp_free_context(tdata->ctx);
+        FreeXmpContext(tdata->ctx);
+        SDL_AddAtomicInt(&adata->active_tracks, -1);
         SDL_free(tdata);
         return SetLibXmpError("xmp_start_player", err);
     }
@@ -265,14 +301,36 @@ void SDLCALL XMP_quit_track(void *track_userdata)
     XMP_TrackData *tdata = (XMP_TrackData *) track_userdata;
     libxmp.xmp_stop_module(tdata->ctx);
     libxmp.xmp_end_player(tdata->ctx);
-    libxmp.xmp_release_module(tdata->ctx);
-    libxmp.xmp_free_context(tdata->ctx);
+
+    // keep the loaded module around for the next track, unless there's already a spare.
+    XMP_AudioData *adata = tdata->adata;
+    if (!SDL_CompareAndSwapAtomicPointer(&adata->spare_ctx, NULL, tdata->ctx)) {
+        FreeXmpContext(tdata->ctx);
+    }
+
+    // ...but if that was the last track playing this audio, free the spare, too. Every track puts its context back before
+    //  it gets here, so the last one out always sees whatever was left.
+    if (SDL_AtomicDecRef(&adata->active_tracks)) {
+        void *spare;
+        do {
+            spare = SDL_GetAtomicPointer(&adata->spare_ctx);
+        } while (spare && !SDL_CompareAndSwapAtomicPointer(&adata->spare_ctx, spare, NULL));
+        if (spare) {
+            FreeXmpContext((xmp_context) spare);
+        }
+    }
+
     SDL_free(tdata);
 }
 
 void SDLCALL XMP_quit_audio(void *audio_userdata)
 {
-    SDL_assert(audio_userdata == NULL);   // no state.
+    XMP_AudioData *adata = (XMP_AudioData *) audio_userdata;
+    void *spare = SDL_GetAtomicPointer(&adata->spare_ctx);
+    if (spare) {
+        FreeXmpContext((xmp_context) spare);
+    }
+    SDL_free(adata);
 }
 
 MIX_Decoder MIX_Decoder_XMP = {
@@ -0,0 +1,360 @@
+#define SDL_MAIN_USE_CALLBACKS 1  /* use the callbacks instead of main() */
+#include <SDL3/SDL.h>
+#include <SDL3/SDL_main.h>
+#include "SDL3_mixer/SDL_mixer.h"
+
+// This doesn't make any sound; it runs mixers with MIX_Generate() and checks
+//  that what comes out is what should. Give it a compressed file (MP3, Ogg
+//  Vorbis, FLAC...), ideally longer than 20 seconds, to check seeking and
+//  predecoding, too.
+
+#define CHUNK_FRAMES 1001  // an odd size, so work doesn't line up with buffer edges.
+
+static int failures = 0;
+
+#define CHECK(cond, ...) do { if (!(cond)) { SDL_Log("FAIL: " __VA_ARGS__); failures++; } } while (0)
+
+static MIX_Track *CreatePlayingTrack(MIX_Mixer *mixer, MIX_Audio *audio, Sint64 start_frame, Sint64 start_at_mixer_frame)
+{
+    MIX_Track *track = MIX_CreateTrack(mixer);
+    if (!track || !MIX_SetTrackAudio(track, audio)) {
+        return NULL;
+    }
+
+    const SDL_PropertiesID options = SDL_CreateProperties();
+    SDL_SetNumberProperty(options, MIX_PROP_PLAY_START_FRAME_NUMBER, start_frame);
+    SDL_SetNumberProperty(options, MIX_PROP_PLAY_START_AT_MIXER_FRAME_NUMBER, start_at_mixer_frame);
+    const bool okay = MIX_PlayTrack(track, options);
+    SDL_DestroyProperties(options);
+    return okay ? track : NULL;
+}
+
+// generate `frames` frames in CHUNK_FRAMES pieces; `out` can be NULL to throw them away.
+static bool Generate(MIX_Mixer *mixer, const SDL_AudioSpec *spec, float *out, Uint64 frames)
+{
+    float buffer[CHUNK_FRAMES * 8];
+    const int framesize = (int) sizeof (float) * spec->channels;
+    while (frames > 0) {
+        const int chunk = (int) SDL_min(frames, (Uint64) CHUNK_FRAMES);
+        if (!MIX_Generate(mixer, out ? out : buffer, chunk * framesize)) {
+            return false;
+        }
+        if (out) {
+            out += chunk * spec->channels;
+        }
+        frames -= chunk;
+    }
+    return true;
+}
+
+// A track scheduled with MIX_PROP_PLAY_START_AT_MIXER_FRAME_NUMBER and MIX_StopTrackAtMixerFrame() must be heard for
+//  exactly those frames, even though they land in the middle of MIX_Generate() calls.
+static void CheckScheduling(void)
+{
+    const SDL_AudioSpec spec = { SDL_AUDIO_F32, 1, 48000 };
+    const Uint64 start = 1234;
+    const Uint64 stop = 5678;
+    const Uint64 total = 8000;
+
+    static float ones[10000];
+    for (int i = 0; i < SDL_arraysize(ones); i++) {
+        ones[i] = 1.0f;
+    }
+
+    MIX_Mixer *mixer = MIX_CreateMixer(&spec);
+    MIX_Audio *audio = mixer ? MIX_LoadRawAudio(mixer, ones, sizeof (ones), &spec) : NULL;
+    MIX_Track *track = audio ? CreatePlayingTrack(mixer, audio, 0, (Sint64) start) : NULL;
+    float *output = (float *) SDL_calloc(total, sizeof (float));
+    if (!track || !output || !MIX_StopTrackAtMixerFrame(track, stop, 0) || !Generate(mixer, &spec, output, total)) {
+        CHECK(false, "scheduling: couldn't set up or run the mixer: %s", SDL_GetError());
+    } else {
+        Uint64 first_wrong = total;
+        for (Uint64 i = 0; i < total; i++) {
+            const float expected = ((i >= start) && (i < stop)) ? 1.0f : 0.0f;
+            if (output[i] != expected) {
+                first_wrong = i;
+                break;
+            }
+        }
+        CHECK(first_wrong == total, "scheduling: frame %" SDL_PRIu64 " is %f, but the track should play from frame %" SDL_PRIu64 " to %" SDL_PRIu64, first_wrong, output[first_wrong], start, stop);
+        CHECK(MIX_GetMixerClock(mixer) == total, "scheduling: mixer clock is %" SDL_PRIu64 ", not %" SDL_PRIu64, MIX_GetMixerClock(mixer), total);
+    }
+
+    SDL_free(output);
+    MIX_DestroyMixer(mixer);
+    MIX_DestroyAudio(audio);
+    SDL_Log("scheduling: checked");
+}
+
+static MIX_Audio *LoadTestAudio(const char *path, bool predecode, Sint64 seek_interval_ms, bool build_seek_table)
+{
+    const SDL_PropertiesID props = SDL_CreateProperties();
+    SDL_SetPointerProperty(props, MIX_PROP_AUDIO_LOAD_IOSTREAM_POINTER, SDL_IOFromFile(path, "rb"));
+    SDL_SetBooleanProperty(props, MIX_PROP_AUDIO_LOAD_CLOSEIO_BOOLEAN, true);
+    SDL_SetBooleanProperty(props, MIX_PROP_AUDIO_LOAD_PREDECODE_BOOLEAN, predecode);
+    SDL_SetNumberProperty(props, MIX_PROP_AUDIO_LOAD_SEEK_INTERVAL_MS_NUMBER, seek_interval_ms);
+    SDL_SetBooleanProperty(props, MIX_PROP_AUDIO_LOAD_BUILD_SEEK_TABLE_BOOLEAN, build_seek_table);
+    MIX_Audio *audio = MIX_LoadAudioWithProperties(props);
+    SDL_DestroyProperties(props);
+    return audio;
+}
+
+// the mixer runs in the audio's own format, so a single track at full gain comes out exactly as it was decoded.
+static MIX_Mixer *CreateMatchingMixer(MIX_Audio *audio, SDL_AudioSpec *spec)
+{
+    if (!MIX_GetAudioFormat(audio, spec)) {
+        return NULL;
+    } else if (spec->channels > 8) {
+        SDL_SetError("This test only handles up to 8 channels");
+        return NULL;
+    }
+    spec->format = SDL_AUDIO_F32;
+    return MIX_CreateMixer(spec);
+}
+
+// Seeking with a seek table has to land on the same samples that decoding straight through from the start does.
+static void CheckSeeking(const char *path)
+{
+    MIX_Audio *linear = LoadTestAudio(path, false, 0, false);  // no table, and we never seek this one.
+    MIX_Audio *indexed = LoadTestAudio(path, false, 250, true);
+    SDL_AudioSpec spec;
+    if (!linear || !indexed || !MIX_GetAudioFormat(linear, &spec)) {
+        CHECK(false, "seeking: couldn't load '%s': %s", path, SDL_GetError());
+        MIX_DestroyAudio(linear);
+        MIX_DestroyAudio(indexed);
+        return;
+    }
+
+    const Sint64 duration = MIX_GetAudioDuration(linear);
+    const Uint64 length = (duration > 0) ? (Uint64) duration : ((Uint64) spec.freq * 10);
+    const Uint64 compare_frames = (Uint64) spec.freq / 4;
+    const Uint64 targets[] = { 1, length / 3, (length / 2) + 4321, (length > compare_frames * 2) ? (length - compare_frames * 2) : 0 };
+    const size_t values = (size_t) (compare_frames * spec.channels);
+    float *expected = (float *) SDL_malloc(values * sizeof (float));
+    float *actual = (float *) SDL_malloc(values * sizeof (float));
+
+    for (int i = 0; expected && actual && (i < SDL_arraysize(targets)); i++) {
+        const Uint64 target = targets[i];
+        SDL_AudioSpec mixspec;
+        MIX_Mixer *linear_mixer = CreateMatchingMixer(linear, &mixspec);
+        MIX_Mixer *indexed_mixer = CreateMatchingMixer(indexed, &mixspec);
+        const bool okay = linear_mixer && indexed_mixer &&
+                          CreatePlayingTrack(linear_mixer, linear, 0, 0) &&
+                          CreatePlayingTrack(indexed_mixer, indexed, (Sint64) target, 0) &&
+                          Generate(linear_mixer, &mixspec, NULL, target) &&
+                          Generate(linear_mixer, &mixspec, expected, compare_frames) &&
+                          Generate(indexed_mixer, &mixspec, actual, compare_frames);
+        if (!okay) {
+            CHECK(false, "seeking: couldn't run the mixers: %s", SDL_GetError());
+        } else {
+            float max_diff = 0.0f;
+            for (size_t j = 0; j < values; j++) {
+                max_diff = SDL_max(max_diff, SDL_fabsf(expected[j] - actual[j]));
+            }
+            // lossy formats might round differently after a seek, but anything audible means we landed in the wrong place.
+            CHECK(max_diff <= 0.0001f, "seeking: frame %" SDL_PRIu64 " differs from a linear decode by up to %f", target, max_diff);
+            SDL_Log("seeking: frame %" SDL_PRIu64 " differs from a linear decode by up to %f", target, max_diff);
+        }
+        MIX_DestroyMixer(linear_mixer);
+        MIX_DestroyMixer(indexed_mixer);
+    }
+
+    SDL_free(expected);
+    SDL_free(actual);
+    MIX_DestroyAudio(linear);
+    MIX_DestroyAudio(indexed);
+}
+
+// Predecoding (which splits long files across threads when the decoder allows it) has to produce exactly the same
+//  samples as decoding the file serially while it plays.
+static void CheckPredecode(const char *path)
+{
+    MIX_Audio *streamed = LoadTestAudio(path, false, 1000, false);
+    MIX_Audio *predecoded = LoadTestAudio(path, true, 1000, false);
+    SDL_AudioSpec spec;
+    MIX_Mixer *streamed_mixer = streamed ? CreateMatchingMixer(streamed, &spec) : NULL;
+    MIX_Mixer *predecoded_mixer = predecoded ? CreateMatchingMixer(predecoded, &spec) : NULL;
+    if (!streamed_mixer || !predecoded_mixer || !CreatePlayingTrack(streamed_mixer, streamed, 0, 0) || !CreatePlayingTrack(predecoded_mixer, predecoded, 0, 0)) {
+        CHECK(false, "predecode: couldn't set up '%s': %s", path, SDL_GetError());
+    } else {
+        const Sint64 duration = MIX_GetAudioDuration(predecoded);
+        if (duration < ((Sint64) spec.freq * 20)) {
+            SDL_Log("predecode: '%s' is shorter than 20 seconds, so this won't use more than one thread.", path);
+        }
+
+        // a little past the end, to make sure the predecoded version doesn't stop early or run long.
+        const Uint64 total = (Uint64) SDL_max(duration, 0) + CHUNK_FRAMES;
+        float expected[CHUNK_FRAMES * 8];
+        float actual[CHUNK_FRAMES * 8];
+        for (Uint64 frame = 0; frame < total; frame += CHUNK_FRAMES) {
+            if (!Generate(streamed_mixer, &spec, expected, CHUNK_FRAMES) || !Generate(predecoded_mixer, &spec, actual, CHUNK_FRAMES)) {
+                CHECK(false, "predecode: couldn't run the mixers: %s", SDL_GetError());
+                break;
+            } else if (SDL_memcmp(expected, actual, CHUNK_FRAMES * spec.channels * sizeof (float)) != 0) {
+                CHECK(false, "predecode: output differs from a serial decode near frame %" SDL_PRIu64, frame);
+                break;
+            }
+        }
+        SDL_Log("predecode: checked %" SDL_PRIu64 " frames", total);
+    }
+
+    MIX_DestroyMixer(streamed_mixer);
+    MIX_DestroyMixer(predecoded_mixer);
+    MIX_DestroyAudio(streamed);
+    MIX_DestroyAudio(predecoded);
+}
+
+#define AMBISONIC_FRAMES 4800
+
+// Render `sources` copies of a mono sine wave through a stereo mixer with the given ambisonic order. Each copy is
+//  positioned at `position` if it isn't NULL, or forced to `gains` if that isn't NULL, or left alone.
+static bool RenderAmbisonic(int order, int sources, const MIX_Point3D *position, const MIX_StereoGains *gains, float *out)
+{
+    const SDL_AudioSpec spec = { SDL_AUDIO_F32, 2, 48000 };
+    const SDL_AudioSpec monospec = { SDL_AUDIO_F32, 1, 48000 };
+
+    static float sine[AMBISONIC_FRAMES];  // quiet enough that ten of these together don't clip.
+    for (int i = 0; i < SDL_arraysize(sine); i++) {
+        sine[i] = 0.05f * SDL_sinf(((float) i) * (2.0f * SDL_PI_F * 440.0f / 48000.0f));
+    }
+
+    MIX_Mixer *mixer = MIX_CreateMixer(&spec);
+    MIX_Audio *audio = mixer ? MIX_LoadRawAudio(mixer, sine, sizeof (sine), &monospec) : NULL;
+    bool okay = audio && MIX_SetAmbisonicOrder(mixer, order);
+    for (int i = 0; okay && (i < sources); i++) {
+        MIX_Track *track = MIX_CreateTrack(mixer);
+        okay = track && MIX_SetTrackAudio(track, audio);
+        if (okay && position) {
+            okay = MIX_SetTrack3DPosition(track, position);
+        } else if (okay && gains) {
+            okay = MIX_SetTrackStereo(track, gains);
+        }
+        okay = okay && MIX_PlayTrack(track, 0);
+    }
+    okay = okay && Generate(mixer, &spec, out, AMBISONIC_FRAMES);
+
+    MIX_DestroyMixer(mixer);
+    MIX_DestroyAudio(audio);
+    return okay;
+}
+
+static void SumSquares(const float *stereo, int frames, double *left, double *right)
+{
+    *left = *right = 0.0;
+    for (int i = 0; i < frames; i++) {
+        *left += (double) stereo[i * 2] * stereo[i * 2];
+        *right += (double) stereo[(i * 2) + 1] * stereo[(i * 2) + 1];
+    }
+}
+
+// The ambisonic bus (MIX_SetAmbisonicOrder) has to put 3D tracks on the correct side, mix any number of them as one
+//  sound field, and leave tracks that aren't 3D alone.
+static void CheckAmbisonics(void)
+{
+    const SDL_AudioSpec spec = { SDL_AUDIO_F32, 2, 48000 };
+    MIX_Mixer *mixer = MIX_CreateMixer(&spec);
+    if (!mixer) {
+        CHECK(false, "ambisonics: couldn't create a mixer: %s", SDL_GetError());
+        return;
+    }
+
+    CHECK(!MIX_SetAmbisonicOrder(mixer, -1), "ambisonics: order -1 was accepted");
+    CHECK(!MIX_SetAmbisonicOrder(mixer, 4), "ambisonics: order 4 was accepted");
+    for (int order = 0; order <= 3; order++) {
+        CHECK(MIX_SetAmbisonicOrder(mixer, order), "ambisonics: order %d was rejected: %s", order, SDL_GetError());
+        CHECK(MIX_GetAmbisonicOrder(mixer) == order, "ambisonics: order is %d after setting it to %d", MIX_GetAmbisonicOrder(mixer), order);
+    }
+    MIX_DestroyMixer(mixer);
+
+    static float expected[AMBISONIC_FRAMES * 2];
+    static float actual[AMBISONIC_FRAMES * 2];
+    const MIX_Point3D left = { -1.0f, 0.0f, 0.0f };
+    const MIX_Point3D right = { 1.0f, 0.0f, 0.0f };
+    const MIX_Point3D front = { 0.0f, 0.0f, -1.0f };
+    const MIX_StereoGains gains = { 0.25f, 0.75f };
+
+    for (int order = 1; order <= 3; order++) {
+        double l, r;
+        if (!RenderAmbisonic(order, 1, &left, NULL, actual)) {
+            CHECK(false, "ambisonics: couldn't render order %d: %s", order, SDL_GetError());
+            continue;
+        }
+        SumSquares(actual, AMBISONIC_FRAMES, &l, &r);
+        CHECK(l > (r * 2.0), "ambisonics: order %d, a track on the left has %f energy on the left and %f on the right", order, l, r);
+
+        if (RenderAmbisonic(order, 1, &right, NULL, actual)) {
+            SumSquares(actual, AMBISONIC_FRAMES, &l, &r);
+            CHECK(r > (l * 2.0), "ambisonics: order %d, a track on the right has %f energy on the left and %f on the right", order, l, r);
+        }
+
+        if (RenderAmbisonic(order, 1, &front, NULL, actual)) {
+            SumSquares(actual, AMBISONIC_FRAMES, &l, &r);
+            CHECK((l > 0.0) && (SDL_fabs(l - r) <= (l * 0.01)), "ambisonics: order %d, a track in front has %f energy on the left and %f on the right", order, l, r);
+        }
+
+        // the bus is decoded once, so ten tracks in the same place are exactly ten times as loud as one.
+        if (RenderAmbisonic(order, 1, &left, NULL, expected) && RenderAmbisonic(order, 10, &left, NULL, actual)) {
+            float max_diff = 0.0f;
+            for (int i = 0; i < SDL_arraysize(actual); i++) {
+                max_diff = SDL_max(max_diff, SDL_fabsf((expected[i] * 10.0f) - actual[i]));
+            }
+            CHECK(max_diff <= 0.0001f, "ambisonics: order %d, ten tracks differ from ten times one track by up to %f", order, max_diff);
+        }
+
+        // forced-stereo and unpositioned tracks don't go through the bus at all.
+        if (RenderAmbisonic(0, 1, NULL, &gains, expected) && RenderAmbisonic(order, 1, NULL, &gains, actual)) {
+            CHECK(SDL_memcmp(expected, actual, sizeof (actual)) == 0, "ambisonics: order %d changed a forced-stereo track", order);
+        }
+        if (RenderAmbisonic(0, 1, NULL, NULL, expected) && RenderAmbisonic(order, 1, NULL, NULL, actual)) {
+            CHECK(SDL_memcmp(expected, actual, sizeof (actual)) == 0, "ambisonics: order %d changed an unpositioned track", order);
+        }
+    }
+
+    SDL_Log("ambisonics: checked");
+}
+
+SDL_AppResult SDL_AppInit(void **appstate, int argc, char *argv[])
+{
+    SDL_SetAppMetadata("Test SDL_mixer behavior", "1.0", "org.libsdl.testmixerbehavior");
+
+    if (argc > 2) {
+        SDL_Log("USAGE: %s [compressed_file_to_check]", argv[0]);
+        return SDL_APP_FAILURE;
+    } else if (!MIX_Init()) {
+        SDL_Log("Couldn't initialize SDL_mixer: %s", SDL_GetError());
+        return SDL_APP_FAILURE;
+    }
+
+    CheckScheduling();
+    CheckAmbisonics();
+
+    if (argc == 2) {
+        CheckSeeking(argv[1]);
+        CheckPredecode(argv[1]);
+    } else {
+        SDL_Log("No file given, so not checking seeking or predecoding.");
+    }
+
+    if (failures) {
+        SDL_Log("%d check(s) failed.", failures);
+        return SDL_APP_FAILURE;
+    }
+
+    SDL_Log("All checks passed.");
+    return SDL_APP_SUCCESS;
+}
+
+SDL_AppResult SDL_AppEvent(void *appstate, SDL_Event *event)
+{
+    return SDL_APP_CONTINUE;
+}
+
+SDL_AppResult SDL_AppIterate(void *appstate)
+{
+    return SDL_APP_SUCCESS;
+}
+
+void SDL_AppQuit(void *appstate, SDL_AppResult result)
+{
+    MIX_Quit();  // this cleans up any tracks, mixers, and audio we didn't.
+}